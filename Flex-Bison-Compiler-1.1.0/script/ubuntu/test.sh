@@ -4,23 +4,202 @@ set -u
 
 BASE_PATH="$(dirname "$0")/../.."
 cd "$BASE_PATH"
+BASE_PATH="$(pwd)"
 
 GREEN='\033[0;32m'
 RED='\033[0;31m'
 OFF='\033[0m'
 STATUS=0
 
+# Every case is compiled (and run) in a directory of its own, so the files
+# named by its directives are relative to it.
+WORK="$(mktemp -d)"
+
+# The compile server of the "served" directive, which the client reaches on a
+# socket of its own. The client is copied away from the compiler, so it cannot
+# fall back to it.
+SOCKET="$WORK/server.socket"
+cp "$BASE_PATH/build/CompilerClient" "$WORK/CompilerClient"
+"$BASE_PATH/build/Compiler" --server "$SOCKET" --workers 2 > "$WORK/server.txt" 2>&1 &
+SERVER="$!"
+trap 'kill "$SERVER" 2> /dev/null; wait "$SERVER" 2> /dev/null; rm -rf "$WORK"' EXIT
+for attempt in $(seq 50); do
+	[ -S "$SOCKET" ] && break
+	sleep 0.1
+done
+
+# Prints the values of a directive of a case, one per line. The directives
+# are the "name: value" lines of the comment that starts the case, if any.
+directive() {
+	awk -v name="$2" '
+		NR == 1 && !/^\/\*/ { exit }
+		{
+			line = $0
+			sub(/^\/\*+/, "", line)
+			sub(/^[ \t]*\*?[ \t]*/, "", line)
+			sub(/[ \t]*\*\/.*$/, "", line)
+			if (index(line, name ": ") == 1) print substr(line, length(name) + 3)
+		}
+		/\*\// { exit }' "$1"
+}
+
+# Compiles a case in its directory, with the words of its "environment" and
+# "arguments" directives, and then the extra words (each "NAME=value" word is
+# a variable, and any other one an argument). The assembly is left in
+# "output.s" (even with "OUTPUT_FILE"), and the standard error output in
+# "error.txt". The summaries of the cases of its "interface" directives are
+# loaded (and written first, once), and so is the profile of its "profile"
+# directive. Returns the status of the compiler (or of the client, in
+# "COMPILER_COMMAND").
+compile() {
+	local source="$1"
+	local directory="$2"
+	shift 2
+	local variables=()
+	local arguments=()
+	local output=""
+	local interfaces=""
+	local library
+	local run
+	for library in $(directive "$source" interface); do
+		if [ ! -f "$WORK/interface-$library/interface.bin" ]; then
+			mkdir -p "$WORK/interface-$library"
+			compile "$BASE_PATH/src/test/c/accept/$library" "$WORK/interface-$library" INTERFACE_OUTPUT_FILE=interface.bin
+		fi
+		interfaces="${interfaces:+$interfaces:}$WORK/interface-$library/interface.bin"
+	done
+	[ -n "$interfaces" ] && variables+=("INTERFACE_FILES=$interfaces")
+	local runs="$(directive "$source" profile)"
+	if [ -n "$runs" ] && [ -z "${TRAINING:-}" ]; then
+		local training="$WORK/profile-$(basename "$source")"
+		if [ ! -f "$training/program.profile" ]; then
+			mkdir -p "$training"
+			TRAINING=1 compile "$source" "$training" PROFILE_OUTPUT_FILE=program.profile
+			gcc "$training/output.s" -o "$training/program" 2> /dev/null
+			for run in $(seq "$runs"); do
+				(cd "$training" && ./program > /dev/null 2>&1)
+			done
+		fi
+		variables+=("PROFILE_FILE=$training/program.profile")
+	fi
+	for word in $(directive "$source" environment) $(directive "$source" arguments) "$@"; do
+		if [[ "$word" == *=* ]]; then
+			variables+=("$word")
+			[[ "$word" == OUTPUT_FILE=* ]] && output="${word#OUTPUT_FILE=}"
+		else
+			arguments+=("$word")
+		fi
+	done
+	(cd "$directory" && env "${variables[@]}" "${COMPILER_COMMAND:-$BASE_PATH/build/Compiler}" "${arguments[@]}" < "$source" > output.s 2> error.txt)
+	local result="$?"
+	if [ -n "$output" ] && [ -f "$directory/$output" ]; then
+		mv "$directory/$output" "$directory/output.s"
+	fi
+	return "$result"
+}
+
+# Checks the directives of the standard error output of a case (accepted or
+# rejected), and prints the first one that fails (or nothing):
+#	logged: text		The standard error output contains the text.
+#	unlogged: text		The standard error output doesn't contain the text.
+logging() {
+	local source="$1"
+	local directory="$2"
+	local text
+	while IFS= read -r text; do
+		grep -qF -- "$text" "$directory/error.txt" || { echo "the errors lack \"$text\""; return; }
+	done < <(directive "$source" logged)
+	while IFS= read -r text; do
+		grep -qF -- "$text" "$directory/error.txt" && { echo "the errors have \"$text\""; return; }
+	done < <(directive "$source" unlogged)
+}
+
+# Checks the directives of a case that compiled (after the ones of "logging"),
+# and prints the first one that fails (or nothing):
+#	contains: text		The assembly contains the text.
+#	lacks: text		The assembly doesn't contain the text.
+#	statistics: text	The "--stats" JSON contains the text.
+#	identical: words	The assembly is the same with the extra words.
+#	served: number		The assembly is the same on each of these many
+#				compilations through the compile server.
+#	recompiled: text	Compiled again in its directory (e.g., with the
+#				same function cache), the assembly is the same,
+#				and the "--stats" JSON contains the text.
+#	status: number		The program exits with this status (linked with
+#				the cases of its "interface" directives).
+#	report: text		The coverage report of "program.coverage", which
+#				the program writes, contains the text.
+check() {
+	local source="$1"
+	local directory="$2"
+	local text
+	local failure="$(logging "$source" "$directory")"
+	[ -n "$failure" ] && { echo "$failure"; return; }
+	while IFS= read -r text; do
+		grep -qF -- "$text" "$directory/output.s" || { echo "the output lacks \"$text\""; return; }
+	done < <(directive "$source" contains)
+	while IFS= read -r text; do
+		grep -qF -- "$text" "$directory/output.s" && { echo "the output has \"$text\""; return; }
+	done < <(directive "$source" lacks)
+	while IFS= read -r text; do
+		grep -qF -- "$text" "$directory/error.txt" || { echo "the statistics lack \"$text\""; return; }
+	done < <(directive "$source" statistics)
+	while IFS= read -r text; do
+		mkdir -p "$directory/identical"
+		compile "$source" "$directory/identical" $text
+		cmp -s "$directory/output.s" "$directory/identical/output.s" || { echo "the output changes with \"$text\""; return; }
+	done < <(directive "$source" identical)
+	while IFS= read -r text; do
+		mkdir -p "$directory/served"
+		for request in $(seq "$text"); do
+			COMPILER_COMMAND="$WORK/CompilerClient" compile "$source" "$directory/served" "COMPILER_SOCKET=$SOCKET"
+			[ "$?" == "0" ] || { echo "the compile server rejects it"; return; }
+			cmp -s "$directory/output.s" "$directory/served/output.s" || { echo "the output of the compile server differs"; return; }
+		done
+	done < <(directive "$source" served)
+	while IFS= read -r text; do
+		[ -f "$directory/first.s" ] || cp "$directory/output.s" "$directory/first.s"
+		compile "$source" "$directory" --stats
+		cmp -s "$directory/first.s" "$directory/output.s" || { echo "the output changes when it's compiled again"; return; }
+		grep -qF -- "$text" "$directory/error.txt" || { echo "the statistics of the second compilation lack \"$text\""; return; }
+	done < <(directive "$source" recompiled)
+	while IFS= read -r text; do
+		local libraries=()
+		for library in $(directive "$source" interface); do
+			libraries+=("$WORK/interface-$library/output.s")
+		done
+		gcc "$directory/output.s" "${libraries[@]}" -o "$directory/program" 2> "$directory/error.txt" || { echo "the output doesn't assemble"; return; }
+		(cd "$directory" && ./program > /dev/null 2>&1)
+		local result="$?"
+		[ "$result" == "$text" ] || { echo "the program exits with status $result"; return; }
+	done < <(directive "$source" status)
+	while IFS= read -r text; do
+		"$BASE_PATH/build/CompilerCoverageReport" --coverage "$directory/program.coverage" --source "$source" > "$directory/report.txt" 2>&1
+		grep -qF -- "$text" "$directory/report.txt" || { echo "the coverage report lacks \"$text\""; return; }
+	done < <(directive "$source" report)
+}
+
 echo "Compiler should accept..."
 echo ""
 
 for test in $(ls src/test/c/accept/); do
-	cat "src/test/c/accept/$test" | build/Compiler >/dev/null 2>&1
+	directory="$WORK/accept-$test"
+	mkdir -p "$directory"
+	STATISTICS=()
+	[ -n "$(directive "src/test/c/accept/$test" statistics)" ] && STATISTICS=(--stats)
+	compile "$BASE_PATH/src/test/c/accept/$test" "$directory" "${STATISTICS[@]}"
 	RESULT="$?"
-	if [ "$RESULT" == "0" ]; then
+	if [ "$RESULT" != "0" ]; then
+		STATUS=1
+		echo -e "    $test, ${RED}but it rejects${OFF} (status $RESULT)"
+		continue
+	fi
+	FAILURE="$(check "$BASE_PATH/src/test/c/accept/$test" "$directory")"
+	if [ -z "$FAILURE" ]; then
 		echo -e "    $test, ${GREEN}and it does${OFF} (status $RESULT)"
 	else
 		STATUS=1
-		echo -e "    $test, ${RED}but it rejects${OFF} (status $RESULT)"
+		echo -e "    $test, ${RED}but $FAILURE${OFF}"
 	fi
 done
 echo ""
@@ -29,16 +208,57 @@ echo "Compiler should reject..."
 echo ""
 
 for test in $(ls src/test/c/reject/); do
-	cat "src/test/c/reject/$test" | build/Compiler >/dev/null 2>&1
+	directory="$WORK/reject-$test"
+	mkdir -p "$directory"
+	compile "$BASE_PATH/src/test/c/reject/$test" "$directory"
 	RESULT="$?"
-	if [ "$RESULT" != "0" ]; then
+	if [ "$RESULT" == "0" ]; then
+		STATUS=1
+		echo -e "    $test, ${RED}but it accepts${OFF} (status $RESULT)"
+		continue
+	fi
+	FAILURE="$(logging "$BASE_PATH/src/test/c/reject/$test" "$directory")"
+	if [ -z "$FAILURE" ]; then
 		echo -e "    $test, ${GREEN}and it does${OFF} (status $RESULT)"
 	else
 		STATUS=1
-		echo -e "    $test, ${RED}but it accepts${OFF} (status $RESULT)"
+		echo -e "    $test, ${RED}but $FAILURE${OFF}"
 	fi
 done
 echo ""
 
+echo "Benchmark should emit a program that compiles..."
+echo ""
+
+# The synthetic program of a fixed seed is compiled and linked, and it must
+# exit with the same status as when it's compiled by GCC.
+directory="$WORK/benchmark"
+mkdir -p "$directory"
+"$BASE_PATH/build/CompilerBenchmark" --emit --seed 7 > "$directory/program.c"
+"$BASE_PATH/build/Compiler" < "$directory/program.c" > "$directory/output.s" 2> "$directory/error.txt"
+RESULT="$?"
+if [ "$RESULT" != "0" ]; then
+	STATUS=1
+	echo -e "    seed 7, ${RED}but it rejects${OFF} (status $RESULT)"
+elif ! gcc "$directory/output.s" -o "$directory/program" 2> "$directory/error.txt"; then
+	STATUS=1
+	echo -e "    seed 7, ${RED}but the output doesn't assemble${OFF}"
+elif ! gcc -w -x c "$directory/program.c" -o "$directory/reference" 2> "$directory/error.txt"; then
+	STATUS=1
+	echo -e "    seed 7, ${RED}but GCC rejects it${OFF}"
+else
+	(cd "$directory" && ./program > /dev/null 2>&1)
+	RESULT="$?"
+	(cd "$directory" && ./reference > /dev/null 2>&1)
+	EXPECTED="$?"
+	if [ "$RESULT" == "$EXPECTED" ]; then
+		echo -e "    seed 7, ${GREEN}and it does${OFF} (status $RESULT)"
+	else
+		STATUS=1
+		echo -e "    seed 7, ${RED}but the program exits with status $RESULT${OFF} (instead of $EXPECTED)"
+	fi
+fi
+echo ""
+
 echo "All done."
 exit $STATUS
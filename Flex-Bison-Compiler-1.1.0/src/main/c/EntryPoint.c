@@ -1,31 +1,54 @@
+#include "backend/code-generation/Emitter.h"
 #include "backend/code-generation/Generator.h"
 #include "backend/domain-specific/Calculator.h"
+#include "backend/optimization/Peephole.h"
 #include "frontend/lexical-analysis/FlexActions.h"
 #include "frontend/syntactic-analysis/AbstractSyntaxTree.h"
 #include "frontend/syntactic-analysis/BisonActions.h"
 #include "frontend/syntactic-analysis/SyntacticAnalyzer.h"
+#include "server/CompileServer.h"
 #include "shared/CompilerState.h"
 #include "shared/Environment.h"
 #include "shared/Logger.h"
+#include "shared/Statistics.h"
 #include "shared/String.h"
 
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+/* PRIVATE FUNCTIONS */
+
+static CompilationStatus _compile(const int count, const char ** arguments);
+static boolean _hasOption(const int count, const char ** arguments, const char * option);
+static void _initializeModules(void);
+static CompilationStatus _serve(const int count, const char ** arguments);
+static void _shutdownModules(void);
+
 /**
- * The main entry-point of the entire application. If you use "strtok" to
- * parse anything inside this project instead of using Flex and Bison, I will
- * find you, and I will kill you (Bryan Mills; "Taken", 2008).
+ * Compiles the program in the standard input (or in the input of the
+ * syntactic analyzer, if it was restarted). With "--stats", the statistics
+ * of the compilation are written as JSON in the standard error output. With
+ * "--token-array", the whole input is lexed before the parsing starts, and
+ * with "--parallel-parse", the token array is parsed in parallel. With
+ * "--streaming", each top-level declaration is generated and released as
+ * soon as it's parsed, so the AST is never complete (nor parsed in parallel).
  */
-const int main(const int count, const char ** arguments) {
-    Logger * logger = createLogger("EntryPoint");
-    initializeFlexActionsModule();
-    initializeBisonActionsModule();
-    initializeSyntacticAnalyzerModule();
-    initializeAbstractSyntaxTreeModule();
-//	initializeCalculatorModule();
-//	initializeGeneratorModule();
-
+static CompilationStatus _compile(const int count, const char ** arguments) {
     // Logs the arguments of the application.
     for (int k = 0; k < count; ++k) {
-        logDebugging(logger, "Argument %d: \"%s\"", k, arguments[k]);
+        logDebugging(_logger, "Argument %d: \"%s\"", k, arguments[k]);
+    }
+
+    // The peephole rules count their hits since the start of the process.
+    const boolean statistics = _hasOption(count, arguments, "--stats");
+    const int peepholeRuleCount = getPeepholeRuleCount();
+    unsigned long * peepholeHits = statistics ? calloc(peepholeRuleCount, sizeof(unsigned long)) : NULL;
+    for (int rule = 0; peepholeHits != NULL && rule < peepholeRuleCount; ++rule) {
+        peepholeHits[rule] = getPeepholeRuleHits(rule);
+    }
+    if (statistics) {
+        startStatistics();
     }
 
     // Begin compilation process.
@@ -34,40 +57,165 @@ const int main(const int count, const char ** arguments) {
             .succeed = false,
             .value = 0
     };
-    const SyntacticAnalysisStatus syntacticAnalysisStatus = parse(&compilerState);
+    CompilerState generationState = {
+            .abstractSyntaxtTree = NULL,
+            .succeed = true,
+            .value = 0
+    };
+    const boolean streaming = _hasOption(count, arguments, "--streaming");
+    if (streaming && beginGeneration(&generationState)) {
+        compilerState.declarationConsumer = generateDeclaration;
+    }
+    uint64_t start = monotonicTime();
+    SyntacticAnalysisStatus syntacticAnalysisStatus;
+    const boolean parallelParse = !streaming && _hasOption(count, arguments, "--parallel-parse");
+    if (parallelParse || _hasOption(count, arguments, "--token-array")) {
+        TokenArray * tokens = lexTokens();
+        addPhaseTime(STATISTICS_LEXING, monotonicTime() - start);
+        syntacticAnalysisStatus = parallelParse
+                ? parseTokensInParallel(&compilerState, tokens)
+                : parseTokens(&compilerState, tokens);
+        destroyTokenArray(tokens);
+    }
+    else {
+        syntacticAnalysisStatus = parse(&compilerState);
+    }
+    if (compilerState.declarationConsumer != NULL) {
+        endGeneration();
+    }
+    addPhaseTime(STATISTICS_PARSING, monotonicTime() - start);
     CompilationStatus compilationStatus = SUCCEED;
     if (syntacticAnalysisStatus == ACCEPT) {
         // ----------------------------------------------------------------------------------------
         // Beginning of the Backend... ------------------------------------------------------------
-        /*logDebugging(logger, "Computing expression value...");
         Program * program = compilerState.abstractSyntaxtTree;
-        ComputationResult computationResult = computeExpression(program->expression);
-        if (computationResult.succeed) {
-            compilerState.value = computationResult.value;
-            generate(&compilerState);
+        compilerState.succeed = true;
+        start = monotonicTime();
+        if (streaming) {
+            // The program was generated while it was parsed.
+            compilerState.succeed = generationState.succeed;
         }
         else {
-            logError(logger, "The computation phase rejects the input program.");
+            generate(&compilerState);
+        }
+        addPhaseTime(STATISTICS_GENERATION, monotonicTime() - start);
+        if (!compilerState.succeed) {
+            logError(_logger, "The code-generation phase rejects the input program.");
             compilationStatus = FAILED;
         }
         // ...end of the Backend. -----------------------------------------------------------------
         // ----------------------------------------------------------------------------------------
-        logDebugging(logger, "Releasing AST resources...");
-        releaseProgram(program);*/
+        logDebugging(_logger, "Releasing AST resources...");
+        start = monotonicTime();
+        freeProgram(program);
+        addPhaseTime(STATISTICS_RELEASE, monotonicTime() - start);
     }
     else {
-        logError(logger, "The syntactic-analysis phase rejects the input program.");
+        logError(_logger, "The syntactic-analysis phase rejects the input program.");
         compilationStatus = FAILED;
     }
+    if (statistics) {
+        stopStatistics();
+        for (int rule = 0; peepholeHits != NULL && rule < peepholeRuleCount; ++rule) {
+            countNamed(STATISTICS_PEEPHOLE_RULES, getPeepholeRuleName(rule), getPeepholeRuleHits(rule) - peepholeHits[rule]);
+        }
+        writeStatistics(stderr);
+        free(peepholeHits);
+    }
+    return compilationStatus;
+}
+
+/**
+ * True if the option is one of the arguments.
+ */
+static boolean _hasOption(const int count, const char ** arguments, const char * option) {
+    for (int k = 1; k < count; ++k) {
+        if (strcmp(arguments[k], option) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void _initializeModules(void) {
+    _logger = createLogger("EntryPoint");
+    initializeStatisticsModule();
+    initializeLineCounterModule();
+    initializeFlexActionsModule();
+    initializeBisonActionsModule();
+    initializeSyntacticAnalyzerModule();
+    initializeAbstractSyntaxTreeModule();
+    initializeInterfaceResolverModule();
+    initializeTypeCheckerModule();
+    initializeCalculatorModule();
+    initializePeepholeModule();
+    initializeEmitterModule();
+    initializeGeneratorModule();
+    initializeCompileServerModule();
+}
+
+/**
+ * Runs the compile server: "--server [path] [--workers amount]". The path
+ * defaults to the one of the client (see "compileSocketPath").
+ */
+static CompilationStatus _serve(const int count, const char ** arguments) {
+    char buffer[PATH_MAX];
+    const char * path = NULL;
+    unsigned int workers = 0;
+    for (int k = 1; k < count; ++k) {
+        if (strcmp(arguments[k], "--workers") == 0 && k + 1 < count) {
+            workers = (unsigned int) strtoul(arguments[++k], NULL, 10);
+        }
+        else if (strcmp(arguments[k], "--server") == 0 && k + 1 < count && strncmp(arguments[k + 1], "--", 2) != 0) {
+            path = arguments[++k];
+        }
+    }
+    if (path == NULL) {
+        path = compileSocketPath(buffer, sizeof(buffer));
+    }
+    const CompilerHooks hooks = {
+            .initialize = _initializeModules,
+            .shutdown = _shutdownModules,
+            .compile = _compile
+    };
+    return serveCompileRequests(path, workers, &hooks);
+}
 
-    logDebugging(logger, "Releasing modules resources...");
-    //shutdownGeneratorModule();
-    //shutdownCalculatorModule();
+static void _shutdownModules(void) {
+    logDebugging(_logger, "Releasing modules resources...");
+    shutdownCompileServerModule();
+    shutdownGeneratorModule();
+    shutdownEmitterModule();
+    shutdownPeepholeModule();
+    shutdownCalculatorModule();
+    shutdownTypeCheckerModule();
+    shutdownInterfaceResolverModule();
     shutdownAbstractSyntaxTreeModule();
     shutdownSyntacticAnalyzerModule();
     shutdownBisonActionsModule();
     shutdownFlexActionsModule();
-    logDebugging(logger, "Compilation is done.");
-    destroyLogger(logger);
+    shutdownLineCounterModule();
+    shutdownStatisticsModule();
+    logDebugging(_logger, "Compilation is done.");
+    destroyLogger(_logger);
+}
+
+/* PUBLIC FUNCTIONS */
+
+/**
+ * The main entry-point of the entire application. If you use "strtok" to
+ * parse anything inside this project instead of using Flex and Bison, I will
+ * find you, and I will kill you (Bryan Mills; "Taken", 2008).
+ */
+const int main(const int count, const char ** arguments) {
+    _initializeModules();
+    CompilationStatus compilationStatus;
+    if (1 < count && strcmp(arguments[1], "--server") == 0) {
+        compilationStatus = _serve(count, arguments);
+    }
+    else {
+        compilationStatus = _compile(count, arguments);
+    }
+    _shutdownModules();
     return compilationStatus;
 }
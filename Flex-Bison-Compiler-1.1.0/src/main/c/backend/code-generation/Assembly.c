@@ -0,0 +1,490 @@
+#include "Assembly.h"
+#include <stdarg.h>
+
+/* MODULE INTERNAL STATE */
+
+static const char * _byteRegisters[] = { "al", "bl", "cl", "dl", "sil", "dil", "bpl", "spl", "r8b", "r9b", "r10b", "r11b" };
+static const char * _longRegisters[] = { "eax", "ebx", "ecx", "edx", "esi", "edi", "ebp", "esp", "r8d", "r9d", "r10d", "r11d" };
+static const char * _quadRegisters[] = { "rax", "rbx", "rcx", "rdx", "rsi", "rdi", "rbp", "rsp", "r8", "r9", "r10", "r11" };
+
+/* PRIVATE FUNCTIONS */
+
+static int _align(const int value, const int alignment);
+static const char * _conditionSuffix(const Condition condition);
+static void _formatLine(char ** text, size_t * capacity, size_t * length, const char indentationCharacter, const unsigned int indentationSize, const unsigned int indentationLevel, const char * const format, ...);
+static int _formatOperand(char * buffer, const size_t size, int length, const AssemblyFunction * function, const Operand * operand, const Width width);
+static const char * _mnemonic(const Opcode opcode);
+static int _print(char * buffer, const size_t size, const int length, const char * const format, ...);
+static const char * _registerName(const Register reg, const Width width);
+static char _widthSuffix(const Width width);
+
+/**
+ * Rounds a value up to the next multiple of the alignment.
+ */
+static int _align(const int value, const int alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * The suffix of "jcc" and "setcc" for the specified condition.
+ */
+static const char * _conditionSuffix(const Condition condition) {
+	switch (condition) {
+		case CONDITION_EQUAL: return "e";
+		case CONDITION_NOT_EQUAL: return "ne";
+		case CONDITION_LESS: return "l";
+		case CONDITION_LESS_EQUAL: return "le";
+		case CONDITION_GREATER: return "g";
+		case CONDITION_GREATER_EQUAL: return "ge";
+		case CONDITION_BELOW: return "b";
+		case CONDITION_BELOW_EQUAL: return "be";
+		case CONDITION_ABOVE: return "a";
+		case CONDITION_ABOVE_EQUAL: return "ae";
+		default: return "";
+	}
+}
+
+/**
+ * Appends an indented and formatted line to a buffer, which grows as needed.
+ */
+static void _formatLine(char ** text, size_t * capacity, size_t * length, const char indentationCharacter, const unsigned int indentationSize, const unsigned int indentationLevel, const char * const format, ...) {
+	const size_t prefix = indentationLevel * indentationSize;
+	va_list arguments;
+	va_start(arguments, format);
+	const int formatted = vsnprintf(NULL, 0, format, arguments);
+	va_end(arguments);
+	while (*capacity < *length + prefix + formatted + 2) {
+		*capacity *= 2;
+		*text = realloc(*text, *capacity);
+	}
+	memset(*text + *length, indentationCharacter, prefix);
+	va_start(arguments, format);
+	vsnprintf(*text + *length + prefix, formatted + 1, format, arguments);
+	va_end(arguments);
+	*length += prefix + formatted;
+	(*text)[(*length)++] = '\n';
+}
+
+/**
+ * Writes a single operand at the specified position of the buffer, and
+ * returns the new length. Registers are named after the specified width,
+ * except inside memory operands, where they are always 64 bits wide.
+ */
+static int _formatOperand(char * buffer, const size_t size, int length, const AssemblyFunction * function, const Operand * operand, const Width width) {
+	switch (operand->type) {
+		case OPERAND_IMMEDIATE:
+			return _print(buffer, size, length, "$%ld", operand->displacement);
+		case OPERAND_LABEL:
+			return _print(buffer, size, length, ".L%s.%d", function->name, operand->label);
+		case OPERAND_REGISTER:
+			return _print(buffer, size, length, "%%%s", _registerName(operand->base, width));
+		case OPERAND_SYMBOL:
+			return _print(buffer, size, length, "%s", operand->symbol);
+		case OPERAND_MEMORY: {
+			if (operand->symbol != NULL) {
+				if (operand->displacement == 0) {
+					return _print(buffer, size, length, "%s(%%rip)", operand->symbol);
+				}
+				return _print(buffer, size, length, "%s%+ld(%%rip)", operand->symbol, operand->displacement);
+			}
+			long displacement = operand->displacement;
+			if (0 <= operand->slot) {
+				displacement += function->frame.slots[operand->slot].offset;
+			}
+			if (displacement != 0 || operand->base == REGISTER_NONE) {
+				length = _print(buffer, size, length, "%ld", displacement);
+			}
+			if (operand->base == REGISTER_NONE && operand->index == REGISTER_NONE) {
+				return length;
+			}
+			length = _print(buffer, size, length, "(");
+			if (operand->base != REGISTER_NONE) {
+				length = _print(buffer, size, length, "%%%s", _quadRegisters[operand->base]);
+			}
+			if (operand->index != REGISTER_NONE) {
+				length = _print(buffer, size, length, ",%%%s,%d", _quadRegisters[operand->index], operand->scale);
+			}
+			return _print(buffer, size, length, ")");
+		}
+		default:
+			return length;
+	}
+}
+
+/**
+ * The mnemonic of an opcode, without the size suffix.
+ */
+static const char * _mnemonic(const Opcode opcode) {
+	switch (opcode) {
+		case OPCODE_ADD: return "add";
+		case OPCODE_AND: return "and";
+		case OPCODE_CALL: return "call";
+		case OPCODE_CMP: return "cmp";
+		case OPCODE_IDIV: return "idiv";
+		case OPCODE_IMUL: return "imul";
+		case OPCODE_JMP: return "jmp";
+		case OPCODE_LEA: return "lea";
+		case OPCODE_LEAVE: return "leave";
+		case OPCODE_MOV: return "mov";
+		case OPCODE_MOVSB: return "movsbl";
+		case OPCODE_MOVSL: return "movslq";
+		case OPCODE_MOVZB: return "movzbl";
+		case OPCODE_NEG: return "neg";
+		case OPCODE_POP: return "pop";
+		case OPCODE_PUSH: return "push";
+		case OPCODE_RET: return "ret";
+		case OPCODE_SAR: return "sar";
+		case OPCODE_SHL: return "shl";
+		case OPCODE_SHR: return "shr";
+		case OPCODE_SUB: return "sub";
+		case OPCODE_TEST: return "test";
+		case OPCODE_XOR: return "xor";
+		default: return "";
+	}
+}
+
+/**
+ * Appends formatted text at the specified position of the buffer, and returns
+ * the new length. Once the buffer is full, it keeps counting characters
+ * without writing them, so the caller can retry with a larger buffer.
+ */
+static int _print(char * buffer, const size_t size, const int length, const char * const format, ...) {
+	va_list arguments;
+	va_start(arguments, format);
+	int written;
+	if ((size_t) length < size) {
+		written = vsnprintf(buffer + length, size - length, format, arguments);
+	}
+	else {
+		written = vsnprintf(NULL, 0, format, arguments);
+	}
+	va_end(arguments);
+	return length + written;
+}
+
+/**
+ * The name of a register when used with the specified width.
+ */
+static const char * _registerName(const Register reg, const Width width) {
+	switch (width) {
+		case WIDTH_BYTE: return _byteRegisters[reg];
+		case WIDTH_LONG: return _longRegisters[reg];
+		default: return _quadRegisters[reg];
+	}
+}
+
+/**
+ * The AT&T suffix for the specified operation width.
+ */
+static char _widthSuffix(const Width width) {
+	switch (width) {
+		case WIDTH_BYTE: return 'b';
+		case WIDTH_LONG: return 'l';
+		default: return 'q';
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+Operand immediateOperand(const long value) {
+	Operand operand = { .type = OPERAND_IMMEDIATE, .base = REGISTER_NONE, .index = REGISTER_NONE, .displacement = value, .slot = -1 };
+	return operand;
+}
+
+Operand labelOperand(const int label) {
+	Operand operand = { .type = OPERAND_LABEL, .base = REGISTER_NONE, .index = REGISTER_NONE, .slot = -1, .label = label };
+	return operand;
+}
+
+Operand memoryOperand(const Register base, const long displacement) {
+	Operand operand = { .type = OPERAND_MEMORY, .base = base, .index = REGISTER_NONE, .displacement = displacement, .slot = -1 };
+	return operand;
+}
+
+Operand registerOperand(const Register reg) {
+	Operand operand = { .type = OPERAND_REGISTER, .base = reg, .index = REGISTER_NONE, .slot = -1 };
+	return operand;
+}
+
+Operand slotOperand(const int slot) {
+	Operand operand = { .type = OPERAND_MEMORY, .base = REGISTER_RBP, .index = REGISTER_NONE, .slot = slot };
+	return operand;
+}
+
+Operand symbolMemoryOperand(const char * symbol) {
+	Operand operand = { .type = OPERAND_MEMORY, .base = REGISTER_NONE, .index = REGISTER_NONE, .slot = -1, .symbol = symbol };
+	return operand;
+}
+
+Operand symbolOperand(const char * symbol) {
+	Operand operand = { .type = OPERAND_SYMBOL, .base = REGISTER_NONE, .index = REGISTER_NONE, .slot = -1, .symbol = symbol };
+	return operand;
+}
+
+boolean sameOperand(const Operand * left, const Operand * right) {
+	if (left->type != right->type) {
+		return false;
+	}
+	switch (left->type) {
+		case OPERAND_IMMEDIATE:
+			return left->displacement == right->displacement;
+		case OPERAND_LABEL:
+			return left->label == right->label;
+		case OPERAND_REGISTER:
+			return left->base == right->base;
+		case OPERAND_SYMBOL:
+			return strcmp(left->symbol, right->symbol) == 0;
+		case OPERAND_MEMORY:
+			if ((left->symbol == NULL) != (right->symbol == NULL)) {
+				return false;
+			}
+			if (left->symbol != NULL && strcmp(left->symbol, right->symbol) != 0) {
+				return false;
+			}
+			return left->base == right->base
+				&& left->index == right->index
+				&& (left->index == REGISTER_NONE || left->scale == right->scale)
+				&& left->displacement == right->displacement
+				&& left->slot == right->slot;
+		default:
+			return true;
+	}
+}
+
+Condition negateCondition(const Condition condition) {
+	switch (condition) {
+		case CONDITION_EQUAL: return CONDITION_NOT_EQUAL;
+		case CONDITION_NOT_EQUAL: return CONDITION_EQUAL;
+		case CONDITION_LESS: return CONDITION_GREATER_EQUAL;
+		case CONDITION_LESS_EQUAL: return CONDITION_GREATER;
+		case CONDITION_GREATER: return CONDITION_LESS_EQUAL;
+		case CONDITION_GREATER_EQUAL: return CONDITION_LESS;
+		case CONDITION_BELOW: return CONDITION_ABOVE_EQUAL;
+		case CONDITION_BELOW_EQUAL: return CONDITION_ABOVE;
+		case CONDITION_ABOVE: return CONDITION_BELOW_EQUAL;
+		case CONDITION_ABOVE_EQUAL: return CONDITION_BELOW;
+		default: return CONDITION_NONE;
+	}
+}
+
+Condition swapCondition(const Condition condition) {
+	switch (condition) {
+		case CONDITION_LESS: return CONDITION_GREATER;
+		case CONDITION_LESS_EQUAL: return CONDITION_GREATER_EQUAL;
+		case CONDITION_GREATER: return CONDITION_LESS;
+		case CONDITION_GREATER_EQUAL: return CONDITION_LESS_EQUAL;
+		case CONDITION_BELOW: return CONDITION_ABOVE;
+		case CONDITION_BELOW_EQUAL: return CONDITION_ABOVE_EQUAL;
+		case CONDITION_ABOVE: return CONDITION_BELOW;
+		case CONDITION_ABOVE_EQUAL: return CONDITION_BELOW_EQUAL;
+		default: return condition;
+	}
+}
+
+Instruction * createInstruction(const Opcode opcode, const Width width, const unsigned int operandCount, ...) {
+	Instruction * instruction = calloc(1, sizeof(Instruction));
+	instruction->opcode = opcode;
+	instruction->width = width;
+	instruction->condition = CONDITION_NONE;
+	instruction->operandCount = operandCount;
+	va_list arguments;
+	va_start(arguments, operandCount);
+	for (unsigned int k = 0; k < operandCount; ++k) {
+		instruction->operands[k] = va_arg(arguments, Operand);
+	}
+	va_end(arguments);
+	return instruction;
+}
+
+Instruction * appendInstruction(InstructionList * list, Instruction * instruction) {
+	instruction->previous = list->last;
+	instruction->next = NULL;
+	if (list->last == NULL) {
+		list->first = instruction;
+	}
+	else {
+		list->last->next = instruction;
+	}
+	list->last = instruction;
+	++list->count;
+	return instruction;
+}
+
+Instruction * insertInstructionBefore(InstructionList * list, Instruction * position, Instruction * instruction) {
+	if (position == NULL) {
+		return appendInstruction(list, instruction);
+	}
+	instruction->next = position;
+	instruction->previous = position->previous;
+	if (position->previous == NULL) {
+		list->first = instruction;
+	}
+	else {
+		position->previous->next = instruction;
+	}
+	position->previous = instruction;
+	++list->count;
+	return instruction;
+}
+
+void removeInstruction(InstructionList * list, Instruction * instruction) {
+	if (instruction->previous == NULL) {
+		list->first = instruction->next;
+	}
+	else {
+		instruction->previous->next = instruction->next;
+	}
+	if (instruction->next == NULL) {
+		list->last = instruction->previous;
+	}
+	else {
+		instruction->next->previous = instruction->previous;
+	}
+	--list->count;
+	free(instruction);
+}
+
+void releaseInstructionList(InstructionList * list) {
+	Instruction * instruction = list->first;
+	while (instruction != NULL) {
+		Instruction * next = instruction->next;
+		free(instruction);
+		instruction = next;
+	}
+	list->first = NULL;
+	list->last = NULL;
+	list->count = 0;
+}
+
+AssemblyFunction * createAssemblyFunction(const char * name) {
+	AssemblyFunction * function = calloc(1, sizeof(AssemblyFunction));
+	function->name = strdup(name);
+	return function;
+}
+
+void destroyAssemblyFunction(AssemblyFunction * function) {
+	if (function != NULL) {
+		releaseInstructionList(&function->instructions);
+		free(function->frame.slots);
+		free(function->counters);
+		free(function->blocks);
+		free(function->blockLines);
+		free(function->blockCounters);
+		free(function->blockAdded);
+		free(function->blockSubtracted);
+		free(function->text);
+		free(function->name);
+		free(function);
+	}
+}
+
+int createLabel(AssemblyFunction * function) {
+	return function->labels++;
+}
+
+int createSlot(StackFrame * frame, const int size, const int alignment) {
+	if (frame->count == frame->capacity) {
+		frame->capacity = frame->capacity == 0 ? 16 : 2 * frame->capacity;
+		frame->slots = realloc(frame->slots, frame->capacity * sizeof(Slot));
+	}
+	Slot * slot = &frame->slots[frame->count];
+	slot->size = size;
+	slot->alignment = alignment;
+	slot->offset = 0;
+	return frame->count++;
+}
+
+void layoutStackFrame(StackFrame * frame) {
+	int size = 0;
+	for (int k = 0; k < frame->count; ++k) {
+		Slot * slot = &frame->slots[k];
+		size = _align(size + slot->size, slot->alignment);
+		slot->offset = -size;
+	}
+	frame->size = _align(size, 16);
+}
+
+char * formatAssemblyFunction(const AssemblyFunction * function, const char indentationCharacter, const unsigned int indentationSize, size_t * length) {
+	const size_t guess = 128;
+	size_t capacity = (indentationSize + guess) * (function->instructions.count + 4) + 4 * strlen(function->name);
+	char * text = malloc(capacity);
+	*length = 0;
+	_formatLine(&text, &capacity, length, indentationCharacter, indentationSize, 1, "%s", ".text");
+	if (!function->local) {
+		_formatLine(&text, &capacity, length, indentationCharacter, indentationSize, 1, ".globl\t%s", function->name);
+	}
+	_formatLine(&text, &capacity, length, indentationCharacter, indentationSize, 1, ".type\t%s, @function", function->name);
+	_formatLine(&text, &capacity, length, indentationCharacter, indentationSize, 0, "%s:", function->name);
+	for (Instruction * instruction = function->instructions.first; instruction != NULL; instruction = instruction->next) {
+		const size_t prefix = (instruction->opcode == OPCODE_LABEL ? 0 : 1) * indentationSize;
+		for (size_t required = *length + prefix + guess; capacity < required; ) {
+			capacity *= 2;
+			text = realloc(text, capacity);
+		}
+		int formatted = formatInstruction(text + *length + prefix, capacity - *length - prefix, function, instruction);
+		if (capacity <= *length + prefix + formatted + 1) {
+			capacity = 2 * (*length + prefix + formatted + 1);
+			text = realloc(text, capacity);
+			formatInstruction(text + *length + prefix, capacity - *length - prefix, function, instruction);
+		}
+		memset(text + *length, indentationCharacter, prefix);
+		*length += prefix + formatted;
+		text[(*length)++] = '\n';
+	}
+	_formatLine(&text, &capacity, length, indentationCharacter, indentationSize, 1, ".size\t%s, .-%s", function->name, function->name);
+	return text;
+}
+
+int formatInstruction(char * buffer, const size_t size, const AssemblyFunction * function, const Instruction * instruction) {
+	const Operand * operands = instruction->operands;
+	int length = 0;
+	switch (instruction->opcode) {
+		case OPCODE_LABEL:
+			length = _formatOperand(buffer, size, length, function, &operands[0], WIDTH_QUAD);
+			return _print(buffer, size, length, ":");
+		case OPCODE_CONVERT:
+			return _print(buffer, size, length, "%s", instruction->width == WIDTH_QUAD ? "cqto" : "cltd");
+		case OPCODE_LEAVE:
+		case OPCODE_RET:
+			return _print(buffer, size, length, "%s", _mnemonic(instruction->opcode));
+		case OPCODE_CALL:
+			return _print(buffer, size, length, "call\t%s@PLT", operands[0].symbol);
+		case OPCODE_JMP:
+			length = _print(buffer, size, length, "jmp\t");
+			return _formatOperand(buffer, size, length, function, &operands[0], WIDTH_QUAD);
+		case OPCODE_JCC:
+		case OPCODE_SETCC:
+			length = _print(buffer, size, length, "%s%s\t",
+				instruction->opcode == OPCODE_JCC ? "j" : "set",
+				_conditionSuffix(instruction->condition));
+			return _formatOperand(buffer, size, length, function, &operands[0], WIDTH_BYTE);
+		default:
+			break;
+	}
+	Width sourceWidth = instruction->width;
+	Width destinationWidth = instruction->width;
+	switch (instruction->opcode) {
+		case OPCODE_MOVSB:
+		case OPCODE_MOVZB:
+			sourceWidth = WIDTH_BYTE;
+			destinationWidth = WIDTH_LONG;
+			length = _print(buffer, size, length, "%s\t", _mnemonic(instruction->opcode));
+			break;
+		case OPCODE_MOVSL:
+			sourceWidth = WIDTH_LONG;
+			destinationWidth = WIDTH_QUAD;
+			length = _print(buffer, size, length, "%s\t", _mnemonic(instruction->opcode));
+			break;
+		default:
+			length = _print(buffer, size, length, "%s%c\t", _mnemonic(instruction->opcode), _widthSuffix(instruction->width));
+			break;
+	}
+	for (unsigned int k = 0; k < instruction->operandCount; ++k) {
+		if (0 < k) {
+			length = _print(buffer, size, length, ", ");
+		}
+		const Width width = k + 1 == instruction->operandCount ? destinationWidth : sourceWidth;
+		length = _formatOperand(buffer, size, length, function, &operands[k], width);
+	}
+	return length;
+}
@@ -0,0 +1,258 @@
+#ifndef ASSEMBLY_HEADER
+#define ASSEMBLY_HEADER
+
+#include "../../shared/Type.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * An in-memory representation of x86-64 code (AT&T syntax, System V ABI),
+ * which allows to analyze and rewrite the generated instructions before
+ * emitting them as text.
+ */
+
+typedef enum {
+	REGISTER_NONE = -1,
+	REGISTER_RAX = 0,
+	REGISTER_RBX,
+	REGISTER_RCX,
+	REGISTER_RDX,
+	REGISTER_RSI,
+	REGISTER_RDI,
+	REGISTER_RBP,
+	REGISTER_RSP,
+	REGISTER_R8,
+	REGISTER_R9,
+	REGISTER_R10,
+	REGISTER_R11
+} Register;
+
+/**
+ * The size of the operation, in bytes. It selects both the suffix of the
+ * mnemonic and the name of the register operands.
+ */
+typedef enum {
+	WIDTH_BYTE = 1,
+	WIDTH_LONG = 4,
+	WIDTH_QUAD = 8
+} Width;
+
+typedef enum {
+	CONDITION_NONE,
+	CONDITION_EQUAL,
+	CONDITION_NOT_EQUAL,
+	CONDITION_LESS,
+	CONDITION_LESS_EQUAL,
+	CONDITION_GREATER,
+	CONDITION_GREATER_EQUAL,
+	CONDITION_BELOW,
+	CONDITION_BELOW_EQUAL,
+	CONDITION_ABOVE,
+	CONDITION_ABOVE_EQUAL
+} Condition;
+
+typedef enum {
+	OPCODE_ADD,
+	OPCODE_AND,
+	OPCODE_CALL,
+	OPCODE_CMP,
+	OPCODE_CONVERT,
+	OPCODE_IDIV,
+	OPCODE_IMUL,
+	OPCODE_JCC,
+	OPCODE_JMP,
+	OPCODE_LABEL,
+	OPCODE_LEA,
+	OPCODE_LEAVE,
+	OPCODE_MOV,
+	OPCODE_MOVSB,
+	OPCODE_MOVSL,
+	OPCODE_MOVZB,
+	OPCODE_NEG,
+	OPCODE_POP,
+	OPCODE_PUSH,
+	OPCODE_RET,
+	OPCODE_SAR,
+	OPCODE_SETCC,
+	OPCODE_SHL,
+	OPCODE_SHR,
+	OPCODE_SUB,
+	OPCODE_TEST,
+	OPCODE_XOR
+} Opcode;
+
+typedef enum {
+	OPERAND_NONE,
+	OPERAND_IMMEDIATE,
+	OPERAND_LABEL,
+	OPERAND_MEMORY,
+	OPERAND_REGISTER,
+	OPERAND_SYMBOL
+} OperandType;
+
+/**
+ * An instruction operand. Memory operands address either a stack slot (if
+ * "slot" is not negative), a global symbol (RIP-relative), or a base
+ * register, plus an optional scaled index and a displacement.
+ */
+typedef struct {
+	OperandType type;
+	Register base;
+	Register index;
+	int scale;
+	long displacement;
+	int slot;
+	const char * symbol;
+	int label;
+} Operand;
+
+typedef struct Instruction Instruction;
+
+struct Instruction {
+	Opcode opcode;
+	Width width;
+	Condition condition;
+	unsigned int operandCount;
+	Operand operands[3];
+	Instruction * previous;
+	Instruction * next;
+};
+
+/**
+ * A doubly-linked list of instructions, so passes can insert and remove
+ * instructions anywhere in constant time.
+ */
+typedef struct {
+	Instruction * first;
+	Instruction * last;
+	unsigned int count;
+} InstructionList;
+
+/**
+ * A stack slot of the current frame. The offset (relative to %rbp) is only
+ * known after the frame layout is computed.
+ */
+typedef struct {
+	int size;
+	int alignment;
+	int offset;
+} Slot;
+
+typedef struct {
+	Slot * slots;
+	int count;
+	int capacity;
+	int size;
+} StackFrame;
+
+/**
+ * A lowered function, ready to be optimized and emitted.
+ */
+typedef struct {
+	char * name;
+	InstructionList instructions;
+	StackFrame frame;
+	int labels;
+
+	// The symbol of the profiling counters of an instrumented function (or
+	// NULL), their amount, and the structural hash of the function.
+	char * counters;
+	unsigned int counterCount;
+	unsigned int profileHash;
+
+	// The symbol of the basic block counters of a function with coverage (or
+	// NULL), their amount, and the line and the count of each block (see
+	// "ProfileSites").
+	char * blocks;
+	unsigned int blockCounterCount;
+	unsigned int blockCount;
+	unsigned int * blockLines;
+	int * blockCounters;
+	int * blockAdded;
+	int * blockSubtracted;
+
+	// True if the function is only visible inside of the program (e.g., a
+	// specialized clone), so it isn't global.
+	boolean local;
+
+	// True if the function reports an index out of bounds (see
+	// "BOUNDS_CHECKS").
+	boolean boundsChecked;
+
+	// The text of the function (and its length), if it's stored in (or loaded
+	// from) the function cache (see "FUNCTION_CACHE_DIRECTORY").
+	char * text;
+	size_t textLength;
+} AssemblyFunction;
+
+/** Operand constructors. */
+
+Operand immediateOperand(const long value);
+Operand labelOperand(const int label);
+Operand memoryOperand(const Register base, const long displacement);
+Operand registerOperand(const Register reg);
+Operand slotOperand(const int slot);
+Operand symbolMemoryOperand(const char * symbol);
+Operand symbolOperand(const char * symbol);
+
+/**
+ * True if both operands reference exactly the same location or value.
+ */
+boolean sameOperand(const Operand * left, const Operand * right);
+
+/**
+ * The condition that holds exactly when the specified one does not.
+ */
+Condition negateCondition(const Condition condition);
+
+/**
+ * The condition that holds when the operands of the comparison are swapped
+ * (e.g., "a < b" is "b > a").
+ */
+Condition swapCondition(const Condition condition);
+
+/** Instruction list management. */
+
+Instruction * createInstruction(const Opcode opcode, const Width width, const unsigned int operandCount, ...);
+Instruction * appendInstruction(InstructionList * list, Instruction * instruction);
+Instruction * insertInstructionBefore(InstructionList * list, Instruction * position, Instruction * instruction);
+void removeInstruction(InstructionList * list, Instruction * instruction);
+void releaseInstructionList(InstructionList * list);
+
+/** Functions and frames. */
+
+AssemblyFunction * createAssemblyFunction(const char * name);
+void destroyAssemblyFunction(AssemblyFunction * function);
+
+/**
+ * Reserves a new label number inside the function.
+ */
+int createLabel(AssemblyFunction * function);
+
+/**
+ * Reserves a new stack slot in the frame, and returns its index.
+ */
+int createSlot(StackFrame * frame, const int size, const int alignment);
+
+/**
+ * Assigns an offset to every slot, and computes the (16 bytes aligned) size
+ * of the frame.
+ */
+void layoutStackFrame(StackFrame * frame);
+
+/**
+ * Writes an instruction in AT&T syntax (without indentation nor new-line),
+ * and returns the amount of characters written, like "snprintf".
+ */
+int formatInstruction(char * buffer, const size_t size, const AssemblyFunction * function, const Instruction * instruction);
+
+/**
+ * Formats a lowered function as the generator outputs it (its directives,
+ * its label, and an instruction per line, indented), in a new buffer (which
+ * must be freed), and leaves its length.
+ */
+char * formatAssemblyFunction(const AssemblyFunction * function, const char indentationCharacter, const unsigned int indentationSize, size_t * length);
+
+#endif
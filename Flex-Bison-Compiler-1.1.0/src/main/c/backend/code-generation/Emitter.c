@@ -0,0 +1,293 @@
+#include "Emitter.h"
+
+/* MODULE INTERNAL STATE */
+
+/**
+ * A block of buffered output.
+ */
+typedef struct {
+	char * data;
+	size_t length;
+	size_t capacity;
+} Chunk;
+
+struct Emitter {
+	int descriptor;
+	boolean mapped;
+	boolean failed;
+	char * indentation;
+	size_t indentationLength;
+	char character;
+	unsigned int size;
+	Chunk * chunks;
+	unsigned int chunkCount;
+	unsigned int current;
+	size_t pending;
+	char * map;
+	size_t mapSize;
+	size_t length;
+};
+
+static Logger * _logger = NULL;
+
+// The size of each chunk, and of the pending output that triggers a write.
+static const size_t _chunkSize = 64 * 1024;
+static const size_t _highWaterMark = 1024 * 1024;
+
+// The amount of buffers per "writev" call, if the system doesn't tell.
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+// The initial size of a mapped file, which doubles when it's full.
+static const size_t _initialMapSize = 1024 * 1024;
+
+void initializeEmitterModule() {
+	_logger = createLogger("Emitter");
+}
+
+void shutdownEmitterModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static Emitter * _createEmitter(const int descriptor, const char character, const unsigned int size);
+static const char * _indentation(Emitter * emitter, const size_t length);
+static boolean _mapFile(Emitter * emitter, const size_t size);
+static char * _reserve(Emitter * emitter, const size_t size, size_t * available);
+static boolean _writeChunks(Emitter * emitter);
+
+static Emitter * _createEmitter(const int descriptor, const char character, const unsigned int size) {
+	Emitter * emitter = calloc(1, sizeof(Emitter));
+	emitter->descriptor = descriptor;
+	emitter->character = character;
+	emitter->size = size;
+	return emitter;
+}
+
+/**
+ * The cached indentation prefix of the specified length, which is only
+ * rebuilt when a deeper level is requested.
+ */
+static const char * _indentation(Emitter * emitter, const size_t length) {
+	if (emitter->indentationLength < length) {
+		emitter->indentation = realloc(emitter->indentation, length);
+		memset(emitter->indentation, emitter->character, length);
+		emitter->indentationLength = length;
+	}
+	return emitter->indentation;
+}
+
+/**
+ * Resizes the output file, and maps it in memory.
+ */
+static boolean _mapFile(Emitter * emitter, const size_t size) {
+	if (emitter->map != NULL) {
+		munmap(emitter->map, emitter->mapSize);
+		emitter->map = NULL;
+	}
+	if (ftruncate(emitter->descriptor, (off_t) size) != 0) {
+		logError(_logger, "Cannot resize the output file: %s", strerror(errno));
+		return false;
+	}
+	void * map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, emitter->descriptor, 0);
+	if (map == MAP_FAILED) {
+		logError(_logger, "Cannot map the output file: %s", strerror(errno));
+		return false;
+	}
+	emitter->map = map;
+	emitter->mapSize = size;
+	return true;
+}
+
+/**
+ * Returns the end of the output, with room for at least "size" bytes. The
+ * actual room (maybe larger) is stored in "available". If the room cannot
+ * be obtained, the emitter is flagged as failed, and a scratch buffer is
+ * returned instead.
+ */
+static char * _reserve(Emitter * emitter, const size_t size, size_t * available) {
+	if (emitter->mapped) {
+		size_t mapSize = emitter->mapSize;
+		while (mapSize < emitter->length + size) {
+			mapSize *= 2;
+		}
+		if (emitter->failed || (mapSize != emitter->mapSize && !_mapFile(emitter, mapSize))) {
+			emitter->failed = true;
+			emitter->mapped = false;
+			emitter->length = 0;
+			return _reserve(emitter, size, available);
+		}
+		*available = emitter->mapSize - emitter->length;
+		return emitter->map + emitter->length;
+	}
+	Chunk * chunk = emitter->chunkCount == 0 ? NULL : &emitter->chunks[emitter->current];
+	if (chunk == NULL || chunk->capacity - chunk->length < size) {
+		if (chunk != NULL && 0 < chunk->length) {
+			++emitter->current;
+		}
+		if (emitter->current == emitter->chunkCount) {
+			emitter->chunks = realloc(emitter->chunks, (emitter->chunkCount + 1) * sizeof(Chunk));
+			emitter->chunks[emitter->chunkCount++] = (Chunk) { .data = NULL, .length = 0, .capacity = 0 };
+		}
+		chunk = &emitter->chunks[emitter->current];
+		if (chunk->capacity < size) {
+			chunk->capacity = size < _chunkSize ? _chunkSize : size;
+			free(chunk->data);
+			chunk->data = malloc(chunk->capacity);
+		}
+	}
+	*available = chunk->capacity - chunk->length;
+	return chunk->data + chunk->length;
+}
+
+/**
+ * Writes every pending chunk with as few system calls as possible, and
+ * empties them (they are reused afterwards).
+ */
+static boolean _writeChunks(Emitter * emitter) {
+	const unsigned int count = emitter->chunkCount == 0 ? 0 : emitter->current + 1;
+	struct iovec * vectors = calloc(count == 0 ? 1 : count, sizeof(struct iovec));
+	int vectorCount = 0;
+	for (unsigned int k = 0; k < count; ++k) {
+		if (0 < emitter->chunks[k].length) {
+			vectors[vectorCount].iov_base = emitter->chunks[k].data;
+			vectors[vectorCount].iov_len = emitter->chunks[k].length;
+			++vectorCount;
+		}
+		emitter->chunks[k].length = 0;
+	}
+	struct iovec * vector = vectors;
+	while (!emitter->failed && 0 < vectorCount) {
+		const ssize_t written = writev(emitter->descriptor, vector, vectorCount < IOV_MAX ? vectorCount : IOV_MAX);
+		if (written < 0) {
+			if (errno != EINTR) {
+				logError(_logger, "Cannot write the output: %s", strerror(errno));
+				emitter->failed = true;
+			}
+			continue;
+		}
+		// A partial write leaves the remainder of some vectors pending.
+		size_t remainder = (size_t) written;
+		while (0 < vectorCount && vector->iov_len <= remainder) {
+			remainder -= vector->iov_len;
+			++vector;
+			--vectorCount;
+		}
+		if (0 < vectorCount) {
+			vector->iov_base = (char *) vector->iov_base + remainder;
+			vector->iov_len -= remainder;
+		}
+	}
+	free(vectors);
+	emitter->current = 0;
+	emitter->pending = 0;
+	return !emitter->failed;
+}
+
+/* PUBLIC FUNCTIONS */
+
+Emitter * createEmitter(const int descriptor, const char character, const unsigned int size) {
+	return _createEmitter(descriptor, character, size);
+}
+
+Emitter * createMappedEmitter(const char * path, const char character, const unsigned int size) {
+	const int descriptor = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (descriptor < 0) {
+		logError(_logger, "Cannot create the output file \"%s\": %s", path, strerror(errno));
+		return NULL;
+	}
+	Emitter * emitter = _createEmitter(descriptor, character, size);
+	emitter->mapped = true;
+	if (!_mapFile(emitter, _initialMapSize)) {
+		close(descriptor);
+		free(emitter);
+		return NULL;
+	}
+	return emitter;
+}
+
+boolean destroyEmitter(Emitter * emitter) {
+	if (emitter == NULL) {
+		return false;
+	}
+	boolean succeed = flushEmitter(emitter) && !emitter->failed;
+	if (emitter->map != NULL) {
+		munmap(emitter->map, emitter->mapSize);
+	}
+	if (0 <= emitter->descriptor && emitter->mapSize != 0) {
+		if (ftruncate(emitter->descriptor, (off_t) emitter->length) != 0) {
+			logError(_logger, "Cannot truncate the output file: %s", strerror(errno));
+			succeed = false;
+		}
+		close(emitter->descriptor);
+	}
+	for (unsigned int k = 0; k < emitter->chunkCount; ++k) {
+		free(emitter->chunks[k].data);
+	}
+	free(emitter->chunks);
+	free(emitter->indentation);
+	free(emitter);
+	return succeed;
+}
+
+void emit(Emitter * emitter, const unsigned int indentationLevel, const char * const format, ...) {
+	const size_t prefix = indentationLevel * emitter->size;
+	va_list arguments;
+	va_start(arguments, format);
+	va_list copy;
+	va_copy(copy, arguments);
+	// The text is formatted in the free room of the current chunk, and only
+	// if it doesn't fit, again in a larger one.
+	size_t available = 0;
+	char * buffer = _reserve(emitter, prefix + 1, &available);
+	int length = vsnprintf(buffer + prefix, available - prefix, format, arguments);
+	if (0 <= length && available - prefix <= (size_t) length) {
+		buffer = _reserve(emitter, prefix + length + 1, &available);
+		length = vsnprintf(buffer + prefix, available - prefix, format, copy);
+	}
+	va_end(copy);
+	va_end(arguments);
+	if (length < 0) {
+		logError(_logger, "Cannot format the output: %s", format);
+		emitter->failed = true;
+		return;
+	}
+	memcpy(buffer, _indentation(emitter, prefix), prefix);
+	commitEmitterSpace(emitter, prefix + length);
+}
+
+void emitText(Emitter * emitter, const unsigned int indentationLevel, const char * text, const size_t length) {
+	const size_t prefix = indentationLevel * emitter->size;
+	char * buffer = reserveEmitterSpace(emitter, prefix + length);
+	memcpy(buffer, _indentation(emitter, prefix), prefix);
+	memcpy(buffer + prefix, text, length);
+	commitEmitterSpace(emitter, prefix + length);
+}
+
+char * reserveEmitterSpace(Emitter * emitter, const size_t size) {
+	size_t available = 0;
+	return _reserve(emitter, size, &available);
+}
+
+void commitEmitterSpace(Emitter * emitter, const size_t length) {
+	if (emitter->mapped) {
+		emitter->length += length;
+		return;
+	}
+	emitter->chunks[emitter->current].length += length;
+	emitter->pending += length;
+	if (_highWaterMark <= emitter->pending) {
+		_writeChunks(emitter);
+	}
+}
+
+boolean flushEmitter(Emitter * emitter) {
+	if (emitter->mapped) {
+		return !emitter->failed;
+	}
+	return _writeChunks(emitter);
+}
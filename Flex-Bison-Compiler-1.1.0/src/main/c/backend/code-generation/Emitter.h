@@ -0,0 +1,78 @@
+#ifndef EMITTER_HEADER
+#define EMITTER_HEADER
+
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/**
+ * A buffered writer for the generated output. The text is formatted straight
+ * into large chunks of memory (so emitting a line never allocates nor makes
+ * a system call), and the chunks are written with a single "writev" once
+ * they exceed a high-water mark, or when the emitter is destroyed.
+ *
+ * Alternatively, the output can be a file mapped in memory, which receives
+ * the text directly (the file grows as needed, and it's truncated to its
+ * final size at the end).
+ */
+typedef struct Emitter Emitter;
+
+/** Initialize module's internal state. */
+void initializeEmitterModule();
+
+/** Shutdown module's internal state. */
+void shutdownEmitterModule();
+
+/**
+ * Creates an emitter over an open file descriptor (which is not closed),
+ * that indents each line with "size" copies of the character per level.
+ */
+Emitter * createEmitter(const int descriptor, const char character, const unsigned int size);
+
+/**
+ * Creates an emitter over a new (or truncated) file mapped in memory, or
+ * returns NULL if the file cannot be created.
+ */
+Emitter * createMappedEmitter(const char * path, const char character, const unsigned int size);
+
+/**
+ * Writes any pending output, and releases the emitter. Returns false if
+ * some output could not be written.
+ */
+boolean destroyEmitter(Emitter * emitter);
+
+/**
+ * Appends an indented and formatted text, like "printf".
+ */
+void emit(Emitter * emitter, const unsigned int indentationLevel, const char * const format, ...);
+
+/**
+ * Appends an indented text of the specified length.
+ */
+void emitText(Emitter * emitter, const unsigned int indentationLevel, const char * text, const size_t length);
+
+/**
+ * Returns a buffer of at least "size" bytes at the end of the output, where
+ * the caller can write directly. Only the bytes committed afterwards are
+ * kept (at most "size").
+ */
+char * reserveEmitterSpace(Emitter * emitter, const size_t size);
+void commitEmitterSpace(Emitter * emitter, const size_t length);
+
+/**
+ * Writes the pending output. Returns false if it could not be written.
+ */
+boolean flushEmitter(Emitter * emitter);
+
+#endif
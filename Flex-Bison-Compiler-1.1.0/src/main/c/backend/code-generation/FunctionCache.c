@@ -0,0 +1,318 @@
+#include "FunctionCache.h"
+
+/* MODULE INTERNAL STATE */
+
+/**
+ * The "MGCF" signature (in little-endian), and the version of the layout
+ * (and of the key).
+ */
+static const uint32_t _magic = 0x4643474Du;
+static const uint32_t _version = 1;
+
+/**
+ * The temporary files written by this process, to name each one apart.
+ */
+static unsigned int _temporaryFiles = 0;
+
+/**
+ * The key of a function being hashed (FNV-1a), and the symbols that resolve
+ * its global names.
+ */
+typedef struct {
+	uint64_t hash;
+	SymbolTable * symbolTable;
+} CacheWalk;
+
+/* PRIVATE FUNCTIONS */
+
+static boolean _entryPath(const FunctionCache * cache, const uint64_t key, char path[PATH_MAX]);
+static void _mix(CacheWalk * walk, const uint64_t value);
+static void _mixName(CacheWalk * walk, const char * name);
+static void _walkBlock(CacheWalk * walk, const Block * block);
+static void _walkExpression(CacheWalk * walk, const Expression * expression);
+static void _walkStatement(CacheWalk * walk, const Statement * statement);
+
+/**
+ * Writes the path of the entry of a key, and returns false if it doesn't
+ * fit (so a long directory never truncates two keys into the same file).
+ */
+static boolean _entryPath(const FunctionCache * cache, const uint64_t key, char path[PATH_MAX]) {
+	const int length = snprintf(path, PATH_MAX, "%s/%016" PRIx64, cache->directory, key);
+	return 0 <= length && length < PATH_MAX;
+}
+
+/**
+ * Adds a value to the key, a byte at a time.
+ */
+static void _mix(CacheWalk * walk, const uint64_t value) {
+	for (unsigned int k = 0; k < 8; ++k) {
+		walk->hash = (walk->hash ^ ((value >> (8 * k)) & 0xFF)) * 1099511628211ull;
+	}
+}
+
+/**
+ * Adds a name to the key (with its terminator, so two names never merge),
+ * and the global symbol with that name, if any. A local variable can shadow
+ * it, but then the key only changes more often than needed.
+ */
+static void _mixName(CacheWalk * walk, const char * name) {
+	for (const char * character = name; ; ++character) {
+		walk->hash = (walk->hash ^ (unsigned char) *character) * 1099511628211ull;
+		if (*character == '\0') {
+			break;
+		}
+	}
+	const Symbol * symbol = lookupSymbol(walk->symbolTable, name);
+	if (symbol == NULL) {
+		_mix(walk, UINT64_MAX);
+		return;
+	}
+	_mix(walk, symbol->type);
+	_mix(walk, symbol->dataType);
+	_mix(walk, symbol->array ? (uint64_t) (uint32_t) symbol->arraySize : UINT32_MAX + 1ull);
+	_mix(walk, symbol->external);
+	_mix(walk, (uint64_t) (int64_t) symbol->parameterCount);
+	for (int k = 0; symbol->parameters != NULL && k < symbol->parameterCount; ++k) {
+		_mix(walk, symbol->parameters[k].dataType | (symbol->parameters[k].array << 8));
+	}
+}
+
+/**
+ * Walks a block (and the ones nested in it).
+ */
+static void _walkBlock(CacheWalk * walk, const Block * block) {
+	_mix(walk, STATEMENT_BLOCK);
+	for (const Statements * statements = block->statements; statements != NULL; statements = statements->next) {
+		_walkStatement(walk, statements->statement);
+	}
+	_mix(walk, STATEMENT_EMPTY);
+}
+
+/**
+ * Walks an expression, with its names and constants.
+ */
+static void _walkExpression(CacheWalk * walk, const Expression * expression) {
+	_mix(walk, expression->type);
+	switch (expression->type) {
+		case EXPRESSION_NOT:
+		case EXPRESSION_PARENTHESIS:
+			_walkExpression(walk, expression->singleExpression);
+			break;
+		case EXPRESSION_IDENTIFIER:
+			_mixName(walk, *expression->identifier);
+			break;
+		case EXPRESSION_CONSTANT:
+			_mix(walk, expression->constant->type);
+			_mix(walk, (uint64_t) (int64_t) (expression->constant->type == TYPE_CHAR ? *expression->constant->character : *expression->constant->integer));
+			break;
+		case EXPRESSION_ARRAY_ACCESS:
+			_mixName(walk, *expression->identifierArray);
+			_walkExpression(walk, expression->indexExpression);
+			break;
+		case EXPRESSION_FUNCTION_CALL: {
+			_mixName(walk, *expression->identifierFunc);
+			unsigned int count = 0;
+			for (const ListArguments * argument = expression->arguments; argument != NULL; argument = argument->next, ++count) {
+				_walkExpression(walk, argument->expression);
+			}
+			_mix(walk, count);
+			break;
+		}
+		default:
+			_walkExpression(walk, expression->leftExpression);
+			_walkExpression(walk, expression->rightExpression);
+			break;
+	}
+}
+
+/**
+ * Walks a statement, with its names and constants.
+ */
+static void _walkStatement(CacheWalk * walk, const Statement * statement) {
+	_mix(walk, statement->type);
+	switch (statement->type) {
+		case STATEMENT_DECLARATION:
+			_mix(walk, statement->dataType);
+			_mixName(walk, *statement->identifier);
+			_mix(walk, statement->variableSuffix->type);
+			if (statement->variableSuffix->type == VARIABLE_SUFFIX_ASSIGNMENT) {
+				_walkExpression(walk, statement->variableSuffix->expression);
+			}
+			else if (statement->variableSuffix->type == VARIABLE_SUFFIX_ARRAY) {
+				_mix(walk, (uint64_t) (int64_t) *statement->variableSuffix->arraySize);
+			}
+			break;
+		case STATEMENT_IF:
+			_mix(walk, statement->statementIf->hasElse);
+			_walkExpression(walk, statement->statementIf->condition);
+			_walkBlock(walk, statement->statementIf->thenBlock);
+			if (statement->statementIf->hasElse) {
+				_walkBlock(walk, statement->statementIf->elseBlock);
+			}
+			break;
+		case STATEMENT_WHILE:
+			_walkExpression(walk, statement->statementWhile->condition);
+			_walkBlock(walk, statement->statementWhile->block);
+			break;
+		case STATEMENT_FOR: {
+			const StatementFor * loop = statement->statementFor;
+			_mix(walk, (loop->hasInit ? 1 : 0) | (loop->hasCondition ? 2 : 0) | (loop->hasUpdate ? 4 : 0));
+			if (loop->hasInit) {
+				_walkExpression(walk, loop->init);
+			}
+			if (loop->hasCondition) {
+				_walkExpression(walk, loop->condition);
+			}
+			if (loop->hasUpdate) {
+				_walkExpression(walk, loop->update);
+			}
+			_walkBlock(walk, loop->block);
+			break;
+		}
+		case STATEMENT_RETURN:
+			_mix(walk, statement->statementReturn->hasExpression);
+			if (statement->statementReturn->hasExpression) {
+				_walkExpression(walk, statement->statementReturn->expression);
+			}
+			break;
+		case STATEMENT_EXPRESSION:
+			_walkExpression(walk, statement->statementExpression->expression);
+			break;
+		case STATEMENT_BLOCK:
+			_walkBlock(walk, statement->block);
+			break;
+		case STATEMENT_EMPTY:
+			break;
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+FunctionCache * openFunctionCache(const char * directory, const uint64_t options) {
+	struct stat status;
+	if (mkdir(directory, 0755) != 0 && (errno != EEXIST || stat(directory, &status) != 0 || !S_ISDIR(status.st_mode))) {
+		return NULL;
+	}
+	FunctionCache * cache = calloc(1, sizeof(FunctionCache));
+	cache->directory = strdup(directory);
+	CacheWalk walk = { .hash = 14695981039346656037ull };
+	_mix(&walk, _version);
+	_mix(&walk, options);
+	if (stat("/proc/self/exe", &status) == 0) {
+		_mix(&walk, (uint64_t) status.st_size);
+		_mix(&walk, (uint64_t) status.st_mtim.tv_sec);
+		_mix(&walk, (uint64_t) status.st_mtim.tv_nsec);
+	}
+	cache->seed = walk.hash;
+	return cache;
+}
+
+void closeFunctionCache(FunctionCache * cache) {
+	if (cache != NULL) {
+		free(cache->directory);
+		free(cache);
+	}
+}
+
+uint64_t functionCacheKey(const FunctionCache * cache, const Declaration * function, SymbolTable * symbolTable) {
+	CacheWalk walk = {
+		.hash = cache->seed,
+		.symbolTable = symbolTable
+	};
+	_mix(&walk, function->dataType);
+	_mix(&walk, function->declarationType);
+	_mixName(&walk, *function->identifier);
+	const Parameters * parameters = function->declarationSuffix->parameters;
+	_mix(&walk, parameters->type);
+	for (const ParameterList * node = parameters->type == PARAMS_LIST ? parameters->list : NULL; node != NULL; node = node->next) {
+		_mix(&walk, node->parameter->type);
+		_mix(&walk, node->parameter->array->type);
+		_mixName(&walk, *node->parameter->identifier);
+	}
+	_walkBlock(&walk, function->declarationSuffix->functionSuffix->block);
+	return walk.hash;
+}
+
+char * loadCachedFunction(const FunctionCache * cache, const uint64_t key, size_t * length, uint32_t * flags) {
+	char path[PATH_MAX];
+	if (!_entryPath(cache, key, path)) {
+		return NULL;
+	}
+	const int descriptor = open(path, O_RDONLY);
+	if (descriptor < 0) {
+		return NULL;
+	}
+	FunctionCacheHeader header;
+	struct stat status;
+	char * text = NULL;
+	if (fstat(descriptor, &status) == 0 && read(descriptor, &header, sizeof(header)) == (ssize_t) sizeof(header)
+			&& header.magic == _magic && header.version == _version && header.key == key
+			&& (uint64_t) status.st_size == sizeof(header) + (uint64_t) header.length) {
+		text = malloc(header.length == 0 ? 1 : header.length);
+		if (read(descriptor, text, header.length) != (ssize_t) header.length) {
+			free(text);
+			text = NULL;
+		}
+	}
+	close(descriptor);
+	if (text != NULL) {
+		*length = header.length;
+		*flags = header.flags;
+	}
+	return text;
+}
+
+boolean storeCachedFunction(const FunctionCache * cache, const uint64_t key, const char * text, const size_t length, const uint32_t flags) {
+	if (UINT32_MAX < length) {
+		return false;
+	}
+	char path[PATH_MAX];
+	char temporary[PATH_MAX];
+	const unsigned int file = __atomic_fetch_add(&_temporaryFiles, 1, __ATOMIC_RELAXED);
+	if (!_entryPath(cache, key, path)) {
+		return false;
+	}
+	const int temporaryLength = snprintf(temporary, sizeof(temporary), "%s.%ld.%u.tmp", path, (long) getpid(), file);
+	if (temporaryLength < 0 || (int) sizeof(temporary) <= temporaryLength) {
+		return false;
+	}
+	const int descriptor = open(temporary, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (descriptor < 0) {
+		return false;
+	}
+	const FunctionCacheHeader header = {
+		.magic = _magic,
+		.version = _version,
+		.key = key,
+		.flags = flags,
+		.length = (uint32_t) length
+	};
+	boolean written = write(descriptor, &header, sizeof(header)) == (ssize_t) sizeof(header);
+	for (size_t offset = 0; written && offset < length; ) {
+		const ssize_t count = write(descriptor, text + offset, length - offset);
+		written = 0 < count;
+		offset += written ? (size_t) count : 0;
+	}
+	written = close(descriptor) == 0 && written;
+	if (!written || rename(temporary, path) != 0) {
+		unlink(temporary);
+		return false;
+	}
+	return true;
+}
+
+boolean loadCachedAssemblyFunction(const FunctionCache * cache, const uint64_t key, AssemblyFunction * function) {
+	uint32_t flags = 0;
+	function->text = loadCachedFunction(cache, key, &function->textLength, &flags);
+	if (function->text == NULL) {
+		return false;
+	}
+	function->boundsChecked = (flags & FUNCTION_CACHE_BOUNDS_CHECKED) != 0;
+	return true;
+}
+
+boolean storeCachedAssemblyFunction(const FunctionCache * cache, const uint64_t key, AssemblyFunction * function, const char indentationCharacter, const unsigned int indentationSize) {
+	function->text = formatAssemblyFunction(function, indentationCharacter, indentationSize, &function->textLength);
+	const uint32_t flags = function->boundsChecked ? FUNCTION_CACHE_BOUNDS_CHECKED : 0;
+	return storeCachedFunction(cache, key, function->text, function->textLength, flags);
+}
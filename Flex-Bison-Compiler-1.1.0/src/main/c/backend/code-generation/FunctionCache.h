@@ -0,0 +1,101 @@
+#ifndef FUNCTION_CACHE_HEADER
+#define FUNCTION_CACHE_HEADER
+
+#include "../../frontend/semantic-analysis/SymbolTable.h"
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Type.h"
+#include "Assembly.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * A content-addressed store of generated functions on disk (see
+ * "FUNCTION_CACHE_DIRECTORY"), so a rebuild only lowers and optimizes the
+ * functions that changed. Each function is a file named by its key, which
+ * hashes everything its assembly depends on:
+ *
+ *	- Its whole AST, with its identifiers and constants.
+ *	- Every global symbol that it names (or its absence): its kind, type,
+ *	  array size, linkage and parameters, so a change in the signature of a
+ *	  callee (or in a global) misses.
+ *	- The options of the generation, and the executable of the compiler (its
+ *	  size and modification time), so a new compiler never reads the entries
+ *	  of an old one.
+ *
+ * An entry has a header (with its key, its flags and the length of its
+ * text), and then the assembly of the function. It's written to a temporary
+ * file first, and renamed, so many compilations can share the directory.
+ */
+
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t key;
+	uint32_t flags;
+	uint32_t length;
+} FunctionCacheHeader;
+
+/**
+ * The flags of an entry: the function reports an index out of bounds (see
+ * "BOUNDS_CHECKS").
+ */
+typedef enum {
+	FUNCTION_CACHE_BOUNDS_CHECKED = 1
+} FunctionCacheFlag;
+
+typedef struct {
+	char * directory;
+	uint64_t seed;
+} FunctionCache;
+
+/**
+ * Opens the cache in a directory (creating it, if needed), for a generation
+ * with the specified options. Returns NULL if the directory cannot be used.
+ */
+FunctionCache * openFunctionCache(const char * directory, const uint64_t options);
+
+/**
+ * Closes the cache.
+ */
+void closeFunctionCache(FunctionCache * cache);
+
+/**
+ * The key of a function definition, with the global symbols of a symbol
+ * table (only its global scope must be open).
+ */
+uint64_t functionCacheKey(const FunctionCache * cache, const Declaration * function, SymbolTable * symbolTable);
+
+/**
+ * Loads the text of a function (which must be freed), with its length and
+ * flags, or returns NULL if it's not in the cache (or its entry is invalid).
+ */
+char * loadCachedFunction(const FunctionCache * cache, const uint64_t key, size_t * length, uint32_t * flags);
+
+/**
+ * Stores the text of a function, with its flags. Returns false if it cannot
+ * be written (the cache is only an optimization, so it's not an error).
+ */
+boolean storeCachedFunction(const FunctionCache * cache, const uint64_t key, const char * text, const size_t length, const uint32_t flags);
+
+/**
+ * Loads a function into the text of a lowered one (with its flags), and
+ * returns true, or returns false if it's not in the cache.
+ */
+boolean loadCachedAssemblyFunction(const FunctionCache * cache, const uint64_t key, AssemblyFunction * function);
+
+/**
+ * Formats a lowered function as it's output (see "formatAssemblyFunction"),
+ * keeps the text in the function, and stores it, with its flags. Returns
+ * false if it cannot be written.
+ */
+boolean storeCachedAssemblyFunction(const FunctionCache * cache, const uint64_t key, AssemblyFunction * function, const char indentationCharacter, const unsigned int indentationSize);
+
+#endif
@@ -0,0 +1,104 @@
+#include "FunctionScheduler.h"
+
+/* PRIVATE FUNCTIONS */
+
+static boolean _isDefinition(const Declaration * declaration);
+static void * _lowerFunctions(void * argument);
+static boolean _lowerNextFunction(FunctionScheduler * scheduler, void * worker);
+
+/**
+ * Whether a declaration is a function definition.
+ */
+static boolean _isDefinition(const Declaration * declaration) {
+	const DeclarationSuffix * suffix = declaration->declarationSuffix;
+	return suffix->type == DECLARATION_SUFFIX_FUNCTION && suffix->functionSuffix->type == SUFFIX_BLOCK;
+}
+
+/**
+ * The body of a worker thread: lowers functions until there are no more.
+ */
+static void * _lowerFunctions(void * argument) {
+	FunctionSchedulerThread * thread = argument;
+	while (_lowerNextFunction(thread->scheduler, thread->worker)) {
+	}
+	return NULL;
+}
+
+/**
+ * Claims the next function of the queue (if any), lowers it, and signals
+ * that it's done. Returns false if there were no more functions.
+ */
+static boolean _lowerNextFunction(FunctionScheduler * scheduler, void * worker) {
+	const unsigned int index = __atomic_fetch_add(&scheduler->next, 1, __ATOMIC_RELAXED);
+	if (scheduler->count <= index) {
+		return false;
+	}
+	FunctionTask * task = &scheduler->tasks[index];
+	AssemblyFunction * function = scheduler->lower(worker, task->declaration);
+	pthread_mutex_lock(&scheduler->mutex);
+	task->function = function;
+	task->done = true;
+	pthread_cond_broadcast(&scheduler->lowered);
+	pthread_mutex_unlock(&scheduler->mutex);
+	return true;
+}
+
+/* PUBLIC FUNCTIONS */
+
+FunctionScheduler * createFunctionScheduler(DeclarationList * declarationList, void ** workers, const unsigned int workerCount, FunctionLowering lower) {
+	FunctionScheduler * scheduler = calloc(1, sizeof(FunctionScheduler));
+	for (DeclarationList * node = declarationList; node != NULL; node = node->next) {
+		if (_isDefinition(node->declaration)) {
+			++scheduler->count;
+		}
+	}
+	scheduler->tasks = calloc(scheduler->count, sizeof(FunctionTask));
+	unsigned int index = 0;
+	for (DeclarationList * node = declarationList; node != NULL; node = node->next) {
+		if (_isDefinition(node->declaration)) {
+			scheduler->tasks[index++].declaration = node->declaration;
+		}
+	}
+	scheduler->lower = lower;
+	scheduler->threadCount = workerCount;
+	scheduler->threads = calloc(workerCount, sizeof(FunctionSchedulerThread));
+	pthread_mutex_init(&scheduler->mutex, NULL);
+	pthread_cond_init(&scheduler->lowered, NULL);
+	for (unsigned int k = 0; k < workerCount; ++k) {
+		scheduler->threads[k].scheduler = scheduler;
+		scheduler->threads[k].worker = workers[k];
+	}
+	for (unsigned int k = 1; k < workerCount; ++k) {
+		FunctionSchedulerThread * thread = &scheduler->threads[k];
+		thread->started = pthread_create(&thread->thread, NULL, _lowerFunctions, thread) == 0;
+	}
+	return scheduler;
+}
+
+AssemblyFunction * awaitScheduledFunction(FunctionScheduler * scheduler, const unsigned int index) {
+	FunctionTask * task = &scheduler->tasks[index];
+	pthread_mutex_lock(&scheduler->mutex);
+	while (!task->done) {
+		pthread_mutex_unlock(&scheduler->mutex);
+		const boolean lowered = _lowerNextFunction(scheduler, scheduler->threads[0].worker);
+		pthread_mutex_lock(&scheduler->mutex);
+		while (!lowered && !task->done) {
+			pthread_cond_wait(&scheduler->lowered, &scheduler->mutex);
+		}
+	}
+	pthread_mutex_unlock(&scheduler->mutex);
+	return task->function;
+}
+
+void destroyFunctionScheduler(FunctionScheduler * scheduler) {
+	for (unsigned int k = 0; k < scheduler->threadCount; ++k) {
+		if (scheduler->threads[k].started) {
+			pthread_join(scheduler->threads[k].thread, NULL);
+		}
+	}
+	pthread_cond_destroy(&scheduler->lowered);
+	pthread_mutex_destroy(&scheduler->mutex);
+	free(scheduler->threads);
+	free(scheduler->tasks);
+	free(scheduler);
+}
@@ -0,0 +1,77 @@
+#ifndef FUNCTION_SCHEDULER_HEADER
+#define FUNCTION_SCHEDULER_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Type.h"
+#include "Assembly.h"
+#include <pthread.h>
+#include <stdlib.h>
+
+/**
+ * Lowers the function definitions of a program in many threads at the same
+ * time, while the calling thread takes the lowered functions in order. Every
+ * worker claims the next function that nobody claimed, until there are no
+ * more, so a long function only delays the worker that lowers it. The
+ * calling thread is a worker too: while the function that it awaits is not
+ * done, it lowers the next one.
+ */
+
+/**
+ * Lowers a function definition with the state of a worker (e.g., its own
+ * symbol table), which no other thread uses.
+ */
+typedef AssemblyFunction * (*FunctionLowering)(void * worker, Declaration * declaration);
+
+/**
+ * A function definition of the program, and its lowered function, once a
+ * worker is done with it.
+ */
+typedef struct {
+	Declaration * declaration;
+	AssemblyFunction * function;
+	boolean done;
+} FunctionTask;
+
+typedef struct FunctionScheduler FunctionScheduler;
+
+/**
+ * A worker thread, and its state.
+ */
+typedef struct {
+	FunctionScheduler * scheduler;
+	void * worker;
+	pthread_t thread;
+	boolean started;
+} FunctionSchedulerThread;
+
+struct FunctionScheduler {
+	FunctionTask * tasks;
+	unsigned int count;
+	unsigned int next;
+	FunctionLowering lower;
+	FunctionSchedulerThread * threads;
+	unsigned int threadCount;
+	pthread_mutex_t mutex;
+	pthread_cond_t lowered;
+};
+
+/**
+ * Collects the function definitions of a declaration list, and starts
+ * lowering them with every worker but the first one, which belongs to the
+ * calling thread. Each worker runs in its own thread (if it can be started).
+ */
+FunctionScheduler * createFunctionScheduler(DeclarationList * declarationList, void ** workers, const unsigned int workerCount, FunctionLowering lower);
+
+/**
+ * Waits until the function definition at an index (in the order of the
+ * declarations) is lowered, and returns it (the caller must destroy it).
+ */
+AssemblyFunction * awaitScheduledFunction(FunctionScheduler * scheduler, const unsigned int index);
+
+/**
+ * Waits for every worker thread, and destroys the scheduler. Every function
+ * must have been awaited.
+ */
+void destroyFunctionScheduler(FunctionScheduler * scheduler);
+
+#endif
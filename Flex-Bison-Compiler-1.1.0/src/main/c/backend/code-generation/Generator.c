@@ -1,174 +1,2431 @@
-//#include "Generator.h"
-//
-///* MODULE INTERNAL STATE */
-//
-//const char _indentationCharacter = ' ';
-//const char _indentationSize = 4;
-//static Logger * _logger = NULL;
-//
-//void initializeGeneratorModule() {
-//	_logger = createLogger("Generator");
-//}
-//
-//void shutdownGeneratorModule() {
-//	if (_logger != NULL) {
-//		destroyLogger(_logger);
-//	}
-//}
-//
-///** PRIVATE FUNCTIONS */
-//
-//static const char _expressionTypeToCharacter(const ExpressionType type);
-//static void _generateConstant(const unsigned int indentationLevel, Constant * constant);
-//static void _generateEpilogue(const int value);
-//static void _generateExpression(const unsigned int indentationLevel, Expression * expression);
-//static void _generateFactor(const unsigned int indentationLevel, Factor * factor);
-//static void _generateProgram(Program * program);
-//static void _generatePrologue(void);
-//static char * _indentation(const unsigned int indentationLevel);
-//static void _output(const unsigned int indentationLevel, const char * const format, ...);
-//
-///**
-// * Converts and expression type to the proper character of the operation
-// * involved, or returns '\0' if that's not possible.
-// */
-//static const char _expressionTypeToCharacter(const ExpressionType type) {
-//	switch (type) {
-//		case ADDITION: return '+';
-//		case DIVISION: return '/';
-//		case MULTIPLICATION: return '*';
-//		case SUBTRACTION: return '-';
-//		default:
-//			logError(_logger, "The specified expression type cannot be converted into character: %d", type);
-//			return '\0';
-//	}
-//}
-//
-///**
-// * Generates the output of a constant.
-// */
-//static void _generateConstant(const unsigned int indentationLevel, Constant * constant) {
-//	_output(indentationLevel, "%s", "[ $C$, circle, draw, black!20\n");
-//	_output(1 + indentationLevel, "%s%d%s", "[ $", constant->value, "$, circle, draw ]\n");
-//	_output(indentationLevel, "%s", "]\n");
-//}
-//
-///**
-// * Creates the epilogue of the generated output, that is, the final lines that
-// * completes a valid Latex document.
-// */
-//static void _generateEpilogue(const int value) {
-//	_output(0, "%s%d%s",
-//		"            [ $", value, "$, circle, draw, blue ]\n"
-//		"        ]\n"
-//		"    \\end{forest}\n"
-//		"\\end{document}\n\n"
-//	);
-//}
-//
-///**
-// * Generates the output of an expression.
-// */
-//static void _generateExpression(const unsigned int indentationLevel, Expression * expression) {
-//	_output(indentationLevel, "%s", "[ $E$, circle, draw, black!20\n");
-//	switch (expression->type) {
-//		case ADDITION:
-//		case DIVISION:
-//		case MULTIPLICATION:
-//		case SUBTRACTION:
-//			_generateExpression(1 + indentationLevel, expression->leftExpression);
-//			_output(1 + indentationLevel, "%s%c%s", "[ $", _expressionTypeToCharacter(expression->type), "$, circle, draw, purple ]\n");
-//			_generateExpression(1 + indentationLevel, expression->rightExpression);
-//			break;
-//		case FACTOR:
-//			_generateFactor(1 + indentationLevel, expression->factor);
-//			break;
-//		default:
-//			logError(_logger, "The specified expression type is unknown: %d", expression->type);
-//			break;
-//	}
-//	_output(indentationLevel, "%s", "]\n");
-//}
-//
-///**
-// * Generates the output of a factor.
-// */
-//static void _generateFactor(const unsigned int indentationLevel, Factor * factor) {
-//	_output(indentationLevel, "%s", "[ $F$, circle, draw, black!20\n");
-//	switch (factor->type) {
-//		case CONSTANT:
-//			_generateConstant(1 + indentationLevel, factor->constant);
-//			break;
-//		case EXPRESSION:
-//			_output(1 + indentationLevel, "%s", "[ $($, circle, draw, purple ]\n");
-//			_generateExpression(1 + indentationLevel, factor->expression);
-//			_output(1 + indentationLevel, "%s", "[ $)$, circle, draw, purple ]\n");
-//			break;
-//		default:
-//			logError(_logger, "The specified factor type is unknown: %d", factor->type);
-//			break;
-//	}
-//	_output(indentationLevel, "%s", "]\n");
-//}
-//
-///**
-// * Generates the output of the program.
-// */
-//static void _generateProgram(Program * program) {
-//	_generateExpression(3, program->expression);
-//}
-//
-///**
-// * Creates the prologue of the generated output, a Latex document that renders
-// * a tree thanks to the Forest package.
-// *
-// * @see https://ctan.dcc.uchile.cl/graphics/pgf/contrib/forest/forest-doc.pdf
-// */
-//static void _generatePrologue(void) {
-//	_output(0, "%s",
-//		"\\documentclass{standalone}\n\n"
-//		"\\usepackage[utf8]{inputenc}\n"
-//		"\\usepackage[T1]{fontenc}\n"
-//		"\\usepackage{amsmath}\n"
-//		"\\usepackage{forest}\n"
-//		"\\usepackage{microtype}\n\n"
-//		"\\begin{document}\n"
-//		"    \\centering\n"
-//		"    \\begin{forest}\n"
-//		"        [ \\text{$=$}, circle, draw, purple\n"
-//	);
-//}
-//
-///**
-// * Generates an indentation string for the specified level.
-// */
-//static char * _indentation(const unsigned int level) {
-//	return indentation(_indentationCharacter, level, _indentationSize);
-//}
-//
-///**
-// * Outputs a formatted string to standard output. The "fflush" instruction
-// * allows to see the output even close to a failure, because it drops the
-// * buffering.
-// */
-//static void _output(const unsigned int indentationLevel, const char * const format, ...) {
-//	va_list arguments;
-//	va_start(arguments, format);
-//	char * indentation = _indentation(indentationLevel);
-//	char * effectiveFormat = concatenate(2, indentation, format);
-//	vfprintf(stdout, effectiveFormat, arguments);
-//	fflush(stdout);
-//	free(effectiveFormat);
-//	free(indentation);
-//	va_end(arguments);
-//}
-//
-///** PUBLIC FUNCTIONS */
-//
-//void generate(CompilerState * compilerState) {
-//	logDebugging(_logger, "Generating final output...");
-//	_generatePrologue();
-//	_generateProgram(compilerState->abstractSyntaxtTree);
-//	_generateEpilogue(compilerState->value);
-//	logDebugging(_logger, "Generation is done.");
-//}
+#include "Generator.h"
+#include <unistd.h>
+
+/* MODULE INTERNAL STATE */
+
+const char _indentationCharacter = '\t';
+const char _indentationSize = 1;
+static Logger * _logger = NULL;
+
+/**
+ * The destination of the generated output.
+ */
+static Emitter * _emitter = NULL;
+
+/**
+ * The System V registers used to pass the first integer arguments.
+ */
+static const Register _argumentRegisters[] = { REGISTER_RDI, REGISTER_RSI, REGISTER_RDX, REGISTER_RCX, REGISTER_R8, REGISTER_R9 };
+static const int _argumentRegisterCount = 6;
+
+/**
+ * An upper bound on the rounds of dead-store elimination (each one can only
+ * expose a few more dead stores, through the peephole optimizer).
+ */
+static const int _maximumDeadStorePasses = 4;
+
+/**
+ * The amount of threads that lower the functions of a program (see
+ * "GENERATOR_THREADS"), and the minimum amount of functions for each one,
+ * below which the threads cost more than they save.
+ */
+static unsigned int _generatorThreads = 1;
+static const unsigned int _minimumFunctionsPerThread = 4;
+
+/**
+ * The steps that each call to a pure function can take to be evaluated at
+ * compile-time (see "EVALUATION_STEPS"). With none, the calls aren't
+ * evaluated.
+ */
+static uint64_t _evaluationSteps = 100000;
+
+/**
+ * How much the clones of the functions specialized for constant arguments
+ * can grow the program, as a percentage of its nodes (see
+ * "SPECIALIZATION_GROWTH"). With none, nothing is specialized.
+ */
+static unsigned int _specializationGrowth = 25;
+
+/**
+ * The requirements of an expression that isn't an array index (see
+ * "selectInstructions").
+ */
+static const IndexRequirements _noIndex = { .elementSize = 0, .exact = false };
+
+void initializeGeneratorModule() {
+	_logger = createLogger("Generator");
+	const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+	const char * threads = getStringOrDefault("GENERATOR_THREADS", NULL);
+	const int generatorThreads = threads == NULL ? (int) processors : atoi(threads);
+	_generatorThreads = generatorThreads <= 0 ? 1 : (unsigned int) generatorThreads;
+	const char * steps = getStringOrDefault("EVALUATION_STEPS", NULL);
+	if (steps != NULL) {
+		_evaluationSteps = strtoull(steps, NULL, 10);
+	}
+	const char * growth = getStringOrDefault("SPECIALIZATION_GROWTH", NULL);
+	if (growth != NULL) {
+		_specializationGrowth = (unsigned int) strtoul(growth, NULL, 10);
+	}
+}
+
+void shutdownGeneratorModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/**
+ * The state of the generation of a program. The function is the one being
+ * lowered (if any), and the symbols with a known constant value at the
+ * current point of its code are tracked in order to forget them at the next
+ * label (i.e., at every control-flow join). The interface summaries loaded
+ * stay mapped until the end, and the definitions are exported to a new one,
+ * if requested.
+ *
+ * The functions are either instrumented (see "PROFILE_OUTPUT_FILE"), or
+ * optimized with the counts of a profile (see "PROFILE_FILE"), through the
+ * profiling sites of the function being lowered (there are none in an
+ * inlined call). An inlined callee is generated in a copy of the global
+ * scope, kept until the end since the instructions refer to the names of its
+ * symbols. The rarely executed blocks of the function are generated apart,
+ * and appended to its end.
+ *
+ * With coverage (see "COVERAGE_OUTPUT_FILE"), the basic blocks of a function
+ * count their executions too. The body of the counted loop being generated
+ * (if any) isn't counted on each iteration, but once the loop exits. The
+ * instrumented (and covered) functions are listed to write their counters
+ * when the program exits.
+ *
+ * With bounds checks (see "BOUNDS_CHECKS"), the ranges of the indices of the
+ * function being lowered tell which accesses are always in bounds, and the
+ * others jump to its bounds label (created on demand) when they fail. The
+ * for-loops that checked their accesses before starting are stacked while
+ * their body is generated, and the copies of the loops that check every
+ * access are counted, so their accesses are reported once.
+ *
+ * With a function cache (see "FUNCTION_CACHE_DIRECTORY"), a function is only
+ * lowered if its key isn't there, and then it's stored, once it's formatted.
+ * The cache is ignored while instrumenting, or with a profile, since their
+ * output depends on more than the function.
+ *
+ * As a whole program (see "WHOLE_PROGRAM"), the unreachable declarations are
+ * removed before generating any of them (which doesn't apply while
+ * streaming, since the program is never complete).
+ */
+typedef struct {
+	CompilerState * compilerState;
+	SymbolTable * symbolTable;
+	AssemblyFunction * function;
+	DataType returnType;
+	int returnLabel;
+	Symbol ** constants;
+	int constantCount;
+	int constantCapacity;
+	InterfaceSummary ** interfaces;
+	int interfaceCount;
+	InterfaceWriter * interfaceWriter;
+	Profile * profile;
+	boolean instrument;
+	ProfileSites * sites;
+	const uint64_t * counts;
+	SymbolTable * inlineScope;
+	InstructionList coldInstructions;
+	boolean outlining;
+	InstrumentedFunctions instrumented;
+	boolean coverage;
+	const Block * uncountedBlock;
+	InstrumentedFunctions covered;
+	boolean boundsChecks;
+	RangeAnalysis * ranges;
+	int boundsLabel;
+	HoistedLoop * hoisted;
+	unsigned int checkedCopies;
+	boolean boundsFailure;
+	FunctionCache * cache;
+	boolean wholeProgram;
+} GeneratorContext;
+
+
+/**
+ * A copy of the known constant values at some point of the generated code,
+ * used to restore them at the labels where the control-flow joins.
+ */
+typedef struct {
+	Symbol ** symbols;
+	int * values;
+	int count;
+} ConstantSnapshot;
+
+/**
+ * A worker that lowers functions, with its own context, symbol table (a copy
+ * of the global symbols) and compiler state, so it shares nothing mutable
+ * with the other ones.
+ */
+typedef struct {
+	GeneratorContext context;
+	CompilerState compilerState;
+} FunctionWorker;
+
+/**
+ * The generation in progress, from "beginGeneration" to "endGeneration".
+ */
+static GeneratorContext _context;
+
+/** PRIVATE FUNCTIONS */
+
+static void _appendColdInstructions(GeneratorContext * context);
+static void _checkBounds(GeneratorContext * context, const Symbol * symbol, Expression * index, const ComputationResult constantIndex);
+static void _checkProgramTypes(GeneratorContext * context, DeclarationList * declarationList);
+static Nonterminal _classifyLeaf(void * context, Expression * expression, int * value);
+static void _countBlock(GeneratorContext * context, const void * node);
+static Symbol * _countedLoopVariable(GeneratorContext * context, StatementFor * statement);
+static Symbol * _countedWhileVariable(GeneratorContext * context, StatementWhile * statement);
+static void _countLoopExit(GeneratorContext * context, Symbol * variable, const Block * block, const int start);
+static int _countLoopStart(GeneratorContext * context, Symbol * variable, const Block * block);
+static void _countSite(GeneratorContext * context, const int site, const int counter);
+static void _declareGlobal(GeneratorContext * context, Declaration * declaration);
+static void _declareGlobals(GeneratorContext * context, DeclarationList * declarationList);
+static Instruction * _emit(GeneratorContext * context, Instruction * instruction);
+static void _emitCondition(GeneratorContext * context, const Opcode opcode, const Condition condition, const Operand operand);
+static void _emitLabel(GeneratorContext * context, const int label);
+static void _evaluatePureCalls(Program * program, const boolean first);
+static Condition _expressionTypeToCondition(const ExpressionType type);
+static boolean _isRelational(const Expression * expression);
+static void _forgetConstant(Symbol * symbol);
+static void _forgetAssignedInBlock(GeneratorContext * context, Block * block);
+static void _forgetAssignedInExpression(GeneratorContext * context, Expression * expression);
+static void _forgetAssignedInLoop(GeneratorContext * context, Expression * condition, Expression * update, Block * block);
+static void _forgetConstants(GeneratorContext * context);
+static void _forgetScopeConstants(GeneratorContext * context);
+static void _generateArguments(GeneratorContext * context, ListArguments * arguments, const int count);
+static void _generateAssignment(GeneratorContext * context, Expression * expression);
+static void _generateBinaryOperation(GeneratorContext * context, Expression * expression, const Opcode opcode);
+static void _generateBlock(GeneratorContext * context, Block * block);
+static void _generateBranch(GeneratorContext * context, Expression * condition, const boolean jumpIfTrue, const int label);
+static void _generateComparison(GeneratorContext * context, Expression * expression);
+static Condition _generateComparisonFlags(GeneratorContext * context, Expression * expression);
+static void _generateDeclaration(GeneratorContext * context, Declaration * declaration);
+static void _generateDeclarationStatement(GeneratorContext * context, Statement * statement);
+static void _generateDivision(GeneratorContext * context, Expression * expression, const boolean remainder);
+static Operand _generateElementAddress(GeneratorContext * context, const char * name, Expression * index);
+static void _generateEpilogue(GeneratorContext * context);
+static void _generateExpression(GeneratorContext * context, Expression * expression);
+static void _generateFor(GeneratorContext * context, StatementFor * statement);
+static void _generateForLoop(GeneratorContext * context, StatementFor * statement);
+static void _generateFunction(GeneratorContext * context, Declaration * declaration);
+static void _generateFunctionCall(GeneratorContext * context, Expression * expression);
+static void _generateFunctionsInParallel(GeneratorContext * context, DeclarationList * declarationList, const unsigned int functionCount);
+static void _generateGlobalVariable(GeneratorContext * context, Declaration * declaration);
+static void _generateIf(GeneratorContext * context, StatementIf * statement);
+static long _generateIndex(GeneratorContext * context, Expression * index, const IndexRequirements requirements, int * factor);
+static void _generateInlinedCall(GeneratorContext * context, Expression * expression, Declaration * callee, const int count);
+static void _generateLogicalOperation(GeneratorContext * context, Expression * expression);
+static void _generateOutlinedIf(GeneratorContext * context, StatementIf * statement);
+static void _generateParameters(GeneratorContext * context, Parameters * parameters);
+static void _generateProgram(GeneratorContext * context, Program * program);
+static void _generateReturn(GeneratorContext * context, StatementReturn * statement);
+static void _generateRootExpression(GeneratorContext * context, Expression * expression);
+static int _generateScaled(GeneratorContext * context, Expression * expression, const IndexRequirements requirements);
+static void _generateStatement(GeneratorContext * context, Statement * statement);
+static void _generateWhile(GeneratorContext * context, StatementWhile * statement);
+static boolean _hoistBoundsChecks(GeneratorContext * context, StatementFor * statement, int * checkedLabel);
+static void _loadInterfaces(GeneratorContext * context, const char * paths);
+static void _loadSymbol(GeneratorContext * context, Symbol * symbol, const char * name);
+static AssemblyFunction * _lowerFunction(GeneratorContext * context, Declaration * declaration);
+static AssemblyFunction * _lowerScheduledFunction(void * worker, Declaration * declaration);
+static void _outputFunction(GeneratorContext * context, AssemblyFunction * function);
+static int _profileSite(GeneratorContext * context, const void * node);
+static void _releaseConstants(ConstantSnapshot * snapshot);
+static void _rememberConstant(GeneratorContext * context, Symbol * symbol, const int value);
+static void _restoreConstants(GeneratorContext * context, const ConstantSnapshot * snapshot);
+static boolean _returnsInBlock(const Block * block);
+static ConstantSnapshot _saveConstants(GeneratorContext * context);
+static ComputationResult _resolveConstant(void * context, const char * identifier);
+static Selection _selectRules(GeneratorContext * context, Expression * expression, const Nonterminal goal, const IndexRequirements requirements);
+static Operand _selectedOperand(GeneratorContext * context, Expression * expression, const Nonterminal nonterminal);
+static boolean _simpleOperand(GeneratorContext * context, Expression * expression, Operand * operand);
+static Operand _storageOperand(Symbol * symbol, const char * name);
+static void _storeSymbol(GeneratorContext * context, Symbol * symbol, const char * name);
+static Width _widthOf(const DataType dataType);
+
+/**
+ * Moves the rarely executed blocks of the function being lowered to its end.
+ */
+static void _appendColdInstructions(GeneratorContext * context) {
+	Instruction * instruction = context->coldInstructions.first;
+	while (instruction != NULL) {
+		Instruction * next = instruction->next;
+		appendInstruction(&context->function->instructions, instruction);
+		instruction = next;
+	}
+	context->coldInstructions = (InstructionList) { .first = NULL, .last = NULL, .count = 0 };
+}
+
+/**
+ * Checks the bounds of an array access, whose index is either constant or
+ * in %rcx, unless its range is always in bounds, or a loop around it already
+ * checked it. The arrays of unknown size (the parameters) aren't checked.
+ */
+static void _checkBounds(GeneratorContext * context, const Symbol * symbol, Expression * index, const ComputationResult constantIndex) {
+	if (!context->boundsChecks || !isBoundsCheckedArray(symbol)) {
+		return;
+	}
+	const BoundsCheck check = classifyBoundsCheck(context->ranges, context->hoisted, symbol, index, constantIndex);
+	if (statisticsEnabled && context->checkedCopies == 0) {
+		countNamed(STATISTICS_BOUNDS_CHECKS, check == BOUNDS_CHECK_ELIMINATED ? "eliminated" : (check == BOUNDS_CHECK_REQUIRED ? "checked" : "hoisted"), 1);
+	}
+	if (check != BOUNDS_CHECK_REQUIRED) {
+		return;
+	}
+	if (context->boundsLabel < 0) {
+		context->boundsLabel = createLabel(context->function);
+	}
+	if (constantIndex.succeed) {
+		_emit(context, createInstruction(OPCODE_JMP, WIDTH_QUAD, 1, labelOperand(context->boundsLabel)));
+	}
+	else {
+		_emit(context, createInstruction(OPCODE_CMP, WIDTH_QUAD, 2, immediateOperand(symbol->arraySize), registerOperand(REGISTER_RCX)));
+		_emitCondition(context, OPCODE_JCC, CONDITION_ABOVE_EQUAL, labelOperand(context->boundsLabel));
+	}
+}
+
+/**
+ * Checks the types of every function of the program, before anything
+ * rewrites it (e.g., a folded call has no type, so it would hide an error),
+ * in a scratch copy of the global scope.
+ */
+static void _checkProgramTypes(GeneratorContext * context, DeclarationList * declarationList) {
+	SymbolTable * symbolTable = context->symbolTable;
+	context->symbolTable = copyGlobalScope(symbolTable);
+	_declareGlobals(context, declarationList);
+	for (DeclarationList * node = declarationList; node != NULL; node = node->next) {
+		if (!checkFunctionTypes(context->symbolTable, node->declaration)) {
+			context->compilerState->succeed = false;
+		}
+	}
+	destroySymbolTable(context->symbolTable);
+	context->symbolTable = symbolTable;
+}
+
+/**
+ * Classifies a leaf for the instruction selector: a constant (even a known
+ * one) is an immediate, an integer variable is read in place, and anything
+ * else is loaded into %eax.
+ */
+static Nonterminal _classifyLeaf(void * context, Expression * expression, int * value) {
+	Operand operand;
+	if (!_simpleOperand((GeneratorContext *) context, expression, &operand)) {
+		return NONTERMINAL_REGISTER;
+	}
+	if (operand.type == OPERAND_IMMEDIATE) {
+		*value = (int) operand.displacement;
+		return NONTERMINAL_IMMEDIATE;
+	}
+	return NONTERMINAL_MEMORY;
+}
+
+/**
+ * Counts an execution of the basic block that starts at a node, if the
+ * function has coverage, and one starts there (the flags are never alive
+ * here, either). The body of a counted loop adds its iterations when the
+ * loop exits instead.
+ */
+static void _countBlock(GeneratorContext * context, const void * node) {
+	if (context->coverage && context->sites != NULL && node != context->uncountedBlock) {
+		const int block = profileBlock(context->sites, node);
+		if (0 <= block) {
+			Operand operand = symbolMemoryOperand(context->function->blocks);
+			operand.displacement = 8 * block;
+			_emit(context, createInstruction(OPCODE_ADD, WIDTH_QUAD, 2, immediateOperand(1), operand));
+		}
+	}
+}
+
+/**
+ * The induction variable of a for-loop whose body can count its executions
+ * when the loop exits, or NULL if it must count them on each iteration. The
+ * loop must be canonical (see "RangeAnalysis.h"), so the body is executed as
+ * many times as the variable is incremented, and its body can't return, so
+ * every execution reaches the exit.
+ */
+static Symbol * _countedLoopVariable(GeneratorContext * context, StatementFor * statement) {
+	if (!context->coverage || context->sites == NULL || context->ranges == NULL || profileBlock(context->sites, statement->block) < 0) {
+		return NULL;
+	}
+	const RangeLoop * loop = rangeLoop(context->ranges, statement);
+	if (loop == NULL || _returnsInBlock(statement->block)) {
+		return NULL;
+	}
+	Symbol * symbol = lookupSymbol(context->symbolTable, *loop->variable->identifier);
+	return symbol == NULL || symbol->type == SYMBOL_GLOBAL_VARIABLE ? NULL : symbol;
+}
+
+/**
+ * The induction variable of a while-loop whose body can count its executions
+ * when the loop exits (see "countedWhileVariable"), or NULL if it must count
+ * them on each iteration. As in a counted for-loop, the variable must be a
+ * local integer, and the body can't return.
+ */
+static Symbol * _countedWhileVariable(GeneratorContext * context, StatementWhile * statement) {
+	if (!context->coverage || context->sites == NULL || profileBlock(context->sites, statement->block) < 0 || _returnsInBlock(statement->block)) {
+		return NULL;
+	}
+	const char * name = countedWhileVariable(statement);
+	Symbol * symbol = name == NULL ? NULL : lookupSymbol(context->symbolTable, name);
+	if (symbol == NULL || symbol->type == SYMBOL_FUNCTION || symbol->type == SYMBOL_GLOBAL_VARIABLE || symbol->array || symbol->dataType != TYPE_INT) {
+		return NULL;
+	}
+	return symbol;
+}
+
+/**
+ * Adds the times that the induction variable of a counted loop was
+ * incremented (since its initial value, kept in a slot) to the counter of its
+ * body, once the loop exits.
+ */
+static void _countLoopExit(GeneratorContext * context, Symbol * variable, const Block * block, const int start) {
+	const Operand rax = registerOperand(REGISTER_RAX);
+	Operand counter = symbolMemoryOperand(context->function->blocks);
+	counter.displacement = 8 * profileBlock(context->sites, block);
+	_emit(context, createInstruction(OPCODE_MOV, WIDTH_LONG, 2, _storageOperand(variable, variable->name), rax));
+	_emit(context, createInstruction(OPCODE_SUB, WIDTH_LONG, 2, slotOperand(start), rax));
+	_emit(context, createInstruction(OPCODE_ADD, WIDTH_QUAD, 2, rax, counter));
+}
+
+/**
+ * Keeps the initial value of the induction variable of a counted loop in a
+ * slot (which is returned), before the loop starts, so its body isn't
+ * counted on each iteration.
+ */
+static int _countLoopStart(GeneratorContext * context, Symbol * variable, const Block * block) {
+	const Operand rax = registerOperand(REGISTER_RAX);
+	const int start = createSlot(&context->function->frame, 4, 4);
+	_emit(context, createInstruction(OPCODE_MOV, WIDTH_LONG, 2, _storageOperand(variable, variable->name), rax));
+	_emit(context, createInstruction(OPCODE_MOV, WIDTH_LONG, 2, rax, slotOperand(start)));
+	context->uncountedBlock = block;
+	return start;
+}
+
+/**
+ * Counts an execution of a profiling site of an instrumented function,
+ * adding one to the specified counter of the site (the flags are never
+ * alive here).
+ */
+static void _countSite(GeneratorContext * context, const int site, const int counter) {
+	if (context->instrument && 0 <= site) {
+		Operand operand = symbolMemoryOperand(context->function->counters);
+		operand.displacement = 8 * (site + counter);
+		_emit(context, createInstruction(OPCODE_ADD, WIDTH_QUAD, 2, immediateOperand(1), operand));
+	}
+}
+
+/**
+ * Registers a global function or variable (or updates the type and linkage
+ * of a previous declaration with the same name).
+ */
+static void _declareGlobal(GeneratorContext * context, Declaration * declaration) {
+	const char * name = *declaration->identifier;
+	Symbol * symbol = lookupSymbol(context->symbolTable, name);
+	if (declaration->declarationSuffix->type == DECLARATION_SUFFIX_FUNCTION) {
+		if (symbol == NULL) {
+			symbol = declareSymbol(context->symbolTable, name, SYMBOL_FUNCTION, declaration->dataType);
+			symbol->external = true;
+		}
+		symbol->dataType = declaration->dataType;
+		if (declaration->declarationSuffix->functionSuffix->type == SUFFIX_BLOCK) {
+			symbol->external = false;
+		}
+	}
+	else {
+		VariableSuffix * suffix = declaration->declarationSuffix->variableSuffix;
+		if (symbol == NULL) {
+			symbol = declareSymbol(context->symbolTable, name, SYMBOL_GLOBAL_VARIABLE, declaration->dataType);
+			symbol->external = true;
+		}
+		if (suffix->type == VARIABLE_SUFFIX_ARRAY) {
+			symbol->array = true;
+			symbol->arraySize = *suffix->arraySize;
+		}
+		if (declaration->declarationType == DECLARATION_REGULAR || suffix->type == VARIABLE_SUFFIX_ASSIGNMENT) {
+			symbol->external = false;
+		}
+	}
+}
+
+/**
+ * Registers every global function and variable before generating any code,
+ * so a function can be called (or a global used) before its definition.
+ */
+static void _declareGlobals(GeneratorContext * context, DeclarationList * declarationList) {
+	for (DeclarationList * node = declarationList; node != NULL; node = node->next) {
+		_declareGlobal(context, node->declaration);
+		DeclarationSuffix * suffix = node->declaration->declarationSuffix;
+		if (suffix->type == DECLARATION_SUFFIX_FUNCTION && suffix->functionSuffix->type == SUFFIX_BLOCK) {
+			lookupSymbol(context->symbolTable, *node->declaration->identifier)->definition = node->declaration;
+		}
+	}
+}
+
+/**
+ * Appends an instruction to the function being lowered.
+ */
+static Instruction * _emit(GeneratorContext * context, Instruction * instruction) {
+	return appendInstruction(&context->function->instructions, instruction);
+}
+
+/**
+ * Appends a conditional instruction ("jcc" or "setcc").
+ */
+static void _emitCondition(GeneratorContext * context, const Opcode opcode, const Condition condition, const Operand operand) {
+	Instruction * instruction = createInstruction(opcode, WIDTH_BYTE, 1, operand);
+	instruction->condition = condition;
+	_emit(context, instruction);
+}
+
+/**
+ * Places a label. Since other paths can jump into it, nothing is known about
+ * the values of the variables anymore.
+ */
+static void _emitLabel(GeneratorContext * context, const int label) {
+	_emit(context, createInstruction(OPCODE_LABEL, WIDTH_QUAD, 1, labelOperand(label)));
+	_forgetConstants(context);
+}
+
+/**
+ * Replaces the calls to the pure functions of a program with constant
+ * arguments by their values (unless "EVALUATION_STEPS" is zero). The pure
+ * functions are only counted the first time.
+ */
+static void _evaluatePureCalls(Program * program, const boolean first) {
+	if (_evaluationSteps == 0) {
+		return;
+	}
+	Evaluator * evaluator = createEvaluator(program, _evaluationSteps);
+	const unsigned int replaced = evaluatePureCalls(evaluator, program);
+	logDebugging(_logger, "Replaced %u calls to %u pure functions by their values.", replaced, evaluator->pureCount);
+	if (statisticsEnabled) {
+		if (first) {
+			countNamed(STATISTICS_PARTIAL_EVALUATION, "pureFunctions", evaluator->pureCount);
+		}
+		countNamed(STATISTICS_PARTIAL_EVALUATION, "replacedCalls", replaced);
+	}
+	destroyEvaluator(evaluator);
+}
+
+/**
+ * The condition that holds when a relational expression is true.
+ */
+static Condition _expressionTypeToCondition(const ExpressionType type) {
+	switch (type) {
+		case EXPRESSION_EQUAL: return CONDITION_EQUAL;
+		case EXPRESSION_NOT_EQUAL: return CONDITION_NOT_EQUAL;
+		case EXPRESSION_LESS: return CONDITION_LESS;
+		case EXPRESSION_LESS_EQUAL: return CONDITION_LESS_EQUAL;
+		case EXPRESSION_GREATER: return CONDITION_GREATER;
+		case EXPRESSION_GREATER_EQUAL: return CONDITION_GREATER_EQUAL;
+		default:
+			logError(_logger, "The specified expression type cannot be converted into a condition: %d", type);
+			return CONDITION_NONE;
+	}
+}
+
+/**
+ * True for the comparison operators, which can set the flags directly.
+ */
+static boolean _isRelational(const Expression * expression) {
+	switch (expression->type) {
+		case EXPRESSION_EQUAL:
+		case EXPRESSION_NOT_EQUAL:
+		case EXPRESSION_LESS:
+		case EXPRESSION_LESS_EQUAL:
+		case EXPRESSION_GREATER:
+		case EXPRESSION_GREATER_EQUAL:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/**
+ * Forgets the value of a single symbol (e.g., after a non-constant
+ * assignment).
+ */
+static void _forgetConstant(Symbol * symbol) {
+	symbol->constant = false;
+}
+
+/**
+ * Forgets the value of every symbol assigned anywhere inside a block, that
+ * is, the values that cannot be trusted at a label that joins the end of the
+ * block with another path.
+ */
+static void _forgetAssignedInBlock(GeneratorContext * context, Block * block) {
+	for (Statements * statements = block->statements; statements != NULL; statements = statements->next) {
+		Statement * statement = statements->statement;
+		switch (statement->type) {
+			case STATEMENT_DECLARATION:
+				if (statement->variableSuffix->type == VARIABLE_SUFFIX_ASSIGNMENT) {
+					_forgetAssignedInExpression(context, statement->variableSuffix->expression);
+				}
+				break;
+			case STATEMENT_IF:
+				_forgetAssignedInExpression(context, statement->statementIf->condition);
+				_forgetAssignedInBlock(context, statement->statementIf->thenBlock);
+				if (statement->statementIf->hasElse) {
+					_forgetAssignedInBlock(context, statement->statementIf->elseBlock);
+				}
+				break;
+			case STATEMENT_WHILE:
+				_forgetAssignedInExpression(context, statement->statementWhile->condition);
+				_forgetAssignedInBlock(context, statement->statementWhile->block);
+				break;
+			case STATEMENT_FOR:
+				if (statement->statementFor->hasInit) {
+					_forgetAssignedInExpression(context, statement->statementFor->init);
+				}
+				if (statement->statementFor->hasCondition) {
+					_forgetAssignedInExpression(context, statement->statementFor->condition);
+				}
+				if (statement->statementFor->hasUpdate) {
+					_forgetAssignedInExpression(context, statement->statementFor->update);
+				}
+				_forgetAssignedInBlock(context, statement->statementFor->block);
+				break;
+			case STATEMENT_RETURN:
+				if (statement->statementReturn->hasExpression) {
+					_forgetAssignedInExpression(context, statement->statementReturn->expression);
+				}
+				break;
+			case STATEMENT_EXPRESSION:
+				_forgetAssignedInExpression(context, statement->statementExpression->expression);
+				break;
+			case STATEMENT_BLOCK:
+				_forgetAssignedInBlock(context, statement->block);
+				break;
+			case STATEMENT_EMPTY:
+				break;
+		}
+	}
+}
+
+/**
+ * Forgets the value of every symbol assigned inside an expression. Since
+ * the language has no pointers to scalars, a call cannot modify a local.
+ */
+static void _forgetAssignedInExpression(GeneratorContext * context, Expression * expression) {
+	switch (expression->type) {
+		case EXPRESSION_ASSIGNMENT:
+			if (expression->leftExpression->type == EXPRESSION_IDENTIFIER) {
+				Symbol * symbol = lookupSymbol(context->symbolTable, *expression->leftExpression->identifier);
+				if (symbol != NULL) {
+					_forgetConstant(symbol);
+				}
+			}
+			else {
+				_forgetAssignedInExpression(context, expression->leftExpression);
+			}
+			_forgetAssignedInExpression(context, expression->rightExpression);
+			break;
+		case EXPRESSION_NOT:
+		case EXPRESSION_PARENTHESIS:
+			_forgetAssignedInExpression(context, expression->singleExpression);
+			break;
+		case EXPRESSION_IDENTIFIER:
+		case EXPRESSION_CONSTANT:
+			break;
+		case EXPRESSION_ARRAY_ACCESS:
+			_forgetAssignedInExpression(context, expression->indexExpression);
+			break;
+		case EXPRESSION_FUNCTION_CALL:
+			for (ListArguments * argument = expression->arguments; argument != NULL; argument = argument->next) {
+				_forgetAssignedInExpression(context, argument->expression);
+			}
+			break;
+		default:
+			_forgetAssignedInExpression(context, expression->leftExpression);
+			_forgetAssignedInExpression(context, expression->rightExpression);
+			break;
+	}
+}
+
+/**
+ * Forgets the value of every symbol assigned inside a loop, which cannot be
+ * trusted at its head. The condition and the update are optional.
+ */
+static void _forgetAssignedInLoop(GeneratorContext * context, Expression * condition, Expression * update, Block * block) {
+	if (condition != NULL) {
+		_forgetAssignedInExpression(context, condition);
+	}
+	if (update != NULL) {
+		_forgetAssignedInExpression(context, update);
+	}
+	_forgetAssignedInBlock(context, block);
+}
+
+/**
+ * Forgets every known value.
+ */
+static void _forgetConstants(GeneratorContext * context) {
+	for (int k = 0; k < context->constantCount; ++k) {
+		context->constants[k]->constant = false;
+	}
+	context->constantCount = 0;
+}
+
+/**
+ * Forgets the values of the symbols declared in the current scope, because
+ * they are about to be released.
+ */
+static void _forgetScopeConstants(GeneratorContext * context) {
+	int count = 0;
+	for (int k = 0; k < context->constantCount; ++k) {
+		Symbol * symbol = context->constants[k];
+		if (symbol->depth == context->symbolTable->depth) {
+			symbol->constant = false;
+		}
+		else if (symbol->constant) {
+			context->constants[count++] = symbol;
+		}
+	}
+	context->constantCount = count;
+}
+
+/**
+ * Evaluates the arguments of a call and moves them to the registers and
+ * stack positions required by the System V ABI. Complex arguments are
+ * evaluated into temporary slots first, since evaluating the next ones can
+ * clobber any register. Returns with the stack arguments already pushed.
+ */
+static void _generateArguments(GeneratorContext * context, ListArguments * arguments, const int count) {
+	Operand * operands = calloc(count, sizeof(Operand));
+	Width * widths = calloc(count, sizeof(Width));
+	int k = 0;
+	for (ListArguments * argument = arguments; argument != NULL; argument = argument->next, ++k) {
+		if (_simpleOperand(context, argument->expression, &operands[k])) {
+			widths[k] = WIDTH_LONG;
+		}
+		else {
+			_generateRootExpression(context, argument->expression);
+			operands[k] = slotOperand(createSlot(&context->function->frame, 8, 8));
+			widths[k] = WIDTH_QUAD;
+			_emit(context, createInstruction(OPCODE_MOV, WIDTH_QUAD, 2, registerOperand(REGISTER_RAX), operands[k]));
+		}
+	}
+	const Operand rax = registerOperand(REGISTER_RAX);
+	for (k = count - 1; _argumentRegisterCount <= k; --k) {
+		_emit(context, createInstruction(OPCODE_MOV, widths[k], 2, operands[k], rax));
+		_emit(context, createInstruction(OPCODE_PUSH, WIDTH_QUAD, 1, rax));
+	}
+	for (k = 0; k < count && k < _argumentRegisterCount; ++k) {
+		_emit(context, createInstruction(OPCODE_MOV, widths[k], 2, operands[k], registerOperand(_argumentRegisters[k])));
+	}
+	free(widths);
+	free(operands);
+}
+
+/**
+ * Generates an assignment, which leaves the assigned value (converted to the
+ * type of the left-hand side) in %eax.
+ */
+static void _generateAssignment(GeneratorContext * context, Expression * expression) {
+	Expression * lvalue = expression->leftExpression;
+	Expression * value = expression->rightExpression;
+	const ComputationResult constant = computeExpression(value, _resolveConstant, context);
+	const Operand eax = registerOperand(REGISTER_RAX);
+	if (lvalue->type == EXPRESSION_ARRAY_ACCESS) {
+		Symbol * symbol = lookupSymbol(context->symbolTable, *lvalue->identifierArray);
+		const DataType dataType = symbol == NULL ? TYPE_INT : symbol->dataType;
+		Operand source;
+		if (constant.succeed) {
+			source = immediateOperand(constant.value);
+		}
+		else if (!_simpleOperand(context, value, &source)) {
+			_generateExpression(context, value);
+			source = slotOperand(createSlot(&context->function->frame, 4, 4));
+			_emit(context, createInstruction(OPCODE_MOV, WIDTH_LONG, 2, eax, source));
+		}
+		const Operand address = _generateElementAddress(context, *lvalue->identifierArray, lvalue->indexExpression);
+		_emit(context, createInstruction(OPCODE_MOV, WIDTH_LONG, 2, source, eax));
+		_emit(context, createInstruction(OPCODE_MOV, _widthOf(dataType), 2, eax, address));
+		if (dataType == TYPE_CHAR) {
+			_emit(context, createInstruction(OPCODE_MOVSB, WIDTH_LONG, 2, eax, eax));
+		}
+		return;
+	}
+	const char * name = *lvalue->identifier;
+	Symbol * symbol = lookupSymbol(context->symbolTable, name);
+	if (constant.succeed) {
+		_emit(context, createInstruction(OPCODE_MOV, WIDTH_LONG, 2, immediateOperand(constant.value), eax));
+	}
+	else {
+		_generateExpression(context, value);
+	}
+	_storeSymbol(context, symbol, name);
+	if (symbol != NULL && (symbol->type == SYMBOL_LOCAL_VARIABLE || symbol->type == SYMBOL_PARAMETER) && !symbol->array) {
+		if (constant.succeed) {
+			_rememberConstant(context, symbol, symbol->dataType == TYPE_CHAR ? (char) constant.value : constant.value);
+		}
+		else {
+			_forgetConstant(symbol);
+		}
+	}
+}
+
+/**
+ * Generates an arithmetic operation (addition, subtraction or product), with
+ * the tile selected for it. An operand that's a constant or a variable is
+ * used directly as the source of the instruction (the left one, too, if the
+ * operation is commutative), a product by a constant is a single "imul", and
+ * a constant operation is folded. Otherwise, the right operand is spilled.
+ */
+static void _generateBinaryOperation(GeneratorContext * context, Expression * expression, const Opcode opcode) {
+	const Operand eax = registerOperand(REGISTER_RAX);
+	const Selection selection = _selectRules(context, expression, NONTERMINAL_REGISTER, _noIndex);
+	const SelectionRule * rule = selection.rules[NONTERMINAL_REGISTER];
+	Operand source;
+	switch (rule->tile) {
+		case TILE_LOAD_IMMEDIATE:
+			_emit(context, createInstruction(OPCODE_MOV, WIDTH_LONG, 2, immediateOperand(selection.value), eax));
+			return;
+		case TILE_OPERATION:
+			source = _selectedOperand(context, expression->rightExpression, rule->right);
+			_generateExpression(context, expression->leftExpression);
+			_emit(context, createInstruction(opcode, WIDTH_LONG, 2, source, eax));
+			return;
+		case TILE_SWAPPED_OPERATION:
+			source = _selectedOperand(context, expression->leftExpression, rule->left);
+			_generateExpression(context, expression->rightExpression);
+			_emit(context, createInstruction(opcode, WIDTH_LONG, 2, source, eax));
+			return;
+		case TILE_MULTIPLY_IMMEDIATE: {
+			const boolean leftFactor = rule->left == NONTERMINAL_IMMEDIATE;
+			const Operand factor = _selectedOperand(context, leftFactor ? expression->leftExpression : expression->rightExpression, NONTERMINAL_IMMEDIATE);
+			Expression * multiplicand = leftFactor ? expression->rightExpression : expression->leftExpression;
+			if ((leftFactor ? rule->right : rule->left) == NONTERMINAL_MEMORY) {
+				source = _selectedOperand(context, multiplicand, NONTERMINAL_MEMORY);
+			}
+			else {
+				_generateExpression(context, multiplicand);
+				source = eax;
+			}
+			_emit(context, createInstruction(OPCODE_IMUL, WIDTH_LONG, 3, factor, source, eax));
+			return;
+		}
+		default:
+			break;
+	}
+	if (!_simpleOperand(context, expression->rightExpression, &source)) {
+		_generateExpression(context, expression->rightExpression);
+		source = slotOperand(createSlot(&context->function->frame, 4, 4));
+		_emit(context, createInstruction(OPCODE_MOV, WIDTH_LONG, 2, eax, source));
+	}
+	_generateExpression(context, expression->leftExpression);
+	if (opcode == OPCODE_IMUL && source.type == OPERAND_IMMEDIATE) {
+		_emit(context, createInstruction(OPCODE_IMUL, WIDTH_LONG, 3, source, eax, eax));
+	}
+	else {
+		_emit(context, createInstruction(opcode, WIDTH_LONG, 2, source, eax));
+	}
+}
+
+/**
+ * Generates a block, which opens a new scope.
+ */
+static void _generateBlock(GeneratorContext * context, Block * block) {
+	beginScope(context->symbolTable);
+	_countBlock(context, block);
+	for (Statements * statements = block->statements; statements != NULL; statements = statements->next) {
+		_countBlock(context, statements->statement);
+		_generateStatement(context, statements->statement);
+	}
+	_forgetScopeConstants(context);
+	endScope(context->symbolTable);
+}
+
+/**
+ * Lowers a condition into compare-and-branch code, which jumps to the label
+ * if the condition evaluates to the specified truth value, and falls through
+ * otherwise. The logical operators never materialize a value: they become
+ * short-circuit jumps, and "!" just swaps the truth value. Leaves are folded
+ * if possible, but not the logical nodes, so each node is folded once.
+ *
+ * The known constant values after this function are valid at every jump to
+ * the label, too.
+ */
+static void _generateBranch(GeneratorContext * context, Expression * condition, const boolean jumpIfTrue, const int label) {
+	const Operand eax = registerOperand(REGISTER_RAX);
+	switch (condition->type) {
+		case EXPRESSION_PARENTHESIS:
+			_generateBranch(context, condition->singleExpression, jumpIfTrue, label);
+			return;
+		case EXPRESSION_NOT:
+			_generateBranch(context, condition->singleExpression, !jumpIfTrue, label);
+			return;
+		case EXPRESSION_AND:
+		case EXPRESSION_OR: {
+			// The left operand of "&&" decides alone when it's false, and the
+			// one of "||" when it's true. If that's not the truth value of the
+			// jump, it must skip the right operand.
+			const boolean decisive = condition->type == EXPRESSION_OR;
+			ConstantSnapshot left;
+			if (jumpIfTrue == decisive) {
+				_generateBranch(context, condition->leftExpression, jumpIfTrue, label);
+				left = _saveConstants(context);
+				_generateBranch(context, condition->rightExpression, jumpIfTrue, label);
+			}
+			else {
+				const int skipLabel = createLabel(context->function);
+				_generateBranch(context, condition->leftExpression, decisive, skipLabel);
+				left = _saveConstants(context);
+				_generateBranch(context, condition->rightExpression, jumpIfTrue, label);
+				_emitLabel(context, skipLabel);
+			}
+			_restoreConstants(context, &left);
+			_forgetAssignedInExpression(context, condition->rightExpression);
+			_releaseConstants(&left);
+			return;
+		}
+		default:
+			break;
+	}
+	const ComputationResult constant = computeExpression(condition, _resolveConstant, context);
+	if (constant.succeed) {
+		if ((constant.value != 0) == jumpIfTrue) {
+			_emit(context, createInstruction(OPCODE_JMP, WIDTH_QUAD, 1, labelOperand(label)));
+		}
+	}
+	else if (_isRelational(condition)) {
+		const Condition flags = _generateComparisonFlags(context, condition);
+		_emitCondition(context, OPCODE_JCC, jumpIfTrue ? flags : negateCondition(flags), labelOperand(label));
+	}
+	else {
+		_generateExpression(context, condition);
+		_emit(context, createInstruction(OPCODE_TEST, WIDTH_LONG, 2, eax, eax));
+		_emitCondition(context, OPCODE_JCC, jumpIfTrue ? CONDITION_NOT_EQUAL : CONDITION_EQUAL, labelOperand(label));
+	}
+}
+
+/**
+ * Generates a relational operation, which leaves 1 (true) or 0 (false) in
+ * %eax (folded, if it's constant).
+ */
+static void _generateComparison(GeneratorContext * context, Expression * expression) {
+	const Operand eax = registerOperand(REGISTER_RAX);
+	const Selection selection = _selectRules(context, expression, NONTERMINAL_REGISTER, _noIndex);
+	if (selection.rules[NONTERMINAL_REGISTER]->tile == TILE_LOAD_IMMEDIATE) {
+		_emit(context, createInstruction(OPCODE_MOV, WIDTH_LONG, 2, immediateOperand(selection.value), eax));
+		return;
+	}
+	_emitCondition(context, OPCODE_SETCC, _generateComparisonFlags(context, expression), eax);
+	_emit(context, createInstruction(OPCODE_MOVZB, WIDTH_LONG, 2, eax, eax));
+}
+
+/**
+ * Compares both operands of a relational operation, with the tile selected
+ * for it, and returns the condition that holds if it's true. A variable is
+ * compared in place with a constant, and an operand that's a constant or a
+ * variable is used directly as the source of the "cmp" (on either side, by
+ * swapping the condition). A comparison against zero becomes a "test".
+ */
+static Condition _generateComparisonFlags(GeneratorContext * context, Expression * expression) {
+	const Operand eax = registerOperand(REGISTER_RAX);
+	const SelectionRule * rule = _selectRules(context, expression, NONTERMINAL_FLAGS, _noIndex).rules[NONTERMINAL_FLAGS];
+	const Condition condition = _expressionTypeToCondition(expression->type);
+	Operand source;
+	switch (rule->tile) {
+		case TILE_COMPARE_MEMORY: {
+			const boolean leftMemory = rule->left == NONTERMINAL_MEMORY;
+			const Operand memory = _selectedOperand(context, leftMemory ? expression->leftExpression : expression->rightExpression, NONTERMINAL_MEMORY);
+			source = _selectedOperand(context, leftMemory ? expression->rightExpression : expression->leftExpression, NONTERMINAL_IMMEDIATE);
+			_emit(context, createInstruction(OPCODE_CMP, WIDTH_LONG, 2, source, memory));
+			return leftMemory ? condition : swapCondition(condition);
+		}
+		case TILE_SWAPPED_COMPARE:
+			source = _selectedOperand(context, expression->leftExpression, rule->left);
+			_generateExpression(context, expression->rightExpression);
+			_emit(context, createInstruction(OPCODE_CMP, WIDTH_LONG, 2, source, eax));
+			return swapCondition(condition);
+		case TILE_TEST:
+			_generateExpression(context, expression);
+			_emit(context, createInstruction(OPCODE_TEST, WIDTH_LONG, 2, eax, eax));
+			return CONDITION_NOT_EQUAL;
+		case TILE_COMPARE:
+			source = _selectedOperand(context, expression->rightExpression, rule->right);
+			break;
+		default:
+			_generateExpression(context, expression->rightExpression);
+			source = slotOperand(createSlot(&context->function->frame, 4, 4));
+			_emit(context, createInstruction(OPCODE_MOV, WIDTH_LONG, 2, eax, source));
+			break;
+	}
+	_generateExpression(context, expression->leftExpression);
+	if (source.type == OPERAND_IMMEDIATE && source.displacement == 0) {
+		_emit(context, createInstruction(OPCODE_TEST, WIDTH_LONG, 2, eax, eax));
+	}
+	else {
+		_emit(context, createInstruction(OPCODE_CMP, WIDTH_LONG, 2, source, eax));
+	}
+	return condition;
+}
+
+/**
+ * Generates a top-level declaration: a function definition, or a global
+ * variable (a function prototype generates nothing).
+ */
+static void _generateDeclaration(GeneratorContext * context, Declaration * declaration) {
+	exportInterfaceDeclaration(context->interfaceWriter, declaration);
+	if (declaration->declarationSuffix->type == DECLARATION_SUFFIX_FUNCTION) {
+		if (declaration->declarationSuffix->functionSuffix->type == SUFFIX_BLOCK) {
+			_generateFunction(context, declaration);
+		}
+	}
+	else {
+		_generateGlobalVariable(context, declaration);
+	}
+}
+
+/**
+ * Generates the declaration of a local variable, which reserves a new slot
+ * in the stack frame. Arrays are aligned to 16 bytes.
+ */
+static void _generateDeclarationStatement(GeneratorContext * context, Statement * statement) {
+	VariableSuffix * suffix = statement->variableSuffix;
+	const int size = statement->dataType == TYPE_CHAR ? 1 : 4;
+	ComputationResult constant = { .succeed = false, .value = 0 };
+	if (suffix->type == VARIABLE_SUFFIX_ASSIGNMENT) {
+		constant = computeExpression(suffix->expression, _resolveConstant, context);
+		if (constant.succeed) {
+			_emit(context, createInstruction(OPCODE_MOV, WIDTH_LONG, 2, immediateOperand(constant.value), registerOperand(REGISTER_RAX)));
+		}
+		else {
+			_generateExpression(context, suffix->expression);
+		}
+	}
+	Symbol * symbol = declareSymbol(context->symbolTable, *statement->identifier, SYMBOL_LOCAL_VARIABLE, statement->dataType);
+	if (suffix->type == VARIABLE_SUFFIX_ARRAY) {
+		const int arraySize = *suffix->arraySize;
+		symbol->array = true;
+		symbol->arraySize = arraySize;
+		symbol->slot = createSlot(&context->function->frame, size * (0 < arraySize ? arraySize : 1), size * arraySize < 16 ? size : 16);
+	}
+	else {
+		symbol->slot = createSlot(&context->function->frame, size, size);
+	}
+	if (suffix->type == VARIABLE_SUFFIX_ASSIGNMENT) {
+		_storeSymbol(context, symbol, symbol->name);
+		if (constant.succeed) {
+			_rememberConstant(context, symbol, statement->dataType == TYPE_CHAR ? (char) constant.value : constant.value);
+		}
+	}
+}
+
+/**
+ * Generates a division or a remainder. If the divisor is known at
+ * compile-time (even through constant propagation), the "idiv" is replaced
+ * with a cheaper sequence.
+ */
+static void _generateDivision(GeneratorContext * context, Expression * expression, const boolean remainder) {
+	const Operand eax = registerOperand(REGISTER_RAX);
+	const Operand ecx = registerOperand(REGISTER_RCX);
+	const ComputationResult divisor = computeExpression(expression->rightExpression, _resolveConstant, context);
+	Operand source;
+	if (divisor.succeed) {
+		_generateExpression(context, expression->leftExpression);
+		if (generateConstantDivision(&context->function->instructions, divisor.value, remainder)) {
+			return;
+		}
+		_emit(context, createInstruction(OPCODE_MOV, WIDTH_LONG, 2, immediateOperand(divisor.value), ecx));
+		source = ecx;
+	}
+	else {
+		if (!_simpleOperand(context, expression->rightExpression, &source)) {
+			_generateExpression(context, expression->rightExpression);
+			source = slotOperand(createSlot(&context->function->frame, 4, 4));
+			_emit(context, createInstruction(OPCODE_MOV, WIDTH_LONG, 2, eax, source));
+		}
+		_generateExpression(context, expression->leftExpression);
+	}
+	_emit(context, createInstruction(OPCODE_CONVERT, WIDTH_LONG, 0));
+	_emit(context, createInstruction(OPCODE_IDIV, WIDTH_LONG, 1, source));
+	if (remainder) {
+		_emit(context, createInstruction(OPCODE_MOV, WIDTH_LONG, 2, registerOperand(REGISTER_RDX), eax));
+	}
+}
+
+/**
+ * Computes the address of an array element (checking its bounds, if
+ * requested), and returns it as a memory operand. It can use %rcx (the
+ * index) and %rdx (the base address). Unless its bounds are checked, the
+ * constant terms and factor of the index are folded into the address (e.g.,
+ * "a[2 * i + 1]" is "4(%rdx,%rcx,8)").
+ */
+static Operand _generateElementAddress(GeneratorContext * context, const char * name, Expression * index) {
+	Symbol * symbol = lookupSymbol(context->symbolTable, name);
+	const int scale = (symbol != NULL && symbol->dataType == TYPE_CHAR) ? 1 : 4;
+	const ComputationResult constantIndex = computeExpression(index, _resolveConstant, context);
+	const Operand rdx = registerOperand(REGISTER_RDX);
+	const IndexRequirements requirements = {
+		.elementSize = scale,
+		.exact = context->boundsChecks && symbol != NULL && symbol->array && symbol->type != SYMBOL_PARAMETER && 0 < symbol->arraySize
+	};
+	long displacement = 0;
+	int factor = 1;
+	if (!constantIndex.succeed) {
+		displacement = _generateIndex(context, index, requirements, &factor);
+	}
+	_checkBounds(context, symbol, index, constantIndex);
+	Operand address;
+	if (symbol != NULL && symbol->type == SYMBOL_PARAMETER && symbol->array) {
+		_emit(context, createInstruction(OPCODE_MOV, WIDTH_QUAD, 2, slotOperand(symbol->slot), rdx));
+		address = memoryOperand(REGISTER_RDX, 0);
+	}
+	else if (symbol != NULL && (symbol->type == SYMBOL_LOCAL_VARIABLE || symbol->type == SYMBOL_PARAMETER)) {
+		address = slotOperand(symbol->slot);
+	}
+	else if (constantIndex.succeed) {
+		address = symbolMemoryOperand(name);
+	}
+	else {
+		_emit(context, createInstruction(OPCODE_LEA, WIDTH_QUAD, 2, symbolMemoryOperand(name), rdx));
+		address = memoryOperand(REGISTER_RDX, 0);
+	}
+	if (constantIndex.succeed) {
+		address.displacement += (long) constantIndex.value * scale;
+	}
+	else {
+		address.displacement += displacement * scale;
+		address.index = REGISTER_RCX;
+		address.scale = scale * factor;
+	}
+	return address;
+}
+
+/**
+ * Creates the epilogue of the generated output, which marks the stack as
+ * non-executable.
+ */
+static void _generateEpilogue(GeneratorContext * context) {
+	const char * path = getStringOrDefault("PROFILE_OUTPUT_FILE", NULL);
+	if (path != NULL && 0 < context->instrumented.count) {
+		emitCounterDump(_emitter, "profile", path, &context->instrumented, "counters", false);
+	}
+	const char * coverage = getStringOrDefault("COVERAGE_OUTPUT_FILE", NULL);
+	if (coverage != NULL && 0 < context->covered.count) {
+		emitCounterDump(_emitter, "coverage", coverage, &context->covered, "blocks", true);
+	}
+	if (context->boundsFailure) {
+		emitBoundsFailure(_emitter);
+	}
+	emit(_emitter, 1, "%s", ".section\t.note.GNU-stack,\"\",@progbits\n");
+}
+
+/**
+ * Generates an expression, leaving its value in %eax (or an address in %rax
+ * for arrays).
+ */
+static void _generateExpression(GeneratorContext * context, Expression * expression) {
+	const Operand eax = registerOperand(REGISTER_RAX);
+	switch (expression->type) {
+		case EXPRESSION_ASSIGNMENT:
+			_generateAssignment(context, expression);
+			break;
+		case EXPRESSION_AND:
+		case EXPRESSION_OR:
+			_generateLogicalOperation(context, expression);
+			break;
+		case EXPRESSION_EQUAL:
+		case EXPRESSION_NOT_EQUAL:
+		case EXPRESSION_LESS:
+		case EXPRESSION_GREATER:
+		case EXPRESSION_LESS_EQUAL:
+		case EXPRESSION_GREATER_EQUAL:
+			_generateComparison(context, expression);
+			break;
+		case EXPRESSION_ADDITION:
+			_generateBinaryOperation(context, expression, OPCODE_ADD);
+			break;
+		case EXPRESSION_SUBTRACTION:
+			_generateBinaryOperation(context, expression, OPCODE_SUB);
+			break;
+		case EXPRESSION_MULTIPLICATION:
+			_generateBinaryOperation(context, expression, OPCODE_IMUL);
+			break;
+		case EXPRESSION_DIVISION:
+			_generateDivision(context, expression, false);
+			break;
+		case EXPRESSION_MODULO:
+			_generateDivision(context, expression, true);
+			break;
+		case EXPRESSION_NOT: {
+			Expression * operand = expression->singleExpression;
+			while (operand->type == EXPRESSION_PARENTHESIS) {
+				operand = operand->singleExpression;
+			}
+			if (_isRelational(operand)) {
+				_emitCondition(context, OPCODE_SETCC, negateCondition(_generateComparisonFlags(context, operand)), eax);
+				_emit(context, createInstruction(OPCODE_MOVZB, WIDTH_LONG, 2, eax, eax));
+			}
+			else if (operand->type == EXPRESSION_AND || operand->type == EXPRESSION_OR || operand->type == EXPRESSION_NOT) {
+				_generateLogicalOperation(context, expression);
+			}
+			else {
+				_generateExpression(context, operand);
+				_emit(context, createInstruction(OPCODE_TEST, WIDTH_LONG, 2, eax, eax));
+				_emitCondition(context, OPCODE_SETCC, CONDITION_EQUAL, eax);
+				_emit(context, createInstruction(OPCODE_MOVZB, WIDTH_LONG, 2, eax, eax));
+			}
+			break;
+		}
+		case EXPRESSION_IDENTIFIER: {
+			Symbol * symbol = lookupSymbol(context->symbolTable, *expression->identifier);
+			if (symbol != NULL && symbol->constant) {
+				_emit(context, createInstruction(OPCODE_MOV, WIDTH_LONG, 2, immediateOperand(symbol->value), eax));
+			}
+			else {
+				_loadSymbol(context, symbol, *expression->identifier);
+			}
+			break;
+		}
+		case EXPRESSION_CONSTANT:
+			_emit(context, createInstruction(OPCODE_MOV, WIDTH_LONG, 2, immediateOperand(computeConstant(expression->constant).value), eax));
+			break;
+		case EXPRESSION_PARENTHESIS:
+			_generateExpression(context, expression->singleExpression);
+			break;
+		case EXPRESSION_ARRAY_ACCESS: {
+			Symbol * symbol = lookupSymbol(context->symbolTable, *expression->identifierArray);
+			const Operand address = _generateElementAddress(context, *expression->identifierArray, expression->indexExpression);
+			if (symbol != NULL && symbol->dataType == TYPE_CHAR) {
+				_emit(context, createInstruction(OPCODE_MOVSB, WIDTH_LONG, 2, address, eax));
+			}
+			else {
+				_emit(context, createInstruction(OPCODE_MOV, WIDTH_LONG, 2, address, eax));
+			}
+			break;
+		}
+		case EXPRESSION_FUNCTION_CALL:
+			_generateFunctionCall(context, expression);
+			break;
+		default:
+			logError(_logger, "The specified expression type is unknown: %d", expression->type);
+			context->compilerState->succeed = false;
+			break;
+	}
+}
+
+/**
+ * Generates a for-loop. Any of its three expressions can be missing. If it
+ * checks the bounds of its accesses before starting, there are two copies of
+ * the loop: one that trusts them, and one that checks every access, used
+ * when any of them can be out of bounds (so it fails exactly where it would
+ * without hoisting the checks).
+ */
+static void _generateFor(GeneratorContext * context, StatementFor * statement) {
+	if (statement->hasInit) {
+		_generateRootExpression(context, statement->init);
+	}
+	int checkedLabel = -1;
+	if (!_hoistBoundsChecks(context, statement, &checkedLabel)) {
+		_generateForLoop(context, statement);
+		return;
+	}
+	HoistedLoop hoisted = {
+		.loop = statement,
+		.outer = context->hoisted
+	};
+	if (checkedLabel < 0) {
+		context->hoisted = &hoisted;
+		_generateForLoop(context, statement);
+		context->hoisted = hoisted.outer;
+		return;
+	}
+	const int endLabel = createLabel(context->function);
+	ConstantSnapshot entry = _saveConstants(context);
+	context->hoisted = &hoisted;
+	_generateForLoop(context, statement);
+	context->hoisted = hoisted.outer;
+	_emit(context, createInstruction(OPCODE_JMP, WIDTH_QUAD, 1, labelOperand(endLabel)));
+	// Only the checks jump to the other copy, so the known values still hold.
+	_emit(context, createInstruction(OPCODE_LABEL, WIDTH_QUAD, 1, labelOperand(checkedLabel)));
+	_restoreConstants(context, &entry);
+	_releaseConstants(&entry);
+	++context->checkedCopies;
+	_generateForLoop(context, statement);
+	--context->checkedCopies;
+	_emitLabel(context, endLabel);
+}
+
+/**
+ * Generates a for-loop after its initialization, rotated (and unrolled) like
+ * the while-loop. With coverage, a counted loop keeps the initial value of
+ * its induction variable, and adds the times it was incremented to the
+ * counter of its body when it exits.
+ */
+static void _generateForLoop(GeneratorContext * context, StatementFor * statement) {
+	const int site = _profileSite(context, statement);
+	const boolean unrolled = shouldUnrollLoop(context->counts, site, statement->block);
+	const int bodyLabel = createLabel(context->function);
+	const int conditionLabel = createLabel(context->function);
+	const int exitLabel = unrolled ? createLabel(context->function) : -1;
+	Expression * condition = statement->hasCondition ? statement->condition : NULL;
+	Expression * update = statement->hasUpdate ? statement->update : NULL;
+	Symbol * variable = _countedLoopVariable(context, statement);
+	const Block * uncountedBlock = context->uncountedBlock;
+	const int start = variable != NULL ? _countLoopStart(context, variable, statement->block) : -1;
+	_countSite(context, site, 0);
+	ConstantSnapshot entry = _saveConstants(context);
+	_emit(context, createInstruction(OPCODE_JMP, WIDTH_QUAD, 1, labelOperand(conditionLabel)));
+	_emitLabel(context, bodyLabel);
+	_restoreConstants(context, &entry);
+	_forgetAssignedInLoop(context, condition, update, statement->block);
+	_countSite(context, site, 1);
+	_generateBlock(context, statement->block);
+	if (update != NULL) {
+		_generateRootExpression(context, update);
+	}
+	if (unrolled) {
+		if (condition != NULL) {
+			_generateBranch(context, condition, false, exitLabel);
+		}
+		_generateBlock(context, statement->block);
+		if (update != NULL) {
+			_generateRootExpression(context, update);
+		}
+	}
+	_emitLabel(context, conditionLabel);
+	_restoreConstants(context, &entry);
+	_forgetAssignedInLoop(context, condition, update, statement->block);
+	_releaseConstants(&entry);
+	if (condition != NULL) {
+		_generateBranch(context, condition, true, bodyLabel);
+	}
+	else {
+		_emit(context, createInstruction(OPCODE_JMP, WIDTH_QUAD, 1, labelOperand(bodyLabel)));
+	}
+	if (unrolled) {
+		_emitLabel(context, exitLabel);
+	}
+	if (variable != NULL) {
+		_countLoopExit(context, variable, statement->block, start);
+		context->uncountedBlock = uncountedBlock;
+	}
+}
+
+/**
+ * Lowers a function definition, and outputs it.
+ */
+static void _generateFunction(GeneratorContext * context, Declaration * declaration) {
+	AssemblyFunction * function = _lowerFunction(context, declaration);
+	_outputFunction(context, function);
+	destroyAssemblyFunction(function);
+}
+
+/**
+ * Generates a function call, which leaves the returned value in %eax. The
+ * stack is kept aligned to 16 bytes at the call instruction. A hot call to a
+ * small function of the program is inlined instead (see "shouldInlineCall"),
+ * but not with coverage, so every block is counted in its own function.
+ */
+static void _generateFunctionCall(GeneratorContext * context, Expression * expression) {
+	const char * name = *expression->identifierFunc;
+	Symbol * symbol = lookupSymbol(context->symbolTable, name);
+	int count = 0;
+	for (ListArguments * argument = expression->arguments; argument != NULL; argument = argument->next) {
+		++count;
+	}
+	if (!checkInterfaceCall(context->symbolTable, name, symbol, expression->arguments, count)) {
+		context->compilerState->succeed = false;
+	}
+	const int site = _profileSite(context, expression);
+	_countSite(context, site, 0);
+	if (!context->coverage && shouldInlineCall(context->counts, site, symbol, count, context->function->name)) {
+		_generateInlinedCall(context, expression, symbol->definition, count);
+		return;
+	}
+	const int stackArguments = count < _argumentRegisterCount ? 0 : count - _argumentRegisterCount;
+	const int padding = stackArguments % 2 == 0 ? 0 : 8;
+	const Operand rsp = registerOperand(REGISTER_RSP);
+	const Operand eax = registerOperand(REGISTER_RAX);
+	if (0 < padding) {
+		_emit(context, createInstruction(OPCODE_SUB, WIDTH_QUAD, 2, immediateOperand(padding), rsp));
+	}
+	_generateArguments(context, expression->arguments, count);
+	if (symbol == NULL || symbol->type != SYMBOL_FUNCTION || symbol->external) {
+		// The callee could be variadic, which expects the amount of vector
+		// registers used in %al.
+		_emit(context, createInstruction(OPCODE_XOR, WIDTH_LONG, 2, eax, eax));
+	}
+	_emit(context, createInstruction(OPCODE_CALL, WIDTH_QUAD, 1, symbolOperand(name)));
+	if (0 < stackArguments) {
+		_emit(context, createInstruction(OPCODE_ADD, WIDTH_QUAD, 2, immediateOperand(8 * stackArguments + padding), rsp));
+	}
+	if (symbol != NULL && symbol->type == SYMBOL_FUNCTION && symbol->dataType == TYPE_CHAR) {
+		_emit(context, createInstruction(OPCODE_MOVSB, WIDTH_LONG, 2, eax, eax));
+	}
+}
+
+/**
+ * Generates the declarations of a program, lowering its functions in many
+ * threads at the same time (see "FunctionScheduler"), while this thread
+ * outputs the declarations in order, so the output is the same as the
+ * sequential one.
+ */
+static void _generateFunctionsInParallel(GeneratorContext * context, DeclarationList * declarationList, const unsigned int functionCount) {
+	unsigned int workerCount = functionCount / _minimumFunctionsPerThread;
+	if (_generatorThreads < workerCount) {
+		workerCount = _generatorThreads;
+	}
+	// The symbol tables are copied before any worker starts, since this
+	// thread can still declare symbols in its own.
+	FunctionWorker * workers = calloc(workerCount, sizeof(FunctionWorker));
+	void ** contexts = calloc(workerCount, sizeof(void *));
+	for (unsigned int k = 0; k < workerCount; ++k) {
+		workers[k].compilerState.succeed = true;
+		workers[k].context = (GeneratorContext) {
+			.compilerState = &workers[k].compilerState,
+			.symbolTable = copyGlobalScope(context->symbolTable),
+			.profile = context->profile,
+			.instrument = context->instrument,
+			.coverage = context->coverage,
+			.boundsChecks = context->boundsChecks,
+			.cache = context->cache
+		};
+		contexts[k] = &workers[k].context;
+	}
+	logDebugging(_logger, "Lowering %u functions in %u threads...", functionCount, workerCount);
+	FunctionScheduler * scheduler = createFunctionScheduler(declarationList, contexts, workerCount, _lowerScheduledFunction);
+	unsigned int index = 0;
+	for (DeclarationList * node = declarationList; node != NULL; node = node->next) {
+		Declaration * declaration = node->declaration;
+		DeclarationSuffix * suffix = declaration->declarationSuffix;
+		exportInterfaceDeclaration(context->interfaceWriter, declaration);
+		if (suffix->type != DECLARATION_SUFFIX_FUNCTION) {
+			_generateGlobalVariable(context, declaration);
+		}
+		else if (suffix->functionSuffix->type == SUFFIX_BLOCK) {
+			AssemblyFunction * function = awaitScheduledFunction(scheduler, index++);
+			_outputFunction(context, function);
+			destroyAssemblyFunction(function);
+		}
+	}
+	destroyFunctionScheduler(scheduler);
+	for (unsigned int k = 0; k < workerCount; ++k) {
+		if (!workers[k].compilerState.succeed) {
+			context->compilerState->succeed = false;
+		}
+		destroySymbolTable(workers[k].context.symbolTable);
+		destroySymbolTable(workers[k].context.inlineScope);
+		free(workers[k].context.constants);
+	}
+	free(contexts);
+	free(workers);
+}
+
+/**
+ * Outputs a global variable. Uninitialized variables become common symbols,
+ * and the initializer of the others must be constant.
+ */
+static void _generateGlobalVariable(GeneratorContext * context, Declaration * declaration) {
+	const char * name = *declaration->identifier;
+	VariableSuffix * suffix = declaration->declarationSuffix->variableSuffix;
+	const int size = declaration->dataType == TYPE_CHAR ? 1 : 4;
+	switch (suffix->type) {
+		case VARIABLE_SUFFIX_NONE:
+			if (declaration->declarationType == DECLARATION_REGULAR) {
+				emit(_emitter, 1, ".comm\t%s,%d,%d\n", name, size, size);
+			}
+			break;
+		case VARIABLE_SUFFIX_ARRAY: {
+			if (declaration->declarationType == DECLARATION_REGULAR) {
+				const int arraySize = 0 < *suffix->arraySize ? *suffix->arraySize : 1;
+				emit(_emitter, 1, ".comm\t%s,%d,%d\n", name, size * arraySize, size * arraySize < 16 ? size : 16);
+			}
+			break;
+		}
+		case VARIABLE_SUFFIX_ASSIGNMENT: {
+			const ComputationResult initializer = computeExpression(suffix->expression, NULL, NULL);
+			if (!initializer.succeed) {
+				logError(_logger, "The initializer of the global variable \"%s\" is not a constant.", name);
+				context->compilerState->succeed = false;
+				return;
+			}
+			emit(_emitter, 1, ".globl\t%s\n", name);
+			emit(_emitter, 1, "%s", ".data\n");
+			emit(_emitter, 1, ".align\t%d\n", size);
+			emit(_emitter, 1, ".type\t%s, @object\n", name);
+			emit(_emitter, 1, ".size\t%s, %d\n", name, size);
+			emit(_emitter, 0, "%s:\n", name);
+			if (declaration->dataType == TYPE_CHAR) {
+				emit(_emitter, 1, ".byte\t%d\n", (char) initializer.value);
+			}
+			else {
+				emit(_emitter, 1, ".long\t%d\n", initializer.value);
+			}
+			break;
+		}
+	}
+}
+
+/**
+ * Generates an if-statement, with an optional else-block. With a profile,
+ * the block executed most often follows the condition (so it doesn't jump),
+ * and a block that's rarely executed is moved to the end of the function.
+ */
+static void _generateIf(GeneratorContext * context, StatementIf * statement) {
+	const int site = _profileSite(context, statement);
+	_countSite(context, site, 0);
+	const IfLayout layout = chooseIfLayout(context->counts, site, statement);
+	if (layout == IF_LAYOUT_OUTLINED && !context->outlining) {
+		_generateOutlinedIf(context, statement);
+		return;
+	}
+	const boolean inverted = layout == IF_LAYOUT_INVERTED;
+	Block * first = inverted ? statement->elseBlock : statement->thenBlock;
+	Block * second = inverted ? statement->thenBlock : statement->elseBlock;
+	const int secondLabel = createLabel(context->function);
+	_generateBranch(context, statement->condition, inverted, secondLabel);
+	ConstantSnapshot condition = _saveConstants(context);
+	_countSite(context, site, 1);
+	_generateBlock(context, first);
+	if (statement->hasElse) {
+		const int endLabel = createLabel(context->function);
+		_emit(context, createInstruction(OPCODE_JMP, WIDTH_QUAD, 1, labelOperand(endLabel)));
+		_emitLabel(context, secondLabel);
+		_restoreConstants(context, &condition);
+		_generateBlock(context, second);
+		_emitLabel(context, endLabel);
+		_restoreConstants(context, &condition);
+		_forgetAssignedInBlock(context, statement->elseBlock);
+	}
+	else {
+		_emitLabel(context, secondLabel);
+		_restoreConstants(context, &condition);
+	}
+	_forgetAssignedInBlock(context, statement->thenBlock);
+	_releaseConstants(&condition);
+}
+
+/**
+ * Generates an array index into %rcx (sign-extended), with the tile selected
+ * for it, and returns the constant folded out of it (in elements), which is
+ * added to the displacement of the address. If a constant factor is folded
+ * into its scale, it's returned too.
+ */
+static long _generateIndex(GeneratorContext * context, Expression * index, const IndexRequirements requirements, int * factor) {
+	const Operand rcx = registerOperand(REGISTER_RCX);
+	const SelectionRule * rule = _selectRules(context, index, NONTERMINAL_INDEX, requirements).rules[NONTERMINAL_INDEX];
+	while (index->type == EXPRESSION_PARENTHESIS) {
+		index = index->singleExpression;
+	}
+	switch (rule->tile) {
+		case TILE_INDEX_DISPLACEMENT: {
+			const boolean leftIndex = rule->left == NONTERMINAL_INDEX;
+			const long constant = _selectedOperand(context, leftIndex ? index->rightExpression : index->leftExpression, NONTERMINAL_IMMEDIATE).displacement;
+			const long rest = _generateIndex(context, leftIndex ? index->leftExpression : index->rightExpression, requirements, factor);
+			return index->type == EXPRESSION_SUBTRACTION ? rest - constant : rest + constant;
+		}
+		case TILE_INDEX_SCALE: {
+			const boolean leftFactor = rule->left == NONTERMINAL_IMMEDIATE;
+			Expression * scaled = leftFactor ? index->rightExpression : index->leftExpression;
+			*factor = (int) _selectedOperand(context, leftFactor ? index->leftExpression : index->rightExpression, NONTERMINAL_IMMEDIATE).displacement;
+			if ((leftFactor ? rule->right : rule->left) == NONTERMINAL_MEMORY) {
+				_emit(context, createInstruction(OPCODE_MOVSL, WIDTH_QUAD, 2, _selectedOperand(context, scaled, NONTERMINAL_MEMORY), rcx));
+			}
+			else {
+				_generateExpression(context, scaled);
+				_emit(context, createInstruction(OPCODE_MOVSL, WIDTH_QUAD, 2, registerOperand(REGISTER_RAX), rcx));
+			}
+			return 0;
+		}
+		case TILE_INDEX_SCALED_SUM: {
+			const boolean leftScaled = rule->left == NONTERMINAL_SCALED;
+			Operand sum = memoryOperand(REGISTER_RCX, 0);
+			sum.index = REGISTER_RAX;
+			sum.scale = _generateScaled(context, leftScaled ? index->leftExpression : index->rightExpression, requirements);
+			_emit(context, createInstruction(OPCODE_MOVSL, WIDTH_QUAD, 2, _selectedOperand(context, leftScaled ? index->rightExpression : index->leftExpression, NONTERMINAL_MEMORY), rcx));
+			_emit(context, createInstruction(OPCODE_LEA, WIDTH_QUAD, 2, sum, rcx));
+			return 0;
+		}
+		case TILE_INDEX_SCALED: {
+			const int scale = _generateScaled(context, index, requirements);
+			Operand scaled = memoryOperand(REGISTER_NONE, 0);
+			scaled.index = REGISTER_RAX;
+			scaled.scale = scale;
+			_emit(context, scale == 1
+				? createInstruction(OPCODE_MOV, WIDTH_QUAD, 2, registerOperand(REGISTER_RAX), rcx)
+				: createInstruction(OPCODE_LEA, WIDTH_QUAD, 2, scaled, rcx));
+			return 0;
+		}
+		case TILE_INDEX_MEMORY:
+			_emit(context, createInstruction(OPCODE_MOVSL, WIDTH_QUAD, 2, _selectedOperand(context, index, NONTERMINAL_MEMORY), rcx));
+			return 0;
+		default:
+			_generateExpression(context, index);
+			_emit(context, createInstruction(OPCODE_MOVSL, WIDTH_QUAD, 2, registerOperand(REGISTER_RAX), rcx));
+			return 0;
+	}
+}
+
+/**
+ * Generates a hot call by copying the body of the callee in place, which
+ * leaves the returned value in %eax. The arguments are evaluated first (in
+ * order), and then the body is generated in a new symbol table, with only the
+ * global symbols, where a return jumps to the end of the copy.
+ */
+static void _generateInlinedCall(GeneratorContext * context, Expression * expression, Declaration * callee, const int count) {
+	logDebugging(_logger, "Inlining a call to \"%s\" in \"%s\"...", *callee->identifier, context->function->name);
+	const Operand eax = registerOperand(REGISTER_RAX);
+	int * arguments = calloc(count, sizeof(int));
+	int k = 0;
+	for (ListArguments * argument = expression->arguments; argument != NULL; argument = argument->next, ++k) {
+		_generateRootExpression(context, argument->expression);
+		arguments[k] = createSlot(&context->function->frame, 4, 4);
+		_emit(context, createInstruction(OPCODE_MOV, WIDTH_LONG, 2, eax, slotOperand(arguments[k])));
+	}
+	SymbolTable * symbolTable = context->symbolTable;
+	ProfileSites * sites = context->sites;
+	const uint64_t * counts = context->counts;
+	RangeAnalysis * ranges = context->ranges;
+	const DataType returnType = context->returnType;
+	const int returnLabel = context->returnLabel;
+	if (context->inlineScope == NULL) {
+		context->inlineScope = copyGlobalScope(symbolTable);
+	}
+	context->symbolTable = context->inlineScope;
+	context->sites = NULL;
+	context->counts = NULL;
+	context->ranges = NULL;
+	context->returnType = callee->dataType;
+	context->returnLabel = createLabel(context->function);
+	beginScope(context->symbolTable);
+	Parameters * parameters = callee->declarationSuffix->parameters;
+	k = 0;
+	for (ParameterList * node = parameters->type == PARAMS_LIST ? parameters->list : NULL; node != NULL; node = node->next, ++k) {
+		Parameter * parameter = node->parameter;
+		const Width width = _widthOf(parameter->type);
+		Symbol * symbol = declareSymbol(context->symbolTable, *parameter->identifier, SYMBOL_PARAMETER, parameter->type);
+		symbol->slot = createSlot(&context->function->frame, width, width);
+		_emit(context, createInstruction(OPCODE_MOV, WIDTH_LONG, 2, slotOperand(arguments[k]), eax));
+		_emit(context, createInstruction(OPCODE_MOV, width, 2, eax, slotOperand(symbol->slot)));
+	}
+	_generateBlock(context, callee->declarationSuffix->functionSuffix->block);
+	_forgetScopeConstants(context);
+	endScope(context->symbolTable);
+	_emitLabel(context, context->returnLabel);
+	context->symbolTable = symbolTable;
+	context->sites = sites;
+	context->counts = counts;
+	context->ranges = ranges;
+	context->returnType = returnType;
+	context->returnLabel = returnLabel;
+	free(arguments);
+}
+
+/**
+ * Generates a logical operation ("&&", "||" or a negation of them) used as
+ * a value, which leaves 1 (true) or 0 (false) in %eax. It's lowered as
+ * a branch, so only the outcome is materialized.
+ */
+static void _generateLogicalOperation(GeneratorContext * context, Expression * expression) {
+	const int falseLabel = createLabel(context->function);
+	const int endLabel = createLabel(context->function);
+	const Operand eax = registerOperand(REGISTER_RAX);
+	_generateBranch(context, expression, false, falseLabel);
+	ConstantSnapshot outcome = _saveConstants(context);
+	_emit(context, createInstruction(OPCODE_MOV, WIDTH_LONG, 2, immediateOperand(1), eax));
+	_emit(context, createInstruction(OPCODE_JMP, WIDTH_QUAD, 1, labelOperand(endLabel)));
+	_emitLabel(context, falseLabel);
+	_emit(context, createInstruction(OPCODE_XOR, WIDTH_LONG, 2, eax, eax));
+	_emitLabel(context, endLabel);
+	_restoreConstants(context, &outcome);
+	_releaseConstants(&outcome);
+}
+
+/**
+ * Generates an if-statement (without else) whose block is rarely executed:
+ * the block is generated apart, and appended to the end of the function,
+ * from where it jumps back, so the usual path doesn't jump at all.
+ */
+static void _generateOutlinedIf(GeneratorContext * context, StatementIf * statement) {
+	const int coldLabel = createLabel(context->function);
+	const int resumeLabel = createLabel(context->function);
+	_generateBranch(context, statement->condition, true, coldLabel);
+	InstructionList instructions = context->function->instructions;
+	context->function->instructions = context->coldInstructions;
+	context->outlining = true;
+	// Only the branch jumps to the block, so the known values still hold.
+	_emit(context, createInstruction(OPCODE_LABEL, WIDTH_QUAD, 1, labelOperand(coldLabel)));
+	_generateBlock(context, statement->thenBlock);
+	_emit(context, createInstruction(OPCODE_JMP, WIDTH_QUAD, 1, labelOperand(resumeLabel)));
+	context->coldInstructions = context->function->instructions;
+	context->function->instructions = instructions;
+	context->outlining = false;
+	_emitLabel(context, resumeLabel);
+}
+
+/**
+ * Declares the parameters of a function, and copies them from the registers
+ * (or the caller frame) into their own slots.
+ */
+static void _generateParameters(GeneratorContext * context, Parameters * parameters) {
+	if (parameters->type != PARAMS_LIST) {
+		return;
+	}
+	int k = 0;
+	for (ParameterList * node = parameters->list; node != NULL; node = node->next, ++k) {
+		Parameter * parameter = node->parameter;
+		const boolean array = parameter->array->type == PARAMETER_ARRAY_BRACKETS;
+		const Width width = array ? WIDTH_QUAD : _widthOf(parameter->type);
+		Symbol * symbol = declareSymbol(context->symbolTable, *parameter->identifier, SYMBOL_PARAMETER, parameter->type);
+		symbol->array = array;
+		symbol->slot = createSlot(&context->function->frame, width, width);
+		Operand source;
+		if (k < _argumentRegisterCount) {
+			source = registerOperand(_argumentRegisters[k]);
+		}
+		else {
+			_emit(context, createInstruction(OPCODE_MOV, width, 2, memoryOperand(REGISTER_RBP, 16 + 8 * (k - _argumentRegisterCount)), registerOperand(REGISTER_RAX)));
+			source = registerOperand(REGISTER_RAX);
+		}
+		_emit(context, createInstruction(OPCODE_MOV, width, 2, source, slotOperand(symbol->slot)));
+	}
+}
+
+/**
+ * Generates the output of the program (lowering its functions in parallel,
+ * if there are enough of them). First, its types are checked, the calls to
+ * its pure functions with constant arguments are replaced by their values,
+ * and its functions are specialized for the remaining constant arguments
+ * (evaluating the calls of the clones again). Then, as a whole program, its unreachable declarations
+ * are removed (e.g., the originals of the clones, if nothing else calls
+ * them). Nothing is specialized with coverage, so every block is counted in
+ * the function of its source.
+ */
+static void _generateProgram(GeneratorContext * context, Program * program) {
+	if (program->type != PROGRAM_DECLARATIONS) {
+		return;
+	}
+	_checkProgramTypes(context, program->declarationList);
+	_evaluatePureCalls(program, true);
+	if (0 < _specializationGrowth && !context->coverage) {
+		const Specializations specializations = specializeFunctions(program, _specializationGrowth);
+		logDebugging(_logger, "Redirected %u calls to %u specialized clones.", specializations.redirected, specializations.clones);
+		if (statisticsEnabled) {
+			countNamed(STATISTICS_SPECIALIZATION, "clones", specializations.clones);
+			countNamed(STATISTICS_SPECIALIZATION, "redirectedCalls", specializations.redirected);
+		}
+		if (0 < specializations.clones) {
+			_evaluatePureCalls(program, false);
+		}
+	}
+	if (context->wholeProgram) {
+		const EliminatedDeclarations eliminated = eliminateDeadDeclarations(program, getStringOrDefault("EXPORTED_SYMBOLS", NULL));
+		logDebugging(_logger, "Removed %u unreachable functions and %u unreachable globals.", eliminated.functions, eliminated.globals);
+		if (statisticsEnabled) {
+			countNamed(STATISTICS_DEAD_DECLARATIONS, "functions", eliminated.functions);
+			countNamed(STATISTICS_DEAD_DECLARATIONS, "globals", eliminated.globals);
+		}
+	}
+	_declareGlobals(context, program->declarationList);
+	unsigned int functionCount = 0;
+	for (DeclarationList * node = program->declarationList; node != NULL; node = node->next) {
+		DeclarationSuffix * suffix = node->declaration->declarationSuffix;
+		if (suffix->type == DECLARATION_SUFFIX_FUNCTION && suffix->functionSuffix->type == SUFFIX_BLOCK) {
+			++functionCount;
+		}
+	}
+	if (1 < _generatorThreads && 2 * _minimumFunctionsPerThread <= functionCount) {
+		_generateFunctionsInParallel(context, program->declarationList, functionCount);
+		return;
+	}
+	for (DeclarationList * node = program->declarationList; node != NULL; node = node->next) {
+		_generateDeclaration(context, node->declaration);
+	}
+}
+
+/**
+ * Generates a return statement, converting the returned value to the type of
+ * the function.
+ */
+static void _generateReturn(GeneratorContext * context, StatementReturn * statement) {
+	if (statement->hasExpression) {
+		_generateRootExpression(context, statement->expression);
+		if (context->returnType == TYPE_CHAR) {
+			const Operand eax = registerOperand(REGISTER_RAX);
+			_emit(context, createInstruction(OPCODE_MOVSB, WIDTH_LONG, 2, eax, eax));
+		}
+	}
+	_emit(context, createInstruction(OPCODE_JMP, WIDTH_QUAD, 1, labelOperand(context->returnLabel)));
+}
+
+/**
+ * Generates a full expression (i.e., one that is not part of another one),
+ * folding it entirely if its value is known at compile-time.
+ */
+static void _generateRootExpression(GeneratorContext * context, Expression * expression) {
+	const ComputationResult constant = computeExpression(expression, _resolveConstant, context);
+	if (constant.succeed) {
+		_emit(context, createInstruction(OPCODE_MOV, WIDTH_LONG, 2, immediateOperand(constant.value), registerOperand(REGISTER_RAX)));
+	}
+	else {
+		_generateExpression(context, expression);
+	}
+}
+
+/**
+ * Generates a scaled part of an array index into %rax (sign-extended), with
+ * the tile selected for it: the operand times the multiplier of its factor,
+ * with an "lea". Returns the scale of the factor, which is left to the "lea"
+ * that adds the part to the rest of the index.
+ */
+static int _generateScaled(GeneratorContext * context, Expression * expression, const IndexRequirements requirements) {
+	const Operand rax = registerOperand(REGISTER_RAX);
+	const SelectionRule * rule = _selectRules(context, expression, NONTERMINAL_SCALED, requirements).rules[NONTERMINAL_SCALED];
+	while (expression->type == EXPRESSION_PARENTHESIS) {
+		expression = expression->singleExpression;
+	}
+	const boolean leftFactor = rule->left == NONTERMINAL_IMMEDIATE;
+	Expression * scaled = leftFactor ? expression->rightExpression : expression->leftExpression;
+	const int factor = (int) _selectedOperand(context, leftFactor ? expression->leftExpression : expression->rightExpression, NONTERMINAL_IMMEDIATE).displacement;
+	int multiplier = 1;
+	int scale = factor;
+	splitFactor(factor, &multiplier, &scale);
+	if ((leftFactor ? rule->right : rule->left) == NONTERMINAL_MEMORY) {
+		_emit(context, createInstruction(OPCODE_MOVSL, WIDTH_QUAD, 2, _selectedOperand(context, scaled, NONTERMINAL_MEMORY), rax));
+	}
+	else {
+		_generateExpression(context, scaled);
+		_emit(context, createInstruction(OPCODE_MOVSL, WIDTH_QUAD, 2, rax, rax));
+	}
+	if (1 < multiplier) {
+		Operand product = memoryOperand(REGISTER_RAX, 0);
+		product.index = REGISTER_RAX;
+		product.scale = multiplier - 1;
+		_emit(context, createInstruction(OPCODE_LEA, WIDTH_QUAD, 2, product, rax));
+	}
+	return scale;
+}
+
+/**
+ * Generates a statement.
+ */
+static void _generateStatement(GeneratorContext * context, Statement * statement) {
+	switch (statement->type) {
+		case STATEMENT_DECLARATION:
+			_generateDeclarationStatement(context, statement);
+			break;
+		case STATEMENT_IF:
+			_generateIf(context, statement->statementIf);
+			break;
+		case STATEMENT_WHILE:
+			_generateWhile(context, statement->statementWhile);
+			break;
+		case STATEMENT_FOR:
+			_generateFor(context, statement->statementFor);
+			break;
+		case STATEMENT_RETURN:
+			_generateReturn(context, statement->statementReturn);
+			break;
+		case STATEMENT_EXPRESSION:
+			_generateRootExpression(context, statement->statementExpression->expression);
+			break;
+		case STATEMENT_BLOCK:
+			_generateBlock(context, statement->block);
+			break;
+		case STATEMENT_EMPTY:
+			break;
+	}
+}
+
+/**
+ * Generates a while-loop. It's rotated, so the condition is checked at the
+ * bottom, and each iteration runs a single compare-and-branch sequence. A
+ * hot loop is unrolled: its body is copied, with the condition checked in
+ * between, so each jump back runs two iterations. With coverage, a counted
+ * loop counts its body when it exits, as a counted for-loop does.
+ */
+static void _generateWhile(GeneratorContext * context, StatementWhile * statement) {
+	const int site = _profileSite(context, statement);
+	const boolean unrolled = shouldUnrollLoop(context->counts, site, statement->block);
+	const int bodyLabel = createLabel(context->function);
+	const int conditionLabel = createLabel(context->function);
+	const int exitLabel = unrolled ? createLabel(context->function) : -1;
+	Symbol * variable = _countedWhileVariable(context, statement);
+	const Block * uncountedBlock = context->uncountedBlock;
+	const int start = variable != NULL ? _countLoopStart(context, variable, statement->block) : -1;
+	_countSite(context, site, 0);
+	ConstantSnapshot entry = _saveConstants(context);
+	_emit(context, createInstruction(OPCODE_JMP, WIDTH_QUAD, 1, labelOperand(conditionLabel)));
+	_emitLabel(context, bodyLabel);
+	_restoreConstants(context, &entry);
+	_forgetAssignedInLoop(context, statement->condition, NULL, statement->block);
+	_countSite(context, site, 1);
+	_generateBlock(context, statement->block);
+	if (unrolled) {
+		_generateBranch(context, statement->condition, false, exitLabel);
+		_generateBlock(context, statement->block);
+	}
+	_emitLabel(context, conditionLabel);
+	_restoreConstants(context, &entry);
+	_forgetAssignedInLoop(context, statement->condition, NULL, statement->block);
+	_releaseConstants(&entry);
+	_generateBranch(context, statement->condition, true, bodyLabel);
+	if (unrolled) {
+		_emitLabel(context, exitLabel);
+	}
+	if (variable != NULL) {
+		_countLoopExit(context, variable, statement->block, start);
+		context->uncountedBlock = uncountedBlock;
+	}
+}
+
+/**
+ * Checks the bounds of the accesses of a canonical for-loop once, before it
+ * starts (see "planHoistedBoundsChecks"). Returns true if the loop checks
+ * them (leaving the label where any failed check jumps, or -1 if they're all
+ * known to pass), or false if its accesses must be checked one by one (or
+ * there's nothing to check).
+ */
+static boolean _hoistBoundsChecks(GeneratorContext * context, StatementFor * statement, int * checkedLabel) {
+	HoistedBounds bounds;
+	if (!context->boundsChecks || !planHoistedBoundsChecks(context->ranges, context->symbolTable, statement, _resolveConstant, context, &bounds)) {
+		return false;
+	}
+	const RangeLoop * loop = rangeLoop(context->ranges, statement);
+	*checkedLabel = bounds.checkLower || bounds.checkUpper ? createLabel(context->function) : -1;
+	const Operand eax = registerOperand(REGISTER_RAX);
+	if (bounds.checkLower) {
+		_generateExpression(context, loop->variable);
+		_emit(context, createInstruction(OPCODE_CMP, WIDTH_LONG, 2, immediateOperand((long) bounds.lower), eax));
+		_emitCondition(context, OPCODE_JCC, CONDITION_LESS, labelOperand(*checkedLabel));
+	}
+	if (bounds.checkUpper) {
+		_generateExpression(context, loop->bound);
+		_emit(context, createInstruction(OPCODE_CMP, WIDTH_LONG, 2, immediateOperand((long) bounds.upper), eax));
+		_emitCondition(context, OPCODE_JCC, CONDITION_GREATER, labelOperand(*checkedLabel));
+	}
+	return true;
+}
+
+/**
+ * Maps the interface summaries in a list of paths separated by colons, and
+ * registers their symbols. A summary that cannot be loaded fails the
+ * generation.
+ */
+static void _loadInterfaces(GeneratorContext * context, const char * paths) {
+	char * list = strdup(paths);
+	char * state = NULL;
+	for (char * path = strtok_r(list, ":", &state); path != NULL; path = strtok_r(NULL, ":", &state)) {
+		InterfaceSummary * summary = loadInterfaceSummary(path);
+		if (summary == NULL) {
+			logError(_logger, "The interface summary \"%s\" cannot be loaded.", path);
+			context->compilerState->succeed = false;
+			continue;
+		}
+		context->interfaces = realloc(context->interfaces, (context->interfaceCount + 1) * sizeof(InterfaceSummary *));
+		context->interfaces[context->interfaceCount++] = summary;
+		declareInterfaceSymbols(context->symbolTable, summary);
+	}
+	free(list);
+}
+
+/**
+ * Loads the value of a variable in %eax (sign-extending characters), or its
+ * address in %rax if it's an array. Unknown identifiers are assumed to be
+ * external integers.
+ */
+static void _loadSymbol(GeneratorContext * context, Symbol * symbol, const char * name) {
+	const Operand rax = registerOperand(REGISTER_RAX);
+	if (symbol == NULL) {
+		logDebugging(_logger, "The identifier \"%s\" is undeclared, and it's assumed to be an external integer.", name);
+	}
+	else if (symbol->array) {
+		if (symbol->type == SYMBOL_PARAMETER) {
+			_emit(context, createInstruction(OPCODE_MOV, WIDTH_QUAD, 2, slotOperand(symbol->slot), rax));
+		}
+		else {
+			_emit(context, createInstruction(OPCODE_LEA, WIDTH_QUAD, 2, _storageOperand(symbol, name), rax));
+		}
+		return;
+	}
+	else if (symbol->dataType == TYPE_CHAR) {
+		_emit(context, createInstruction(OPCODE_MOVSB, WIDTH_LONG, 2, _storageOperand(symbol, name), rax));
+		return;
+	}
+	_emit(context, createInstruction(OPCODE_MOV, WIDTH_LONG, 2, _storageOperand(symbol, name), rax));
+}
+
+/**
+ * Lowers a function definition into a new assembly function, optimized and
+ * ready to output. It only reads the global symbols (the locals are declared
+ * in a scope of its own), so many functions can be lowered at the same time,
+ * each one with its own context.
+ */
+static AssemblyFunction * _lowerFunction(GeneratorContext * context, Declaration * declaration) {
+	const char * name = *declaration->identifier;
+	logDebugging(_logger, "Generating function \"%s\"...", name);
+	AssemblyFunction * function = createAssemblyFunction(name);
+	function->local = declaration->declarationType == DECLARATION_INTERNAL;
+	uint64_t key = 0;
+	if (context->cache != NULL) {
+		key = functionCacheKey(context->cache, declaration, context->symbolTable);
+		const boolean cached = loadCachedAssemblyFunction(context->cache, key, function);
+		if (statisticsEnabled) {
+			countNamed(STATISTICS_FUNCTION_CACHE, cached ? "hits" : "misses", 1);
+		}
+		if (cached) {
+			logDebugging(_logger, "The function \"%s\" is in the cache.", name);
+			return function;
+		}
+	}
+	const boolean succeed = context->compilerState->succeed;
+	context->function = function;
+	context->returnType = declaration->dataType;
+	context->returnLabel = createLabel(function);
+	if (context->instrument || context->profile != NULL || context->coverage) {
+		context->sites = createProfileSites(declaration);
+		if (context->instrument) {
+			if (0 < context->sites->counterCount) {
+				function->counters = calloc(strlen(name) + 12, sizeof(char));
+				sprintf(function->counters, ".Lcounters.%s", name);
+			}
+			function->counterCount = context->sites->counterCount;
+			function->profileHash = context->sites->hash;
+		}
+		else if (context->profile != NULL) {
+			context->counts = profileCounters(context->profile, name, context->sites->hash, context->sites->counterCount);
+		}
+		if (context->coverage) {
+			function->blocks = calloc(strlen(name) + 10, sizeof(char));
+			sprintf(function->blocks, ".Lblocks.%s", name);
+			function->blockCounterCount = context->sites->blockCounterCount;
+			function->blockCount = context->sites->blockCount;
+			function->blockLines = calloc(function->blockCount, sizeof(unsigned int));
+			function->blockCounters = calloc(function->blockCount, sizeof(int));
+			function->blockAdded = calloc(function->blockCount, sizeof(int));
+			function->blockSubtracted = calloc(function->blockCount, sizeof(int));
+			memcpy(function->blockLines, context->sites->lines, function->blockCount * sizeof(unsigned int));
+			memcpy(function->blockCounters, context->sites->blockCounters, function->blockCount * sizeof(int));
+			memcpy(function->blockAdded, context->sites->blockAdded, function->blockCount * sizeof(int));
+			memcpy(function->blockSubtracted, context->sites->blockSubtracted, function->blockCount * sizeof(int));
+		}
+	}
+	context->boundsLabel = -1;
+	if (context->boundsChecks || context->coverage) {
+		context->ranges = analyzeRanges(declaration);
+	}
+	beginScope(context->symbolTable);
+	_generateParameters(context, declaration->declarationSuffix->parameters);
+	_generateBlock(context, declaration->declarationSuffix->functionSuffix->block);
+	_forgetScopeConstants(context);
+	endScope(context->symbolTable);
+	if (strcmp(name, "main") == 0) {
+		const Operand eax = registerOperand(REGISTER_RAX);
+		_emit(context, createInstruction(OPCODE_XOR, WIDTH_LONG, 2, eax, eax));
+	}
+	_emitLabel(context, context->returnLabel);
+	_emit(context, createInstruction(OPCODE_LEAVE, WIDTH_QUAD, 0));
+	_emit(context, createInstruction(OPCODE_RET, WIDTH_QUAD, 0));
+	_appendColdInstructions(context);
+	if (0 <= context->boundsLabel) {
+		_emit(context, createInstruction(OPCODE_LABEL, WIDTH_QUAD, 1, labelOperand(context->boundsLabel)));
+		_emit(context, createInstruction(OPCODE_CALL, WIDTH_QUAD, 1, symbolOperand(".Lbounds.fail")));
+		function->boundsChecked = true;
+	}
+	destroyRangeAnalysis(context->ranges);
+	context->ranges = NULL;
+	destroyProfileSites(context->sites);
+	context->sites = NULL;
+	context->counts = NULL;
+	threadJumps(function);
+	optimizePeepholes(&function->instructions);
+	// Removing a store can leave its source dead, which can make another store dead.
+	for (int pass = 0; pass < _maximumDeadStorePasses && 0 < eliminateDeadStores(function); ++pass) {
+		optimizePeepholes(&function->instructions);
+	}
+	colorStackSlots(function);
+	layoutStackFrame(&function->frame);
+	// The prologue is inserted last, once the size of the frame is known.
+	const Operand rbp = registerOperand(REGISTER_RBP);
+	const Operand rsp = registerOperand(REGISTER_RSP);
+	Instruction * body = function->instructions.first;
+	insertInstructionBefore(&function->instructions, body, createInstruction(OPCODE_PUSH, WIDTH_QUAD, 1, rbp));
+	insertInstructionBefore(&function->instructions, body, createInstruction(OPCODE_MOV, WIDTH_QUAD, 2, rsp, rbp));
+	if (0 < function->frame.size) {
+		insertInstructionBefore(&function->instructions, body, createInstruction(OPCODE_SUB, WIDTH_QUAD, 2, immediateOperand(function->frame.size), rsp));
+	}
+	context->function = NULL;
+	// A function with errors is never stored, so a key in the cache has none.
+	if (context->cache != NULL && succeed && context->compilerState->succeed) {
+		if (!storeCachedAssemblyFunction(context->cache, key, function, _indentationCharacter, _indentationSize)) {
+			logDebugging(_logger, "The function \"%s\" cannot be stored in the cache.", name);
+		}
+	}
+	return function;
+}
+
+/**
+ * Lowers a function definition with the context of a worker of the
+ * scheduler.
+ */
+static AssemblyFunction * _lowerScheduledFunction(void * worker, Declaration * declaration) {
+	return _lowerFunction(worker, declaration);
+}
+
+/**
+ * Outputs a lowered function, one instruction per line (or its text, if it's
+ * in the function cache).
+ */
+static void _outputFunction(GeneratorContext * context, AssemblyFunction * function) {
+	context->boundsFailure = context->boundsFailure || function->boundsChecked;
+	if (function->text != NULL) {
+		emitText(_emitter, 0, function->text, function->textLength);
+	}
+	else {
+		emit(_emitter, 1, "%s", ".text\n");
+		if (!function->local) {
+			emit(_emitter, 1, ".globl\t%s\n", function->name);
+		}
+		emit(_emitter, 1, ".type\t%s, @function\n", function->name);
+		emit(_emitter, 0, "%s:\n", function->name);
+		// The instructions are formatted in place, right after their indentation.
+		const size_t guess = 128;
+		for (Instruction * instruction = function->instructions.first; instruction != NULL; instruction = instruction->next) {
+			const unsigned int indentationLevel = instruction->opcode == OPCODE_LABEL ? 0 : 1;
+			const size_t prefix = indentationLevel * _indentationSize;
+			char * buffer = reserveEmitterSpace(_emitter, prefix + guess);
+			int length = formatInstruction(buffer + prefix, guess, function, instruction);
+			if (guess <= (size_t) length) {
+				buffer = reserveEmitterSpace(_emitter, prefix + length + 1);
+				formatInstruction(buffer + prefix, length + 1, function, instruction);
+			}
+			memset(buffer, _indentationCharacter, prefix);
+			buffer[prefix + length] = '\n';
+			commitEmitterSpace(_emitter, prefix + length + 1);
+		}
+		emit(_emitter, 1, ".size\t%s, .-%s\n", function->name, function->name);
+	}
+	emitFunctionCounters(_emitter, function);
+	if (function->blocks != NULL) {
+		addInstrumentedFunction(&context->covered, function->name, function->blockLines[0], function->blockCount);
+	}
+	if (context->instrument) {
+		addInstrumentedFunction(&context->instrumented, function->name, function->profileHash, function->counterCount);
+	}
+}
+
+/**
+ * The first counter of a profiling site of the function being lowered, or
+ * -1 if there are no sites (as in an inlined call).
+ */
+static int _profileSite(GeneratorContext * context, const void * node) {
+	return context->sites == NULL ? -1 : profileSite(context->sites, node);
+}
+
+/**
+ * Releases a snapshot of the known constant values.
+ */
+static void _releaseConstants(ConstantSnapshot * snapshot) {
+	free(snapshot->symbols);
+	free(snapshot->values);
+}
+
+/**
+ * Records that a symbol holds a known constant value from now on.
+ */
+static void _rememberConstant(GeneratorContext * context, Symbol * symbol, const int value) {
+	if (!symbol->constant) {
+		if (context->constantCount == context->constantCapacity) {
+			context->constantCapacity = context->constantCapacity == 0 ? 16 : 2 * context->constantCapacity;
+			context->constants = realloc(context->constants, context->constantCapacity * sizeof(Symbol *));
+		}
+		context->constants[context->constantCount++] = symbol;
+	}
+	symbol->constant = true;
+	symbol->value = value;
+}
+
+/**
+ * The identifier resolver used to propagate constants into the calculator.
+ */
+static ComputationResult _resolveConstant(void * context, const char * identifier) {
+	GeneratorContext * generatorContext = context;
+	Symbol * symbol = lookupSymbol(generatorContext->symbolTable, identifier);
+	ComputationResult result = {
+		.succeed = symbol != NULL && symbol->constant,
+		.value = symbol == NULL ? 0 : symbol->value
+	};
+	return result;
+}
+
+/**
+ * Replaces the known constant values with the ones of a snapshot, whose
+ * symbols must still be in scope.
+ */
+static void _restoreConstants(GeneratorContext * context, const ConstantSnapshot * snapshot) {
+	_forgetConstants(context);
+	for (int k = 0; k < snapshot->count; ++k) {
+		_rememberConstant(context, snapshot->symbols[k], snapshot->values[k]);
+	}
+}
+
+/**
+ * True if a block (or the ones nested in it) has a return statement.
+ */
+static boolean _returnsInBlock(const Block * block) {
+	for (const Statements * statements = block->statements; statements != NULL; statements = statements->next) {
+		const Statement * statement = statements->statement;
+		switch (statement->type) {
+			case STATEMENT_RETURN:
+				return true;
+			case STATEMENT_IF:
+				if (_returnsInBlock(statement->statementIf->thenBlock)
+						|| (statement->statementIf->hasElse && _returnsInBlock(statement->statementIf->elseBlock))) {
+					return true;
+				}
+				break;
+			case STATEMENT_WHILE:
+				if (_returnsInBlock(statement->statementWhile->block)) {
+					return true;
+				}
+				break;
+			case STATEMENT_FOR:
+				if (_returnsInBlock(statement->statementFor->block)) {
+					return true;
+				}
+				break;
+			case STATEMENT_BLOCK:
+				if (_returnsInBlock(statement->block)) {
+					return true;
+				}
+				break;
+			default:
+				break;
+		}
+	}
+	return false;
+}
+
+/**
+ * Copies the known constant values at the current point of the code.
+ */
+static ConstantSnapshot _saveConstants(GeneratorContext * context) {
+	ConstantSnapshot snapshot = {
+		.symbols = calloc(context->constantCount, sizeof(Symbol *)),
+		.values = calloc(context->constantCount, sizeof(int)),
+		.count = 0
+	};
+	for (int k = 0; k < context->constantCount; ++k) {
+		Symbol * symbol = context->constants[k];
+		if (symbol->constant) {
+			snapshot.symbols[snapshot.count] = symbol;
+			snapshot.values[snapshot.count++] = symbol->value;
+		}
+	}
+	return snapshot;
+}
+
+/**
+ * Labels an expression for the instruction selector, and counts the rule
+ * that derives the goal, which is reduced next.
+ */
+static Selection _selectRules(GeneratorContext * context, Expression * expression, const Nonterminal goal, const IndexRequirements requirements) {
+	const Selection selection = selectInstructions(expression, requirements, _classifyLeaf, context);
+	if (statisticsEnabled && context->checkedCopies == 0) {
+		countNamed(STATISTICS_INSTRUCTION_SELECTION, selection.rules[goal]->name, 1);
+	}
+	return selection;
+}
+
+/**
+ * The source operand of an expression that the selected rule derives as an
+ * immediate (its value, which can be folded), or as memory (the variable).
+ */
+static Operand _selectedOperand(GeneratorContext * context, Expression * expression, const Nonterminal nonterminal) {
+	if (nonterminal == NONTERMINAL_IMMEDIATE) {
+		return immediateOperand(selectInstructions(expression, _noIndex, _classifyLeaf, context).value);
+	}
+	Operand operand;
+	_simpleOperand(context, expression, &operand);
+	return operand;
+}
+
+/**
+ * Checks if an expression can be used directly as the source operand of an
+ * instruction, that is, if it's a constant or an integer variable.
+ */
+static boolean _simpleOperand(GeneratorContext * context, Expression * expression, Operand * operand) {
+	while (expression->type == EXPRESSION_PARENTHESIS) {
+		expression = expression->singleExpression;
+	}
+	if (expression->type == EXPRESSION_CONSTANT) {
+		*operand = immediateOperand(computeConstant(expression->constant).value);
+		return true;
+	}
+	if (expression->type != EXPRESSION_IDENTIFIER) {
+		return false;
+	}
+	Symbol * symbol = lookupSymbol(context->symbolTable, *expression->identifier);
+	if (symbol != NULL && symbol->constant) {
+		*operand = immediateOperand(symbol->value);
+		return true;
+	}
+	if (symbol != NULL && (symbol->array || symbol->dataType == TYPE_CHAR || symbol->type == SYMBOL_FUNCTION)) {
+		return false;
+	}
+	*operand = _storageOperand(symbol, *expression->identifier);
+	return true;
+}
+
+/**
+ * The memory operand where the value of a variable is stored.
+ */
+static Operand _storageOperand(Symbol * symbol, const char * name) {
+	if (symbol != NULL && (symbol->type == SYMBOL_LOCAL_VARIABLE || symbol->type == SYMBOL_PARAMETER)) {
+		return slotOperand(symbol->slot);
+	}
+	return symbolMemoryOperand(symbol == NULL ? name : symbol->name);
+}
+
+/**
+ * Stores %eax (or %al for characters) into a variable. If the value is
+ * a character, %eax is also sign-extended, because that's the value of the
+ * assignment.
+ */
+static void _storeSymbol(GeneratorContext * context, Symbol * symbol, const char * name) {
+	const Operand eax = registerOperand(REGISTER_RAX);
+	if (symbol != NULL && symbol->dataType == TYPE_CHAR && !symbol->array) {
+		_emit(context, createInstruction(OPCODE_MOV, WIDTH_BYTE, 2, eax, _storageOperand(symbol, name)));
+		_emit(context, createInstruction(OPCODE_MOVSB, WIDTH_LONG, 2, eax, eax));
+	}
+	else {
+		_emit(context, createInstruction(OPCODE_MOV, WIDTH_LONG, 2, eax, _storageOperand(symbol, name)));
+	}
+}
+
+/**
+ * The width of a scalar value of the specified type.
+ */
+static Width _widthOf(const DataType dataType) {
+	return dataType == TYPE_CHAR ? WIDTH_BYTE : WIDTH_LONG;
+}
+
+/** PUBLIC FUNCTIONS */
+
+boolean beginGeneration(CompilerState * compilerState) {
+	logDebugging(_logger, "Generating final output...");
+	_context = (GeneratorContext) {
+		.compilerState = compilerState,
+		.symbolTable = createSymbolTable(),
+		.function = NULL,
+		.constants = NULL,
+		.constantCount = 0,
+		.constantCapacity = 0,
+		.interfaces = NULL,
+		.interfaceCount = 0,
+		.interfaceWriter = NULL,
+		.profile = NULL,
+		.instrument = false,
+		.sites = NULL,
+		.counts = NULL,
+		.outlining = false,
+		.instrumented = {
+			.functions = NULL,
+			.count = 0,
+			.capacity = 0
+		},
+		.coverage = false,
+		.covered = {
+			.functions = NULL,
+			.count = 0,
+			.capacity = 0
+		},
+		.boundsChecks = false,
+		.ranges = NULL,
+		.boundsLabel = -1,
+		.hoisted = NULL,
+		.checkedCopies = 0,
+		.boundsFailure = false,
+		.cache = NULL,
+		.wholeProgram = false
+	};
+	const char * path = getStringOrDefault("OUTPUT_FILE", NULL);
+	_emitter = path == NULL
+		? createEmitter(STDOUT_FILENO, _indentationCharacter, _indentationSize)
+		: createMappedEmitter(path, _indentationCharacter, _indentationSize);
+	if (_emitter == NULL) {
+		compilerState->succeed = false;
+		destroySymbolTable(_context.symbolTable);
+		_context.symbolTable = NULL;
+		return false;
+	}
+	const char * interfaces = getStringOrDefault("INTERFACE_FILES", NULL);
+	if (interfaces != NULL) {
+		_loadInterfaces(&_context, interfaces);
+	}
+	if (getStringOrDefault("INTERFACE_OUTPUT_FILE", NULL) != NULL) {
+		_context.interfaceWriter = createInterfaceWriter();
+	}
+	_context.coverage = getStringOrDefault("COVERAGE_OUTPUT_FILE", NULL) != NULL;
+	_context.boundsChecks = getBooleanOrDefault("BOUNDS_CHECKS", false);
+	_context.wholeProgram = getBooleanOrDefault("WHOLE_PROGRAM", false);
+	const char * profile = getStringOrDefault("PROFILE_FILE", NULL);
+	_context.instrument = getStringOrDefault("PROFILE_OUTPUT_FILE", NULL) != NULL;
+	if (profile != NULL && !_context.instrument) {
+		_context.profile = loadProfile(profile);
+		if (_context.profile == NULL) {
+			logError(_logger, "The profile \"%s\" cannot be read.", profile);
+			compilerState->succeed = false;
+		}
+	}
+	const char * cache = getStringOrDefault("FUNCTION_CACHE_DIRECTORY", NULL);
+	if (cache != NULL && !_context.instrument && profile == NULL && !_context.coverage) {
+		_context.cache = openFunctionCache(cache, _context.boundsChecks ? 1 : 0);
+		if (_context.cache == NULL) {
+			logDebugging(_logger, "The function cache \"%s\" cannot be used.", cache);
+		}
+	}
+	return true;
+}
+
+void endGeneration() {
+	_generateEpilogue(&_context);
+	if (!destroyEmitter(_emitter)) {
+		_context.compilerState->succeed = false;
+	}
+	_emitter = NULL;
+	const char * interface = getStringOrDefault("INTERFACE_OUTPUT_FILE", NULL);
+	if (_context.interfaceWriter != NULL && _context.compilerState->succeed && !writeInterfaceSummary(_context.interfaceWriter, interface)) {
+		logError(_logger, "The interface summary \"%s\" cannot be written.", interface);
+		_context.compilerState->succeed = false;
+	}
+	destroyInterfaceWriter(_context.interfaceWriter);
+	destroySymbolTable(_context.symbolTable);
+	destroySymbolTable(_context.inlineScope);
+	for (int k = 0; k < _context.interfaceCount; ++k) {
+		unloadInterfaceSummary(_context.interfaces[k]);
+	}
+	free(_context.interfaces);
+	free(_context.constants);
+	destroyProfile(_context.profile);
+	closeFunctionCache(_context.cache);
+	releaseInstrumentedFunctions(&_context.instrumented);
+	releaseInstrumentedFunctions(&_context.covered);
+	_context = (GeneratorContext) { .compilerState = NULL };
+	logDebugging(_logger, "Generation is done.");
+}
+
+void generate(CompilerState * compilerState) {
+	if (beginGeneration(compilerState)) {
+		_generateProgram(&_context, compilerState->abstractSyntaxtTree);
+		endGeneration();
+	}
+}
+
+void generateDeclaration(void * declaration) {
+	_declareGlobal(&_context, declaration);
+	if (!checkFunctionTypes(_context.symbolTable, declaration)) {
+		_context.compilerState->succeed = false;
+	}
+	_generateDeclaration(&_context, declaration);
+}
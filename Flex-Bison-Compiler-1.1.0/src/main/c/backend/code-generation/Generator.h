@@ -1,22 +1,69 @@
-//#ifndef GENERATOR_HEADER
-//#define GENERATOR_HEADER
-//
-//#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
-//#include "../../shared/CompilerState.h"
-//#include "../../shared/Logger.h"
-//#include "../../shared/String.h"
-//#include <stdarg.h>
-//#include <stdio.h>
-//
-///** Initialize module's internal state. */
-//void initializeGeneratorModule();
-//
-///** Shutdown module's internal state. */
-//void shutdownGeneratorModule();
-//
-///**
-// * Generates the final output using the current compiler state.
-// */
-//void generate(CompilerState * compilerState);
-//
-//#endif
+#ifndef GENERATOR_HEADER
+#define GENERATOR_HEADER
+
+#include "../../frontend/semantic-analysis/InterfaceResolver.h"
+#include "../../frontend/semantic-analysis/SymbolTable.h"
+#include "../../frontend/semantic-analysis/TypeChecker.h"
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/CompilerState.h"
+#include "../../shared/Environment.h"
+#include "../../shared/Logger.h"
+#include "../../shared/String.h"
+#include "../domain-specific/Calculator.h"
+#include "../domain-specific/Evaluator.h"
+#include "../optimization/BoundsChecks.h"
+#include "../optimization/DeadDeclarationElimination.h"
+#include "../optimization/DeadStoreElimination.h"
+#include "../optimization/Instrumentation.h"
+#include "../optimization/JumpThreading.h"
+#include "../optimization/Peephole.h"
+#include "../optimization/Profile.h"
+#include "../optimization/ProfileGuided.h"
+#include "../optimization/RangeAnalysis.h"
+#include "../optimization/Specialization.h"
+#include "../optimization/StackSlotColoring.h"
+#include "../optimization/StrengthReduction.h"
+#include "Assembly.h"
+#include "Emitter.h"
+#include "FunctionCache.h"
+#include "FunctionScheduler.h"
+#include "InstructionSelector.h"
+#include <stdarg.h>
+#include <stdio.h>
+
+/** Initialize module's internal state. */
+void initializeGeneratorModule();
+
+/** Shutdown module's internal state. */
+void shutdownGeneratorModule();
+
+/**
+ * Generates the final output using the current compiler state, that is, an
+ * x86-64 assembly (GNU as, AT&T syntax) for the System V ABI, in the standard
+ * output (or in the file named by the "OUTPUT_FILE" environment variable).
+ * If the program cannot be translated, the compiler state is flagged as
+ * failed. The interface summaries in "INTERFACE_FILES" are loaded first, and
+ * the definitions of the program are exported to "INTERFACE_OUTPUT_FILE", if
+ * defined (see "InterfaceSummary.h"). The functions are lowered by up to
+ * "GENERATOR_THREADS" threads, but they're output in order. The functions
+ * that didn't change since a previous compilation are loaded from the cache
+ * in "FUNCTION_CACHE_DIRECTORY", if defined (see "FunctionCache.h"). With
+ * "WHOLE_PROGRAM", the declarations that aren't reachable from "main" (or
+ * from "EXPORTED_SYMBOLS") are removed from the program first. The calls to
+ * its pure functions with constant arguments are replaced by their values
+ * (see "Evaluator.h"), within "EVALUATION_STEPS" each.
+ */
+void generate(CompilerState * compilerState);
+
+/**
+ * Generates the output one top-level declaration at a time, as they are
+ * parsed (see "declarationConsumer"): begins the output (returning false if
+ * it cannot be created), generates each declaration as soon as it's handed,
+ * and ends the output. Only the global symbols are kept between declarations,
+ * so a declaration is only visible after it (as in C).
+ */
+boolean beginGeneration(CompilerState * compilerState);
+void generateDeclaration(void * declaration);
+void endGeneration();
+
+#endif
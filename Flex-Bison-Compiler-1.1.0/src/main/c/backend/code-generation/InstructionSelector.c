@@ -0,0 +1,274 @@
+#include "InstructionSelector.h"
+
+/* MODULE INTERNAL STATE */
+
+/**
+ * The sets of operators of the rules.
+ */
+typedef enum {
+	OPERATORS_LEAVES = (1u << EXPRESSION_CONSTANT) | (1u << EXPRESSION_IDENTIFIER),
+	OPERATORS_ADDITION = 1u << EXPRESSION_ADDITION,
+	OPERATORS_ADDITIVE = (1u << EXPRESSION_ADDITION) | (1u << EXPRESSION_SUBTRACTION),
+	OPERATORS_MULTIPLICATION = 1u << EXPRESSION_MULTIPLICATION,
+	OPERATORS_RELATIONAL = (1u << EXPRESSION_EQUAL) | (1u << EXPRESSION_NOT_EQUAL) | (1u << EXPRESSION_LESS)
+		| (1u << EXPRESSION_LESS_EQUAL) | (1u << EXPRESSION_GREATER) | (1u << EXPRESSION_GREATER_EQUAL),
+	OPERATORS_FOLDABLE = OPERATORS_ADDITIVE | OPERATORS_MULTIPLICATION | OPERATORS_RELATIONAL
+		| (1u << EXPRESSION_DIVISION) | (1u << EXPRESSION_MODULO),
+	OPERATORS_OPAQUE = (1u << EXPRESSION_ASSIGNMENT) | (1u << EXPRESSION_AND) | (1u << EXPRESSION_OR)
+		| (1u << EXPRESSION_NOT) | (1u << EXPRESSION_ARRAY_ACCESS) | (1u << EXPRESSION_FUNCTION_CALL)
+		| (1u << EXPRESSION_DIVISION) | (1u << EXPRESSION_MODULO)
+} OperatorSet;
+
+/**
+ * The operators whose operands are labeled (the ones the grammar covers, or
+ * that can be folded).
+ */
+static const unsigned int _labeledOperators = OPERATORS_FOLDABLE;
+
+/**
+ * The cost of an expression that the generator computes on its own (e.g., a
+ * call), and the depth below which the expressions aren't labeled (so they
+ * cost that much).
+ */
+static const unsigned int _opaqueCost = 4;
+static const unsigned int _maximumDepth = 12;
+
+static const unsigned int _infiniteCost = UINT_MAX / 4;
+
+#define NONE NONTERMINAL_COUNT
+#define FLAGS NONTERMINAL_FLAGS
+#define IMMEDIATE NONTERMINAL_IMMEDIATE
+#define INDEX NONTERMINAL_INDEX
+#define MEMORY NONTERMINAL_MEMORY
+#define REGISTER NONTERMINAL_REGISTER
+#define SCALED NONTERMINAL_SCALED
+
+/**
+ * The grammar, where the cost is an estimate of the latency of the emitted
+ * instructions (1 for each "mov", "add" or "cmp", and 3 for each "imul").
+ * The chain rules are applied last, until they don't find anything cheaper.
+ * On a tie, the first rule wins. To add a rule, append it to its group, and
+ * reduce its tile in the generator.
+ */
+static const SelectionRule _rules[] = {
+	// The leaves, and the expressions computed by the generator.
+	{ "immediate", TILE_LEAF, IMMEDIATE, OPERATORS_LEAVES, NONE, NONE, 0, GUARD_IMMEDIATE },
+	{ "memory", TILE_LEAF, MEMORY, OPERATORS_LEAVES, NONE, NONE, 0, GUARD_MEMORY },
+	{ "load", TILE_GENERAL, REGISTER, OPERATORS_LEAVES, NONE, NONE, 1, GUARD_NONE },
+	{ "general", TILE_GENERAL, REGISTER, OPERATORS_OPAQUE, NONE, NONE, _opaqueCost, GUARD_NONE },
+	{ "fold", TILE_FOLD, IMMEDIATE, OPERATORS_FOLDABLE, IMMEDIATE, IMMEDIATE, 0, GUARD_FOLDABLE },
+	// Additions and subtractions.
+	{ "add-register-immediate", TILE_OPERATION, REGISTER, OPERATORS_ADDITIVE, REGISTER, IMMEDIATE, 1, GUARD_NONE },
+	{ "add-register-memory", TILE_OPERATION, REGISTER, OPERATORS_ADDITIVE, REGISTER, MEMORY, 1, GUARD_NONE },
+	{ "add-immediate-register", TILE_SWAPPED_OPERATION, REGISTER, OPERATORS_ADDITION, IMMEDIATE, REGISTER, 1, GUARD_NONE },
+	{ "add-memory-register", TILE_SWAPPED_OPERATION, REGISTER, OPERATORS_ADDITION, MEMORY, REGISTER, 1, GUARD_NONE },
+	{ "add-register-register", TILE_SPILLED_OPERATION, REGISTER, OPERATORS_ADDITIVE, REGISTER, REGISTER, 3, GUARD_NONE },
+	// Multiplications.
+	{ "multiply-memory-immediate", TILE_MULTIPLY_IMMEDIATE, REGISTER, OPERATORS_MULTIPLICATION, MEMORY, IMMEDIATE, 3, GUARD_NONE },
+	{ "multiply-immediate-memory", TILE_MULTIPLY_IMMEDIATE, REGISTER, OPERATORS_MULTIPLICATION, IMMEDIATE, MEMORY, 3, GUARD_NONE },
+	{ "multiply-register-immediate", TILE_MULTIPLY_IMMEDIATE, REGISTER, OPERATORS_MULTIPLICATION, REGISTER, IMMEDIATE, 3, GUARD_NONE },
+	{ "multiply-immediate-register", TILE_MULTIPLY_IMMEDIATE, REGISTER, OPERATORS_MULTIPLICATION, IMMEDIATE, REGISTER, 3, GUARD_NONE },
+	{ "multiply-register-memory", TILE_OPERATION, REGISTER, OPERATORS_MULTIPLICATION, REGISTER, MEMORY, 3, GUARD_NONE },
+	{ "multiply-memory-register", TILE_SWAPPED_OPERATION, REGISTER, OPERATORS_MULTIPLICATION, MEMORY, REGISTER, 3, GUARD_NONE },
+	{ "multiply-register-register", TILE_SPILLED_OPERATION, REGISTER, OPERATORS_MULTIPLICATION, REGISTER, REGISTER, 5, GUARD_NONE },
+	// Comparisons, whose flags are used by a "jcc" or a "setcc".
+	{ "compare-memory-immediate", TILE_COMPARE_MEMORY, FLAGS, OPERATORS_RELATIONAL, MEMORY, IMMEDIATE, 1, GUARD_NONE },
+	{ "compare-immediate-memory", TILE_COMPARE_MEMORY, FLAGS, OPERATORS_RELATIONAL, IMMEDIATE, MEMORY, 1, GUARD_NONE },
+	{ "compare-register-immediate", TILE_COMPARE, FLAGS, OPERATORS_RELATIONAL, REGISTER, IMMEDIATE, 1, GUARD_NONE },
+	{ "compare-register-memory", TILE_COMPARE, FLAGS, OPERATORS_RELATIONAL, REGISTER, MEMORY, 1, GUARD_NONE },
+	{ "compare-immediate-register", TILE_SWAPPED_COMPARE, FLAGS, OPERATORS_RELATIONAL, IMMEDIATE, REGISTER, 1, GUARD_NONE },
+	{ "compare-memory-register", TILE_SWAPPED_COMPARE, FLAGS, OPERATORS_RELATIONAL, MEMORY, REGISTER, 1, GUARD_NONE },
+	{ "compare-register-register", TILE_SPILLED_COMPARE, FLAGS, OPERATORS_RELATIONAL, REGISTER, REGISTER, 3, GUARD_NONE },
+	// Array indices, folded into the addressing mode.
+	{ "index-displacement", TILE_INDEX_DISPLACEMENT, INDEX, OPERATORS_ADDITIVE, INDEX, IMMEDIATE, 0, GUARD_DISPLACEMENT },
+	{ "index-displacement-swapped", TILE_INDEX_DISPLACEMENT, INDEX, OPERATORS_ADDITION, IMMEDIATE, INDEX, 0, GUARD_DISPLACEMENT },
+	{ "index-scale-memory", TILE_INDEX_SCALE, INDEX, OPERATORS_MULTIPLICATION, MEMORY, IMMEDIATE, 1, GUARD_SCALE },
+	{ "index-scale-memory-swapped", TILE_INDEX_SCALE, INDEX, OPERATORS_MULTIPLICATION, IMMEDIATE, MEMORY, 1, GUARD_SCALE },
+	{ "index-scale-register", TILE_INDEX_SCALE, INDEX, OPERATORS_MULTIPLICATION, REGISTER, IMMEDIATE, 1, GUARD_SCALE },
+	{ "index-scale-register-swapped", TILE_INDEX_SCALE, INDEX, OPERATORS_MULTIPLICATION, IMMEDIATE, REGISTER, 1, GUARD_SCALE },
+	{ "scaled-memory", TILE_SCALED_PRODUCT, SCALED, OPERATORS_MULTIPLICATION, MEMORY, IMMEDIATE, 2, GUARD_SPLIT },
+	{ "scaled-memory-swapped", TILE_SCALED_PRODUCT, SCALED, OPERATORS_MULTIPLICATION, IMMEDIATE, MEMORY, 2, GUARD_SPLIT },
+	{ "scaled-register", TILE_SCALED_PRODUCT, SCALED, OPERATORS_MULTIPLICATION, REGISTER, IMMEDIATE, 2, GUARD_SPLIT },
+	{ "scaled-register-swapped", TILE_SCALED_PRODUCT, SCALED, OPERATORS_MULTIPLICATION, IMMEDIATE, REGISTER, 2, GUARD_SPLIT },
+	{ "index-scaled-sum", TILE_INDEX_SCALED_SUM, INDEX, OPERATORS_ADDITION, SCALED, MEMORY, 2, GUARD_DISPLACEMENT },
+	{ "index-scaled-sum-swapped", TILE_INDEX_SCALED_SUM, INDEX, OPERATORS_ADDITION, MEMORY, SCALED, 2, GUARD_DISPLACEMENT },
+	// The chain rules.
+	{ "load-immediate", TILE_LOAD_IMMEDIATE, REGISTER, 0, IMMEDIATE, NONE, 1, GUARD_NONE },
+	{ "load-memory", TILE_LOAD_MEMORY, REGISTER, 0, MEMORY, NONE, 1, GUARD_NONE },
+	{ "set-condition", TILE_SET_CONDITION, REGISTER, 0, FLAGS, NONE, 2, GUARD_NONE },
+	{ "test", TILE_TEST, FLAGS, 0, REGISTER, NONE, 1, GUARD_NONE },
+	{ "index-register", TILE_INDEX_REGISTER, INDEX, 0, REGISTER, NONE, 1, GUARD_NONE },
+	{ "index-memory", TILE_INDEX_MEMORY, INDEX, 0, MEMORY, NONE, 1, GUARD_NONE },
+	{ "index-scaled", TILE_INDEX_SCALED, INDEX, 0, SCALED, NONE, 1, GUARD_NONE }
+};
+
+#undef NONE
+#undef FLAGS
+#undef IMMEDIATE
+#undef INDEX
+#undef MEMORY
+#undef REGISTER
+#undef SCALED
+
+static const unsigned int _ruleCount = sizeof(_rules) / sizeof(_rules[0]);
+
+/**
+ * The state of a labeling: the requirements of the index, and the classifier
+ * of the leaves (with its context).
+ */
+typedef struct {
+	IndexRequirements requirements;
+	LeafClassifier classifier;
+	void * context;
+} Labeling;
+
+/* PRIVATE FUNCTIONS */
+
+static boolean _accepts(const Labeling * labeling, const SelectionRule * rule, const Expression * expression, const Nonterminal leaf, const Selection * left, const Selection * right, int * value);
+static void _applyChainRules(Selection * selection);
+static void _label(const Labeling * labeling, Expression * expression, const unsigned int depth, Selection * selection);
+static void _labelOpaque(Selection * selection);
+
+/**
+ * Checks the guard of a rule, and computes the value of the expression if
+ * it folds.
+ */
+static boolean _accepts(const Labeling * labeling, const SelectionRule * rule, const Expression * expression, const Nonterminal leaf, const Selection * left, const Selection * right, int * value) {
+	switch (rule->guard) {
+		case GUARD_IMMEDIATE:
+			return leaf == NONTERMINAL_IMMEDIATE;
+		case GUARD_MEMORY:
+			return leaf == NONTERMINAL_MEMORY;
+		case GUARD_FOLDABLE: {
+			const ComputationResult result = computeBinaryOperation(expression->type, left->value, right->value);
+			*value = result.value;
+			return result.succeed;
+		}
+		case GUARD_DISPLACEMENT:
+			return 0 < labeling->requirements.elementSize && !labeling->requirements.exact;
+		case GUARD_SCALE: {
+			if (labeling->requirements.elementSize <= 0 || labeling->requirements.exact) {
+				return false;
+			}
+			const int factor = rule->left == NONTERMINAL_IMMEDIATE ? left->value : right->value;
+			const long scale = (long) factor * labeling->requirements.elementSize;
+			return scale == 1 || scale == 2 || scale == 4 || scale == 8;
+		}
+		case GUARD_SPLIT: {
+			int multiplier;
+			int scale;
+			return 0 < labeling->requirements.elementSize && !labeling->requirements.exact
+				&& splitFactor(rule->left == NONTERMINAL_IMMEDIATE ? left->value : right->value, &multiplier, &scale);
+		}
+		default:
+			return true;
+	}
+}
+
+/**
+ * Applies the chain rules until none of them finds a cheaper derivation
+ * (they can form cycles, but every rule costs something).
+ */
+static void _applyChainRules(Selection * selection) {
+	for (boolean changed = true; changed; ) {
+		changed = false;
+		for (unsigned int k = 0; k < _ruleCount; ++k) {
+			const SelectionRule * rule = &_rules[k];
+			if (rule->operators != 0) {
+				continue;
+			}
+			const unsigned int cost = selection->costs[rule->left] + rule->cost;
+			if (cost < selection->costs[rule->result]) {
+				selection->costs[rule->result] = cost;
+				selection->rules[rule->result] = rule;
+				changed = true;
+			}
+		}
+	}
+}
+
+/**
+ * Labels an expression (and its operands, down to the maximum depth).
+ */
+static void _label(const Labeling * labeling, Expression * expression, const unsigned int depth, Selection * selection) {
+	while (expression->type == EXPRESSION_PARENTHESIS) {
+		expression = expression->singleExpression;
+	}
+	for (unsigned int k = 0; k < NONTERMINAL_COUNT; ++k) {
+		selection->rules[k] = NULL;
+		selection->costs[k] = _infiniteCost;
+	}
+	selection->value = 0;
+	if (_maximumDepth <= depth) {
+		_labelOpaque(selection);
+		return;
+	}
+	const unsigned int operator = 1u << expression->type;
+	Nonterminal leaf = NONTERMINAL_REGISTER;
+	Selection left;
+	Selection right;
+	if ((operator & OPERATORS_LEAVES) != 0) {
+		leaf = labeling->classifier(labeling->context, expression, &selection->value);
+	}
+	else if ((operator & _labeledOperators) != 0) {
+		_label(labeling, expression->leftExpression, depth + 1, &left);
+		_label(labeling, expression->rightExpression, depth + 1, &right);
+	}
+	for (unsigned int k = 0; k < _ruleCount; ++k) {
+		const SelectionRule * rule = &_rules[k];
+		if ((rule->operators & operator) == 0) {
+			continue;
+		}
+		unsigned int cost = rule->cost;
+		if (rule->left != NONTERMINAL_COUNT) {
+			cost += left.costs[rule->left] + right.costs[rule->right];
+		}
+		int value = selection->value;
+		if (cost < selection->costs[rule->result] && _accepts(labeling, rule, expression, leaf, &left, &right, &value)) {
+			selection->costs[rule->result] = cost;
+			selection->rules[rule->result] = rule;
+			selection->value = value;
+		}
+	}
+	_applyChainRules(selection);
+}
+
+/**
+ * Labels an expression that is only computed by the generator.
+ */
+static void _labelOpaque(Selection * selection) {
+	for (unsigned int k = 0; k < _ruleCount; ++k) {
+		if (_rules[k].tile == TILE_GENERAL && (_rules[k].operators & OPERATORS_OPAQUE) != 0) {
+			selection->rules[NONTERMINAL_REGISTER] = &_rules[k];
+			selection->costs[NONTERMINAL_REGISTER] = _opaqueCost;
+			break;
+		}
+	}
+	_applyChainRules(selection);
+}
+
+/* PUBLIC FUNCTIONS */
+
+Selection selectInstructions(Expression * expression, const IndexRequirements requirements, LeafClassifier classifier, void * context) {
+	const Labeling labeling = {
+		.requirements = requirements,
+		.classifier = classifier,
+		.context = context
+	};
+	Selection selection;
+	_label(&labeling, expression, 0, &selection);
+	return selection;
+}
+
+boolean splitFactor(const int factor, int * multiplier, int * scale) {
+	static const int multipliers[] = { 1, 3, 5, 9 };
+	for (unsigned int k = 0; k < sizeof(multipliers) / sizeof(multipliers[0]); ++k) {
+		const int quotient = factor / multipliers[k];
+		if (0 < factor && factor % multipliers[k] == 0 && (quotient == 1 || quotient == 2 || quotient == 4 || quotient == 8)) {
+			*multiplier = multipliers[k];
+			*scale = quotient;
+			return true;
+		}
+	}
+	return false;
+}
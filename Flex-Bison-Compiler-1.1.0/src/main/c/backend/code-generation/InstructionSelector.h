@@ -0,0 +1,168 @@
+#ifndef INSTRUCTION_SELECTOR_HEADER
+#define INSTRUCTION_SELECTOR_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Type.h"
+#include "../domain-specific/Calculator.h"
+#include <limits.h>
+#include <stdlib.h>
+
+/**
+ * A bottom-up rewriting (BURS) instruction selector for the expressions of
+ * the generator. Its rules are a tree grammar: each one derives a
+ * nonterminal (where the value of the expression ends up) from an operator
+ * and the nonterminals of its operands, with the cost of the instructions
+ * that it emits. Labeling an expression finds the cheapest rule for each
+ * nonterminal, bottom-up (dynamic programming), and the generator reduces it
+ * top-down, emitting the tile of each chosen rule.
+ *
+ * The leaves are classified by the generator (a known constant is an
+ * immediate, and an integer variable can be read in place), and the nodes
+ * the grammar doesn't cover (e.g., calls) can only be computed in %eax, at a
+ * fixed cost. Each expression is only labeled down to a depth, so labeling
+ * every node of a long expression again as it's reduced stays linear.
+ */
+
+/**
+ * Where the value of an expression can end up: in %eax, in an immediate, in
+ * memory (an integer variable), in the flags (a comparison, as a condition),
+ * or as an array index (in %rcx, with a factor and a displacement, to fold
+ * into an addressing mode). A scaled value is a part of an index: a product
+ * whose constant factor is split in a multiplier, applied in %rax by an
+ * "lea", and a scale, left for the "lea" that adds it to the rest of the
+ * index (e.g., "20 * i" is "5 * i" in %rax, with a scale of 4).
+ */
+typedef enum {
+	NONTERMINAL_REGISTER,
+	NONTERMINAL_IMMEDIATE,
+	NONTERMINAL_MEMORY,
+	NONTERMINAL_FLAGS,
+	NONTERMINAL_INDEX,
+	NONTERMINAL_SCALED,
+	NONTERMINAL_COUNT
+} Nonterminal;
+
+/**
+ * The instructions that a rule emits, once its operands are reduced.
+ */
+typedef enum {
+	// The leaves, as classified by the generator.
+	TILE_LEAF,
+	// Any expression, computed in %eax by the generator on its own.
+	TILE_GENERAL,
+	// "mov $c, %eax", "mov m, %eax", "setcc %al ; movzb %al, %eax", and
+	// "test %eax, %eax".
+	TILE_LOAD_IMMEDIATE,
+	TILE_LOAD_MEMORY,
+	TILE_SET_CONDITION,
+	TILE_TEST,
+	// An operation with constant operands, computed at compile-time.
+	TILE_FOLD,
+	// "op s, %eax", with the left operand in %eax (or the right one, if the
+	// operation is commutative), and "op s, %eax" after spilling the right
+	// operand to s.
+	TILE_OPERATION,
+	TILE_SWAPPED_OPERATION,
+	TILE_SPILLED_OPERATION,
+	// "imul $c, s, %eax", with s in memory or in %eax.
+	TILE_MULTIPLY_IMMEDIATE,
+	// "cmp s, %eax" (or "test"), "cmp $c, m", "cmp s, %eax" with the right
+	// operand in %eax, and "cmp s, %eax" after spilling the right operand.
+	TILE_COMPARE,
+	TILE_COMPARE_MEMORY,
+	TILE_SWAPPED_COMPARE,
+	TILE_SPILLED_COMPARE,
+	// "movslq %eax, %rcx", "movslq m, %rcx", a constant added to the
+	// displacement of the address, and a constant factor of the index folded
+	// into the scale of the address.
+	TILE_INDEX_REGISTER,
+	TILE_INDEX_MEMORY,
+	TILE_INDEX_DISPLACEMENT,
+	TILE_INDEX_SCALE,
+	// "movslq s, %rax ; lea (%rax,%rax,m-1), %rax", a scaled value (without
+	// the "lea" if the multiplier is 1). Then "movslq m, %rcx ; lea
+	// (%rcx,%rax,s), %rcx", added to a variable, and "lea (,%rax,s), %rcx",
+	// on its own.
+	TILE_SCALED_PRODUCT,
+	TILE_INDEX_SCALED_SUM,
+	TILE_INDEX_SCALED
+} Tile;
+
+/**
+ * A dynamic condition of a rule, besides matching its operands: the class
+ * of a leaf, a computation that succeeds, and an index that can have a
+ * displacement (or a factor, if it's valid as the scale of an address, or
+ * if it can be split in a multiplier and a scale).
+ */
+typedef enum {
+	GUARD_NONE,
+	GUARD_IMMEDIATE,
+	GUARD_MEMORY,
+	GUARD_FOLDABLE,
+	GUARD_DISPLACEMENT,
+	GUARD_SCALE,
+	GUARD_SPLIT
+} Guard;
+
+/**
+ * A rule of the grammar. The operators are a set of expression types (one
+ * bit each), whose operands must derive the left and the right nonterminals
+ * (or "NONTERMINAL_COUNT", if the rule doesn't look at them). A chain rule
+ * has no operators, and derives its nonterminal from another one of the same
+ * expression (its left one).
+ */
+typedef struct {
+	const char * name;
+	Tile tile;
+	Nonterminal result;
+	unsigned int operators;
+	Nonterminal left;
+	Nonterminal right;
+	unsigned int cost;
+	Guard guard;
+} SelectionRule;
+
+/**
+ * Classifies a leaf (a constant or an identifier): it's either an immediate
+ * (with its value), a variable that can be read in place (memory), or
+ * something to compute in %eax (a register). The context is forwarded
+ * untouched from the caller of "selectInstructions".
+ */
+typedef Nonterminal (*LeafClassifier)(void * context, Expression * expression, int * value);
+
+/**
+ * The labels of an expression: the cheapest rule that derives each
+ * nonterminal (NULL if none does) and its cost, and the value of the
+ * expression, if it's an immediate.
+ */
+typedef struct {
+	const SelectionRule * rules[NONTERMINAL_COUNT];
+	unsigned int costs[NONTERMINAL_COUNT];
+	int value;
+} Selection;
+
+/**
+ * The requirements of the index of an array access: the size of its
+ * elements (zero, if it's not an index), and whether it must be exactly in
+ * %rcx (e.g., to check its bounds), which rules out the displacement and the
+ * factor.
+ */
+typedef struct {
+	int elementSize;
+	boolean exact;
+} IndexRequirements;
+
+/**
+ * Labels an expression (parentheses are transparent), with the requirements
+ * of an index, if it's one. Every expression derives at least a register,
+ * the flags and an index.
+ */
+Selection selectInstructions(Expression * expression, const IndexRequirements requirements, LeafClassifier classifier, void * context);
+
+/**
+ * Splits a positive factor in a multiplier (1, 3, 5 or 9, which an "lea"
+ * applies as "(%r,%r,m-1)") and a scale (1, 2, 4 or 8), if it can.
+ */
+boolean splitFactor(const int factor, int * multiplier, int * scale);
+
+#endif
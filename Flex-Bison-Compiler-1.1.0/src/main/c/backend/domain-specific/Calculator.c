@@ -1,136 +1,253 @@
-//#include "Calculator.h"
-//
-///* MODULE INTERNAL STATE */
-//
-//static Logger * _logger = NULL;
-//
-//void initializeCalculatorModule() {
-//	_logger = createLogger("Calculator");
-//}
-//
-//void shutdownCalculatorModule() {
-//	if (_logger != NULL) {
-//		destroyLogger(_logger);
-//	}
-//}
-//
-///** PRIVATE FUNCTIONS */
-//
-//static BinaryOperator _expressionTypeToBinaryOperator(const ExpressionType type);
-//static ComputationResult _invalidBinaryOperator(const int x, const int y);
-//static ComputationResult _invalidComputation();
-//
-///**
-// * Converts and expression type to the proper binary operator. If that's not
-// * possible, returns a binary operator that always returns an invalid
-// * computation result.
-// */
-//static BinaryOperator _expressionTypeToBinaryOperator(const ExpressionType type) {
-//	switch (type) {
-//		case ADDITION: return add;
-//		case DIVISION: return divide;
-//		case MULTIPLICATION: return multiply;
-//		case SUBTRACTION: return subtract;
-//		default:
-//			logError(_logger, "The specified expression type cannot be converted into character: %d", type);
-//			return _invalidBinaryOperator;
-//	}
-//}
-//
-///**
-// * A binary operator that always returns an invalid computation result.
-// */
-//static ComputationResult _invalidBinaryOperator(const int x, const int y) {
-//	return _invalidComputation();
-//}
-//
-///**
-// * A computation that always returns an invalid result.
-// */
-//static ComputationResult _invalidComputation() {
-//	ComputationResult computationResult = {
-//		.succeed = false,
-//		.value = 0
-//	};
-//	return computationResult;
-//}
-//
-///** PUBLIC FUNCTIONS */
-//
-//ComputationResult add(const int leftAddend, const int rightAddend) {
-//	ComputationResult computationResult = {
-//		.succeed = true,
-//		.value = leftAddend + rightAddend
-//	};
-//	return computationResult;
-//}
-//
-//ComputationResult divide(const int dividend, const int divisor) {
-//	const int sign = dividend < 0 ? -1 : +1;
-//	const boolean divisionByZero = divisor == 0 ? true : false;
-//	if (divisionByZero) {
-//		logError(_logger, "The divisor cannot be zero (the computation was %d/%d).", dividend, divisor);
-//	}
-//	ComputationResult computationResult = {
-//		.succeed = divisionByZero ? false : true,
-//		.value = divisionByZero ? (sign * INT_MAX) : (dividend / divisor)
-//	};
-//	return computationResult;
-//}
-//
-//ComputationResult multiply(const int multiplicand, const int multiplier) {
-//	ComputationResult computationResult = {
-//		.succeed = true,
-//		.value = multiplicand * multiplier
-//	};
-//	return computationResult;
-//}
-//
-//ComputationResult subtract(const int minuend, const int subtract) {
-//	ComputationResult computationResult = {
-//		.succeed = true,
-//		.value = minuend - subtract
-//	};
-//	return computationResult;
-//}
-//
-//ComputationResult computeConstant(Constant * constant) {
-//	ComputationResult computationResult = {
-//		.succeed = true,
-//		.value = constant->value
-//	};
-//	return computationResult;
-//}
-//
-//ComputationResult computeExpression(Expression * expression) {
-//	switch (expression->type) {
-//		case ADDITION:
-//		case DIVISION:
-//		case MULTIPLICATION:
-//		case SUBTRACTION:
-//			ComputationResult leftResult = computeExpression(expression->leftExpression);
-//			ComputationResult rightResult = computeExpression(expression->rightExpression);
-//			if (leftResult.succeed && rightResult.succeed) {
-//				BinaryOperator binaryOperator = _expressionTypeToBinaryOperator(expression->type);
-//				return binaryOperator(leftResult.value, rightResult.value);
-//			}
-//			else {
-//				return _invalidComputation();
-//			}
-//		case FACTOR:
-//			return computeFactor(expression->factor);
-//		default:
-//			return _invalidComputation();
-//	}
-//}
-//
-//ComputationResult computeFactor(Factor * factor) {
-//	switch (factor->type) {
-//		case CONSTANT:
-//			return computeConstant(factor->constant);
-//		case EXPRESSION:
-//			return computeExpression(factor->expression);
-//		default:
-//			return _invalidComputation();
-//	}
-//}
+#include "Calculator.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeCalculatorModule() {
+	_logger = createLogger("Calculator");
+}
+
+void shutdownCalculatorModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** PRIVATE FUNCTIONS */
+
+static BinaryOperator _expressionTypeToBinaryOperator(const ExpressionType type);
+static ComputationResult _invalidBinaryOperator(const int x, const int y);
+static ComputationResult _invalidComputation();
+static ComputationResult _validComputation(const int value);
+
+/**
+ * Converts and expression type to the proper binary operator. If that's not
+ * possible, returns a binary operator that always returns an invalid
+ * computation result.
+ */
+static BinaryOperator _expressionTypeToBinaryOperator(const ExpressionType type) {
+	switch (type) {
+		case EXPRESSION_ADDITION: return add;
+		case EXPRESSION_DIVISION: return divide;
+		case EXPRESSION_EQUAL: return equal;
+		case EXPRESSION_GREATER: return greater;
+		case EXPRESSION_GREATER_EQUAL: return greaterEqual;
+		case EXPRESSION_LESS: return less;
+		case EXPRESSION_LESS_EQUAL: return lessEqual;
+		case EXPRESSION_MODULO: return modulo;
+		case EXPRESSION_MULTIPLICATION: return multiply;
+		case EXPRESSION_NOT_EQUAL: return notEqual;
+		case EXPRESSION_SUBTRACTION: return subtract;
+		default:
+			logError(_logger, "The specified expression type cannot be converted into a binary operator: %d", type);
+			return _invalidBinaryOperator;
+	}
+}
+
+/**
+ * A binary operator that always returns an invalid computation result.
+ */
+static ComputationResult _invalidBinaryOperator(const int x, const int y) {
+	(void) x;
+	(void) y;
+	return _invalidComputation();
+}
+
+/**
+ * A computation that always returns an invalid result.
+ */
+static ComputationResult _invalidComputation() {
+	ComputationResult computationResult = {
+		.succeed = false,
+		.value = 0
+	};
+	return computationResult;
+}
+
+/**
+ * A computation that succeeds with the specified value.
+ */
+static ComputationResult _validComputation(const int value) {
+	ComputationResult computationResult = {
+		.succeed = true,
+		.value = value
+	};
+	return computationResult;
+}
+
+/** PUBLIC FUNCTIONS */
+
+ComputationResult add(const int leftAddend, const int rightAddend) {
+	return _validComputation((int) ((unsigned int) leftAddend + (unsigned int) rightAddend));
+}
+
+ComputationResult divide(const int dividend, const int divisor) {
+	if (divisor == 0) {
+		logDebugging(_logger, "The divisor cannot be zero (the computation was %d/%d).", dividend, divisor);
+		return _invalidComputation();
+	}
+	if (dividend == INT_MIN && divisor == -1) {
+		return _invalidComputation();
+	}
+	return _validComputation(dividend / divisor);
+}
+
+ComputationResult modulo(const int dividend, const int divisor) {
+	if (divisor == 0) {
+		logDebugging(_logger, "The divisor cannot be zero (the computation was %d%%%d).", dividend, divisor);
+		return _invalidComputation();
+	}
+	if (dividend == INT_MIN && divisor == -1) {
+		return _invalidComputation();
+	}
+	return _validComputation(dividend % divisor);
+}
+
+ComputationResult multiply(const int multiplicand, const int multiplier) {
+	return _validComputation((int) ((unsigned int) multiplicand * (unsigned int) multiplier));
+}
+
+ComputationResult subtract(const int minuend, const int subtract) {
+	return _validComputation((int) ((unsigned int) minuend - (unsigned int) subtract));
+}
+
+ComputationResult equal(const int left, const int right) {
+	return _validComputation(left == right);
+}
+
+ComputationResult greater(const int left, const int right) {
+	return _validComputation(left > right);
+}
+
+ComputationResult greaterEqual(const int left, const int right) {
+	return _validComputation(left >= right);
+}
+
+ComputationResult less(const int left, const int right) {
+	return _validComputation(left < right);
+}
+
+ComputationResult lessEqual(const int left, const int right) {
+	return _validComputation(left <= right);
+}
+
+ComputationResult notEqual(const int left, const int right) {
+	return _validComputation(left != right);
+}
+
+ComputationResult computeConstant(Constant * constant) {
+	switch (constant->type) {
+		case TYPE_INT:
+			return _validComputation(*constant->integer);
+		case TYPE_CHAR:
+			return _validComputation(*constant->character);
+		default:
+			return _invalidComputation();
+	}
+}
+
+ComputationResult computeBinaryOperation(const ExpressionType type, const int left, const int right) {
+	switch (type) {
+		case EXPRESSION_ADDITION:
+		case EXPRESSION_DIVISION:
+		case EXPRESSION_EQUAL:
+		case EXPRESSION_GREATER:
+		case EXPRESSION_GREATER_EQUAL:
+		case EXPRESSION_LESS:
+		case EXPRESSION_LESS_EQUAL:
+		case EXPRESSION_MODULO:
+		case EXPRESSION_MULTIPLICATION:
+		case EXPRESSION_NOT_EQUAL:
+		case EXPRESSION_SUBTRACTION:
+			return _expressionTypeToBinaryOperator(type)(left, right);
+		default:
+			return _invalidComputation();
+	}
+}
+
+ComputationResult computeExpression(Expression * expression, IdentifierResolver resolver, void * context) {
+	return computeExpressionWithCalls(expression, resolver, NULL, context);
+}
+
+ComputationResult computeExpressionWithCalls(Expression * expression, IdentifierResolver resolver, CallResolver callResolver, void * context) {
+	switch (expression->type) {
+		case EXPRESSION_ADDITION:
+		case EXPRESSION_DIVISION:
+		case EXPRESSION_EQUAL:
+		case EXPRESSION_GREATER:
+		case EXPRESSION_GREATER_EQUAL:
+		case EXPRESSION_LESS:
+		case EXPRESSION_LESS_EQUAL:
+		case EXPRESSION_MODULO:
+		case EXPRESSION_MULTIPLICATION:
+		case EXPRESSION_NOT_EQUAL:
+		case EXPRESSION_SUBTRACTION: {
+			ComputationResult leftResult = computeExpressionWithCalls(expression->leftExpression, resolver, callResolver, context);
+			if (!leftResult.succeed) {
+				return _invalidComputation();
+			}
+			ComputationResult rightResult = computeExpressionWithCalls(expression->rightExpression, resolver, callResolver, context);
+			if (!rightResult.succeed) {
+				return _invalidComputation();
+			}
+			BinaryOperator binaryOperator = _expressionTypeToBinaryOperator(expression->type);
+			return binaryOperator(leftResult.value, rightResult.value);
+		}
+		case EXPRESSION_AND: {
+			ComputationResult leftResult = computeExpressionWithCalls(expression->leftExpression, resolver, callResolver, context);
+			if (leftResult.succeed && leftResult.value == 0) {
+				return _validComputation(0);
+			}
+			ComputationResult rightResult = computeExpressionWithCalls(expression->rightExpression, resolver, callResolver, context);
+			if (leftResult.succeed && rightResult.succeed) {
+				return _validComputation(rightResult.value != 0);
+			}
+			return _invalidComputation();
+		}
+		case EXPRESSION_OR: {
+			ComputationResult leftResult = computeExpressionWithCalls(expression->leftExpression, resolver, callResolver, context);
+			if (leftResult.succeed && leftResult.value != 0) {
+				return _validComputation(1);
+			}
+			ComputationResult rightResult = computeExpressionWithCalls(expression->rightExpression, resolver, callResolver, context);
+			if (leftResult.succeed && rightResult.succeed) {
+				return _validComputation(rightResult.value != 0);
+			}
+			return _invalidComputation();
+		}
+		case EXPRESSION_NOT: {
+			ComputationResult result = computeExpressionWithCalls(expression->singleExpression, resolver, callResolver, context);
+			return result.succeed ? _validComputation(result.value == 0) : result;
+		}
+		case EXPRESSION_PARENTHESIS:
+			return computeExpressionWithCalls(expression->singleExpression, resolver, callResolver, context);
+		case EXPRESSION_CONSTANT:
+			return computeConstant(expression->constant);
+		case EXPRESSION_IDENTIFIER:
+			if (resolver == NULL) {
+				return _invalidComputation();
+			}
+			return resolver(context, *expression->identifier);
+		case EXPRESSION_FUNCTION_CALL: {
+			if (callResolver == NULL) {
+				return _invalidComputation();
+			}
+			int arguments[MAXIMUM_COMPUTED_ARGUMENTS];
+			int count = 0;
+			for (ListArguments * argument = expression->arguments; argument != NULL; argument = argument->next) {
+				if (count == MAXIMUM_COMPUTED_ARGUMENTS) {
+					return _invalidComputation();
+				}
+				ComputationResult result = computeExpressionWithCalls(argument->expression, resolver, callResolver, context);
+				if (!result.succeed) {
+					return _invalidComputation();
+				}
+				arguments[count++] = result.value;
+			}
+			return callResolver(context, *expression->identifierFunc, arguments, count);
+		}
+		default:
+			return _invalidComputation();
+	}
+}
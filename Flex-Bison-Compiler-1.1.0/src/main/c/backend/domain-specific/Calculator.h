@@ -1,53 +1,96 @@
-//#ifndef CALCULATOR_HEADER
-//#define CALCULATOR_HEADER
-//
-///**
-// * We reuse the types from the AST for convenience, but you should separate
-// * the layers of the backend and frontend using another group of
-// * domain-specific models or DTOs (Data Transfer Objects).
-// */
-//#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
-//#include "../../shared/Logger.h"
-//#include "../../shared/Type.h"
-//#include <limits.h>
-//
-///** Initialize module's internal state. */
-//void initializeCalculatorModule();
-//
-///** Shutdown module's internal state. */
-//void shutdownCalculatorModule();
-//
-///**
-// * The result of a computation. It's considered valid only if "succeed" is
-// * true.
-// */
-//typedef struct {
-//	boolean succeed;
-//	int value;
-//} ComputationResult;
-//
-//typedef ComputationResult (*BinaryOperator)(const int, const int);
-//
-///** Arithmetic operations. */
-//
-//ComputationResult add(const int leftAddend, const int rightAddend);
-//ComputationResult divide(const int dividend, const int divisor);
-//ComputationResult multiply(const int multiplicand, const int multiplier);
-//ComputationResult subtract(const int minuend, const int subtract);
-//
-///**
-// * Computes the final value of a mathematical constant.
-// */
-//ComputationResult computeConstant(Constant * constant);
-//
-///**
-// * Computes the final value of a mathematical expression.
-// */
-//ComputationResult computeExpression(Expression * expression);
-//
-///**
-// * Computes the final value of a mathematical factor.
-// */
-//ComputationResult computeFactor(Factor * factor);
-//
-//#endif
+#ifndef CALCULATOR_HEADER
+#define CALCULATOR_HEADER
+
+/**
+ * We reuse the types from the AST for convenience, but you should separate
+ * the layers of the backend and frontend using another group of
+ * domain-specific models or DTOs (Data Transfer Objects).
+ */
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include <limits.h>
+
+/**
+ * The maximum amount of arguments of a computed call.
+ */
+#define MAXIMUM_COMPUTED_ARGUMENTS 16
+
+/** Initialize module's internal state. */
+void initializeCalculatorModule();
+
+/** Shutdown module's internal state. */
+void shutdownCalculatorModule();
+
+/**
+ * The result of a computation. It's considered valid only if "succeed" is
+ * true.
+ */
+typedef struct {
+	boolean succeed;
+	int value;
+} ComputationResult;
+
+typedef ComputationResult (*BinaryOperator)(const int, const int);
+
+/**
+ * Resolves the value of an identifier at compile-time, which allows to
+ * propagate known constants into an expression. It must return an invalid
+ * computation result if the value is unknown. The context is forwarded
+ * untouched from the caller of "computeExpression".
+ */
+typedef ComputationResult (*IdentifierResolver)(void * context, const char * identifier);
+
+/**
+ * Resolves the value returned by a call at compile-time, with the values of
+ * its arguments (e.g., the call to a pure function, see "Evaluator.h"). It
+ * must return an invalid computation result if the value is unknown, or if
+ * the call has side-effects. The context is the same of the identifiers.
+ */
+typedef ComputationResult (*CallResolver)(void * context, const char * function, const int * arguments, const int count);
+
+/** Arithmetic operations. */
+
+ComputationResult add(const int leftAddend, const int rightAddend);
+ComputationResult divide(const int dividend, const int divisor);
+ComputationResult modulo(const int dividend, const int divisor);
+ComputationResult multiply(const int multiplicand, const int multiplier);
+ComputationResult subtract(const int minuend, const int subtract);
+
+/** Relational operations. */
+
+ComputationResult equal(const int left, const int right);
+ComputationResult greater(const int left, const int right);
+ComputationResult greaterEqual(const int left, const int right);
+ComputationResult less(const int left, const int right);
+ComputationResult lessEqual(const int left, const int right);
+ComputationResult notEqual(const int left, const int right);
+
+/**
+ * Computes a binary operation (arithmetic or relational) of the specified
+ * expression type, or returns an invalid result for any other type.
+ */
+ComputationResult computeBinaryOperation(const ExpressionType type, const int left, const int right);
+
+/**
+ * Computes the final value of a constant.
+ */
+ComputationResult computeConstant(Constant * constant);
+
+/**
+ * Computes the final value of an expression, if it can be known at
+ * compile-time. Expressions with side-effects (assignments and function
+ * calls) are never computed, except when a short-circuit operator proves that
+ * they will not be evaluated. The resolver can be NULL, in which case every
+ * identifier is considered unknown.
+ */
+ComputationResult computeExpression(Expression * expression, IdentifierResolver resolver, void * context);
+
+/**
+ * Like "computeExpression", but the calls are computed too, with a resolver
+ * (once every argument is known). The calls with too many arguments are
+ * never computed.
+ */
+ComputationResult computeExpressionWithCalls(Expression * expression, IdentifierResolver resolver, CallResolver callResolver, void * context);
+
+#endif
@@ -0,0 +1,1042 @@
+#include "Evaluator.h"
+
+/* MODULE INTERNAL STATE */
+
+static const unsigned int _initialCapacity = 16;
+
+/**
+ * The maximum depth of the nested calls of an evaluation (the interpreter is
+ * recursive, like the functions that it evaluates), and the maximum amount
+ * of elements of an evaluated local array.
+ */
+static const unsigned int _maximumDepth = 256;
+static const int _maximumArraySize = 1 << 16;
+
+/**
+ * An empty entry of the hash table of functions (or a missing function).
+ */
+static const unsigned int _noFunction = UINT_MAX;
+
+/**
+ * The state of the purity check of a function: the names of its parameters
+ * and local variables in scope, and the functions that it calls.
+ */
+typedef struct {
+	const Evaluator * evaluator;
+	const char ** locals;
+	unsigned int localCount;
+	unsigned int localCapacity;
+	unsigned int * callees;
+	unsigned int calleeCount;
+	unsigned int calleeCapacity;
+	boolean pure;
+} PurityCheck;
+
+/**
+ * A variable of an evaluated call: a scalar (with its value), or an array
+ * (with its elements), and which of them were initialized.
+ */
+typedef struct {
+	const char * name;
+	DataType type;
+	int value;
+	boolean initialized;
+	int size;
+	int * elements;
+	boolean * initializedElements;
+} EvaluatedVariable;
+
+/**
+ * The state of an evaluation: the variables of every call in progress (the
+ * ones of the innermost call start at its frame), the steps taken, the depth
+ * of the calls, and the value returned by the innermost call.
+ */
+typedef struct {
+	const Evaluator * evaluator;
+	EvaluatedVariable * variables;
+	unsigned int variableCount;
+	unsigned int variableCapacity;
+	unsigned int frame;
+	uint64_t steps;
+	unsigned int depth;
+	int returned;
+} Evaluation;
+
+/**
+ * How the evaluation of a statement ends: normally, returning from its
+ * function, or in a state that cannot be evaluated.
+ */
+typedef enum {
+	EVALUATION_NEXT,
+	EVALUATION_RETURN,
+	EVALUATION_FAILURE
+} EvaluationStatus;
+
+/**
+ * The state of the replacement of the calls of a function: its variables in
+ * scope (with their value, if they're constant), and the names assigned in
+ * it.
+ */
+typedef struct {
+	const Evaluator * evaluator;
+	const char ** names;
+	ComputationResult * values;
+	unsigned int nameCount;
+	unsigned int nameCapacity;
+	const char ** assigned;
+	unsigned int assignedCount;
+	unsigned int assignedCapacity;
+} CallReplacement;
+
+/* PRIVATE FUNCTIONS */
+
+static void _addCallee(PurityCheck * check, const unsigned int function);
+static void _addLocal(PurityCheck * check, const char * name);
+static ComputationResult _call(Evaluation * evaluation, const unsigned int function, const int * arguments, const int count);
+static void _checkBlock(PurityCheck * check, const Block * block);
+static void _checkExpression(PurityCheck * check, const Expression * expression, const boolean assignable);
+static boolean _checkLocal(const PurityCheck * check, const char * name);
+static void _checkStatement(PurityCheck * check, const Statement * statement);
+static void _collectAssignedInBlock(CallReplacement * replacement, const Block * block);
+static void _collectAssignedInExpression(CallReplacement * replacement, const Expression * expression);
+static void _collectAssignedInStatement(CallReplacement * replacement, const Statement * statement);
+static int _convert(const DataType type, const int value);
+static void _declareName(CallReplacement * replacement, const char * name, const ComputationResult value);
+static ComputationResult _evaluateExpression(Evaluation * evaluation, const Expression * expression);
+static EvaluationStatus _executeBlock(Evaluation * evaluation, const Block * block);
+static EvaluationStatus _executeStatement(Evaluation * evaluation, const Statement * statement);
+static unsigned int _findFunction(const Evaluator * evaluator, const char * name);
+static unsigned int _hash(const char * name);
+static ComputationResult _invalid();
+static boolean _isAssigned(const CallReplacement * replacement, const char * name);
+static EvaluatedVariable * _lookup(Evaluation * evaluation, const char * name);
+static void _popVariables(Evaluation * evaluation, const unsigned int count);
+static EvaluatedVariable * _pushVariable(Evaluation * evaluation, const char * name, const DataType type);
+static unsigned int _replaceInBlock(CallReplacement * replacement, Block * block);
+static unsigned int _replaceInExpression(CallReplacement * replacement, Expression * expression);
+static unsigned int _replaceInStatement(CallReplacement * replacement, Statement * statement);
+static ComputationResult _resolveCall(void * context, const char * function, const int * arguments, const int count);
+static ComputationResult _resolveName(void * context, const char * identifier);
+static boolean _step(Evaluation * evaluation);
+static ComputationResult _valid(const int value);
+
+/**
+ * Records a function called by the checked one.
+ */
+static void _addCallee(PurityCheck * check, const unsigned int function) {
+	if (check->calleeCount == check->calleeCapacity) {
+		check->calleeCapacity = check->calleeCapacity == 0 ? _initialCapacity : 2 * check->calleeCapacity;
+		check->callees = realloc(check->callees, check->calleeCapacity * sizeof(unsigned int));
+	}
+	check->callees[check->calleeCount++] = function;
+}
+
+/**
+ * Declares a parameter or a local variable of the checked function.
+ */
+static void _addLocal(PurityCheck * check, const char * name) {
+	if (check->localCount == check->localCapacity) {
+		check->localCapacity = check->localCapacity == 0 ? _initialCapacity : 2 * check->localCapacity;
+		check->locals = realloc(check->locals, check->localCapacity * sizeof(const char *));
+	}
+	check->locals[check->localCount++] = name;
+}
+
+/**
+ * Evaluates a call to a pure function, in a new frame with its parameters.
+ * The parameters and the returned value are converted to their types.
+ */
+static ComputationResult _call(Evaluation * evaluation, const unsigned int function, const int * arguments, const int count) {
+	const Evaluator * evaluator = evaluation->evaluator;
+	if (function == _noFunction || !evaluator->pure[function] || _maximumDepth <= evaluation->depth || !_step(evaluation)) {
+		return _invalid();
+	}
+	const Declaration * definition = evaluator->functions[function];
+	const Parameters * parameters = definition->declarationSuffix->parameters;
+	const unsigned int base = evaluation->variableCount;
+	int parameterCount = 0;
+	for (const ParameterList * node = parameters->type == PARAMS_LIST ? parameters->list : NULL; node != NULL; node = node->next, ++parameterCount) {
+		if (count <= parameterCount) {
+			_popVariables(evaluation, base);
+			return _invalid();
+		}
+		EvaluatedVariable * variable = _pushVariable(evaluation, *node->parameter->identifier, node->parameter->type);
+		variable->value = _convert(node->parameter->type, arguments[parameterCount]);
+		variable->initialized = true;
+	}
+	if (parameterCount != count) {
+		_popVariables(evaluation, base);
+		return _invalid();
+	}
+	const unsigned int frame = evaluation->frame;
+	evaluation->frame = base;
+	++evaluation->depth;
+	const EvaluationStatus status = _executeBlock(evaluation, definition->declarationSuffix->functionSuffix->block);
+	--evaluation->depth;
+	evaluation->frame = frame;
+	_popVariables(evaluation, base);
+	return status == EVALUATION_RETURN ? _valid(_convert(definition->dataType, evaluation->returned)) : _invalid();
+}
+
+/**
+ * Checks a block, whose local variables are only visible inside of it.
+ */
+static void _checkBlock(PurityCheck * check, const Block * block) {
+	const unsigned int localCount = check->localCount;
+	for (const Statements * statements = block->statements; check->pure && statements != NULL; statements = statements->next) {
+		_checkStatement(check, statements->statement);
+	}
+	check->localCount = localCount;
+}
+
+/**
+ * Checks that an expression only names local variables (or functions of the
+ * program), and that it only assigns them where allowed.
+ */
+static void _checkExpression(PurityCheck * check, const Expression * expression, const boolean assignable) {
+	if (!check->pure) {
+		return;
+	}
+	switch (expression->type) {
+		case EXPRESSION_ASSIGNMENT: {
+			const Expression * lvalue = expression->leftExpression;
+			if (!assignable || (lvalue->type != EXPRESSION_IDENTIFIER && lvalue->type != EXPRESSION_ARRAY_ACCESS)) {
+				check->pure = false;
+				return;
+			}
+			_checkExpression(check, lvalue, false);
+			_checkExpression(check, expression->rightExpression, true);
+			break;
+		}
+		case EXPRESSION_NOT:
+		case EXPRESSION_PARENTHESIS:
+			_checkExpression(check, expression->singleExpression, false);
+			break;
+		case EXPRESSION_IDENTIFIER:
+			check->pure = _checkLocal(check, *expression->identifier);
+			break;
+		case EXPRESSION_CONSTANT:
+			break;
+		case EXPRESSION_ARRAY_ACCESS:
+			check->pure = _checkLocal(check, *expression->identifierArray);
+			_checkExpression(check, expression->indexExpression, false);
+			break;
+		case EXPRESSION_FUNCTION_CALL: {
+			const unsigned int function = _findFunction(check->evaluator, *expression->identifierFunc);
+			if (function == _noFunction) {
+				check->pure = false;
+				return;
+			}
+			_addCallee(check, function);
+			for (const ListArguments * argument = expression->arguments; argument != NULL; argument = argument->next) {
+				_checkExpression(check, argument->expression, false);
+			}
+			break;
+		}
+		default:
+			_checkExpression(check, expression->leftExpression, false);
+			_checkExpression(check, expression->rightExpression, false);
+			break;
+	}
+}
+
+/**
+ * True if a name is a parameter or a local variable in scope.
+ */
+static boolean _checkLocal(const PurityCheck * check, const char * name) {
+	for (unsigned int k = check->localCount; 0 < k; --k) {
+		if (strcmp(check->locals[k - 1], name) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Checks a statement. The root of each expression can assign a variable.
+ */
+static void _checkStatement(PurityCheck * check, const Statement * statement) {
+	switch (statement->type) {
+		case STATEMENT_DECLARATION:
+			if (statement->variableSuffix->type == VARIABLE_SUFFIX_ASSIGNMENT) {
+				_checkExpression(check, statement->variableSuffix->expression, true);
+			}
+			_addLocal(check, *statement->identifier);
+			break;
+		case STATEMENT_IF:
+			_checkExpression(check, statement->statementIf->condition, false);
+			_checkBlock(check, statement->statementIf->thenBlock);
+			if (statement->statementIf->hasElse) {
+				_checkBlock(check, statement->statementIf->elseBlock);
+			}
+			break;
+		case STATEMENT_WHILE:
+			_checkExpression(check, statement->statementWhile->condition, false);
+			_checkBlock(check, statement->statementWhile->block);
+			break;
+		case STATEMENT_FOR: {
+			const StatementFor * loop = statement->statementFor;
+			if (loop->hasInit) {
+				_checkExpression(check, loop->init, true);
+			}
+			if (loop->hasCondition) {
+				_checkExpression(check, loop->condition, false);
+			}
+			if (loop->hasUpdate) {
+				_checkExpression(check, loop->update, true);
+			}
+			_checkBlock(check, loop->block);
+			break;
+		}
+		case STATEMENT_RETURN:
+			if (statement->statementReturn->hasExpression) {
+				_checkExpression(check, statement->statementReturn->expression, true);
+			}
+			break;
+		case STATEMENT_EXPRESSION:
+			_checkExpression(check, statement->statementExpression->expression, true);
+			break;
+		case STATEMENT_BLOCK:
+			_checkBlock(check, statement->block);
+			break;
+		case STATEMENT_EMPTY:
+			break;
+	}
+}
+
+/**
+ * Collects the names assigned in a block (and in the ones nested in it).
+ */
+static void _collectAssignedInBlock(CallReplacement * replacement, const Block * block) {
+	for (const Statements * statements = block->statements; statements != NULL; statements = statements->next) {
+		_collectAssignedInStatement(replacement, statements->statement);
+	}
+}
+
+/**
+ * Collects the names of the variables assigned in an expression.
+ */
+static void _collectAssignedInExpression(CallReplacement * replacement, const Expression * expression) {
+	switch (expression->type) {
+		case EXPRESSION_ASSIGNMENT:
+			if (expression->leftExpression->type == EXPRESSION_IDENTIFIER) {
+				if (replacement->assignedCount == replacement->assignedCapacity) {
+					replacement->assignedCapacity = replacement->assignedCapacity == 0 ? _initialCapacity : 2 * replacement->assignedCapacity;
+					replacement->assigned = realloc(replacement->assigned, replacement->assignedCapacity * sizeof(const char *));
+				}
+				replacement->assigned[replacement->assignedCount++] = *expression->leftExpression->identifier;
+			}
+			_collectAssignedInExpression(replacement, expression->leftExpression);
+			_collectAssignedInExpression(replacement, expression->rightExpression);
+			break;
+		case EXPRESSION_NOT:
+		case EXPRESSION_PARENTHESIS:
+			_collectAssignedInExpression(replacement, expression->singleExpression);
+			break;
+		case EXPRESSION_IDENTIFIER:
+		case EXPRESSION_CONSTANT:
+			break;
+		case EXPRESSION_ARRAY_ACCESS:
+			_collectAssignedInExpression(replacement, expression->indexExpression);
+			break;
+		case EXPRESSION_FUNCTION_CALL:
+			for (const ListArguments * argument = expression->arguments; argument != NULL; argument = argument->next) {
+				_collectAssignedInExpression(replacement, argument->expression);
+			}
+			break;
+		default:
+			_collectAssignedInExpression(replacement, expression->leftExpression);
+			_collectAssignedInExpression(replacement, expression->rightExpression);
+			break;
+	}
+}
+
+/**
+ * Collects the names of the variables assigned in a statement.
+ */
+static void _collectAssignedInStatement(CallReplacement * replacement, const Statement * statement) {
+	switch (statement->type) {
+		case STATEMENT_DECLARATION:
+			if (statement->variableSuffix->type == VARIABLE_SUFFIX_ASSIGNMENT) {
+				_collectAssignedInExpression(replacement, statement->variableSuffix->expression);
+			}
+			break;
+		case STATEMENT_IF:
+			_collectAssignedInExpression(replacement, statement->statementIf->condition);
+			_collectAssignedInBlock(replacement, statement->statementIf->thenBlock);
+			if (statement->statementIf->hasElse) {
+				_collectAssignedInBlock(replacement, statement->statementIf->elseBlock);
+			}
+			break;
+		case STATEMENT_WHILE:
+			_collectAssignedInExpression(replacement, statement->statementWhile->condition);
+			_collectAssignedInBlock(replacement, statement->statementWhile->block);
+			break;
+		case STATEMENT_FOR: {
+			const StatementFor * loop = statement->statementFor;
+			if (loop->hasInit) {
+				_collectAssignedInExpression(replacement, loop->init);
+			}
+			if (loop->hasCondition) {
+				_collectAssignedInExpression(replacement, loop->condition);
+			}
+			if (loop->hasUpdate) {
+				_collectAssignedInExpression(replacement, loop->update);
+			}
+			_collectAssignedInBlock(replacement, loop->block);
+			break;
+		}
+		case STATEMENT_RETURN:
+			if (statement->statementReturn->hasExpression) {
+				_collectAssignedInExpression(replacement, statement->statementReturn->expression);
+			}
+			break;
+		case STATEMENT_EXPRESSION:
+			_collectAssignedInExpression(replacement, statement->statementExpression->expression);
+			break;
+		case STATEMENT_BLOCK:
+			_collectAssignedInBlock(replacement, statement->block);
+			break;
+		case STATEMENT_EMPTY:
+			break;
+	}
+}
+
+/**
+ * Converts a value to a type, like storing it in a variable of that type.
+ */
+static int _convert(const DataType type, const int value) {
+	return type == TYPE_CHAR ? (char) value : value;
+}
+
+/**
+ * Declares a variable in the scope of the function whose calls are being
+ * replaced, with its value (if it's constant).
+ */
+static void _declareName(CallReplacement * replacement, const char * name, const ComputationResult value) {
+	if (replacement->nameCount == replacement->nameCapacity) {
+		replacement->nameCapacity = replacement->nameCapacity == 0 ? _initialCapacity : 2 * replacement->nameCapacity;
+		replacement->names = realloc(replacement->names, replacement->nameCapacity * sizeof(const char *));
+		replacement->values = realloc(replacement->values, replacement->nameCapacity * sizeof(ComputationResult));
+	}
+	replacement->names[replacement->nameCount] = name;
+	replacement->values[replacement->nameCount++] = value;
+}
+
+/**
+ * Evaluates an expression. Its variables are looked up after evaluating its
+ * operands, since a call can move them.
+ */
+static ComputationResult _evaluateExpression(Evaluation * evaluation, const Expression * expression) {
+	switch (expression->type) {
+		case EXPRESSION_ASSIGNMENT: {
+			const ComputationResult value = _evaluateExpression(evaluation, expression->rightExpression);
+			const Expression * lvalue = expression->leftExpression;
+			if (!value.succeed) {
+				return value;
+			}
+			if (lvalue->type == EXPRESSION_ARRAY_ACCESS) {
+				const ComputationResult index = _evaluateExpression(evaluation, lvalue->indexExpression);
+				EvaluatedVariable * variable = _lookup(evaluation, *lvalue->identifierArray);
+				if (!index.succeed || variable == NULL || variable->elements == NULL || index.value < 0 || variable->size <= index.value) {
+					return _invalid();
+				}
+				variable->elements[index.value] = _convert(variable->type, value.value);
+				variable->initializedElements[index.value] = true;
+				return _valid(variable->elements[index.value]);
+			}
+			EvaluatedVariable * variable = _lookup(evaluation, *lvalue->identifier);
+			if (variable == NULL || variable->elements != NULL) {
+				return _invalid();
+			}
+			variable->value = _convert(variable->type, value.value);
+			variable->initialized = true;
+			return _valid(variable->value);
+		}
+		case EXPRESSION_AND: {
+			const ComputationResult left = _evaluateExpression(evaluation, expression->leftExpression);
+			if (!left.succeed || left.value == 0) {
+				return left.succeed ? _valid(0) : left;
+			}
+			const ComputationResult right = _evaluateExpression(evaluation, expression->rightExpression);
+			return right.succeed ? _valid(right.value != 0) : right;
+		}
+		case EXPRESSION_OR: {
+			const ComputationResult left = _evaluateExpression(evaluation, expression->leftExpression);
+			if (!left.succeed || left.value != 0) {
+				return left.succeed ? _valid(1) : left;
+			}
+			const ComputationResult right = _evaluateExpression(evaluation, expression->rightExpression);
+			return right.succeed ? _valid(right.value != 0) : right;
+		}
+		case EXPRESSION_NOT: {
+			const ComputationResult result = _evaluateExpression(evaluation, expression->singleExpression);
+			return result.succeed ? _valid(result.value == 0) : result;
+		}
+		case EXPRESSION_PARENTHESIS:
+			return _evaluateExpression(evaluation, expression->singleExpression);
+		case EXPRESSION_CONSTANT:
+			return computeConstant(expression->constant);
+		case EXPRESSION_IDENTIFIER: {
+			const EvaluatedVariable * variable = _lookup(evaluation, *expression->identifier);
+			if (variable == NULL || variable->elements != NULL || !variable->initialized) {
+				return _invalid();
+			}
+			return _valid(variable->value);
+		}
+		case EXPRESSION_ARRAY_ACCESS: {
+			const ComputationResult index = _evaluateExpression(evaluation, expression->indexExpression);
+			const EvaluatedVariable * variable = _lookup(evaluation, *expression->identifierArray);
+			if (!index.succeed || variable == NULL || variable->elements == NULL || index.value < 0 || variable->size <= index.value
+					|| !variable->initializedElements[index.value]) {
+				return _invalid();
+			}
+			return _valid(variable->elements[index.value]);
+		}
+		case EXPRESSION_FUNCTION_CALL: {
+			int arguments[MAXIMUM_COMPUTED_ARGUMENTS];
+			int count = 0;
+			for (const ListArguments * argument = expression->arguments; argument != NULL; argument = argument->next) {
+				if (count == MAXIMUM_COMPUTED_ARGUMENTS) {
+					return _invalid();
+				}
+				const ComputationResult result = _evaluateExpression(evaluation, argument->expression);
+				if (!result.succeed) {
+					return result;
+				}
+				arguments[count++] = result.value;
+			}
+			return _call(evaluation, _findFunction(evaluation->evaluator, *expression->identifierFunc), arguments, count);
+		}
+		default: {
+			const ComputationResult left = _evaluateExpression(evaluation, expression->leftExpression);
+			if (!left.succeed) {
+				return left;
+			}
+			const ComputationResult right = _evaluateExpression(evaluation, expression->rightExpression);
+			if (!right.succeed) {
+				return right;
+			}
+			return computeBinaryOperation(expression->type, left.value, right.value);
+		}
+	}
+}
+
+/**
+ * Executes a block, whose local variables are released at its end.
+ */
+static EvaluationStatus _executeBlock(Evaluation * evaluation, const Block * block) {
+	const unsigned int variableCount = evaluation->variableCount;
+	EvaluationStatus status = EVALUATION_NEXT;
+	for (const Statements * statements = block->statements; status == EVALUATION_NEXT && statements != NULL; statements = statements->next) {
+		status = _executeStatement(evaluation, statements->statement);
+	}
+	_popVariables(evaluation, variableCount);
+	return status;
+}
+
+/**
+ * Executes a statement. Every statement (and every iteration of a loop) is
+ * a step of the evaluation.
+ */
+static EvaluationStatus _executeStatement(Evaluation * evaluation, const Statement * statement) {
+	if (!_step(evaluation)) {
+		return EVALUATION_FAILURE;
+	}
+	switch (statement->type) {
+		case STATEMENT_DECLARATION: {
+			const VariableSuffix * suffix = statement->variableSuffix;
+			ComputationResult value = _invalid();
+			if (suffix->type == VARIABLE_SUFFIX_ASSIGNMENT) {
+				value = _evaluateExpression(evaluation, suffix->expression);
+				if (!value.succeed) {
+					return EVALUATION_FAILURE;
+				}
+			}
+			else if (suffix->type == VARIABLE_SUFFIX_ARRAY && (*suffix->arraySize <= 0 || _maximumArraySize < *suffix->arraySize)) {
+				return EVALUATION_FAILURE;
+			}
+			EvaluatedVariable * variable = _pushVariable(evaluation, *statement->identifier, statement->dataType);
+			variable->value = _convert(statement->dataType, value.value);
+			variable->initialized = value.succeed;
+			if (suffix->type == VARIABLE_SUFFIX_ARRAY) {
+				variable->size = *suffix->arraySize;
+				variable->elements = calloc(variable->size, sizeof(int));
+				variable->initializedElements = calloc(variable->size, sizeof(boolean));
+			}
+			return EVALUATION_NEXT;
+		}
+		case STATEMENT_IF: {
+			const StatementIf * statementIf = statement->statementIf;
+			const ComputationResult condition = _evaluateExpression(evaluation, statementIf->condition);
+			if (!condition.succeed) {
+				return EVALUATION_FAILURE;
+			}
+			if (condition.value != 0) {
+				return _executeBlock(evaluation, statementIf->thenBlock);
+			}
+			return statementIf->hasElse ? _executeBlock(evaluation, statementIf->elseBlock) : EVALUATION_NEXT;
+		}
+		case STATEMENT_WHILE: {
+			const StatementWhile * loop = statement->statementWhile;
+			while (true) {
+				const ComputationResult condition = _evaluateExpression(evaluation, loop->condition);
+				if (!condition.succeed) {
+					return EVALUATION_FAILURE;
+				}
+				if (condition.value == 0) {
+					return EVALUATION_NEXT;
+				}
+				const EvaluationStatus status = _executeBlock(evaluation, loop->block);
+				if (status != EVALUATION_NEXT) {
+					return status;
+				}
+				if (!_step(evaluation)) {
+					return EVALUATION_FAILURE;
+				}
+			}
+		}
+		case STATEMENT_FOR: {
+			const StatementFor * loop = statement->statementFor;
+			if (loop->hasInit && !_evaluateExpression(evaluation, loop->init).succeed) {
+				return EVALUATION_FAILURE;
+			}
+			while (true) {
+				if (loop->hasCondition) {
+					const ComputationResult condition = _evaluateExpression(evaluation, loop->condition);
+					if (!condition.succeed) {
+						return EVALUATION_FAILURE;
+					}
+					if (condition.value == 0) {
+						return EVALUATION_NEXT;
+					}
+				}
+				const EvaluationStatus status = _executeBlock(evaluation, loop->block);
+				if (status != EVALUATION_NEXT) {
+					return status;
+				}
+				if ((loop->hasUpdate && !_evaluateExpression(evaluation, loop->update).succeed) || !_step(evaluation)) {
+					return EVALUATION_FAILURE;
+				}
+			}
+		}
+		case STATEMENT_RETURN: {
+			if (!statement->statementReturn->hasExpression) {
+				return EVALUATION_FAILURE;
+			}
+			const ComputationResult value = _evaluateExpression(evaluation, statement->statementReturn->expression);
+			if (!value.succeed) {
+				return EVALUATION_FAILURE;
+			}
+			evaluation->returned = value.value;
+			return EVALUATION_RETURN;
+		}
+		case STATEMENT_EXPRESSION:
+			return _evaluateExpression(evaluation, statement->statementExpression->expression).succeed ? EVALUATION_NEXT : EVALUATION_FAILURE;
+		case STATEMENT_BLOCK:
+			return _executeBlock(evaluation, statement->block);
+		case STATEMENT_EMPTY:
+			return EVALUATION_NEXT;
+	}
+	return EVALUATION_FAILURE;
+}
+
+/**
+ * The index of the function with the specified name (the last one defined,
+ * like in the generator), or "_noFunction" if there's none.
+ */
+static unsigned int _findFunction(const Evaluator * evaluator, const char * name) {
+	if (evaluator->capacity == 0) {
+		return _noFunction;
+	}
+	for (unsigned int k = _hash(name) & (evaluator->capacity - 1); evaluator->indices[k] != _noFunction; k = (k + 1) & (evaluator->capacity - 1)) {
+		if (strcmp(*evaluator->functions[evaluator->indices[k]]->identifier, name) == 0) {
+			return evaluator->indices[k];
+		}
+	}
+	return _noFunction;
+}
+
+/**
+ * The FNV-1a hash of a name.
+ */
+static unsigned int _hash(const char * name) {
+	unsigned int hash = 2166136261u;
+	for (const char * character = name; *character != '\0'; ++character) {
+		hash = (hash ^ (unsigned char) *character) * 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * A computation that cannot be evaluated.
+ */
+static ComputationResult _invalid() {
+	ComputationResult result = {
+		.succeed = false,
+		.value = 0
+	};
+	return result;
+}
+
+/**
+ * True if a name is assigned somewhere in the function whose calls are being
+ * replaced.
+ */
+static boolean _isAssigned(const CallReplacement * replacement, const char * name) {
+	for (unsigned int k = 0; k < replacement->assignedCount; ++k) {
+		if (strcmp(replacement->assigned[k], name) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Finds the innermost variable with the specified name in the frame of the
+ * current call, or NULL if there's none.
+ */
+static EvaluatedVariable * _lookup(Evaluation * evaluation, const char * name) {
+	for (unsigned int k = evaluation->variableCount; evaluation->frame < k; --k) {
+		if (strcmp(evaluation->variables[k - 1].name, name) == 0) {
+			return &evaluation->variables[k - 1];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Releases the variables declared after the first ones.
+ */
+static void _popVariables(Evaluation * evaluation, const unsigned int count) {
+	while (count < evaluation->variableCount) {
+		EvaluatedVariable * variable = &evaluation->variables[--evaluation->variableCount];
+		free(variable->elements);
+		free(variable->initializedElements);
+	}
+}
+
+/**
+ * Declares an uninitialized scalar variable in the current call. The pointer
+ * is only valid until the next declaration.
+ */
+static EvaluatedVariable * _pushVariable(Evaluation * evaluation, const char * name, const DataType type) {
+	if (evaluation->variableCount == evaluation->variableCapacity) {
+		evaluation->variableCapacity = evaluation->variableCapacity == 0 ? _initialCapacity : 2 * evaluation->variableCapacity;
+		evaluation->variables = realloc(evaluation->variables, evaluation->variableCapacity * sizeof(EvaluatedVariable));
+	}
+	EvaluatedVariable * variable = &evaluation->variables[evaluation->variableCount++];
+	*variable = (EvaluatedVariable) {
+		.name = name,
+		.type = type,
+		.value = 0,
+		.initialized = false,
+		.size = 0,
+		.elements = NULL,
+		.initializedElements = NULL
+	};
+	return variable;
+}
+
+/**
+ * Replaces the calls of a block, whose local variables are only visible
+ * inside of it.
+ */
+static unsigned int _replaceInBlock(CallReplacement * replacement, Block * block) {
+	const unsigned int nameCount = replacement->nameCount;
+	unsigned int replaced = 0;
+	for (Statements * statements = block->statements; statements != NULL; statements = statements->next) {
+		replaced += _replaceInStatement(replacement, statements->statement);
+	}
+	replacement->nameCount = nameCount;
+	return replaced;
+}
+
+/**
+ * Replaces the calls of an expression, after the ones in its operands (so
+ * their arguments are already constants, if they can be).
+ */
+static unsigned int _replaceInExpression(CallReplacement * replacement, Expression * expression) {
+	unsigned int replaced = 0;
+	switch (expression->type) {
+		case EXPRESSION_NOT:
+		case EXPRESSION_PARENTHESIS:
+			return _replaceInExpression(replacement, expression->singleExpression);
+		case EXPRESSION_IDENTIFIER:
+		case EXPRESSION_CONSTANT:
+			return 0;
+		case EXPRESSION_ARRAY_ACCESS:
+			return _replaceInExpression(replacement, expression->indexExpression);
+		case EXPRESSION_FUNCTION_CALL:
+			for (ListArguments * argument = expression->arguments; argument != NULL; argument = argument->next) {
+				replaced += _replaceInExpression(replacement, argument->expression);
+			}
+			break;
+		default:
+			replaced += _replaceInExpression(replacement, expression->leftExpression);
+			replaced += _replaceInExpression(replacement, expression->rightExpression);
+			return replaced;
+	}
+	const ComputationResult result = computeExpressionWithCalls(expression, _resolveName, _resolveCall, replacement);
+	if (!result.succeed) {
+		return replaced;
+	}
+	freeIdentifier(expression->identifierFunc);
+	freeListArguments(expression->arguments);
+	Constant * constant = calloc(1, sizeof(Constant));
+	constant->type = TYPE_INT;
+	constant->integer = malloc(sizeof(ConstantInteger));
+	*constant->integer = result.value;
+	expression->type = EXPRESSION_CONSTANT;
+	expression->constant = constant;
+	return replaced + 1;
+}
+
+/**
+ * Replaces the calls of a statement, and declares its variable (if it's a
+ * declaration), which is constant if it's initialized with a constant and
+ * never assigned.
+ */
+static unsigned int _replaceInStatement(CallReplacement * replacement, Statement * statement) {
+	unsigned int replaced = 0;
+	switch (statement->type) {
+		case STATEMENT_DECLARATION: {
+			VariableSuffix * suffix = statement->variableSuffix;
+			ComputationResult value = _invalid();
+			if (suffix->type == VARIABLE_SUFFIX_ASSIGNMENT) {
+				replaced += _replaceInExpression(replacement, suffix->expression);
+				if (!_isAssigned(replacement, *statement->identifier)) {
+					value = computeExpression(suffix->expression, _resolveName, replacement);
+					value.value = _convert(statement->dataType, value.value);
+				}
+			}
+			_declareName(replacement, *statement->identifier, value);
+			break;
+		}
+		case STATEMENT_IF:
+			replaced += _replaceInExpression(replacement, statement->statementIf->condition);
+			replaced += _replaceInBlock(replacement, statement->statementIf->thenBlock);
+			if (statement->statementIf->hasElse) {
+				replaced += _replaceInBlock(replacement, statement->statementIf->elseBlock);
+			}
+			break;
+		case STATEMENT_WHILE:
+			replaced += _replaceInExpression(replacement, statement->statementWhile->condition);
+			replaced += _replaceInBlock(replacement, statement->statementWhile->block);
+			break;
+		case STATEMENT_FOR: {
+			StatementFor * loop = statement->statementFor;
+			if (loop->hasInit) {
+				replaced += _replaceInExpression(replacement, loop->init);
+			}
+			if (loop->hasCondition) {
+				replaced += _replaceInExpression(replacement, loop->condition);
+			}
+			if (loop->hasUpdate) {
+				replaced += _replaceInExpression(replacement, loop->update);
+			}
+			replaced += _replaceInBlock(replacement, loop->block);
+			break;
+		}
+		case STATEMENT_RETURN:
+			if (statement->statementReturn->hasExpression) {
+				replaced += _replaceInExpression(replacement, statement->statementReturn->expression);
+			}
+			break;
+		case STATEMENT_EXPRESSION:
+			replaced += _replaceInExpression(replacement, statement->statementExpression->expression);
+			break;
+		case STATEMENT_BLOCK:
+			replaced += _replaceInBlock(replacement, statement->block);
+			break;
+		case STATEMENT_EMPTY:
+			break;
+	}
+	return replaced;
+}
+
+/**
+ * Evaluates a call with constant arguments (a "CallResolver").
+ */
+static ComputationResult _resolveCall(void * context, const char * function, const int * arguments, const int count) {
+	CallReplacement * replacement = context;
+	return evaluateCall(replacement->evaluator, function, arguments, count);
+}
+
+/**
+ * Resolves the value of a constant variable in scope (an
+ * "IdentifierResolver"). The globals are never constant.
+ */
+static ComputationResult _resolveName(void * context, const char * identifier) {
+	const CallReplacement * replacement = context;
+	for (unsigned int k = replacement->nameCount; 0 < k; --k) {
+		if (strcmp(replacement->names[k - 1], identifier) == 0) {
+			return replacement->values[k - 1];
+		}
+	}
+	return _invalid();
+}
+
+/**
+ * Takes a step of the evaluation, unless the budget is exhausted.
+ */
+static boolean _step(Evaluation * evaluation) {
+	return ++evaluation->steps <= evaluation->evaluator->budget;
+}
+
+/**
+ * A computation that succeeds with the specified value.
+ */
+static ComputationResult _valid(const int value) {
+	ComputationResult result = {
+		.succeed = true,
+		.value = value
+	};
+	return result;
+}
+
+/* PUBLIC FUNCTIONS */
+
+Evaluator * createEvaluator(const Program * program, const uint64_t budget) {
+	Evaluator * evaluator = calloc(1, sizeof(Evaluator));
+	evaluator->budget = budget;
+	const DeclarationList * declarations = program->type == PROGRAM_DECLARATIONS ? program->declarationList : NULL;
+	for (const DeclarationList * node = declarations; node != NULL; node = node->next) {
+		const DeclarationSuffix * suffix = node->declaration->declarationSuffix;
+		if (suffix->type == DECLARATION_SUFFIX_FUNCTION && suffix->functionSuffix->type == SUFFIX_BLOCK) {
+			++evaluator->functionCount;
+		}
+	}
+	if (evaluator->functionCount == 0) {
+		return evaluator;
+	}
+	evaluator->functions = calloc(evaluator->functionCount, sizeof(Declaration *));
+	evaluator->pure = calloc(evaluator->functionCount, sizeof(boolean));
+	evaluator->capacity = _initialCapacity;
+	while (evaluator->capacity < 2 * evaluator->functionCount) {
+		evaluator->capacity *= 2;
+	}
+	evaluator->indices = malloc(evaluator->capacity * sizeof(unsigned int));
+	memset(evaluator->indices, 0xFF, evaluator->capacity * sizeof(unsigned int));
+	unsigned int index = 0;
+	for (const DeclarationList * node = declarations; node != NULL; node = node->next) {
+		const DeclarationSuffix * suffix = node->declaration->declarationSuffix;
+		if (suffix->type != DECLARATION_SUFFIX_FUNCTION || suffix->functionSuffix->type != SUFFIX_BLOCK) {
+			continue;
+		}
+		const char * name = *node->declaration->identifier;
+		unsigned int k = _hash(name) & (evaluator->capacity - 1);
+		while (evaluator->indices[k] != _noFunction && strcmp(*evaluator->functions[evaluator->indices[k]]->identifier, name) != 0) {
+			k = (k + 1) & (evaluator->capacity - 1);
+		}
+		evaluator->functions[index] = node->declaration;
+		evaluator->indices[k] = index++;
+	}
+	// Every function is checked on its own, and then the ones that call a
+	// function that isn't pure are discarded, until none is.
+	unsigned int ** callees = calloc(evaluator->functionCount, sizeof(unsigned int *));
+	unsigned int * calleeCounts = calloc(evaluator->functionCount, sizeof(unsigned int));
+	PurityCheck check = {
+		.evaluator = evaluator,
+		.locals = NULL,
+		.localCount = 0,
+		.localCapacity = 0
+	};
+	for (unsigned int k = 0; k < evaluator->functionCount; ++k) {
+		const Declaration * function = evaluator->functions[k];
+		const Parameters * parameters = function->declarationSuffix->parameters;
+		check.localCount = 0;
+		check.callees = NULL;
+		check.calleeCount = 0;
+		check.calleeCapacity = 0;
+		check.pure = true;
+		for (const ParameterList * node = parameters->type == PARAMS_LIST ? parameters->list : NULL; node != NULL; node = node->next) {
+			check.pure = check.pure && node->parameter->array->type == PARAMETER_ARRAY_NONE;
+			_addLocal(&check, *node->parameter->identifier);
+		}
+		_checkBlock(&check, function->declarationSuffix->functionSuffix->block);
+		evaluator->pure[k] = check.pure;
+		callees[k] = check.callees;
+		calleeCounts[k] = check.calleeCount;
+	}
+	free(check.locals);
+	for (boolean changed = true; changed; ) {
+		changed = false;
+		for (unsigned int k = 0; k < evaluator->functionCount; ++k) {
+			for (unsigned int c = 0; evaluator->pure[k] && c < calleeCounts[k]; ++c) {
+				if (!evaluator->pure[callees[k][c]]) {
+					evaluator->pure[k] = false;
+					changed = true;
+				}
+			}
+		}
+	}
+	for (unsigned int k = 0; k < evaluator->functionCount; ++k) {
+		evaluator->pureCount += evaluator->pure[k] ? 1 : 0;
+		free(callees[k]);
+	}
+	free(callees);
+	free(calleeCounts);
+	return evaluator;
+}
+
+void destroyEvaluator(Evaluator * evaluator) {
+	if (evaluator != NULL) {
+		free(evaluator->functions);
+		free(evaluator->pure);
+		free(evaluator->indices);
+		free(evaluator);
+	}
+}
+
+ComputationResult evaluateCall(const Evaluator * evaluator, const char * function, const int * arguments, const int count) {
+	Evaluation evaluation = {
+		.evaluator = evaluator,
+		.variables = NULL,
+		.variableCount = 0,
+		.variableCapacity = 0,
+		.frame = 0,
+		.steps = 0,
+		.depth = 0,
+		.returned = 0
+	};
+	const ComputationResult result = _call(&evaluation, _findFunction(evaluator, function), arguments, count);
+	free(evaluation.variables);
+	return result;
+}
+
+unsigned int evaluatePureCalls(const Evaluator * evaluator, Program * program) {
+	if (evaluator->pureCount == 0) {
+		return 0;
+	}
+	CallReplacement replacement = {
+		.evaluator = evaluator,
+		.names = NULL,
+		.values = NULL,
+		.nameCount = 0,
+		.nameCapacity = 0,
+		.assigned = NULL,
+		.assignedCount = 0,
+		.assignedCapacity = 0
+	};
+	unsigned int replaced = 0;
+	for (DeclarationList * node = program->declarationList; node != NULL; node = node->next) {
+		DeclarationSuffix * suffix = node->declaration->declarationSuffix;
+		if (suffix->type != DECLARATION_SUFFIX_FUNCTION || suffix->functionSuffix->type != SUFFIX_BLOCK) {
+			continue;
+		}
+		const Parameters * parameters = suffix->parameters;
+		replacement.nameCount = 0;
+		replacement.assignedCount = 0;
+		for (const ParameterList * node = parameters->type == PARAMS_LIST ? parameters->list : NULL; node != NULL; node = node->next) {
+			_declareName(&replacement, *node->parameter->identifier, _invalid());
+		}
+		Block * block = suffix->functionSuffix->block;
+		_collectAssignedInBlock(&replacement, block);
+		replaced += _replaceInBlock(&replacement, block);
+	}
+	free(replacement.names);
+	free(replacement.values);
+	free(replacement.assigned);
+	return replaced;
+}
@@ -0,0 +1,72 @@
+#ifndef EVALUATOR_HEADER
+#define EVALUATOR_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Type.h"
+#include "Calculator.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * An interpreter of the pure functions of a program, which computes their
+ * calls with constant arguments at compile-time. A function is pure if it
+ * only reads and writes its own parameters and local variables (including
+ * local arrays), it has no array parameters, and it only calls pure
+ * functions of the program (recursion included). It cannot touch a global,
+ * or call an external function, so a call has no effect but its value.
+ *
+ * A call is only computed if it finishes within a budget of steps (each
+ * statement, loop iteration or call is one), without reading an
+ * uninitialized variable, indexing an array out of bounds, dividing by zero,
+ * or falling off its end: otherwise, the program does it at run-time. To
+ * keep the order of the evaluation out of the way, an assignment can only be
+ * the root of an expression (or the value of another assignment).
+ *
+ * The calls of the program are replaced by their value before generating it,
+ * when their arguments are constant: their expressions are computed with the
+ * calculator, where a local variable is constant if it's initialized with a
+ * constant, and never assigned in its function (its name, actually).
+ */
+
+/**
+ * The function definitions of a program (in a hash table, indexed by their
+ * name), which of them are pure, and the budget of each evaluated call.
+ */
+typedef struct {
+	const Declaration ** functions;
+	boolean * pure;
+	unsigned int functionCount;
+	unsigned int pureCount;
+	unsigned int * indices;
+	unsigned int capacity;
+	uint64_t budget;
+} Evaluator;
+
+/**
+ * Finds the pure functions of a program (which must outlive the evaluator),
+ * to evaluate their calls within the specified amount of steps.
+ */
+Evaluator * createEvaluator(const Program * program, const uint64_t budget);
+
+/**
+ * Destroys an evaluator (which can be NULL).
+ */
+void destroyEvaluator(Evaluator * evaluator);
+
+/**
+ * Evaluates the call to a function of the program, with the values of its
+ * arguments (e.g., from a "CallResolver"). The result is invalid if the
+ * function isn't pure, or if the call cannot be evaluated. Many threads can
+ * evaluate calls at the same time.
+ */
+ComputationResult evaluateCall(const Evaluator * evaluator, const char * function, const int * arguments, const int count);
+
+/**
+ * Replaces every call with constant arguments to a pure function of the
+ * program by its value (an "EXPRESSION_CONSTANT"), innermost first, in the
+ * bodies of its functions. Returns the amount of replaced calls.
+ */
+unsigned int evaluatePureCalls(const Evaluator * evaluator, Program * program);
+
+#endif
@@ -0,0 +1,163 @@
+#include "BitSet.h"
+
+/* MODULE INTERNAL STATE */
+
+#define BITS_PER_WORD 64
+
+// The buffers are aligned and padded to an AVX2 register (4 words).
+static const unsigned int _wordAlignment = 4;
+
+/* PRIVATE FUNCTIONS */
+
+static BitSetWord _lastWordMask(const BitSet * set);
+
+/**
+ * The valid bits of the last word of the universe (the others must always
+ * be zero, so the words can be compared and counted directly).
+ */
+static BitSetWord _lastWordMask(const BitSet * set) {
+	const unsigned int remainder = set->size % BITS_PER_WORD;
+	return remainder == 0 ? ~(BitSetWord) 0 : (((BitSetWord) 1) << remainder) - 1;
+}
+
+/* PUBLIC FUNCTIONS */
+
+BitSet * createBitSet(const unsigned int size) {
+	BitSet * set = calloc(1, sizeof(BitSet));
+	const unsigned int words = (size + BITS_PER_WORD - 1) / BITS_PER_WORD;
+	set->size = size;
+	set->words = (words + _wordAlignment - 1) / _wordAlignment * _wordAlignment;
+	void * bits = NULL;
+	if (set->words == 0 || posix_memalign(&bits, _wordAlignment * sizeof(BitSetWord), set->words * sizeof(BitSetWord)) != 0) {
+		bits = NULL;
+	}
+	set->bits = bits;
+	clearBitSet(set);
+	return set;
+}
+
+void destroyBitSet(BitSet * set) {
+	if (set != NULL) {
+		free(set->bits);
+		free(set);
+	}
+}
+
+void addBit(BitSet * set, const unsigned int element) {
+	set->bits[element / BITS_PER_WORD] |= ((BitSetWord) 1) << (element % BITS_PER_WORD);
+}
+
+void removeBit(BitSet * set, const unsigned int element) {
+	set->bits[element / BITS_PER_WORD] &= ~(((BitSetWord) 1) << (element % BITS_PER_WORD));
+}
+
+boolean containsBit(const BitSet * set, const unsigned int element) {
+	return (set->bits[element / BITS_PER_WORD] >> (element % BITS_PER_WORD)) & 1;
+}
+
+void clearBitSet(BitSet * set) {
+	if (set->bits != NULL) {
+		memset(set->bits, 0, set->words * sizeof(BitSetWord));
+	}
+}
+
+void fillBitSet(BitSet * set) {
+	const unsigned int used = (set->size + BITS_PER_WORD - 1) / BITS_PER_WORD;
+	clearBitSet(set);
+	if (used != 0) {
+		memset(set->bits, 0xFF, used * sizeof(BitSetWord));
+		set->bits[used - 1] &= _lastWordMask(set);
+	}
+}
+
+boolean copyBitSet(BitSet * target, const BitSet * source) {
+	BitSetWord * restrict bits = target->bits;
+	const BitSetWord * restrict sourceBits = source->bits;
+	BitSetWord changed = 0;
+	for (unsigned int k = 0; k < target->words; ++k) {
+		changed |= bits[k] ^ sourceBits[k];
+		bits[k] = sourceBits[k];
+	}
+	return changed != 0;
+}
+
+boolean intersectBitSet(BitSet * target, const BitSet * source) {
+	BitSetWord * restrict bits = target->bits;
+	const BitSetWord * restrict sourceBits = source->bits;
+	BitSetWord changed = 0;
+	for (unsigned int k = 0; k < target->words; ++k) {
+		const BitSetWord word = bits[k] & sourceBits[k];
+		changed |= bits[k] ^ word;
+		bits[k] = word;
+	}
+	return changed != 0;
+}
+
+boolean subtractBitSet(BitSet * target, const BitSet * source) {
+	BitSetWord * restrict bits = target->bits;
+	const BitSetWord * restrict sourceBits = source->bits;
+	BitSetWord changed = 0;
+	for (unsigned int k = 0; k < target->words; ++k) {
+		const BitSetWord word = bits[k] & ~sourceBits[k];
+		changed |= bits[k] ^ word;
+		bits[k] = word;
+	}
+	return changed != 0;
+}
+
+boolean unionBitSet(BitSet * target, const BitSet * source) {
+	BitSetWord * restrict bits = target->bits;
+	const BitSetWord * restrict sourceBits = source->bits;
+	BitSetWord changed = 0;
+	for (unsigned int k = 0; k < target->words; ++k) {
+		const BitSetWord word = bits[k] | sourceBits[k];
+		changed |= bits[k] ^ word;
+		bits[k] = word;
+	}
+	return changed != 0;
+}
+
+boolean transferBitSet(BitSet * target, const BitSet * source, const BitSet * generated, const BitSet * killed) {
+	BitSetWord * restrict bits = target->bits;
+	const BitSetWord * restrict sourceBits = source->bits;
+	const BitSetWord * restrict generatedBits = generated->bits;
+	const BitSetWord * restrict killedBits = killed->bits;
+	BitSetWord changed = 0;
+	for (unsigned int k = 0; k < target->words; ++k) {
+		const BitSetWord word = generatedBits[k] | (sourceBits[k] & ~killedBits[k]);
+		changed |= bits[k] ^ word;
+		bits[k] = word;
+	}
+	return changed != 0;
+}
+
+boolean equalBitSet(const BitSet * left, const BitSet * right) {
+	BitSetWord difference = 0;
+	for (unsigned int k = 0; k < left->words; ++k) {
+		difference |= left->bits[k] ^ right->bits[k];
+	}
+	return difference == 0;
+}
+
+unsigned int countBits(const BitSet * set) {
+	unsigned int count = 0;
+	for (unsigned int k = 0; k < set->words; ++k) {
+		count += __builtin_popcountll(set->bits[k]);
+	}
+	return count;
+}
+
+int nextBit(const BitSet * set, const unsigned int from) {
+	if (set->size <= from) {
+		return -1;
+	}
+	unsigned int word = from / BITS_PER_WORD;
+	BitSetWord bits = set->bits[word] & (~(BitSetWord) 0 << (from % BITS_PER_WORD));
+	while (bits == 0) {
+		if (++word == set->words) {
+			return -1;
+		}
+		bits = set->bits[word];
+	}
+	return (int) (word * BITS_PER_WORD + __builtin_ctzll(bits));
+}
@@ -0,0 +1,65 @@
+#ifndef BIT_SET_HEADER
+#define BIT_SET_HEADER
+
+#include "../../shared/Type.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * A dense set of small non-negative integers (the lattice of the data-flow
+ * analyses). Every operation works a whole word at a time, over buffers
+ * aligned and padded to 32 bytes, so the compiler can vectorize the loops.
+ */
+
+typedef uint64_t BitSetWord;
+
+typedef struct {
+	unsigned int size;
+	unsigned int words;
+	BitSetWord * bits;
+} BitSet;
+
+/**
+ * Creates an empty set for the elements in [0, size).
+ */
+BitSet * createBitSet(const unsigned int size);
+void destroyBitSet(BitSet * set);
+
+void addBit(BitSet * set, const unsigned int element);
+void removeBit(BitSet * set, const unsigned int element);
+boolean containsBit(const BitSet * set, const unsigned int element);
+
+/**
+ * Removes every element, or adds every element of the universe.
+ */
+void clearBitSet(BitSet * set);
+void fillBitSet(BitSet * set);
+
+/**
+ * Set operations over sets of the same size, which store the result in the
+ * target. They return true if the target changed.
+ */
+boolean copyBitSet(BitSet * target, const BitSet * source);
+boolean intersectBitSet(BitSet * target, const BitSet * source);
+boolean subtractBitSet(BitSet * target, const BitSet * source);
+boolean unionBitSet(BitSet * target, const BitSet * source);
+
+/**
+ * The transfer function of the gen/kill frameworks, in a single pass:
+ * target = generated + (source - killed). Returns true if the target changed.
+ */
+boolean transferBitSet(BitSet * target, const BitSet * source, const BitSet * generated, const BitSet * killed);
+
+boolean equalBitSet(const BitSet * left, const BitSet * right);
+unsigned int countBits(const BitSet * set);
+
+/**
+ * The smallest element greater than or equal to the specified one, or -1 if
+ * there is none. It allows to iterate a set:
+ *
+ *	for (int k = nextBit(set, 0); 0 <= k; k = nextBit(set, k + 1)) ...
+ */
+int nextBit(const BitSet * set, const unsigned int from);
+
+#endif
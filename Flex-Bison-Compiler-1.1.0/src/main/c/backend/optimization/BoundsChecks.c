@@ -0,0 +1,84 @@
+#include "BoundsChecks.h"
+
+/* MODULE INTERNAL STATE */
+
+/**
+ * The largest body of a for-loop that is copied to check the bounds of its
+ * accesses before it, and the message of the routine that reports an index
+ * out of bounds (with its length).
+ */
+static const unsigned int _maximumVersionedNodes = 256;
+static const char _boundsMessage[] = "Array index out of bounds.";
+
+/* PUBLIC FUNCTIONS */
+
+boolean isBoundsCheckedArray(const Symbol * symbol) {
+	return symbol != NULL && symbol->array && symbol->type != SYMBOL_PARAMETER && 0 < symbol->arraySize;
+}
+
+BoundsCheck classifyBoundsCheck(const RangeAnalysis * ranges, const HoistedLoop * hoisted, const Symbol * symbol, const Expression * index, const ComputationResult constantIndex) {
+	const RangeAccess * access = ranges == NULL ? NULL : rangeAccess(ranges, index);
+	const Range range = constantIndex.succeed
+		? (Range) { constantIndex.value, constantIndex.value }
+		: (access == NULL ? (Range) { INT_MIN, INT_MAX } : access->range);
+	if (0 <= range.minimum && range.maximum < symbol->arraySize) {
+		return BOUNDS_CHECK_ELIMINATED;
+	}
+	while (access != NULL && hoisted != NULL && hoisted->loop != access->loop) {
+		hoisted = hoisted->outer;
+	}
+	return access == NULL || hoisted == NULL ? BOUNDS_CHECK_REQUIRED : BOUNDS_CHECK_HOISTED;
+}
+
+boolean planHoistedBoundsChecks(const RangeAnalysis * ranges, const SymbolTable * symbolTable, const StatementFor * statement, IdentifierResolver resolver, void * context, HoistedBounds * bounds) {
+	const RangeLoop * loop = ranges == NULL ? NULL : rangeLoop(ranges, statement);
+	if (loop == NULL || _maximumVersionedNodes < countBlockNodes(statement->block)) {
+		return false;
+	}
+	// The initial value must be at least the lower limit, and the bound at most the upper one.
+	boolean hoisted = false;
+	int64_t lower = INT64_MIN;
+	int64_t upper = INT64_MAX;
+	for (unsigned int k = 0; k < ranges->accessCount; ++k) {
+		const RangeAccess * access = &ranges->accesses[k];
+		const Symbol * symbol = access->loop == statement ? lookupSymbol(symbolTable, access->array) : NULL;
+		if (!isBoundsCheckedArray(symbol)) {
+			continue;
+		}
+		if (access->range.minimum < 0) {
+			hoisted = true;
+			lower = lower < -(int64_t) access->offset ? -(int64_t) access->offset : lower;
+		}
+		if (symbol->arraySize <= access->range.maximum) {
+			hoisted = true;
+			upper = symbol->arraySize - (int64_t) access->offset < upper ? symbol->arraySize - (int64_t) access->offset : upper;
+		}
+	}
+	const ComputationResult initial = computeExpression(loop->variable, resolver, context);
+	const ComputationResult bound = computeExpression(loop->bound, resolver, context);
+	if (!hoisted || INT_MAX < lower || upper < INT_MIN || (initial.succeed && initial.value < lower) || (bound.succeed && upper < bound.value)) {
+		return false;
+	}
+	*bounds = (HoistedBounds) {
+		.lower = lower,
+		.upper = upper,
+		.checkLower = INT_MIN < lower && !initial.succeed,
+		.checkUpper = upper < INT_MAX && !bound.succeed
+	};
+	return true;
+}
+
+void emitBoundsFailure(Emitter * emitter) {
+	emit(emitter, 1, "%s", ".section\t.rodata\n");
+	emit(emitter, 0, "%s", ".Lbounds.message:\n");
+	emit(emitter, 1, ".string\t\"%s\\n\"\n", _boundsMessage);
+	emit(emitter, 1, "%s", ".text\n");
+	emit(emitter, 0, "%s", ".Lbounds.fail:\n");
+	emit(emitter, 1, "%s", "andq\t$-16, %rsp\n");
+	emit(emitter, 1, "%s", "movl\t$2, %edi\n");
+	emit(emitter, 1, "%s", "leaq\t.Lbounds.message(%rip), %rsi\n");
+	// The length includes the new-line, in place of the terminator.
+	emit(emitter, 1, "movl\t$%zu, %%edx\n", sizeof(_boundsMessage));
+	emit(emitter, 1, "%s", "call\twrite@PLT\n");
+	emit(emitter, 1, "%s", "call\tabort@PLT\n");
+}
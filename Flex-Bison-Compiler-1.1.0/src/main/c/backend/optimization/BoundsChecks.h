@@ -0,0 +1,89 @@
+#ifndef BOUNDS_CHECKS_HEADER
+#define BOUNDS_CHECKS_HEADER
+
+#include "../../frontend/semantic-analysis/SymbolTable.h"
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Type.h"
+#include "../code-generation/Emitter.h"
+#include "../domain-specific/Calculator.h"
+#include "Profile.h"
+#include "RangeAnalysis.h"
+#include <limits.h>
+#include <stdint.h>
+
+/**
+ * The decisions of the bounds checks (see "BOUNDS_CHECKS"), from the ranges
+ * of the indices of a function (see "RangeAnalysis"). An access to an array
+ * of known size is checked where it happens, unless its range is always in
+ * bounds, or a canonical for-loop around it checked its range before
+ * starting. Such a loop has two copies: one that trusts its accesses, and
+ * one that checks every access, used when any of them can be out of bounds.
+ * Every failed check jumps to a routine that reports it, and aborts.
+ */
+
+/**
+ * How an array access is checked: it's always in bounds, a loop around it
+ * checked it before starting, or it must be checked where it happens.
+ */
+typedef enum {
+	BOUNDS_CHECK_ELIMINATED,
+	BOUNDS_CHECK_HOISTED,
+	BOUNDS_CHECK_REQUIRED
+} BoundsCheck;
+
+/**
+ * A for-loop that checked the bounds of some of its accesses before
+ * starting, and the one around it (from the innermost one, while their
+ * bodies are generated).
+ */
+typedef struct HoistedLoop HoistedLoop;
+
+struct HoistedLoop {
+	const StatementFor * loop;
+	HoistedLoop * outer;
+};
+
+/**
+ * The limits that the induction variable of a loop must start from, and
+ * that its bound cannot exceed, so every access of its body is in bounds,
+ * and whether each one must be checked at run-time (otherwise, it's known to
+ * pass at compile-time).
+ */
+typedef struct {
+	int64_t lower;
+	int64_t upper;
+	boolean checkLower;
+	boolean checkUpper;
+} HoistedBounds;
+
+/**
+ * Whether the accesses to an array are checked: its size must be known (so
+ * the parameters aren't).
+ */
+boolean isBoundsCheckedArray(const Symbol * symbol);
+
+/**
+ * How an access to an array (see "isBoundsCheckedArray") is checked, from
+ * its index (which may be a constant), the ranges of the function (if any),
+ * and the loops that checked their accesses around it.
+ */
+BoundsCheck classifyBoundsCheck(const RangeAnalysis * ranges, const HoistedLoop * hoisted, const Symbol * symbol, const Expression * index, const ComputationResult constantIndex);
+
+/**
+ * Plans the checks of the accesses of a canonical for-loop (see
+ * "RangeAnalysis.h") once, before it starts: the lowest index of each one
+ * from the initial value of its induction variable, and the highest one from
+ * its bound (which are computed with the resolver, if they're constant).
+ * Returns false if its accesses must be checked one by one (or there's
+ * nothing to check), or if its body is too large to copy.
+ */
+boolean planHoistedBoundsChecks(const RangeAnalysis * ranges, const SymbolTable * symbolTable, const StatementFor * statement, IdentifierResolver resolver, void * context, HoistedBounds * bounds);
+
+/**
+ * Emits the routine that reports an index out of bounds, where every failed
+ * check jumps (through a call, so the stack is aligned again): it writes a
+ * message to the standard error output, and aborts the program.
+ */
+void emitBoundsFailure(Emitter * emitter);
+
+#endif
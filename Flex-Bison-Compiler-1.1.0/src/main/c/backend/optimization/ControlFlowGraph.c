@@ -0,0 +1,133 @@
+#include "ControlFlowGraph.h"
+
+/* PRIVATE FUNCTIONS */
+
+static void _addEdge(BasicBlock * source, BasicBlock * target);
+static boolean _endsBlock(const Instruction * instruction);
+static boolean _isLeader(const Instruction * instruction);
+static void _sortReversePostOrder(ControlFlowGraph * graph);
+
+static void _addEdge(BasicBlock * source, BasicBlock * target) {
+	source->successors[source->successorCount++] = target;
+	if (target->predecessorCount == target->predecessorCapacity) {
+		target->predecessorCapacity = target->predecessorCapacity == 0 ? 2 : 2 * target->predecessorCapacity;
+		target->predecessors = realloc(target->predecessors, target->predecessorCapacity * sizeof(BasicBlock *));
+	}
+	target->predecessors[target->predecessorCount++] = source;
+}
+
+static boolean _endsBlock(const Instruction * instruction) {
+	return instruction->opcode == OPCODE_JCC || instruction->opcode == OPCODE_JMP || instruction->opcode == OPCODE_RET;
+}
+
+/**
+ * True if the instruction starts a block: the first one, the first of a run
+ * of labels, and the one after a jump or a return.
+ */
+static boolean _isLeader(const Instruction * instruction) {
+	const Instruction * previous = instruction->previous;
+	return previous == NULL || _endsBlock(previous) || (instruction->opcode == OPCODE_LABEL && previous->opcode != OPCODE_LABEL);
+}
+
+/**
+ * Computes the reverse post-order with an explicit stack (a recursive search
+ * would overflow with long chains of blocks). Each stack entry remembers the
+ * next successor to visit.
+ */
+static void _sortReversePostOrder(ControlFlowGraph * graph) {
+	const unsigned int count = graph->blockCount;
+	unsigned int * stack = calloc(count, sizeof(unsigned int));
+	unsigned int * nextSuccessor = calloc(count, sizeof(unsigned int));
+	boolean * visited = calloc(count, sizeof(boolean));
+	unsigned int position = count;
+	unsigned int top = 0;
+	if (0 < count) {
+		stack[top++] = 0;
+		visited[0] = true;
+	}
+	while (0 < top) {
+		BasicBlock * block = &graph->blocks[stack[top - 1]];
+		if (nextSuccessor[block->index] < block->successorCount) {
+			BasicBlock * successor = block->successors[nextSuccessor[block->index]++];
+			if (!visited[successor->index]) {
+				visited[successor->index] = true;
+				stack[top++] = successor->index;
+			}
+		}
+		else {
+			graph->order[--position] = block->index;
+			--top;
+		}
+	}
+	// The reachable blocks were placed at the end, so they are moved first.
+	graph->reachableCount = count - position;
+	memmove(graph->order, graph->order + position, graph->reachableCount * sizeof(unsigned int));
+	unsigned int k = graph->reachableCount;
+	for (unsigned int block = 0; block < count; ++block) {
+		if (!visited[block]) {
+			graph->order[k++] = block;
+		}
+	}
+	free(visited);
+	free(nextSuccessor);
+	free(stack);
+}
+
+/* PUBLIC FUNCTIONS */
+
+ControlFlowGraph * createControlFlowGraph(const AssemblyFunction * function) {
+	ControlFlowGraph * graph = calloc(1, sizeof(ControlFlowGraph));
+	// First, count the blocks.
+	unsigned int count = 0;
+	for (const Instruction * instruction = function->instructions.first; instruction != NULL; instruction = instruction->next) {
+		if (_isLeader(instruction)) {
+			++count;
+		}
+	}
+	graph->blockCount = count;
+	graph->blocks = calloc(count == 0 ? 1 : count, sizeof(BasicBlock));
+	graph->order = calloc(count == 0 ? 1 : count, sizeof(unsigned int));
+	// Then, delimit them, and find the block of each label.
+	BasicBlock ** blockOfLabel = calloc(function->labels == 0 ? 1 : function->labels, sizeof(BasicBlock *));
+	BasicBlock * block = NULL;
+	for (Instruction * instruction = function->instructions.first; instruction != NULL; instruction = instruction->next) {
+		if (_isLeader(instruction)) {
+			block = block == NULL ? graph->blocks : block + 1;
+			block->index = (unsigned int) (block - graph->blocks);
+			block->first = instruction;
+		}
+		block->last = instruction;
+		if (instruction->opcode == OPCODE_LABEL) {
+			blockOfLabel[instruction->operands[0].label] = block;
+		}
+	}
+	// Finally, link them.
+	for (unsigned int k = 0; k < count; ++k) {
+		BasicBlock * current = &graph->blocks[k];
+		const Instruction * last = current->last;
+		if (last->opcode == OPCODE_JMP || last->opcode == OPCODE_JCC) {
+			BasicBlock * target = blockOfLabel[last->operands[0].label];
+			if (target != NULL) {
+				_addEdge(current, target);
+			}
+		}
+		const boolean fallsThrough = last->opcode != OPCODE_JMP && last->opcode != OPCODE_RET;
+		if (fallsThrough && k + 1 < count && (current->successorCount == 0 || current->successors[0] != current + 1)) {
+			_addEdge(current, current + 1);
+		}
+	}
+	free(blockOfLabel);
+	_sortReversePostOrder(graph);
+	return graph;
+}
+
+void destroyControlFlowGraph(ControlFlowGraph * graph) {
+	if (graph != NULL) {
+		for (unsigned int k = 0; k < graph->blockCount; ++k) {
+			free(graph->blocks[k].predecessors);
+		}
+		free(graph->order);
+		free(graph->blocks);
+		free(graph);
+	}
+}
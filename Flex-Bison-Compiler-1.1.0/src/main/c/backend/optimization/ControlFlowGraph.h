@@ -0,0 +1,48 @@
+#ifndef CONTROL_FLOW_GRAPH_HEADER
+#define CONTROL_FLOW_GRAPH_HEADER
+
+#include "../../shared/Type.h"
+#include "../code-generation/Assembly.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * A maximal sequence of instructions that can only be entered through its
+ * first one, and left through its last one. A block has at most two
+ * successors: the target of its last jump, and the block that follows it.
+ */
+typedef struct BasicBlock BasicBlock;
+
+struct BasicBlock {
+	unsigned int index;
+	Instruction * first;
+	Instruction * last;
+	unsigned int successorCount;
+	BasicBlock * successors[2];
+	unsigned int predecessorCount;
+	unsigned int predecessorCapacity;
+	BasicBlock ** predecessors;
+};
+
+/**
+ * The control-flow graph of a lowered function. The blocks are numbered in
+ * the order of the instructions (the first one is the entry), and "order"
+ * lists them in reverse post-order from the entry, followed by the
+ * unreachable ones (in layout order), if any.
+ */
+typedef struct {
+	unsigned int blockCount;
+	BasicBlock * blocks;
+	unsigned int * order;
+	unsigned int reachableCount;
+} ControlFlowGraph;
+
+/**
+ * Splits the instructions of the function in basic blocks, and links them.
+ * The graph references the instructions, so it must be rebuilt after any
+ * change to the control-flow.
+ */
+ControlFlowGraph * createControlFlowGraph(const AssemblyFunction * function);
+void destroyControlFlowGraph(ControlFlowGraph * graph);
+
+#endif
@@ -0,0 +1,94 @@
+#include "DataFlow.h"
+
+/* PRIVATE FUNCTIONS */
+
+static void _meet(const DataFlowProblem * problem, BitSet * target, const BitSet * source);
+
+static void _meet(const DataFlowProblem * problem, BitSet * target, const BitSet * source) {
+	if (problem->meet == DATA_FLOW_UNION) {
+		unionBitSet(target, source);
+	}
+	else {
+		intersectBitSet(target, source);
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+DataFlowSolution * solveDataFlow(const ControlFlowGraph * graph, const DataFlowProblem * problem) {
+	const unsigned int count = graph->blockCount;
+	const boolean forward = problem->direction == DATA_FLOW_FORWARD;
+	DataFlowSolution * solution = calloc(1, sizeof(DataFlowSolution));
+	solution->blockCount = count;
+	solution->in = calloc(count == 0 ? 1 : count, sizeof(BitSet *));
+	solution->out = calloc(count == 0 ? 1 : count, sizeof(BitSet *));
+	for (unsigned int k = 0; k < count; ++k) {
+		solution->in[k] = createBitSet(problem->size);
+		solution->out[k] = createBitSet(problem->size);
+		// The optimistic value of the meet, so the first visit overrides it.
+		if (problem->meet == DATA_FLOW_INTERSECTION) {
+			fillBitSet(forward ? solution->out[k] : solution->in[k]);
+		}
+	}
+	// A block visited at position "k" of the sweep is pending if "k" is in
+	// the set, so the lowest pending position is always found in O(n/64).
+	unsigned int * position = calloc(count == 0 ? 1 : count, sizeof(unsigned int));
+	unsigned int * blockAt = calloc(count == 0 ? 1 : count, sizeof(unsigned int));
+	for (unsigned int k = 0; k < count; ++k) {
+		blockAt[k] = graph->order[forward ? k : count - 1 - k];
+		position[blockAt[k]] = k;
+	}
+	BitSet * pending = createBitSet(count);
+	fillBitSet(pending);
+	int cursor = 0;
+	while (true) {
+		int k = nextBit(pending, (unsigned int) cursor);
+		if (k < 0 && (k = nextBit(pending, 0)) < 0) {
+			break;
+		}
+		removeBit(pending, (unsigned int) k);
+		cursor = k + 1;
+		const BasicBlock * block = &graph->blocks[blockAt[k]];
+		BitSet * input = forward ? solution->in[block->index] : solution->out[block->index];
+		BitSet * output = forward ? solution->out[block->index] : solution->in[block->index];
+		BasicBlock * const * sources = forward ? block->predecessors : block->successors;
+		const unsigned int sourceCount = forward ? block->predecessorCount : block->successorCount;
+		const boolean boundary = forward ? block->index == 0 : block->successorCount == 0;
+		if (problem->meet == DATA_FLOW_UNION) {
+			clearBitSet(input);
+		}
+		else {
+			fillBitSet(input);
+		}
+		if (boundary) {
+			_meet(problem, input, problem->boundary);
+		}
+		for (unsigned int s = 0; s < sourceCount; ++s) {
+			_meet(problem, input, forward ? solution->out[sources[s]->index] : solution->in[sources[s]->index]);
+		}
+		++solution->visits;
+		if (transferBitSet(output, input, problem->generated[block->index], problem->killed[block->index])) {
+			BasicBlock * const * targets = forward ? block->successors : block->predecessors;
+			const unsigned int targetCount = forward ? block->successorCount : block->predecessorCount;
+			for (unsigned int t = 0; t < targetCount; ++t) {
+				addBit(pending, position[targets[t]->index]);
+			}
+		}
+	}
+	destroyBitSet(pending);
+	free(blockAt);
+	free(position);
+	return solution;
+}
+
+void destroyDataFlowSolution(DataFlowSolution * solution) {
+	if (solution != NULL) {
+		for (unsigned int k = 0; k < solution->blockCount; ++k) {
+			destroyBitSet(solution->in[k]);
+			destroyBitSet(solution->out[k]);
+		}
+		free(solution->out);
+		free(solution->in);
+		free(solution);
+	}
+}
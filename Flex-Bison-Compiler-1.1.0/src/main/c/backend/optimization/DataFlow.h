@@ -0,0 +1,62 @@
+#ifndef DATA_FLOW_HEADER
+#define DATA_FLOW_HEADER
+
+#include "../../shared/Type.h"
+#include "BitSet.h"
+#include "ControlFlowGraph.h"
+#include <stdlib.h>
+
+/**
+ * A generic solver for the gen/kill data-flow problems over the blocks of a
+ * control-flow graph. The facts are the elements of a dense bit-set, so a
+ * problem only has to describe the local effect of each block:
+ *
+ *	forward:	in[b] = meet(out[p]) for each predecessor p
+ *			out[b] = generated[b] + (in[b] - killed[b])
+ *
+ *	backward:	out[b] = meet(in[s]) for each successor s
+ *			in[b] = generated[b] + (out[b] - killed[b])
+ *
+ * The entry block (for forward problems) or the exit blocks (for backward
+ * problems, those without successors) also meet the boundary value.
+ */
+
+typedef enum {
+	DATA_FLOW_FORWARD,
+	DATA_FLOW_BACKWARD
+} DataFlowDirection;
+
+typedef enum {
+	DATA_FLOW_UNION,
+	DATA_FLOW_INTERSECTION
+} DataFlowMeet;
+
+typedef struct {
+	DataFlowDirection direction;
+	DataFlowMeet meet;
+	unsigned int size;
+	BitSet ** generated;
+	BitSet ** killed;
+	BitSet * boundary;
+} DataFlowProblem;
+
+/**
+ * The fixed-point of a problem: the facts that hold at the beginning and at
+ * the end of each block, and the amount of blocks visited to reach it.
+ */
+typedef struct {
+	unsigned int blockCount;
+	BitSet ** in;
+	BitSet ** out;
+	unsigned long visits;
+} DataFlowSolution;
+
+/**
+ * Solves the problem with a worklist, visiting the pending blocks in reverse
+ * post-order (forward problems) or post-order (backward problems), so most
+ * blocks see their final inputs on the first sweep.
+ */
+DataFlowSolution * solveDataFlow(const ControlFlowGraph * graph, const DataFlowProblem * problem);
+void destroyDataFlowSolution(DataFlowSolution * solution);
+
+#endif
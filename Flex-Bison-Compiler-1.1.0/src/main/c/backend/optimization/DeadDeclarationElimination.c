@@ -0,0 +1,202 @@
+#include "DeadDeclarationElimination.h"
+
+/* MODULE INTERNAL STATE */
+
+static const unsigned int _initialCapacity = 16;
+
+/**
+ * The state of the reachability walk: the function definitions of the
+ * program (by name), the reachable names, and the reachable definitions that
+ * weren't walked yet.
+ */
+typedef struct {
+	SymbolTable * definitions;
+	SymbolTable * reached;
+	Declaration ** pending;
+	unsigned int pendingCount;
+	unsigned int pendingCapacity;
+} ReachabilityWalk;
+
+/* PRIVATE FUNCTIONS */
+
+static void _reach(ReachabilityWalk * walk, const char * name);
+static void _walkBlock(ReachabilityWalk * walk, const Block * block);
+static void _walkExpression(ReachabilityWalk * walk, const Expression * expression);
+static void _walkStatement(ReachabilityWalk * walk, const Statement * statement);
+
+/**
+ * Marks a name as reachable, and its definition (if it's a function of the
+ * program) as pending, the first time it's found. Like in the generator, a
+ * name defined twice resolves to its last definition.
+ */
+static void _reach(ReachabilityWalk * walk, const char * name) {
+	if (lookupSymbol(walk->reached, name) != NULL) {
+		return;
+	}
+	declareSymbol(walk->reached, name, SYMBOL_GLOBAL_VARIABLE, TYPE_INT);
+	const Symbol * symbol = lookupSymbol(walk->definitions, name);
+	if (symbol == NULL) {
+		return;
+	}
+	if (walk->pendingCount == walk->pendingCapacity) {
+		walk->pendingCapacity = walk->pendingCapacity == 0 ? _initialCapacity : 2 * walk->pendingCapacity;
+		walk->pending = realloc(walk->pending, walk->pendingCapacity * sizeof(Declaration *));
+	}
+	walk->pending[walk->pendingCount++] = symbol->definition;
+}
+
+/**
+ * Walks a block (and the ones nested in it).
+ */
+static void _walkBlock(ReachabilityWalk * walk, const Block * block) {
+	for (const Statements * statements = block->statements; statements != NULL; statements = statements->next) {
+		_walkStatement(walk, statements->statement);
+	}
+}
+
+/**
+ * Walks an expression, reaching every name in it.
+ */
+static void _walkExpression(ReachabilityWalk * walk, const Expression * expression) {
+	switch (expression->type) {
+		case EXPRESSION_NOT:
+		case EXPRESSION_PARENTHESIS:
+			_walkExpression(walk, expression->singleExpression);
+			break;
+		case EXPRESSION_IDENTIFIER:
+			_reach(walk, *expression->identifier);
+			break;
+		case EXPRESSION_CONSTANT:
+			break;
+		case EXPRESSION_ARRAY_ACCESS:
+			_reach(walk, *expression->identifierArray);
+			_walkExpression(walk, expression->indexExpression);
+			break;
+		case EXPRESSION_FUNCTION_CALL:
+			_reach(walk, *expression->identifierFunc);
+			for (const ListArguments * argument = expression->arguments; argument != NULL; argument = argument->next) {
+				_walkExpression(walk, argument->expression);
+			}
+			break;
+		default:
+			_walkExpression(walk, expression->leftExpression);
+			_walkExpression(walk, expression->rightExpression);
+			break;
+	}
+}
+
+/**
+ * Walks a statement, reaching every name in its expressions.
+ */
+static void _walkStatement(ReachabilityWalk * walk, const Statement * statement) {
+	switch (statement->type) {
+		case STATEMENT_DECLARATION:
+			if (statement->variableSuffix->type == VARIABLE_SUFFIX_ASSIGNMENT) {
+				_walkExpression(walk, statement->variableSuffix->expression);
+			}
+			break;
+		case STATEMENT_IF:
+			_walkExpression(walk, statement->statementIf->condition);
+			_walkBlock(walk, statement->statementIf->thenBlock);
+			if (statement->statementIf->hasElse) {
+				_walkBlock(walk, statement->statementIf->elseBlock);
+			}
+			break;
+		case STATEMENT_WHILE:
+			_walkExpression(walk, statement->statementWhile->condition);
+			_walkBlock(walk, statement->statementWhile->block);
+			break;
+		case STATEMENT_FOR: {
+			const StatementFor * loop = statement->statementFor;
+			if (loop->hasInit) {
+				_walkExpression(walk, loop->init);
+			}
+			if (loop->hasCondition) {
+				_walkExpression(walk, loop->condition);
+			}
+			if (loop->hasUpdate) {
+				_walkExpression(walk, loop->update);
+			}
+			_walkBlock(walk, loop->block);
+			break;
+		}
+		case STATEMENT_RETURN:
+			if (statement->statementReturn->hasExpression) {
+				_walkExpression(walk, statement->statementReturn->expression);
+			}
+			break;
+		case STATEMENT_EXPRESSION:
+			_walkExpression(walk, statement->statementExpression->expression);
+			break;
+		case STATEMENT_BLOCK:
+			_walkBlock(walk, statement->block);
+			break;
+		case STATEMENT_EMPTY:
+			break;
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+EliminatedDeclarations eliminateDeadDeclarations(Program * program, const char * exportedSymbols) {
+	EliminatedDeclarations eliminated = {
+		.functions = 0,
+		.globals = 0
+	};
+	if (program->type != PROGRAM_DECLARATIONS) {
+		return eliminated;
+	}
+	ReachabilityWalk walk = {
+		.definitions = createSymbolTable(),
+		.reached = createSymbolTable(),
+		.pending = NULL,
+		.pendingCount = 0,
+		.pendingCapacity = 0
+	};
+	for (DeclarationList * node = program->declarationList; node != NULL; node = node->next) {
+		DeclarationSuffix * suffix = node->declaration->declarationSuffix;
+		if (suffix->type == DECLARATION_SUFFIX_FUNCTION && suffix->functionSuffix->type == SUFFIX_BLOCK) {
+			const char * name = *node->declaration->identifier;
+			Symbol * symbol = lookupSymbol(walk.definitions, name);
+			if (symbol == NULL) {
+				symbol = declareSymbol(walk.definitions, name, SYMBOL_FUNCTION, node->declaration->dataType);
+			}
+			symbol->definition = node->declaration;
+		}
+	}
+	_reach(&walk, "main");
+	if (exportedSymbols != NULL) {
+		char * list = strdup(exportedSymbols);
+		char * state = NULL;
+		for (char * name = strtok_r(list, ":", &state); name != NULL; name = strtok_r(NULL, ":", &state)) {
+			_reach(&walk, name);
+		}
+		free(list);
+	}
+	while (0 < walk.pendingCount) {
+		const Declaration * function = walk.pending[--walk.pendingCount];
+		_walkBlock(&walk, function->declarationSuffix->functionSuffix->block);
+	}
+	for (DeclarationList ** link = &program->declarationList; *link != NULL; ) {
+		DeclarationList * node = *link;
+		Declaration * declaration = node->declaration;
+		if (lookupSymbol(walk.reached, *declaration->identifier) != NULL) {
+			link = &node->next;
+			continue;
+		}
+		DeclarationSuffix * suffix = declaration->declarationSuffix;
+		if (suffix->type == DECLARATION_SUFFIX_FUNCTION) {
+			eliminated.functions += suffix->functionSuffix->type == SUFFIX_BLOCK ? 1 : 0;
+		}
+		else if (declaration->declarationType == DECLARATION_REGULAR || suffix->variableSuffix->type == VARIABLE_SUFFIX_ASSIGNMENT) {
+			++eliminated.globals;
+		}
+		*link = node->next;
+		freeDeclaration(declaration);
+		free(node);
+	}
+	free(walk.pending);
+	destroySymbolTable(walk.definitions);
+	destroySymbolTable(walk.reached);
+	return eliminated;
+}
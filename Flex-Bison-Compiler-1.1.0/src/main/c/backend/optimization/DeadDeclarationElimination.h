@@ -0,0 +1,37 @@
+#ifndef DEAD_DECLARATION_ELIMINATION_HEADER
+#define DEAD_DECLARATION_ELIMINATION_HEADER
+
+#include "../../frontend/semantic-analysis/SymbolTable.h"
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Type.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * A whole-program elimination of the functions and globals that nothing
+ * uses (see "WHOLE_PROGRAM"). The roots are "main" and the exported symbols,
+ * and a name is reachable if a reachable function names it (a call, or a
+ * use of a global). Local variables aren't resolved, so one that shadows a
+ * global keeps it, which is only conservative. Every top-level declaration
+ * of a name that isn't reachable is removed from the program (including its
+ * prototypes and external declarations), before any of it is generated.
+ */
+
+/**
+ * The amount of removed function definitions and global variables (the
+ * prototypes and the external declarations aren't counted, since they
+ * generate nothing).
+ */
+typedef struct {
+	unsigned int functions;
+	unsigned int globals;
+} EliminatedDeclarations;
+
+/**
+ * Removes (and frees) the top-level declarations of a program that aren't
+ * reachable from "main", or from a list of exported names separated by
+ * colons (which can be NULL).
+ */
+EliminatedDeclarations eliminateDeadDeclarations(Program * program, const char * exportedSymbols);
+
+#endif
@@ -0,0 +1,56 @@
+#include "DeadStoreElimination.h"
+
+/* PRIVATE FUNCTIONS */
+
+static boolean _isPureStore(const Instruction * instruction);
+
+/**
+ * True if the only effect of the instruction is to write its last operand
+ * (so it can be removed if that value is dead).
+ */
+static boolean _isPureStore(const Instruction * instruction) {
+	switch (instruction->opcode) {
+		case OPCODE_MOV:
+		case OPCODE_MOVSB:
+		case OPCODE_MOVSL:
+		case OPCODE_MOVZB:
+		case OPCODE_SETCC:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+unsigned int eliminateDeadStores(AssemblyFunction * function) {
+	SlotLiveness * liveness = computeSlotLiveness(function);
+	const ControlFlowGraph * graph = liveness->graph;
+	BitSet * live = createBitSet(liveness->slotCount);
+	unsigned int removed = 0;
+	SlotAccess accesses[3];
+	for (unsigned int b = 0; b < graph->blockCount; ++b) {
+		const BasicBlock * block = &graph->blocks[b];
+		copyBitSet(live, liveness->solution->out[b]);
+		Instruction * instruction = block->last;
+		while (true) {
+			Instruction * previous = instruction == block->first ? NULL : instruction->previous;
+			if (_isPureStore(instruction) && getSlotAccesses(function, instruction, accesses) == 1
+					&& accesses[0].written && accesses[0].complete && !containsBit(live, (unsigned int) accesses[0].slot)) {
+				// A pure store only reads registers, so the live slots don't change.
+				removeInstruction(&function->instructions, instruction);
+				++removed;
+			}
+			else {
+				transferSlotLiveness(liveness, function, instruction, live);
+			}
+			if (previous == NULL) {
+				break;
+			}
+			instruction = previous;
+		}
+	}
+	destroyBitSet(live);
+	destroySlotLiveness(liveness);
+	return removed;
+}
@@ -0,0 +1,17 @@
+#ifndef DEAD_STORE_ELIMINATION_HEADER
+#define DEAD_STORE_ELIMINATION_HEADER
+
+#include "../../shared/Type.h"
+#include "../code-generation/Assembly.h"
+#include "BitSet.h"
+#include "Liveness.h"
+#include <stdlib.h>
+
+/**
+ * Removes the stores to stack slots whose value is never read afterwards
+ * (like the initialization of a variable whose every use was replaced by a
+ * constant). Returns the amount of removed instructions.
+ */
+unsigned int eliminateDeadStores(AssemblyFunction * function);
+
+#endif
@@ -0,0 +1,130 @@
+#include "Instrumentation.h"
+
+/* PUBLIC FUNCTIONS */
+
+void addInstrumentedFunction(InstrumentedFunctions * table, const char * name, const unsigned int key, const unsigned int counterCount) {
+	if (table->count == table->capacity) {
+		table->capacity = table->capacity == 0 ? 16 : 2 * table->capacity;
+		table->functions = realloc(table->functions, table->capacity * sizeof(InstrumentedFunction));
+	}
+	table->functions[table->count++] = (InstrumentedFunction) {
+		.name = strdup(name),
+		.key = key,
+		.counterCount = counterCount
+	};
+}
+
+void releaseInstrumentedFunctions(InstrumentedFunctions * table) {
+	for (unsigned int k = 0; k < table->count; ++k) {
+		free(table->functions[k].name);
+	}
+	free(table->functions);
+	*table = (InstrumentedFunctions) {
+		.functions = NULL,
+		.count = 0,
+		.capacity = 0
+	};
+}
+
+void emitFunctionCounters(Emitter * emitter, const AssemblyFunction * function) {
+	if (function->counters != NULL) {
+		emit(emitter, 1, "%s", ".bss\n");
+		emit(emitter, 1, "%s", ".align\t8\n");
+		emit(emitter, 0, "%s:\n", function->counters);
+		emit(emitter, 1, ".zero\t%u\n", 8 * function->counterCount);
+	}
+	if (function->blocks != NULL) {
+		emit(emitter, 1, "%s", ".bss\n");
+		emit(emitter, 1, "%s", ".align\t8\n");
+		emit(emitter, 0, "%s:\n", function->blocks);
+		emit(emitter, 1, ".zero\t%u\n", 8 * function->blockCounterCount);
+		emit(emitter, 1, "%s", ".section\t.rodata\n");
+		emit(emitter, 1, "%s", ".align\t4\n");
+		emit(emitter, 0, ".Llines.%s:\n", function->name);
+		for (unsigned int k = 0; k < function->blockCount; ++k) {
+			emit(emitter, 1, ".long\t%u, %d, %d, %d\n", function->blockLines[k], function->blockCounters[k], function->blockAdded[k], function->blockSubtracted[k]);
+		}
+	}
+}
+
+void emitCounterDump(Emitter * emitter, const char * prefix, const char * path, const InstrumentedFunctions * table, const char * counters, const boolean lines) {
+	static const char * const code[] = {
+		"#.dump:", "pushq\t%rbx", "pushq\t%r12", "pushq\t%r13", "pushq\t%r14", "pushq\t%r15",
+		"leaq\t#.path(%rip), %rdi", "leaq\t#.mode(%rip), %rsi", "call\tfopen@PLT",
+		"testq\t%rax, %rax", "je\t#.done", "movq\t%rax, %rbx", "leaq\t#.table(%rip), %r12",
+		"#.function:", "movq\t(%r12), %rdx", "testq\t%rdx, %rdx", "je\t#.close",
+		"movq\t%rbx, %rdi", "leaq\t#.header(%rip), %rsi", "movl\t8(%r12), %ecx", "movl\t12(%r12), %r8d",
+		"xorl\t%eax, %eax", "call\tfprintf@PLT", "movq\t16(%r12), %r13", "movl\t12(%r12), %r14d", "movq\t24(%r12), %r15",
+		"#.counter:", "testl\t%r14d, %r14d", "je\t#.next", "testq\t%r15, %r15", "jne\t#.block",
+		"movq\t(%r13), %rdx", "addq\t$8, %r13", "jmp\t#.value",
+		"#.block:", "movl\t(%r15), %edx", "xorl\t%ecx, %ecx", "movslq\t4(%r15), %rax", "testq\t%rax, %rax", "js\t#.add",
+		"movq\t(%r13,%rax,8), %rcx",
+		"#.add:", "movslq\t8(%r15), %rax", "testq\t%rax, %rax", "js\t#.subtract", "addq\t(%r13,%rax,8), %rcx",
+		"#.subtract:", "movslq\t12(%r15), %rax", "testq\t%rax, %rax", "js\t#.counted", "subq\t(%r13,%rax,8), %rcx",
+		"#.counted:", "addq\t$16, %r15",
+		"#.value:", "movq\t%rbx, %rdi", "leaq\t#.format(%rip), %rsi",
+		"xorl\t%eax, %eax", "call\tfprintf@PLT", "decl\t%r14d", "jmp\t#.counter",
+		"#.next:", "addq\t$32, %r12", "jmp\t#.function",
+		"#.close:", "movq\t%rbx, %rdi", "call\tfclose@PLT",
+		"#.done:", "popq\t%r15", "popq\t%r14", "popq\t%r13", "popq\t%r12", "popq\t%rbx", "ret"
+	};
+	emit(emitter, 1, "%s", ".section\t.rodata\n");
+	emit(emitter, 0, ".L%s.path:\n", prefix);
+	emit(emitter, 1, "%s", ".string\t\"");
+	for (const char * character = path; *character != '\0'; ++character) {
+		if (*character == '"' || *character == '\\') {
+			emit(emitter, 0, "\\%c", *character);
+		}
+		else {
+			emit(emitter, 0, "%c", *character);
+		}
+	}
+	emit(emitter, 0, "%s", "\"\n");
+	emit(emitter, 0, ".L%s.mode:\n", prefix);
+	emit(emitter, 1, "%s", ".string\t\"a\"\n");
+	emit(emitter, 0, ".L%s.header:\n", prefix);
+	emit(emitter, 1, "%s", ".string\t\"function %s %u %u\\n\"\n");
+	emit(emitter, 0, ".L%s.format:\n", prefix);
+	emit(emitter, 1, ".string\t\"%s\"\n", lines ? "%u %lu\\n" : "%lu\\n");
+	for (unsigned int k = 0; k < table->count; ++k) {
+		emit(emitter, 0, ".L%s.name.%u:\n", prefix, k);
+		emit(emitter, 1, ".string\t\"%s\"\n", table->functions[k].name);
+	}
+	emit(emitter, 1, "%s", ".data\n");
+	emit(emitter, 1, "%s", ".align\t8\n");
+	emit(emitter, 0, ".L%s.table:\n", prefix);
+	for (unsigned int k = 0; k < table->count; ++k) {
+		const InstrumentedFunction * function = &table->functions[k];
+		emit(emitter, 1, ".quad\t.L%s.name.%u\n", prefix, k);
+		emit(emitter, 1, ".long\t%u\n", function->key);
+		emit(emitter, 1, ".long\t%u\n", function->counterCount);
+		if (0 < function->counterCount) {
+			emit(emitter, 1, ".quad\t.L%s.%s\n", counters, function->name);
+		}
+		else {
+			emit(emitter, 1, "%s", ".quad\t0\n");
+		}
+		if (lines) {
+			emit(emitter, 1, ".quad\t.Llines.%s\n", function->name);
+		}
+		else {
+			emit(emitter, 1, "%s", ".quad\t0\n");
+		}
+	}
+	emit(emitter, 1, "%s", ".quad\t0\n");
+	emit(emitter, 1, "%s", ".text\n");
+	for (size_t k = 0; k < sizeof(code) / sizeof(code[0]); ++k) {
+		const char * text = code[k];
+		unsigned int indentationLevel = text[strlen(text) - 1] == ':' ? 0 : 1;
+		for (const char * mark = strchr(text, '#'); mark != NULL; mark = strchr(text, '#')) {
+			emitText(emitter, indentationLevel, text, (size_t) (mark - text));
+			emit(emitter, 0, ".L%s", prefix);
+			text = mark + 1;
+			indentationLevel = 0;
+		}
+		emit(emitter, indentationLevel, "%s\n", text);
+	}
+	emit(emitter, 1, "%s", ".section\t.fini_array,\"aw\"\n");
+	emit(emitter, 1, "%s", ".align\t8\n");
+	emit(emitter, 1, ".quad\t.L%s.dump\n", prefix);
+}
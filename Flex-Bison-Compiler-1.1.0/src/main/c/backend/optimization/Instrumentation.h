@@ -0,0 +1,64 @@
+#ifndef INSTRUMENTATION_HEADER
+#define INSTRUMENTATION_HEADER
+
+#include "../../shared/Type.h"
+#include "../code-generation/Assembly.h"
+#include "../code-generation/Emitter.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The output of the counters of an instrumented program (see
+ * "PROFILE_OUTPUT_FILE"), or of a program with coverage (see
+ * "COVERAGE_OUTPUT_FILE"). Every function with counters reserves them (and
+ * the lines of its basic blocks, with coverage) next to its code, and is
+ * listed in a table of the program, whose counters are appended to a file
+ * when the program exits.
+ */
+
+/**
+ * A function with counters, in a table of the program: its key is the
+ * structural hash of the function in a profile, or its line in a coverage.
+ */
+typedef struct {
+	char * name;
+	unsigned int key;
+	unsigned int counterCount;
+} InstrumentedFunction;
+
+typedef struct {
+	InstrumentedFunction * functions;
+	unsigned int count;
+	unsigned int capacity;
+} InstrumentedFunctions;
+
+/**
+ * Appends a function to a table (the name is copied).
+ */
+void addInstrumentedFunction(InstrumentedFunctions * table, const char * name, const unsigned int key, const unsigned int counterCount);
+
+/**
+ * Releases the functions of a table, which is left empty.
+ */
+void releaseInstrumentedFunctions(InstrumentedFunctions * table);
+
+/**
+ * Emits the counters of a lowered function (its profiling counters, or its
+ * basic block counters and the line and count of each block), if it has any.
+ */
+void emitFunctionCounters(Emitter * emitter, const AssemblyFunction * function);
+
+/**
+ * Emits the table of some functions with counters, and a routine that
+ * appends their counters to a file when the program exits: a header for each
+ * function (its name, key and amount of counters), and then each counter in
+ * a line. With lines, there's a line for each basic block instead, with the
+ * line where it starts, and its count (see "ProfileSites"). The symbols are
+ * prefixed with ".L" and the prefix, and the counters of each function are
+ * named after it, also prefixed with ".L" (e.g., ".Lcounters.main").
+ * Everything is local to this program, so many instrumented programs can be
+ * linked together.
+ */
+void emitCounterDump(Emitter * emitter, const char * prefix, const char * path, const InstrumentedFunctions * table, const char * counters, const boolean lines);
+
+#endif
@@ -0,0 +1,238 @@
+#include "JumpThreading.h"
+
+/* MODULE INTERNAL STATE */
+
+/**
+ * An upper bound on the amount of passes, since every rewrite enables new
+ * ones, but a pathological control-flow should not stall the compiler.
+ */
+static const int _maximumPasses = 16;
+
+/* PRIVATE FUNCTIONS */
+
+static boolean _fallsInto(const Instruction * instruction, const int label);
+static int _finalTarget(Instruction ** labels, int * stamps, const int labelCount, const int label, const int stamp);
+static boolean _isComparison(const Instruction * instruction);
+static boolean _isJump(const Instruction * instruction);
+static Instruction * _nextExecuted(Instruction * instruction);
+static boolean _removeUnreachable(InstructionList * list);
+static boolean _removeUnusedLabels(AssemblyFunction * function);
+static void _retarget(Instruction * jump, const int label);
+static boolean _sameComparison(const Instruction * left, const Instruction * right);
+static boolean _threadPass(AssemblyFunction * function);
+static boolean _threadRepeatedComparison(AssemblyFunction * function, Instruction ** labels, const int labelCount, Instruction * jump);
+
+/**
+ * True if the label is placed right after the instruction (maybe among other
+ * labels), so jumping to it is the same as falling through.
+ */
+static boolean _fallsInto(const Instruction * instruction, const int label) {
+	for (const Instruction * next = instruction->next; next != NULL && next->opcode == OPCODE_LABEL; next = next->next) {
+		if (next->operands[0].label == label) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Follows a chain of unconditional jumps starting at the specified label,
+ * and returns its last label. If the chain ends in a cycle (an empty
+ * infinite loop), the label is left as is. The visited labels are marked
+ * with the stamp, which must be unique per call.
+ */
+static int _finalTarget(Instruction ** labels, int * stamps, const int labelCount, const int label, const int stamp) {
+	int target = label;
+	while (target < labelCount && labels[target] != NULL) {
+		stamps[target] = stamp;
+		Instruction * next = _nextExecuted(labels[target]);
+		if (next == NULL || next->opcode != OPCODE_JMP) {
+			return target;
+		}
+		const int nextTarget = next->operands[0].label;
+		if (nextTarget < labelCount && stamps[nextTarget] == stamp) {
+			return label;
+		}
+		target = nextTarget;
+	}
+	return target;
+}
+
+static boolean _isComparison(const Instruction * instruction) {
+	return instruction != NULL && (instruction->opcode == OPCODE_CMP || instruction->opcode == OPCODE_TEST);
+}
+
+static boolean _isJump(const Instruction * instruction) {
+	return instruction->opcode == OPCODE_JMP || instruction->opcode == OPCODE_JCC;
+}
+
+/**
+ * The first instruction that is not a label, starting at the specified one.
+ */
+static Instruction * _nextExecuted(Instruction * instruction) {
+	while (instruction != NULL && instruction->opcode == OPCODE_LABEL) {
+		instruction = instruction->next;
+	}
+	return instruction;
+}
+
+/**
+ * Removes the instructions between an unconditional jump (or a return) and
+ * the next label, since nothing can reach them.
+ */
+static boolean _removeUnreachable(InstructionList * list) {
+	boolean changed = false;
+	for (Instruction * instruction = list->first; instruction != NULL; instruction = instruction->next) {
+		if (instruction->opcode != OPCODE_JMP && instruction->opcode != OPCODE_RET) {
+			continue;
+		}
+		while (instruction->next != NULL && instruction->next->opcode != OPCODE_LABEL) {
+			removeInstruction(list, instruction->next);
+			changed = true;
+		}
+	}
+	return changed;
+}
+
+/**
+ * Removes the labels that no jump references anymore, which exposes new
+ * fall-through opportunities.
+ */
+static boolean _removeUnusedLabels(AssemblyFunction * function) {
+	int * references = calloc(function->labels, sizeof(int));
+	for (Instruction * instruction = function->instructions.first; instruction != NULL; instruction = instruction->next) {
+		if (_isJump(instruction)) {
+			++references[instruction->operands[0].label];
+		}
+	}
+	boolean changed = false;
+	Instruction * instruction = function->instructions.first;
+	while (instruction != NULL) {
+		Instruction * next = instruction->next;
+		if (instruction->opcode == OPCODE_LABEL && references[instruction->operands[0].label] == 0) {
+			removeInstruction(&function->instructions, instruction);
+			changed = true;
+		}
+		instruction = next;
+	}
+	free(references);
+	return changed;
+}
+
+static void _retarget(Instruction * jump, const int label) {
+	jump->operands[0] = labelOperand(label);
+}
+
+/**
+ * True if both instructions compute the same flags.
+ */
+static boolean _sameComparison(const Instruction * left, const Instruction * right) {
+	return _isComparison(left) && _isComparison(right)
+		&& left->opcode == right->opcode
+		&& left->width == right->width
+		&& sameOperand(&left->operands[0], &right->operands[0])
+		&& sameOperand(&left->operands[1], &right->operands[1]);
+}
+
+/**
+ * Applies every rewrite once over the whole function. Returns true if
+ * anything changed.
+ */
+static boolean _threadPass(AssemblyFunction * function) {
+	InstructionList * list = &function->instructions;
+	const int labelCount = function->labels;
+	Instruction ** labels = calloc(labelCount, sizeof(Instruction *));
+	int * stamps = calloc(labelCount, sizeof(int));
+	for (Instruction * instruction = list->first; instruction != NULL; instruction = instruction->next) {
+		if (instruction->opcode == OPCODE_LABEL) {
+			labels[instruction->operands[0].label] = instruction;
+		}
+	}
+	boolean changed = false;
+	int stamp = 0;
+	Instruction * instruction = list->first;
+	while (instruction != NULL) {
+		if (!_isJump(instruction)) {
+			instruction = instruction->next;
+			continue;
+		}
+		const int target = _finalTarget(labels, stamps, labelCount, instruction->operands[0].label, ++stamp);
+		if (target != instruction->operands[0].label) {
+			_retarget(instruction, target);
+			changed = true;
+		}
+		if (instruction->opcode == OPCODE_JCC) {
+			changed |= _threadRepeatedComparison(function, labels, labelCount, instruction);
+			if (_sameComparison(instruction->previous, instruction->next)) {
+				removeInstruction(list, instruction->next);
+				changed = true;
+			}
+			Instruction * next = instruction->next;
+			if (next != NULL && next->opcode == OPCODE_JMP && _fallsInto(next, instruction->operands[0].label)) {
+				instruction->condition = negateCondition(instruction->condition);
+				_retarget(instruction, next->operands[0].label);
+				removeInstruction(list, next);
+				changed = true;
+			}
+		}
+		Instruction * next = instruction->next;
+		if (_fallsInto(instruction, instruction->operands[0].label)) {
+			removeInstruction(list, instruction);
+			changed = true;
+		}
+		instruction = next;
+	}
+	free(stamps);
+	free(labels);
+	changed |= _removeUnreachable(list);
+	changed |= _removeUnusedLabels(function);
+	return changed;
+}
+
+/**
+ * If a conditional jump lands on the same comparison that set its flags,
+ * followed by another conditional jump, the outcome of the latter is already
+ * known, so the first jump can skip both.
+ */
+static boolean _threadRepeatedComparison(AssemblyFunction * function, Instruction ** labels, const int labelCount, Instruction * jump) {
+	const int target = jump->operands[0].label;
+	if (!_isComparison(jump->previous) || labelCount <= target || labels[target] == NULL) {
+		return false;
+	}
+	Instruction * comparison = _nextExecuted(labels[target]);
+	if (!_sameComparison(comparison, jump->previous) || comparison->next == NULL || comparison->next->opcode != OPCODE_JCC) {
+		return false;
+	}
+	Instruction * nextJump = comparison->next;
+	int label = target;
+	if (nextJump->condition == jump->condition) {
+		label = nextJump->operands[0].label;
+	}
+	else if (nextJump->condition == negateCondition(jump->condition)) {
+		if (nextJump->next != NULL && nextJump->next->opcode == OPCODE_LABEL) {
+			label = nextJump->next->operands[0].label;
+		}
+		else {
+			label = createLabel(function);
+			Instruction * instruction = createInstruction(OPCODE_LABEL, WIDTH_QUAD, 1, labelOperand(label));
+			if (nextJump->next == NULL) {
+				appendInstruction(&function->instructions, instruction);
+			}
+			else {
+				insertInstructionBefore(&function->instructions, nextJump->next, instruction);
+			}
+		}
+	}
+	if (label == target) {
+		return false;
+	}
+	_retarget(jump, label);
+	return true;
+}
+
+/* PUBLIC FUNCTIONS */
+
+void threadJumps(AssemblyFunction * function) {
+	for (int pass = 0; pass < _maximumPasses && _threadPass(function); ++pass) {
+	}
+}
@@ -0,0 +1,21 @@
+#ifndef JUMP_THREADING_HEADER
+#define JUMP_THREADING_HEADER
+
+#include "../../shared/Type.h"
+#include "../code-generation/Assembly.h"
+#include <stdlib.h>
+
+/**
+ * Simplifies the control-flow of a lowered function until nothing changes:
+ *
+ *	- Jumps to unconditional jumps are retargeted to their final label.
+ *	- A conditional jump to a label that repeats the same comparison is
+ *	  retargeted to wherever that comparison would go (the flags are known).
+ *	- A comparison repeated right after a conditional jump is removed.
+ *	- "jcc L; jmp M; L:" becomes "jncc M; L:".
+ *	- Jumps to the next instruction, unreachable code and unused labels are
+ *	  removed.
+ */
+void threadJumps(AssemblyFunction * function);
+
+#endif
@@ -0,0 +1,171 @@
+#include "Liveness.h"
+
+/* PRIVATE FUNCTIONS */
+
+static void _access(const AssemblyFunction * function, const Operand * operand, const Width width, const boolean read, const boolean written, SlotAccess * access);
+static Width _destinationWidth(const Instruction * instruction);
+
+/**
+ * Describes the access to an operand, which must reference a slot.
+ */
+static void _access(const AssemblyFunction * function, const Operand * operand, const Width width, const boolean read, const boolean written, SlotAccess * access) {
+	access->slot = operand->slot;
+	access->read = read;
+	access->written = written;
+	access->complete = written && operand->index == REGISTER_NONE && operand->displacement == 0
+		&& function->frame.slots[operand->slot].size == (int) width;
+	access->escapes = false;
+}
+
+/**
+ * The width of the last operand, which is not the width of the instruction
+ * for the extensions and "setcc".
+ */
+static Width _destinationWidth(const Instruction * instruction) {
+	switch (instruction->opcode) {
+		case OPCODE_MOVSB:
+		case OPCODE_MOVZB:
+			return WIDTH_LONG;
+		case OPCODE_MOVSL:
+			return WIDTH_QUAD;
+		case OPCODE_SETCC:
+			return WIDTH_BYTE;
+		default:
+			return instruction->width;
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+unsigned int getSlotAccesses(const AssemblyFunction * function, const Instruction * instruction, SlotAccess accesses[3]) {
+	unsigned int count = 0;
+	const unsigned int last = instruction->operandCount - 1;
+	for (unsigned int k = 0; k < instruction->operandCount; ++k) {
+		const Operand * operand = &instruction->operands[k];
+		if (operand->type != OPERAND_MEMORY || operand->slot < 0) {
+			continue;
+		}
+		boolean read = true;
+		boolean written = false;
+		switch (instruction->opcode) {
+			case OPCODE_LEA:
+				accesses[count].slot = operand->slot;
+				accesses[count].read = false;
+				accesses[count].written = false;
+				accesses[count].complete = false;
+				accesses[count].escapes = true;
+				++count;
+				continue;
+			case OPCODE_MOV:
+			case OPCODE_MOVSB:
+			case OPCODE_MOVSL:
+			case OPCODE_MOVZB:
+				read = k != last;
+				written = k == last;
+				break;
+			case OPCODE_POP:
+			case OPCODE_SETCC:
+				read = false;
+				written = true;
+				break;
+			case OPCODE_IMUL:
+				read = instruction->operandCount < 3 || k != last;
+				written = k == last;
+				break;
+			case OPCODE_ADD:
+			case OPCODE_AND:
+			case OPCODE_NEG:
+			case OPCODE_SAR:
+			case OPCODE_SHL:
+			case OPCODE_SHR:
+			case OPCODE_SUB:
+			case OPCODE_XOR:
+				written = k == last;
+				break;
+			default:
+				break;
+		}
+		_access(function, operand, k == last ? _destinationWidth(instruction) : instruction->width, read, written, &accesses[count++]);
+	}
+	return count;
+}
+
+SlotLiveness * computeSlotLiveness(const AssemblyFunction * function) {
+	SlotLiveness * liveness = calloc(1, sizeof(SlotLiveness));
+	ControlFlowGraph * graph = createControlFlowGraph(function);
+	const unsigned int slotCount = (unsigned int) function->frame.count;
+	liveness->graph = graph;
+	liveness->slotCount = slotCount;
+	liveness->escaping = createBitSet(slotCount);
+	DataFlowProblem problem = {
+		.direction = DATA_FLOW_BACKWARD,
+		.meet = DATA_FLOW_UNION,
+		.size = slotCount,
+		.generated = calloc(graph->blockCount == 0 ? 1 : graph->blockCount, sizeof(BitSet *)),
+		.killed = calloc(graph->blockCount == 0 ? 1 : graph->blockCount, sizeof(BitSet *)),
+		.boundary = createBitSet(slotCount)
+	};
+	// The upward-exposed reads of each block, and its complete writes.
+	SlotAccess accesses[3];
+	for (unsigned int b = 0; b < graph->blockCount; ++b) {
+		BitSet * generated = problem.generated[b] = createBitSet(slotCount);
+		BitSet * killed = problem.killed[b] = createBitSet(slotCount);
+		for (const Instruction * instruction = graph->blocks[b].first; ; instruction = instruction->next) {
+			const unsigned int count = getSlotAccesses(function, instruction, accesses);
+			for (unsigned int k = 0; k < count; ++k) {
+				if (accesses[k].escapes) {
+					addBit(liveness->escaping, (unsigned int) accesses[k].slot);
+				}
+				else if ((accesses[k].read || (accesses[k].written && !accesses[k].complete)) && !containsBit(killed, (unsigned int) accesses[k].slot)) {
+					addBit(generated, (unsigned int) accesses[k].slot);
+				}
+			}
+			for (unsigned int k = 0; k < count; ++k) {
+				if (accesses[k].complete) {
+					addBit(killed, (unsigned int) accesses[k].slot);
+				}
+			}
+			if (instruction == graph->blocks[b].last) {
+				break;
+			}
+		}
+	}
+	copyBitSet(problem.boundary, liveness->escaping);
+	for (unsigned int b = 0; b < graph->blockCount; ++b) {
+		unionBitSet(problem.generated[b], liveness->escaping);
+		subtractBitSet(problem.killed[b], liveness->escaping);
+	}
+	liveness->solution = solveDataFlow(graph, &problem);
+	for (unsigned int b = 0; b < graph->blockCount; ++b) {
+		destroyBitSet(problem.generated[b]);
+		destroyBitSet(problem.killed[b]);
+	}
+	destroyBitSet(problem.boundary);
+	free(problem.killed);
+	free(problem.generated);
+	return liveness;
+}
+
+void destroySlotLiveness(SlotLiveness * liveness) {
+	if (liveness != NULL) {
+		destroyDataFlowSolution(liveness->solution);
+		destroyControlFlowGraph(liveness->graph);
+		destroyBitSet(liveness->escaping);
+		free(liveness);
+	}
+}
+
+void transferSlotLiveness(const SlotLiveness * liveness, const AssemblyFunction * function, const Instruction * instruction, BitSet * live) {
+	SlotAccess accesses[3];
+	const unsigned int count = getSlotAccesses(function, instruction, accesses);
+	for (unsigned int k = 0; k < count; ++k) {
+		if (accesses[k].complete && !containsBit(liveness->escaping, (unsigned int) accesses[k].slot)) {
+			removeBit(live, (unsigned int) accesses[k].slot);
+		}
+	}
+	for (unsigned int k = 0; k < count; ++k) {
+		if (accesses[k].read || (accesses[k].written && !accesses[k].complete)) {
+			addBit(live, (unsigned int) accesses[k].slot);
+		}
+	}
+}
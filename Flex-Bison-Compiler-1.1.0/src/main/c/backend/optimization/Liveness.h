@@ -0,0 +1,55 @@
+#ifndef LIVENESS_HEADER
+#define LIVENESS_HEADER
+
+#include "../../shared/Type.h"
+#include "../code-generation/Assembly.h"
+#include "BitSet.h"
+#include "ControlFlowGraph.h"
+#include "DataFlow.h"
+#include <stdlib.h>
+
+/**
+ * How an instruction accesses a stack slot. A write is complete if it
+ * overwrites the whole slot (otherwise, like a store to an array element,
+ * the rest of the previous value is still alive, so it counts as a read).
+ */
+typedef struct {
+	int slot;
+	boolean read;
+	boolean written;
+	boolean complete;
+	boolean escapes;
+} SlotAccess;
+
+/**
+ * The live stack slots at the boundaries of each block. A slot is live if
+ * its current value may be read later. The slots whose address is taken
+ * (with "lea") are escaping, and they are considered live everywhere.
+ */
+typedef struct {
+	ControlFlowGraph * graph;
+	DataFlowSolution * solution;
+	BitSet * escaping;
+	unsigned int slotCount;
+} SlotLiveness;
+
+/**
+ * Lists the slots accessed by an instruction (at most one per operand), and
+ * returns their amount.
+ */
+unsigned int getSlotAccesses(const AssemblyFunction * function, const Instruction * instruction, SlotAccess accesses[3]);
+
+/**
+ * Computes the live slots of every block of a function, which must not
+ * change while the result is in use.
+ */
+SlotLiveness * computeSlotLiveness(const AssemblyFunction * function);
+void destroySlotLiveness(SlotLiveness * liveness);
+
+/**
+ * Moves the live slots backwards across an instruction: given the live
+ * slots after it, computes the live slots before it.
+ */
+void transferSlotLiveness(const SlotLiveness * liveness, const AssemblyFunction * function, const Instruction * instruction, BitSet * live);
+
+#endif
@@ -0,0 +1,587 @@
+#include "Peephole.h"
+
+/* MODULE INTERNAL STATE */
+
+#define MAXIMUM_PATTERN_LENGTH 4
+#define MAXIMUM_RULES 64
+#define VARIABLES 26
+
+typedef enum {
+	PATTERN_ANY,
+	PATTERN_IMMEDIATE,
+	PATTERN_LABEL,
+	PATTERN_MEMORY,
+	PATTERN_REGISTER
+} PatternOperandType;
+
+/**
+ * An operand of a compiled pattern. Literals have no variable (-1).
+ */
+typedef struct {
+	PatternOperandType type;
+	int variable;
+	Operand literal;
+} PatternOperand;
+
+/**
+ * An instruction of a compiled pattern (or replacement). The opcodes and the
+ * conditions are sets, as bit-masks. A zero width or condition set matches
+ * anything.
+ */
+typedef struct {
+	int copy;
+	unsigned int opcodes;
+	Width width;
+	int widthVariable;
+	unsigned int conditions;
+	int conditionVariable;
+	unsigned int operandCount;
+	PatternOperand operands[3];
+} PatternInstruction;
+
+typedef struct {
+	const char * name;
+	PatternInstruction pattern[MAXIMUM_PATTERN_LENGTH];
+	int patternLength;
+	PatternInstruction replacement[MAXIMUM_PATTERN_LENGTH];
+	int replacementLength;
+	unsigned long hits;
+} PeepholeRule;
+
+/**
+ * The values bound to the variables of a pattern during a match. Operands,
+ * widths and conditions have independent namespaces.
+ */
+typedef struct {
+	Operand operands[VARIABLES];
+	boolean operandBound[VARIABLES];
+	Width widths[VARIABLES];
+	boolean widthBound[VARIABLES];
+	Condition conditions[VARIABLES];
+	boolean conditionBound[VARIABLES];
+} Bindings;
+
+/**
+ * The rules, tried in order at every position. Each one is a name, a pattern
+ * and a replacement. To add a rule, just append it here.
+ *
+ * A 32-bit instruction that writes a register also clears its upper half,
+ * so the rules that drop an instruction as a no-op only match 64-bit ones.
+ */
+static const char * const _ruleSources[][3] = {
+	{ "self-move", "mov.q A, A", "" },
+	{ "load-after-store", "mov.W %R, *M ; mov.W *M, %R", "#1" },
+	{ "store-after-load", "mov.W *M, %R ; mov.W %R, *M", "#1" },
+	{ "forward-store-to-load", "mov.W %R, *M ; mov.W *M, %S", "#1 ; mov.W %R, %S" },
+	{ "overwritten-store", "mov.W A, *M ; mov.W B, *M", "#2" },
+	{ "overwritten-register", "mov.W A, %R ; mov.W $X, %R", "#2" },
+	{ "overwritten-load", "mov.W A, %R ; mov.W *M, %R", "#2" },
+	{ "add-zero", "add|sub.q $0, A", "" },
+	{ "shift-zero", "sar|shl|shr.q $0, A", "" },
+	{ "multiply-by-one", "imul.q $1, A, A", "" },
+	{ "test-after-arithmetic", "add|and|sub|xor.W A, %R ; test.W %R, %R ; jcc|setcc:e|ne B", "#1 ; #3" },
+	{ "test-after-negation", "neg.W %R ; test.W %R, %R ; jcc|setcc:e|ne B", "#1 ; #3" },
+	{ "repeated-sign-extension", "movsb.W %R, %R ; movsb.W %R, %R", "#1" },
+	{ "jump-to-next", "jcc|jmp @L ; label @L", "#2" },
+	{ "push-pop", "push.q A ; pop.q A", "" }
+};
+
+static const char * const _opcodeNames[] = {
+	[OPCODE_ADD] = "add",
+	[OPCODE_AND] = "and",
+	[OPCODE_CALL] = "call",
+	[OPCODE_CMP] = "cmp",
+	[OPCODE_CONVERT] = "convert",
+	[OPCODE_IDIV] = "idiv",
+	[OPCODE_IMUL] = "imul",
+	[OPCODE_JCC] = "jcc",
+	[OPCODE_JMP] = "jmp",
+	[OPCODE_LABEL] = "label",
+	[OPCODE_LEA] = "lea",
+	[OPCODE_LEAVE] = "leave",
+	[OPCODE_MOV] = "mov",
+	[OPCODE_MOVSB] = "movsb",
+	[OPCODE_MOVSL] = "movsl",
+	[OPCODE_MOVZB] = "movzb",
+	[OPCODE_NEG] = "neg",
+	[OPCODE_POP] = "pop",
+	[OPCODE_PUSH] = "push",
+	[OPCODE_RET] = "ret",
+	[OPCODE_SAR] = "sar",
+	[OPCODE_SETCC] = "setcc",
+	[OPCODE_SHL] = "shl",
+	[OPCODE_SHR] = "shr",
+	[OPCODE_SUB] = "sub",
+	[OPCODE_TEST] = "test",
+	[OPCODE_XOR] = "xor"
+};
+
+static const char * const _conditionNames[] = {
+	[CONDITION_NONE] = "",
+	[CONDITION_EQUAL] = "e",
+	[CONDITION_NOT_EQUAL] = "ne",
+	[CONDITION_LESS] = "l",
+	[CONDITION_LESS_EQUAL] = "le",
+	[CONDITION_GREATER] = "g",
+	[CONDITION_GREATER_EQUAL] = "ge",
+	[CONDITION_BELOW] = "b",
+	[CONDITION_BELOW_EQUAL] = "be",
+	[CONDITION_ABOVE] = "a",
+	[CONDITION_ABOVE_EQUAL] = "ae"
+};
+
+static const char * const _registerNames[] = {
+	[REGISTER_RAX] = "rax",
+	[REGISTER_RBX] = "rbx",
+	[REGISTER_RCX] = "rcx",
+	[REGISTER_RDX] = "rdx",
+	[REGISTER_RSI] = "rsi",
+	[REGISTER_RDI] = "rdi",
+	[REGISTER_RBP] = "rbp",
+	[REGISTER_RSP] = "rsp",
+	[REGISTER_R8] = "r8",
+	[REGISTER_R9] = "r9",
+	[REGISTER_R10] = "r10",
+	[REGISTER_R11] = "r11"
+};
+
+static Logger * _logger = NULL;
+static boolean _reportStatistics = false;
+static PeepholeRule _rules[MAXIMUM_RULES];
+static int _ruleCount = 0;
+
+// The rules indexed by the opcodes accepted by the first instruction of
+// their patterns, so each position only tries the rules that can match.
+static int _rulesByOpcode[sizeof(_opcodeNames) / sizeof(_opcodeNames[0])][MAXIMUM_RULES];
+static int _ruleCountByOpcode[sizeof(_opcodeNames) / sizeof(_opcodeNames[0])];
+
+/* PRIVATE FUNCTIONS */
+
+static boolean _compileRule(PeepholeRule * rule, const char * name, const char * pattern, const char * replacement);
+static boolean _disjoint(const Bindings * bindings);
+static Instruction * _instantiate(const PatternInstruction * template, Instruction ** window, const Bindings * bindings);
+static int _lookupName(const char * const * names, const int count, const char * name, const int length);
+static boolean _matchInstruction(const PatternInstruction * pattern, const Instruction * instruction, Bindings * bindings);
+static boolean _matchOperand(const PatternOperand * pattern, const Operand * operand, Bindings * bindings);
+static boolean _matchRule(const PeepholeRule * rule, Instruction * start, Instruction ** window, Bindings * bindings);
+static boolean _parseInstruction(const char ** cursor, PatternInstruction * instruction);
+static boolean _parseOperand(const char ** cursor, PatternOperand * operand);
+static boolean _parseSequence(const char * source, PatternInstruction * sequence, int * length);
+static int _parseWord(const char ** cursor);
+static unsigned int _variablesOf(const PatternInstruction * sequence, const int length);
+
+/**
+ * Compiles the pattern and the replacement of a rule, and checks that the
+ * replacement only uses what the pattern binds.
+ */
+static boolean _compileRule(PeepholeRule * rule, const char * name, const char * pattern, const char * replacement) {
+	rule->name = name;
+	rule->hits = 0;
+	if (!_parseSequence(pattern, rule->pattern, &rule->patternLength) || rule->patternLength == 0) {
+		logError(_logger, "The pattern of the peephole rule \"%s\" is invalid: \"%s\"", name, pattern);
+		return false;
+	}
+	if (!_parseSequence(replacement, rule->replacement, &rule->replacementLength)) {
+		logError(_logger, "The replacement of the peephole rule \"%s\" is invalid: \"%s\"", name, replacement);
+		return false;
+	}
+	const unsigned int bound = _variablesOf(rule->pattern, rule->patternLength);
+	const unsigned int used = _variablesOf(rule->replacement, rule->replacementLength);
+	for (int k = 0; k < rule->replacementLength; ++k) {
+		const PatternInstruction * instruction = &rule->replacement[k];
+		const boolean copies = 0 <= instruction->copy && instruction->copy < rule->patternLength;
+		if (instruction->copy != -1 && !copies) {
+			logError(_logger, "The peephole rule \"%s\" copies an instruction out of its pattern.", name);
+			return false;
+		}
+		if (!copies && instruction->opcodes == 0) {
+			logError(_logger, "The peephole rule \"%s\" has a replacement without opcode.", name);
+			return false;
+		}
+	}
+	if ((used & ~bound) != 0) {
+		logError(_logger, "The replacement of the peephole rule \"%s\" uses unbound variables.", name);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * True if no memory operand of the match depends on a register of the same
+ * match, since a rule cannot know if the register changed in between.
+ */
+static boolean _disjoint(const Bindings * bindings) {
+	for (int m = 0; m < VARIABLES; ++m) {
+		const Operand * memory = &bindings->operands[m];
+		if (!bindings->operandBound[m] || memory->type != OPERAND_MEMORY) {
+			continue;
+		}
+		for (int r = 0; r < VARIABLES; ++r) {
+			const Operand * reg = &bindings->operands[r];
+			if (bindings->operandBound[r] && reg->type == OPERAND_REGISTER
+				&& (memory->base == reg->base || memory->index == reg->base)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * Creates an instruction from a replacement template.
+ */
+static Instruction * _instantiate(const PatternInstruction * template, Instruction ** window, const Bindings * bindings) {
+	Instruction * instruction = calloc(1, sizeof(Instruction));
+	if (0 <= template->copy) {
+		*instruction = *window[template->copy];
+		instruction->previous = NULL;
+		instruction->next = NULL;
+		return instruction;
+	}
+	int opcode = 0;
+	while ((template->opcodes & (1u << opcode)) == 0) {
+		++opcode;
+	}
+	instruction->opcode = opcode;
+	instruction->width = 0 <= template->widthVariable ? bindings->widths[template->widthVariable]
+		: (template->width == 0 ? WIDTH_QUAD : template->width);
+	if (0 <= template->conditionVariable) {
+		instruction->condition = bindings->conditions[template->conditionVariable];
+	}
+	else {
+		int condition = 0;
+		while (template->conditions != 0 && (template->conditions & (1u << condition)) == 0) {
+			++condition;
+		}
+		instruction->condition = condition;
+	}
+	instruction->operandCount = template->operandCount;
+	for (unsigned int k = 0; k < template->operandCount; ++k) {
+		const PatternOperand * operand = &template->operands[k];
+		instruction->operands[k] = 0 <= operand->variable ? bindings->operands[operand->variable] : operand->literal;
+	}
+	return instruction;
+}
+
+/**
+ * Finds the index of a name in a table, or -1 if it's not there.
+ */
+static int _lookupName(const char * const * names, const int count, const char * name, const int length) {
+	for (int k = 0; k < count; ++k) {
+		if (names[k] != NULL && (int) strlen(names[k]) == length && strncmp(names[k], name, length) == 0) {
+			return k;
+		}
+	}
+	return -1;
+}
+
+static boolean _matchInstruction(const PatternInstruction * pattern, const Instruction * instruction, Bindings * bindings) {
+	if ((pattern->opcodes & (1u << instruction->opcode)) == 0 || pattern->operandCount != instruction->operandCount) {
+		return false;
+	}
+	if (0 <= pattern->widthVariable) {
+		if (bindings->widthBound[pattern->widthVariable] && bindings->widths[pattern->widthVariable] != instruction->width) {
+			return false;
+		}
+		bindings->widths[pattern->widthVariable] = instruction->width;
+		bindings->widthBound[pattern->widthVariable] = true;
+	}
+	else if (pattern->width != 0 && pattern->width != instruction->width) {
+		return false;
+	}
+	if (0 <= pattern->conditionVariable) {
+		if (bindings->conditionBound[pattern->conditionVariable] && bindings->conditions[pattern->conditionVariable] != instruction->condition) {
+			return false;
+		}
+		bindings->conditions[pattern->conditionVariable] = instruction->condition;
+		bindings->conditionBound[pattern->conditionVariable] = true;
+	}
+	else if (pattern->conditions != 0 && (pattern->conditions & (1u << instruction->condition)) == 0) {
+		return false;
+	}
+	for (unsigned int k = 0; k < pattern->operandCount; ++k) {
+		if (!_matchOperand(&pattern->operands[k], &instruction->operands[k], bindings)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static boolean _matchOperand(const PatternOperand * pattern, const Operand * operand, Bindings * bindings) {
+	switch (pattern->type) {
+		case PATTERN_IMMEDIATE: if (operand->type != OPERAND_IMMEDIATE) return false; break;
+		case PATTERN_LABEL: if (operand->type != OPERAND_LABEL) return false; break;
+		case PATTERN_MEMORY: if (operand->type != OPERAND_MEMORY) return false; break;
+		case PATTERN_REGISTER: if (operand->type != OPERAND_REGISTER) return false; break;
+		case PATTERN_ANY: break;
+	}
+	if (pattern->variable < 0) {
+		return sameOperand(&pattern->literal, operand);
+	}
+	if (bindings->operandBound[pattern->variable]) {
+		return sameOperand(&bindings->operands[pattern->variable], operand);
+	}
+	bindings->operands[pattern->variable] = *operand;
+	bindings->operandBound[pattern->variable] = true;
+	return true;
+}
+
+/**
+ * Matches a rule against the instructions starting at the specified one,
+ * and fills the window with the matched instructions.
+ */
+static boolean _matchRule(const PeepholeRule * rule, Instruction * start, Instruction ** window, Bindings * bindings) {
+	Instruction * instruction = start;
+	for (int k = 0; k < rule->patternLength; ++k) {
+		if (instruction == NULL || !_matchInstruction(&rule->pattern[k], instruction, bindings)) {
+			return false;
+		}
+		window[k] = instruction;
+		instruction = instruction->next;
+	}
+	return _disjoint(bindings);
+}
+
+/**
+ * Parses a single instruction of a sequence (see the grammar in the header).
+ */
+static boolean _parseInstruction(const char ** cursor, PatternInstruction * instruction) {
+	const int opcodeCount = sizeof(_opcodeNames) / sizeof(_opcodeNames[0]);
+	const int conditionCount = sizeof(_conditionNames) / sizeof(_conditionNames[0]);
+	memset(instruction, 0, sizeof(PatternInstruction));
+	instruction->copy = -1;
+	instruction->widthVariable = -1;
+	instruction->conditionVariable = -1;
+	if (**cursor == '#') {
+		++*cursor;
+		instruction->copy = (int) strtol(*cursor, (char **) cursor, 10) - 1;
+		return 0 <= instruction->copy;
+	}
+	while (true) {
+		const char * name = *cursor;
+		const int opcode = _lookupName(_opcodeNames, opcodeCount, name, _parseWord(cursor));
+		if (opcode < 0) {
+			return false;
+		}
+		instruction->opcodes |= 1u << opcode;
+		if (**cursor != '|') {
+			break;
+		}
+		++*cursor;
+	}
+	if (**cursor == '.') {
+		const char width = *++*cursor;
+		++*cursor;
+		if (isupper(width)) instruction->widthVariable = width - 'A';
+		else if (width == 'b') instruction->width = WIDTH_BYTE;
+		else if (width == 'l') instruction->width = WIDTH_LONG;
+		else if (width == 'q') instruction->width = WIDTH_QUAD;
+		else return false;
+	}
+	if (**cursor == ':') {
+		++*cursor;
+		if (isupper(**cursor)) {
+			instruction->conditionVariable = *(*cursor)++ - 'A';
+		}
+		else while (true) {
+			const char * name = *cursor;
+			const int condition = _lookupName(_conditionNames, conditionCount, name, _parseWord(cursor));
+			if (condition <= CONDITION_NONE) {
+				return false;
+			}
+			instruction->conditions |= 1u << condition;
+			if (**cursor != '|') {
+				break;
+			}
+			++*cursor;
+		}
+	}
+	while (isspace(**cursor)) {
+		++*cursor;
+	}
+	while (**cursor != '\0' && **cursor != ';') {
+		if (instruction->operandCount == 3 || !_parseOperand(cursor, &instruction->operands[instruction->operandCount++])) {
+			return false;
+		}
+		while (isspace(**cursor)) {
+			++*cursor;
+		}
+		if (**cursor == ',') {
+			++*cursor;
+			while (isspace(**cursor)) {
+				++*cursor;
+			}
+		}
+	}
+	return true;
+}
+
+static boolean _parseOperand(const char ** cursor, PatternOperand * operand) {
+	const char prefix = **cursor;
+	operand->variable = -1;
+	switch (prefix) {
+		case '%': operand->type = PATTERN_REGISTER; ++*cursor; break;
+		case '$': operand->type = PATTERN_IMMEDIATE; ++*cursor; break;
+		case '*': operand->type = PATTERN_MEMORY; ++*cursor; break;
+		case '@': operand->type = PATTERN_LABEL; ++*cursor; break;
+		default: operand->type = PATTERN_ANY; break;
+	}
+	if (isupper(**cursor)) {
+		operand->variable = *(*cursor)++ - 'A';
+		return true;
+	}
+	if (prefix == '%') {
+		const char * name = *cursor;
+		const int reg = _lookupName(_registerNames, sizeof(_registerNames) / sizeof(_registerNames[0]), name, _parseWord(cursor));
+		operand->literal = registerOperand(reg);
+		return 0 <= reg;
+	}
+	if (prefix == '$' && (isdigit(**cursor) || **cursor == '-')) {
+		operand->literal = immediateOperand(strtol(*cursor, (char **) cursor, 10));
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Parses a sequence of instructions separated by ";". An empty source is an
+ * empty sequence.
+ */
+static boolean _parseSequence(const char * source, PatternInstruction * sequence, int * length) {
+	const char * cursor = source;
+	*length = 0;
+	while (true) {
+		while (isspace(*cursor)) {
+			++cursor;
+		}
+		if (*cursor == '\0') {
+			return true;
+		}
+		if (*length == MAXIMUM_PATTERN_LENGTH || !_parseInstruction(&cursor, &sequence[(*length)++])) {
+			return false;
+		}
+		while (isspace(*cursor)) {
+			++cursor;
+		}
+		if (*cursor == ';') {
+			++cursor;
+		}
+		else if (*cursor != '\0') {
+			return false;
+		}
+	}
+}
+
+/**
+ * Skips a lowercase alphanumeric word, and returns its length.
+ */
+static int _parseWord(const char ** cursor) {
+	const char * start = *cursor;
+	while (islower(**cursor) || isdigit(**cursor)) {
+		++*cursor;
+	}
+	return (int) (*cursor - start);
+}
+
+/**
+ * The set of operand variables used in a sequence, as a bit-mask.
+ */
+static unsigned int _variablesOf(const PatternInstruction * sequence, const int length) {
+	unsigned int variables = 0;
+	for (int k = 0; k < length; ++k) {
+		for (unsigned int j = 0; j < sequence[k].operandCount; ++j) {
+			if (0 <= sequence[k].operands[j].variable) {
+				variables |= 1u << sequence[k].operands[j].variable;
+			}
+		}
+	}
+	return variables;
+}
+
+/* PUBLIC FUNCTIONS */
+
+void initializePeepholeModule() {
+	_logger = createLogger("Peephole");
+	_reportStatistics = getBooleanOrDefault("PEEPHOLE_STATISTICS", _reportStatistics);
+	_ruleCount = 0;
+	memset(_ruleCountByOpcode, 0, sizeof(_ruleCountByOpcode));
+	const int sourceCount = sizeof(_ruleSources) / sizeof(_ruleSources[0]);
+	for (int k = 0; k < sourceCount && _ruleCount < MAXIMUM_RULES; ++k) {
+		PeepholeRule * rule = &_rules[_ruleCount];
+		if (!_compileRule(rule, _ruleSources[k][0], _ruleSources[k][1], _ruleSources[k][2])) {
+			continue;
+		}
+		for (int opcode = 0; opcode < (int) (sizeof(_opcodeNames) / sizeof(_opcodeNames[0])); ++opcode) {
+			if ((rule->pattern[0].opcodes & (1u << opcode)) != 0) {
+				_rulesByOpcode[opcode][_ruleCountByOpcode[opcode]++] = _ruleCount;
+			}
+		}
+		++_ruleCount;
+	}
+}
+
+void shutdownPeepholeModule() {
+	if (_reportStatistics) {
+		fprintf(stderr, "Peephole rule hits:\n");
+		for (int k = 0; k < _ruleCount; ++k) {
+			fprintf(stderr, "\t%-24s %lu\n", _rules[k].name, _rules[k].hits);
+		}
+	}
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+void optimizePeepholes(InstructionList * list) {
+	Instruction * position = list->first;
+	while (position != NULL) {
+		Instruction * next = position->next;
+		boolean rewritten = false;
+		for (int k = 0; !rewritten && k < _ruleCountByOpcode[position->opcode]; ++k) {
+			PeepholeRule * rule = &_rules[_rulesByOpcode[position->opcode][k]];
+			Instruction * window[MAXIMUM_PATTERN_LENGTH];
+			Bindings bindings;
+			memset(&bindings, 0, sizeof(Bindings));
+			if (!_matchRule(rule, position, window, &bindings)) {
+				continue;
+			}
+			Instruction * after = window[rule->patternLength - 1]->next;
+			for (int j = 0; j < rule->replacementLength; ++j) {
+				Instruction * instruction = _instantiate(&rule->replacement[j], window, &bindings);
+				if (after == NULL) {
+					appendInstruction(list, instruction);
+				}
+				else {
+					insertInstructionBefore(list, after, instruction);
+				}
+			}
+			// Steps back, since the new instructions can complete a window
+			// that starts before them.
+			next = window[0]->previous;
+			for (int j = 0; j < rule->patternLength; ++j) {
+				removeInstruction(list, window[j]);
+			}
+			for (int j = 0; j < MAXIMUM_PATTERN_LENGTH - 2 && next != NULL && next->previous != NULL; ++j) {
+				next = next->previous;
+			}
+			if (next == NULL) {
+				next = list->first;
+			}
+			__atomic_fetch_add(&rule->hits, 1, __ATOMIC_RELAXED);
+			rewritten = true;
+		}
+		position = next;
+	}
+}
+
+int getPeepholeRuleCount() {
+	return _ruleCount;
+}
+
+const char * getPeepholeRuleName(const int rule) {
+	return _rules[rule].name;
+}
+
+unsigned long getPeepholeRuleHits(const int rule) {
+	return _rules[rule].hits;
+}
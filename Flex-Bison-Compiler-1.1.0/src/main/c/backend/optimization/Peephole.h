@@ -0,0 +1,60 @@
+#ifndef PEEPHOLE_HEADER
+#define PEEPHOLE_HEADER
+
+#include "../../shared/Environment.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "../code-generation/Assembly.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * A table-driven peephole optimizer. Each rule is written in a small DSL,
+ * which is compiled once when the module is initialized:
+ *
+ *	"mov.W %R, *M ; mov.W *M, %R"  =>  "#1"
+ *
+ * A pattern is a sequence of instructions separated by ";". Every one of
+ * them is an opcode (or alternatives, like "add|sub"), an optional width
+ * (".b", ".l", ".q", or an uppercase variable), an optional condition for
+ * "jcc" and "setcc" (":e", ":e|ne", or a variable), and its operands:
+ *
+ *	A		any operand, bound to the variable "A"
+ *	%R		a register (or a literal one, like "%rax")
+ *	$X		an immediate (or a literal one, like "$0")
+ *	*M		a memory operand
+ *	@L		a label
+ *
+ * A variable matches the same operand everywhere in a pattern. The
+ * replacement is another sequence, where "#n" copies the n-th matched
+ * instruction, and the other instructions can only use bound variables and
+ * literals. An empty replacement removes the whole window.
+ *
+ * The generated code never keeps the flags alive across an instruction that
+ * doesn't consume them, so the rules can drop or add flag-setting
+ * instructions freely, unless a consumer is part of the pattern.
+ */
+
+/** Initialize module's internal state. */
+void initializePeepholeModule();
+
+/** Shutdown module's internal state. */
+void shutdownPeepholeModule();
+
+/**
+ * Rewrites the instructions with the first matching rule at each position,
+ * until no rule matches anywhere.
+ */
+void optimizePeepholes(InstructionList * list);
+
+/**
+ * The amount of rules, and the name and hit count of each one (accumulated
+ * over every optimized function).
+ */
+int getPeepholeRuleCount();
+const char * getPeepholeRuleName(const int rule);
+unsigned long getPeepholeRuleHits(const int rule);
+
+#endif
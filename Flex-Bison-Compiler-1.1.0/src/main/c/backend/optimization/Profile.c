@@ -0,0 +1,577 @@
+#include "Profile.h"
+
+/* MODULE INTERNAL STATE */
+
+static const unsigned int _initialCapacity = 16;
+
+/**
+ * How a statement (or a block) returns: never, on some of its paths, or on
+ * all of them (so the statements that follow it are never executed).
+ */
+typedef enum {
+	RETURNS_NEVER,
+	RETURNS_SOMETIMES,
+	RETURNS_ALWAYS
+} Returns;
+
+/**
+ * The count of a basic block: the one of a counter, plus the one of another
+ * counter (if "added" isn't negative), minus the one of a third one (if
+ * "subtracted" isn't negative). A block that's never executed has a negative
+ * counter.
+ */
+typedef struct {
+	int counter;
+	int added;
+	int subtracted;
+} BlockCount;
+
+/**
+ * The count of a block that needs a counter of its own, the one of a block
+ * that's never executed, and the one of a block split at its first
+ * if-statement (see "ProfileSites").
+ */
+static const BlockCount _newCount = { -2, -1, -1 };
+static const BlockCount _neverCount = { -1, -1, -1 };
+static const BlockCount _splitCount = { -3, -1, -1 };
+
+/**
+ * The count of a split block is pending (with the number of the block in
+ * "subtracted") until its if-statement sets it. If the path that skips the
+ * then-block starts after the if-statement, its count is pending too (with
+ * the counter of the then-block in "added", and the number of the split block
+ * in "subtracted"), and it needs a counter of its own, which sets the one of
+ * the split block to the sum of both.
+ */
+static const int _skippedCounter = -4;
+
+/**
+ * The state of a walk over an AST: the sites and the basic blocks found so
+ * far (in order), the amount of counters (of each kind) and nodes, and the
+ * structural hash. A block without a counter of its own has no node.
+ */
+typedef struct {
+	const void ** nodes;
+	unsigned int * counters;
+	unsigned int count;
+	unsigned int capacity;
+	const void ** blockNodes;
+	unsigned int * lines;
+	int * blockCounters;
+	int * blockAdded;
+	int * blockSubtracted;
+	unsigned int blockCount;
+	unsigned int blockCapacity;
+	unsigned int blockCounterCount;
+	unsigned int counterCount;
+	unsigned int nodeCount;
+	uint32_t hash;
+} ProfileWalk;
+
+/* PRIVATE FUNCTIONS */
+
+static BlockCount _addBlock(ProfileWalk * walk, const void * node, const unsigned int line, const BlockCount count);
+static void _addSite(ProfileWalk * walk, const void * node, const unsigned int counters);
+static unsigned int _blockLine(const Block * block);
+static int _compareKey(const char * name, const uint32_t hash, const ProfileRecord * record);
+static int _compareRecords(const void * left, const void * right);
+static unsigned int _hashNode(const void * node);
+static void _insertNode(const void ** nodes, unsigned int * values, const unsigned int capacity, const void * node, const unsigned int value);
+static int _lookupNode(const void * const * nodes, const unsigned int * values, const unsigned int capacity, const void * node);
+static void _mix(ProfileWalk * walk, const unsigned int value);
+static void _setBlockCount(ProfileWalk * walk, const unsigned int block, const BlockCount count);
+static boolean _splitsAtIf(const Block * block);
+static Returns _walkBlock(ProfileWalk * walk, const Block * block, BlockCount * count);
+static void _walkExpression(ProfileWalk * walk, const Expression * expression);
+static Returns _walkIf(ProfileWalk * walk, const StatementIf * statementIf, BlockCount * count);
+static Returns _walkLoop(ProfileWalk * walk, const Block * block, const boolean split, BlockCount * count);
+static Returns _walkStatement(ProfileWalk * walk, const Statement * statement, BlockCount * count);
+
+/**
+ * Appends a basic block, which starts at a line, with its count (a new
+ * counter, if it needs one of its own, which may also set the count of a
+ * split block). Returns its count (which is pending, if it's split).
+ */
+static BlockCount _addBlock(ProfileWalk * walk, const void * node, const unsigned int line, const BlockCount count) {
+	if (walk->blockCount == walk->blockCapacity) {
+		walk->blockCapacity = walk->blockCapacity == 0 ? _initialCapacity : 2 * walk->blockCapacity;
+		walk->blockNodes = realloc(walk->blockNodes, walk->blockCapacity * sizeof(void *));
+		walk->lines = realloc(walk->lines, walk->blockCapacity * sizeof(unsigned int));
+		walk->blockCounters = realloc(walk->blockCounters, walk->blockCapacity * sizeof(int));
+		walk->blockAdded = realloc(walk->blockAdded, walk->blockCapacity * sizeof(int));
+		walk->blockSubtracted = realloc(walk->blockSubtracted, walk->blockCapacity * sizeof(int));
+	}
+	const unsigned int block = walk->blockCount++;
+	const boolean counted = count.counter == _newCount.counter || count.counter == _skippedCounter;
+	BlockCount result = counted ? (BlockCount) { (int) walk->blockCounterCount++, -1, -1 } : count;
+	if (count.counter == _skippedCounter) {
+		_setBlockCount(walk, (unsigned int) count.subtracted, (BlockCount) { count.added, result.counter, -1 });
+	}
+	else if (count.counter == _splitCount.counter) {
+		result = (BlockCount) { _splitCount.counter, -1, (int) block };
+	}
+	walk->blockNodes[block] = counted ? node : NULL;
+	walk->lines[block] = line;
+	_setBlockCount(walk, block, result);
+	return result;
+}
+
+/**
+ * Appends a site, with its counters.
+ */
+static void _addSite(ProfileWalk * walk, const void * node, const unsigned int counters) {
+	if (walk->count == walk->capacity) {
+		walk->capacity = walk->capacity == 0 ? _initialCapacity : 2 * walk->capacity;
+		walk->nodes = realloc(walk->nodes, walk->capacity * sizeof(void *));
+		walk->counters = realloc(walk->counters, walk->capacity * sizeof(unsigned int));
+	}
+	walk->nodes[walk->count] = node;
+	walk->counters[walk->count] = walk->counterCount;
+	++walk->count;
+	walk->counterCount += counters;
+}
+
+/**
+ * The line where a block starts: the one of its first statement (or of its
+ * opening brace, if it's empty).
+ */
+static unsigned int _blockLine(const Block * block) {
+	return block->statements == NULL ? block->line : block->statements->statement->line;
+}
+
+/**
+ * Compares a name and a hash with the ones of a record.
+ */
+static int _compareKey(const char * name, const uint32_t hash, const ProfileRecord * record) {
+	const int comparison = strcmp(name, record->name);
+	if (comparison != 0) {
+		return comparison;
+	}
+	return hash < record->hash ? -1 : (hash == record->hash ? 0 : 1);
+}
+
+/**
+ * Orders the records by name, and then by hash.
+ */
+static int _compareRecords(const void * left, const void * right) {
+	const ProfileRecord * record = left;
+	return _compareKey(record->name, record->hash, right);
+}
+
+/**
+ * Hashes the address of a node (the nodes are aligned, so the lowest bits
+ * are discarded).
+ */
+static unsigned int _hashNode(const void * node) {
+	return (unsigned int) (((uintptr_t) node >> 3) * 2654435761u);
+}
+
+/**
+ * Inserts a node in a hash table (with linear probing), which has room.
+ */
+static void _insertNode(const void ** nodes, unsigned int * values, const unsigned int capacity, const void * node, const unsigned int value) {
+	unsigned int index = _hashNode(node) & (capacity - 1);
+	while (nodes[index] != NULL) {
+		index = (index + 1) & (capacity - 1);
+	}
+	nodes[index] = node;
+	values[index] = value;
+}
+
+/**
+ * The value of a node in a hash table, or -1 if it's not there.
+ */
+static int _lookupNode(const void * const * nodes, const unsigned int * values, const unsigned int capacity, const void * node) {
+	unsigned int index = _hashNode(node) & (capacity - 1);
+	while (nodes[index] != NULL) {
+		if (nodes[index] == node) {
+			return (int) values[index];
+		}
+		index = (index + 1) & (capacity - 1);
+	}
+	return -1;
+}
+
+/**
+ * Adds a value to the structural hash (FNV-1a, a value at a time).
+ */
+static void _mix(ProfileWalk * walk, const unsigned int value) {
+	walk->hash = (walk->hash ^ value) * 16777619u;
+	++walk->nodeCount;
+}
+
+/**
+ * Sets the count of a basic block.
+ */
+static void _setBlockCount(ProfileWalk * walk, const unsigned int block, const BlockCount count) {
+	walk->blockCounters[block] = count.counter;
+	walk->blockAdded[block] = count.added;
+	walk->blockSubtracted[block] = count.subtracted;
+}
+
+/**
+ * True if the count of a block (which needs a counter) can be split at its
+ * first if-statement: no statement branches before it, and each of its paths
+ * starts a basic block (its else-block, or the statement after it, if its
+ * then-block ends returning).
+ */
+static boolean _splitsAtIf(const Block * block) {
+	for (const Statements * statements = block->statements; statements != NULL; statements = statements->next) {
+		const Statement * statement = statements->statement;
+		if (statement->type == STATEMENT_IF) {
+			const StatementIf * statementIf = statement->statementIf;
+			const Statements * last = statementIf->thenBlock->statements;
+			while (last != NULL && last->next != NULL) {
+				last = last->next;
+			}
+			return statementIf->hasElse || (statements->next != NULL && last != NULL && last->statement->type == STATEMENT_RETURN);
+		}
+		if (statement->type != STATEMENT_DECLARATION && statement->type != STATEMENT_EXPRESSION && statement->type != STATEMENT_EMPTY) {
+			return false;
+		}
+	}
+	return false;
+}
+
+/**
+ * Walks a block (and the ones nested in it) in order, from the count of its
+ * first statement to the one of its end. The statement after an if-statement
+ * or a loop (or after a block whose count changed) starts a new basic block,
+ * where their paths join. Returns how the block returns.
+ */
+static Returns _walkBlock(ProfileWalk * walk, const Block * block, BlockCount * count) {
+	_mix(walk, STATEMENT_BLOCK);
+	Returns returns = RETURNS_NEVER;
+	boolean joins = false;
+	for (const Statements * statements = block->statements; statements != NULL; statements = statements->next) {
+		const Statement * statement = statements->statement;
+		if (joins) {
+			*count = _addBlock(walk, statement, statement->line, *count);
+		}
+		const BlockCount previous = *count;
+		const Returns returned = _walkStatement(walk, statement, count);
+		if (returns != RETURNS_ALWAYS && returned != RETURNS_NEVER) {
+			returns = returned;
+		}
+		joins = statement->type == STATEMENT_IF || statement->type == STATEMENT_WHILE || statement->type == STATEMENT_FOR
+			|| (statement->type == STATEMENT_BLOCK
+				&& (count->counter != previous.counter || count->added != previous.added || count->subtracted != previous.subtracted));
+	}
+	_mix(walk, STATEMENT_EMPTY);
+	return returns;
+}
+
+/**
+ * Walks an expression, from left to right (a call is a site).
+ */
+static void _walkExpression(ProfileWalk * walk, const Expression * expression) {
+	_mix(walk, expression->type);
+	switch (expression->type) {
+		case EXPRESSION_NOT:
+		case EXPRESSION_PARENTHESIS:
+			_walkExpression(walk, expression->singleExpression);
+			break;
+		case EXPRESSION_IDENTIFIER:
+		case EXPRESSION_CONSTANT:
+			break;
+		case EXPRESSION_ARRAY_ACCESS:
+			_walkExpression(walk, expression->indexExpression);
+			break;
+		case EXPRESSION_FUNCTION_CALL: {
+			_addSite(walk, expression, 1);
+			unsigned int count = 0;
+			for (const ListArguments * argument = expression->arguments; argument != NULL; argument = argument->next, ++count) {
+				_walkExpression(walk, argument->expression);
+			}
+			_mix(walk, count);
+			break;
+		}
+		default:
+			_walkExpression(walk, expression->leftExpression);
+			_walkExpression(walk, expression->rightExpression);
+			break;
+	}
+}
+
+/**
+ * Walks an if-statement (a site), whose blocks start basic blocks. Only the
+ * then-block has a counter: the else-block is executed the times the
+ * if-statement isn't entered (so, unless the if-statement has a derived count
+ * itself, it's the difference of both). If it splits the block before it,
+ * the path that skips the then-block has a counter instead, and the block is
+ * executed as many times as both paths. Where the paths join, the count is
+ * the one of the if-statement if no path returns, the one of the only path
+ * that doesn't return, or a counter of its own otherwise. Returns how the
+ * if-statement returns.
+ */
+static Returns _walkIf(ProfileWalk * walk, const StatementIf * statementIf, BlockCount * count) {
+	_addSite(walk, statementIf, 2);
+	_walkExpression(walk, statementIf->condition);
+	const boolean split = count->counter == _splitCount.counter;
+	const BlockCount entered = _addBlock(walk, statementIf->thenBlock, _blockLine(statementIf->thenBlock), _newCount);
+	BlockCount skipped = split ? (BlockCount) { _skippedCounter, entered.counter, count->subtracted }
+		: 0 <= count->counter && count->added < 0 && count->subtracted < 0 ? (BlockCount) { count->counter, -1, entered.counter }
+		: _newCount;
+	BlockCount end = entered;
+	const Returns thenReturns = _walkBlock(walk, statementIf->thenBlock, &end);
+	Returns elseReturns = RETURNS_NEVER;
+	if (statementIf->hasElse) {
+		skipped = _addBlock(walk, statementIf->elseBlock, _blockLine(statementIf->elseBlock), skipped);
+		end = skipped;
+		elseReturns = _walkBlock(walk, statementIf->elseBlock, &end);
+	}
+	if (split && statementIf->hasElse) {
+		*count = (BlockCount) { entered.counter, skipped.counter, -1 };
+	}
+	if (thenReturns == RETURNS_ALWAYS && elseReturns == RETURNS_ALWAYS) {
+		*count = _neverCount;
+		return RETURNS_ALWAYS;
+	}
+	if (thenReturns == RETURNS_NEVER && elseReturns == RETURNS_NEVER) {
+		return RETURNS_NEVER;
+	}
+	*count = thenReturns == RETURNS_ALWAYS && elseReturns == RETURNS_NEVER ? skipped
+		: thenReturns == RETURNS_NEVER && elseReturns == RETURNS_ALWAYS ? entered
+		: _newCount;
+	return RETURNS_SOMETIMES;
+}
+
+/**
+ * Walks the block of a loop, which starts a basic block, with a counter of its
+ * own (unless it's split at its first if-statement). After the loop, the
+ * count is the one before it, unless its block can return (and then it has a
+ * counter of its own). Returns how the loop returns (even if its block always
+ * returns, it may not be executed).
+ */
+static Returns _walkLoop(ProfileWalk * walk, const Block * block, const boolean split, BlockCount * count) {
+	BlockCount end = _addBlock(walk, block, _blockLine(block), split && _splitsAtIf(block) ? _splitCount : _newCount);
+	if (_walkBlock(walk, block, &end) == RETURNS_NEVER) {
+		return RETURNS_NEVER;
+	}
+	*count = _newCount;
+	return RETURNS_SOMETIMES;
+}
+
+/**
+ * Walks a statement (an if-statement or a loop is a site), from the count of
+ * its basic block to the one after it. Returns how the statement returns.
+ */
+static Returns _walkStatement(ProfileWalk * walk, const Statement * statement, BlockCount * count) {
+	_mix(walk, statement->type);
+	Returns returns = RETURNS_NEVER;
+	switch (statement->type) {
+		case STATEMENT_DECLARATION:
+			_mix(walk, statement->variableSuffix->type);
+			if (statement->variableSuffix->type == VARIABLE_SUFFIX_ASSIGNMENT) {
+				_walkExpression(walk, statement->variableSuffix->expression);
+			}
+			break;
+		case STATEMENT_IF:
+			returns = _walkIf(walk, statement->statementIf, count);
+			break;
+		case STATEMENT_WHILE:
+			_addSite(walk, statement->statementWhile, 2);
+			_walkExpression(walk, statement->statementWhile->condition);
+			// The body of a counted loop is counted when it exits, without a counter on each iteration.
+			returns = _walkLoop(walk, statement->statementWhile->block, countedWhileVariable(statement->statementWhile) == NULL, count);
+			break;
+		case STATEMENT_FOR: {
+			const StatementFor * loop = statement->statementFor;
+			_addSite(walk, loop, 2);
+			_mix(walk, (loop->hasInit ? 1 : 0) | (loop->hasCondition ? 2 : 0) | (loop->hasUpdate ? 4 : 0));
+			if (loop->hasInit) {
+				_walkExpression(walk, loop->init);
+			}
+			if (loop->hasCondition) {
+				_walkExpression(walk, loop->condition);
+			}
+			if (loop->hasUpdate) {
+				_walkExpression(walk, loop->update);
+			}
+			returns = _walkLoop(walk, loop->block, false, count);
+			break;
+		}
+		case STATEMENT_RETURN:
+			if (statement->statementReturn->hasExpression) {
+				_walkExpression(walk, statement->statementReturn->expression);
+			}
+			*count = _neverCount;
+			returns = RETURNS_ALWAYS;
+			break;
+		case STATEMENT_EXPRESSION:
+			_walkExpression(walk, statement->statementExpression->expression);
+			break;
+		case STATEMENT_BLOCK:
+			returns = _walkBlock(walk, statement->block, count);
+			break;
+		case STATEMENT_EMPTY:
+			break;
+	}
+	return returns;
+}
+
+/* PUBLIC FUNCTIONS */
+
+ProfileSites * createProfileSites(const Declaration * function) {
+	ProfileWalk walk = { .hash = 2166136261u };
+	const Parameters * parameters = function->declarationSuffix->parameters;
+	_mix(&walk, parameters->type);
+	if (parameters->type == PARAMS_LIST) {
+		for (const ParameterList * node = parameters->list; node != NULL; node = node->next) {
+			_mix(&walk, node->parameter->array->type);
+		}
+	}
+	const Block * body = function->declarationSuffix->functionSuffix->block;
+	BlockCount count = _addBlock(&walk, body, body->line, _splitsAtIf(body) ? _splitCount : _newCount);
+	_walkBlock(&walk, body, &count);
+	ProfileSites * sites = calloc(1, sizeof(ProfileSites));
+	sites->capacity = _initialCapacity;
+	while (sites->capacity < 2 * walk.count || sites->capacity < 2 * walk.blockCount) {
+		sites->capacity *= 2;
+	}
+	sites->nodes = calloc(sites->capacity, sizeof(void *));
+	sites->counters = calloc(sites->capacity, sizeof(unsigned int));
+	sites->blockNodes = calloc(sites->capacity, sizeof(void *));
+	sites->blocks = calloc(sites->capacity, sizeof(unsigned int));
+	sites->lines = walk.lines;
+	sites->blockCounters = walk.blockCounters;
+	sites->blockAdded = walk.blockAdded;
+	sites->blockSubtracted = walk.blockSubtracted;
+	sites->blockCount = walk.blockCount;
+	sites->blockCounterCount = walk.blockCounterCount;
+	sites->counterCount = walk.counterCount;
+	sites->nodeCount = walk.nodeCount;
+	sites->hash = walk.hash;
+	for (unsigned int k = 0; k < walk.count; ++k) {
+		_insertNode(sites->nodes, sites->counters, sites->capacity, walk.nodes[k], walk.counters[k]);
+	}
+	for (unsigned int k = 0; k < walk.blockCount; ++k) {
+		if (walk.blockNodes[k] != NULL) {
+			_insertNode(sites->blockNodes, sites->blocks, sites->capacity, walk.blockNodes[k], (unsigned int) walk.blockCounters[k]);
+		}
+	}
+	free(walk.nodes);
+	free(walk.counters);
+	free(walk.blockNodes);
+	return sites;
+}
+
+void destroyProfileSites(ProfileSites * sites) {
+	if (sites != NULL) {
+		free(sites->nodes);
+		free(sites->counters);
+		free(sites->blockNodes);
+		free(sites->blocks);
+		free(sites->lines);
+		free(sites->blockCounters);
+		free(sites->blockAdded);
+		free(sites->blockSubtracted);
+		free(sites);
+	}
+}
+
+int profileSite(const ProfileSites * sites, const void * node) {
+	return _lookupNode(sites->nodes, sites->counters, sites->capacity, node);
+}
+
+int profileBlock(const ProfileSites * sites, const void * node) {
+	return _lookupNode(sites->blockNodes, sites->blocks, sites->capacity, node);
+}
+
+unsigned int countBlockNodes(const Block * block) {
+	ProfileWalk walk = { .hash = 0 };
+	BlockCount count = _neverCount;
+	_walkBlock(&walk, block, &count);
+	free(walk.nodes);
+	free(walk.counters);
+	free(walk.blockNodes);
+	free(walk.lines);
+	free(walk.blockCounters);
+	free(walk.blockAdded);
+	free(walk.blockSubtracted);
+	return walk.nodeCount;
+}
+
+Profile * loadProfile(const char * path) {
+	FILE * file = fopen(path, "r");
+	if (file == NULL) {
+		return NULL;
+	}
+	Profile * profile = calloc(1, sizeof(Profile));
+	char name[1024];
+	uint32_t hash;
+	unsigned int counterCount;
+	while (fscanf(file, " function %1023s %" SCNu32 " %u", name, &hash, &counterCount) == 3) {
+		uint64_t * counters = calloc(counterCount == 0 ? 1 : counterCount, sizeof(uint64_t));
+		unsigned int count = 0;
+		while (count < counterCount && fscanf(file, "%" SCNu64, &counters[count]) == 1) {
+			++count;
+		}
+		if (count < counterCount) {
+			free(counters);
+			break;
+		}
+		if (profile->count == profile->capacity) {
+			profile->capacity = profile->capacity == 0 ? _initialCapacity : 2 * profile->capacity;
+			profile->records = realloc(profile->records, profile->capacity * sizeof(ProfileRecord));
+		}
+		profile->records[profile->count++] = (ProfileRecord) {
+			.name = strdup(name),
+			.hash = hash,
+			.counterCount = counterCount,
+			.counters = counters
+		};
+	}
+	fclose(file);
+
+	// Adds up the records of the same function, which are adjacent once sorted.
+	qsort(profile->records, profile->count, sizeof(ProfileRecord), _compareRecords);
+	unsigned int count = 0;
+	for (unsigned int k = 0; k < profile->count; ++k) {
+		ProfileRecord * record = &profile->records[k];
+		ProfileRecord * last = count == 0 ? NULL : &profile->records[count - 1];
+		if (last != NULL && _compareRecords(record, last) == 0 && record->counterCount == last->counterCount) {
+			for (unsigned int j = 0; j < record->counterCount; ++j) {
+				last->counters[j] += record->counters[j];
+			}
+			free(record->name);
+			free(record->counters);
+		}
+		else {
+			profile->records[count++] = *record;
+		}
+	}
+	profile->count = count;
+	return profile;
+}
+
+void destroyProfile(Profile * profile) {
+	if (profile != NULL) {
+		for (unsigned int k = 0; k < profile->count; ++k) {
+			free(profile->records[k].name);
+			free(profile->records[k].counters);
+		}
+		free(profile->records);
+		free(profile);
+	}
+}
+
+const uint64_t * profileCounters(const Profile * profile, const char * name, const uint32_t hash, const unsigned int counterCount) {
+	unsigned int low = 0;
+	unsigned int high = profile->count;
+	while (low < high) {
+		const unsigned int middle = low + (high - low) / 2;
+		const int comparison = _compareKey(name, hash, &profile->records[middle]);
+		if (comparison == 0) {
+			const ProfileRecord * record = &profile->records[middle];
+			return record->counterCount == counterCount ? record->counters : NULL;
+		}
+		if (comparison < 0) {
+			high = middle;
+		}
+		else {
+			low = middle + 1;
+		}
+	}
+	return NULL;
+}
@@ -0,0 +1,145 @@
+#ifndef PROFILE_HEADER
+#define PROFILE_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Type.h"
+#include "RangeAnalysis.h"
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The execution counts of an instrumented program (see "PROFILE_OUTPUT_FILE"),
+ * which guide the optimizations of a later compilation (see "PROFILE_FILE").
+ * Every function has some counters for each of its profiling sites, numbered
+ * in the order of its AST:
+ *
+ *	- An if-statement: the times it's executed, and the times its condition
+ *	  is true.
+ *	- A loop: the times it's entered, and the times its body is executed.
+ *	- A function call: the times it's executed.
+ *
+ * The profile is a text file, with a record for each function:
+ *
+ *	function <name> <structural hash> <amount of counters>
+ *	<counter>
+ *	...
+ *
+ * The basic blocks of a function (see "COVERAGE_OUTPUT_FILE") are numbered in
+ * the same walk: the body of the function, the blocks of an if-statement or
+ * a loop, and the statement that follows an if-statement or a loop (where
+ * their paths join). Each one starts at a line of the source. Only some of
+ * them have a counter, and the count of the others is derived: an else-block
+ * is executed as many times as its if-statement, minus its then-block, and a
+ * join as many times as the block before the if-statement or the loop (if no
+ * path returns before it), or as the only path that doesn't return. The body
+ * of a function (or of a while-loop that isn't counted, see
+ * "countedWhileVariable") whose first branch is an if-statement with a basic
+ * block on each path (its else-block, or the statement after it, if its
+ * then-block ends returning) is executed as many times as both paths, so only
+ * one counter runs on each execution.
+ *
+ * An instrumented program appends its records when it exits, so the records
+ * of many runs are added up. The structural hash only depends on the shape
+ * of the function (its statements and expressions, but not its identifiers
+ * nor its constants), so its records still apply after renaming a variable
+ * or changing a constant, and they're ignored if its structure changes,
+ * without affecting the other functions.
+ */
+
+/**
+ * The profiling sites of a function, that is, the first counter of each node
+ * of its AST that has any (in a hash table, indexed by the node), and the
+ * size of the function (its amount of nodes). The basic blocks with a counter
+ * of their own are in another table (indexed by their first node), and every
+ * basic block has a line and a count: the one of a counter (or zero, if it's
+ * negative), plus the one of another, and minus the one of a third one (each
+ * of them, if it's not negative).
+ */
+typedef struct {
+	const void ** nodes;
+	unsigned int * counters;
+	const void ** blockNodes;
+	unsigned int * blocks;
+	unsigned int * lines;
+	int * blockCounters;
+	int * blockAdded;
+	int * blockSubtracted;
+	unsigned int blockCount;
+	unsigned int blockCounterCount;
+	unsigned int capacity;
+	unsigned int counterCount;
+	unsigned int nodeCount;
+	uint32_t hash;
+} ProfileSites;
+
+/**
+ * The counters of a function, in a profile.
+ */
+typedef struct {
+	char * name;
+	uint32_t hash;
+	unsigned int counterCount;
+	uint64_t * counters;
+} ProfileRecord;
+
+/**
+ * A profile loaded in memory, with its records sorted by name and hash.
+ */
+typedef struct {
+	ProfileRecord * records;
+	unsigned int count;
+	unsigned int capacity;
+} Profile;
+
+/**
+ * Numbers the profiling sites of a function definition, and computes its
+ * structural hash.
+ */
+ProfileSites * createProfileSites(const Declaration * function);
+
+/**
+ * Destroys the profiling sites of a function.
+ */
+void destroyProfileSites(ProfileSites * sites);
+
+/**
+ * The first counter of a node of the AST (an if-statement, a loop or a
+ * function call), or -1 if it's not a profiling site of the function.
+ */
+int profileSite(const ProfileSites * sites, const void * node);
+
+/**
+ * The counter of the basic block that starts at a node of the AST (a block,
+ * or a statement), or -1 if no basic block with a counter of its own starts
+ * there.
+ */
+int profileBlock(const ProfileSites * sites, const void * node);
+
+/**
+ * The size of a block (its amount of nodes, as in "nodeCount"), to weigh
+ * the cost of copying it.
+ */
+unsigned int countBlockNodes(const Block * block);
+
+/**
+ * Reads a profile, adding up the records of the same function (and hash).
+ * Returns NULL if the file cannot be read. A malformed record ends the
+ * profile, but the previous ones are kept.
+ */
+Profile * loadProfile(const char * path);
+
+/**
+ * Destroys a profile, and its records.
+ */
+void destroyProfile(Profile * profile);
+
+/**
+ * The counters of a function, or NULL if the profile has no record of it
+ * with the same structural hash and amount of counters.
+ */
+const uint64_t * profileCounters(const Profile * profile, const char * name, const uint32_t hash, const unsigned int counterCount);
+
+#endif
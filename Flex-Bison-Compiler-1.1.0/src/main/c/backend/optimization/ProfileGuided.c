@@ -0,0 +1,54 @@
+#include "ProfileGuided.h"
+
+/* MODULE INTERNAL STATE */
+
+static const uint64_t _hotCount = 1000;
+static const unsigned int _maximumInlinedNodes = 64;
+static const unsigned int _maximumUnrolledNodes = 64;
+static const uint64_t _minimumUnrolledIterations = 4;
+static const uint64_t _coldRatio = 16;
+
+/* PUBLIC FUNCTIONS */
+
+boolean shouldInlineCall(const uint64_t * counts, const int site, const Symbol * callee, const int argumentCount, const char * caller) {
+	if (site < 0 || counts == NULL || counts[site] < _hotCount) {
+		return false;
+	}
+	if (callee == NULL || callee->type != SYMBOL_FUNCTION || callee->definition == NULL) {
+		return false;
+	}
+	if (strcmp(callee->name, caller) == 0 || strcmp(callee->name, "main") == 0) {
+		return false;
+	}
+	const Declaration * definition = callee->definition;
+	const Parameters * parameters = definition->declarationSuffix->parameters;
+	int parameterCount = 0;
+	for (const ParameterList * node = parameters->type == PARAMS_LIST ? parameters->list : NULL; node != NULL; node = node->next) {
+		if (node->parameter->array->type == PARAMETER_ARRAY_BRACKETS) {
+			return false;
+		}
+		++parameterCount;
+	}
+	return parameterCount == argumentCount && countBlockNodes(definition->declarationSuffix->functionSuffix->block) <= _maximumInlinedNodes;
+}
+
+boolean shouldUnrollLoop(const uint64_t * counts, const int site, const Block * block) {
+	if (site < 0 || counts == NULL) {
+		return false;
+	}
+	const uint64_t entries = counts[site];
+	const uint64_t iterations = counts[site + 1];
+	return _hotCount <= iterations && _minimumUnrolledIterations * entries <= iterations && countBlockNodes(block) <= _maximumUnrolledNodes;
+}
+
+IfLayout chooseIfLayout(const uint64_t * counts, const int site, const StatementIf * statement) {
+	if (site < 0 || counts == NULL) {
+		return IF_LAYOUT_STRAIGHT;
+	}
+	const uint64_t executions = counts[site];
+	const uint64_t taken = counts[site + 1];
+	if (!statement->hasElse && _hotCount <= executions && taken * _coldRatio <= executions) {
+		return IF_LAYOUT_OUTLINED;
+	}
+	return statement->hasElse && 2 * taken < executions ? IF_LAYOUT_INVERTED : IF_LAYOUT_STRAIGHT;
+}
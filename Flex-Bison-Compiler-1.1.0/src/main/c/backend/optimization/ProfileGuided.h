@@ -0,0 +1,53 @@
+#ifndef PROFILE_GUIDED_HEADER
+#define PROFILE_GUIDED_HEADER
+
+#include "../../frontend/semantic-analysis/SymbolTable.h"
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Type.h"
+#include "Profile.h"
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * The decisions of the optimizations guided by a profile (see
+ * "PROFILE_FILE"), from the counters of the function being lowered and the
+ * first counter of a profiling site (see "profileSite"). A call or a loop is
+ * hot if it's executed at least "hot count" times: a hot call is inlined if
+ * its callee is small enough, and a hot loop is unrolled (twice) if its body
+ * is small enough, and it averages enough iterations each time it's entered.
+ * The block of an if-statement is moved to the end of the function if it's
+ * executed at most once every "cold ratio" times the statement is.
+ */
+
+/**
+ * How the blocks of an if-statement are laid out: in the order of the
+ * source, with the else-block first (so the block executed most often
+ * follows the condition, and doesn't jump), or with the then-block (of an
+ * if-statement without else) at the end of the function.
+ */
+typedef enum {
+	IF_LAYOUT_STRAIGHT,
+	IF_LAYOUT_INVERTED,
+	IF_LAYOUT_OUTLINED
+} IfLayout;
+
+/**
+ * Checks if a call must be inlined: it's hot, and its callee is a small
+ * function of this program (other than the caller, or "main"), with the same
+ * amount of parameters as arguments, and none of them arrays.
+ */
+boolean shouldInlineCall(const uint64_t * counts, const int site, const Symbol * callee, const int argumentCount, const char * caller);
+
+/**
+ * Checks if a loop must be unrolled: it's hot, it averages enough iterations
+ * each time it's entered, and its body is small enough to copy.
+ */
+boolean shouldUnrollLoop(const uint64_t * counts, const int site, const Block * block);
+
+/**
+ * The layout of an if-statement. Without counters, it's the one of the
+ * source.
+ */
+IfLayout chooseIfLayout(const uint64_t * counts, const int site, const StatementIf * statement);
+
+#endif
@@ -0,0 +1,1163 @@
+#include "RangeAnalysis.h"
+
+/* MODULE INTERNAL STATE */
+
+static const unsigned int _initialCapacity = 16;
+
+/**
+ * The amount of times that a loop is walked before the bounds that keep
+ * growing are widened.
+ */
+static const unsigned int _iterationsBeforeWidening = 2;
+
+/**
+ * The ranges of a truth value, of an int, and of a char.
+ */
+static const Range _booleanRange = { 0, 1 };
+static const Range _intRange = { INT_MIN, INT_MAX };
+static const Range _charRange = { SCHAR_MIN, SCHAR_MAX };
+
+/**
+ * The ranges of the variables at some point of the function (indexed by
+ * their number), unless nothing reaches it.
+ */
+typedef struct {
+	Range * ranges;
+	boolean reachable;
+} RangeState;
+
+/**
+ * A variable in scope, and its number.
+ */
+typedef struct {
+	const char * name;
+	unsigned int number;
+} ScopedVariable;
+
+/**
+ * A canonical for-loop being walked: the number of its induction variable,
+ * and the amount of variables in scope before its block.
+ */
+typedef struct {
+	const StatementFor * loop;
+	unsigned int variable;
+	unsigned int scopeCount;
+} WalkedLoop;
+
+/**
+ * The state of the analysis of a function. The variables are numbered in the
+ * order of their declarations (a declaration keeps its number each time it's
+ * walked again), and the array accesses are only recorded while "recording"
+ * (in the last walk of each loop, once its ranges are stable). While
+ * "havoc", an assignment leaves the whole range of the type of its variable,
+ * since the order of the evaluation is unknown.
+ */
+typedef struct {
+	RangeAnalysis * analysis;
+	const void ** declarations;
+	unsigned int * numbers;
+	unsigned int declarationCapacity;
+	DataType * types;
+	boolean * arrays;
+	unsigned int variableCount;
+	unsigned int variableCapacity;
+	ScopedVariable * scope;
+	unsigned int scopeCount;
+	unsigned int scopeCapacity;
+	WalkedLoop * loops;
+	unsigned int loopCount;
+	unsigned int loopCapacity;
+	boolean recording;
+	boolean havoc;
+} RangeWalk;
+
+/* PRIVATE FUNCTIONS */
+
+static Range _arithmetic(const ExpressionType type, const Range left, const Range right);
+static boolean _assignsInBlock(const Block * block, const char * name);
+static boolean _assignsInExpression(const Expression * expression, const char * name);
+static boolean _assignsInStatement(const Statement * statement, const char * name);
+static Range _clamp(const Range range, const DataType type);
+static void _constrain(RangeWalk * walk, RangeState * state, Expression * expression, const ExpressionType relation, const Range other);
+static RangeState _copyState(const RangeWalk * walk, const RangeState * state);
+static unsigned int _countDeclarations(const Block * block);
+static unsigned int _declare(RangeWalk * walk, const void * node, const char * name, const DataType type, const boolean array);
+static Range _evaluate(RangeWalk * walk, RangeState * state, Expression * expression);
+static Range _evaluateAccess(RangeWalk * walk, RangeState * state, Expression * access);
+static Range _evaluateRoot(RangeWalk * walk, RangeState * state, Expression * expression);
+static void _forgetAssigned(RangeWalk * walk, RangeState * state, const Expression * expression);
+static boolean _hasNestedAssignment(const Expression * expression);
+static unsigned int _hashNode(const void * node);
+static const StatementFor * _hoistingLoop(const RangeWalk * walk, const Expression * access, int * offset);
+static boolean _includes(const RangeWalk * walk, const RangeState * outer, const RangeState * inner);
+static const char * _incremented(Expression * expression);
+static void _insertNode(const void ** nodes, unsigned int * values, const unsigned int capacity, const void * node, const unsigned int value);
+static boolean _isCanonical(RangeWalk * walk, const StatementFor * loop, WalkedLoop * canonical);
+static void _joinState(const RangeWalk * walk, RangeState * state, const RangeState * other);
+static int _lookupNode(const void * const * nodes, const unsigned int * values, const unsigned int capacity, const void * node);
+static ExpressionType _negation(const ExpressionType relation);
+static void _recordAccess(RangeWalk * walk, const Expression * access, const Range range);
+static void _recordLoop(RangeWalk * walk, const StatementFor * loop, Expression * variable, Expression * bound);
+static void _refine(RangeWalk * walk, RangeState * state, Expression * condition, const boolean truth);
+static int _resolve(const RangeWalk * walk, const char * name, unsigned int * position);
+static ExpressionType _reversal(const ExpressionType relation);
+static void _setState(const RangeWalk * walk, RangeState * state, const RangeState * other);
+static Expression * _strip(Expression * expression);
+static Range _typeRange(const DataType type);
+static Range _unknownElement(const Range value);
+static void _walkBlock(RangeWalk * walk, RangeState * state, const Block * block);
+static void _walkFor(RangeWalk * walk, RangeState * state, const StatementFor * loop);
+static void _walkIteration(RangeWalk * walk, RangeState * state, Expression * condition, Expression * update, const Block * block, const WalkedLoop * canonical);
+static void _walkLoop(RangeWalk * walk, RangeState * state, Expression * condition, Expression * update, const Block * block, const WalkedLoop * canonical);
+static void _walkStatement(RangeWalk * walk, RangeState * state, const Statement * statement);
+static void _widenState(const RangeWalk * walk, RangeState * state, const RangeState * other);
+
+/**
+ * The range of an arithmetic (or relational) operation. A result that could
+ * overflow can be any int, since it wraps around.
+ */
+static Range _arithmetic(const ExpressionType type, const Range left, const Range right) {
+	int64_t values[4];
+	switch (type) {
+		case EXPRESSION_ADDITION:
+			return _clamp((Range) { left.minimum + right.minimum, left.maximum + right.maximum }, TYPE_INT);
+		case EXPRESSION_SUBTRACTION:
+			return _clamp((Range) { left.minimum - right.maximum, left.maximum - right.minimum }, TYPE_INT);
+		case EXPRESSION_MULTIPLICATION:
+			values[0] = left.minimum * right.minimum;
+			values[1] = left.minimum * right.maximum;
+			values[2] = left.maximum * right.minimum;
+			values[3] = left.maximum * right.maximum;
+			break;
+		case EXPRESSION_DIVISION:
+			// Without zero, the quotient is monotonic in both operands.
+			if (right.minimum <= 0 && 0 <= right.maximum) {
+				return _intRange;
+			}
+			values[0] = left.minimum / right.minimum;
+			values[1] = left.minimum / right.maximum;
+			values[2] = left.maximum / right.minimum;
+			values[3] = left.maximum / right.maximum;
+			break;
+		case EXPRESSION_MODULO: {
+			if (right.minimum <= 0 && 0 <= right.maximum) {
+				return _intRange;
+			}
+			// The remainder has the sign of the dividend, and it's smaller than the divisor.
+			const int64_t limit = (-right.minimum < right.maximum ? right.maximum : -right.minimum) - 1;
+			return (Range) {
+				left.minimum < 0 ? (left.minimum < -limit ? -limit : left.minimum) : 0,
+				0 < left.maximum ? (limit < left.maximum ? limit : left.maximum) : 0
+			};
+		}
+		default:
+			return _booleanRange;
+	}
+	Range range = { values[0], values[0] };
+	for (int k = 1; k < 4; ++k) {
+		range.minimum = values[k] < range.minimum ? values[k] : range.minimum;
+		range.maximum = range.maximum < values[k] ? values[k] : range.maximum;
+	}
+	return _clamp(range, TYPE_INT);
+}
+
+/**
+ * True if a block (or the ones nested in it) assigns a variable with the
+ * specified name (in any scope).
+ */
+static boolean _assignsInBlock(const Block * block, const char * name) {
+	for (const Statements * statements = block->statements; statements != NULL; statements = statements->next) {
+		if (_assignsInStatement(statements->statement, name)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * True if an expression assigns a variable with the specified name (or any
+ * variable, if the name is NULL).
+ */
+static boolean _assignsInExpression(const Expression * expression, const char * name) {
+	switch (expression->type) {
+		case EXPRESSION_IDENTIFIER:
+		case EXPRESSION_CONSTANT:
+			return false;
+		case EXPRESSION_NOT:
+		case EXPRESSION_PARENTHESIS:
+			return _assignsInExpression(expression->singleExpression, name);
+		case EXPRESSION_ARRAY_ACCESS:
+			return _assignsInExpression(expression->indexExpression, name);
+		case EXPRESSION_FUNCTION_CALL:
+			for (const ListArguments * argument = expression->arguments; argument != NULL; argument = argument->next) {
+				if (_assignsInExpression(argument->expression, name)) {
+					return true;
+				}
+			}
+			return false;
+		case EXPRESSION_ASSIGNMENT:
+			if (expression->leftExpression->type == EXPRESSION_IDENTIFIER && (name == NULL || strcmp(*expression->leftExpression->identifier, name) == 0)) {
+				return true;
+			}
+			return (name == NULL && expression->leftExpression->type == EXPRESSION_ARRAY_ACCESS)
+				|| _assignsInExpression(expression->leftExpression, name)
+				|| _assignsInExpression(expression->rightExpression, name);
+		default:
+			return _assignsInExpression(expression->leftExpression, name) || _assignsInExpression(expression->rightExpression, name);
+	}
+}
+
+/**
+ * True if a statement (or the ones nested in it) assigns a variable with the
+ * specified name (in any scope).
+ */
+static boolean _assignsInStatement(const Statement * statement, const char * name) {
+	switch (statement->type) {
+		case STATEMENT_DECLARATION:
+			if (statement->variableSuffix->type == VARIABLE_SUFFIX_ASSIGNMENT && _assignsInExpression(statement->variableSuffix->expression, name)) {
+				return true;
+			}
+			break;
+		case STATEMENT_IF:
+			if (_assignsInExpression(statement->statementIf->condition, name) || _assignsInBlock(statement->statementIf->thenBlock, name)
+					|| (statement->statementIf->hasElse && _assignsInBlock(statement->statementIf->elseBlock, name))) {
+				return true;
+			}
+			break;
+		case STATEMENT_WHILE:
+			if (_assignsInExpression(statement->statementWhile->condition, name) || _assignsInBlock(statement->statementWhile->block, name)) {
+				return true;
+			}
+			break;
+		case STATEMENT_FOR: {
+			const StatementFor * loop = statement->statementFor;
+			if ((loop->hasInit && _assignsInExpression(loop->init, name)) || (loop->hasCondition && _assignsInExpression(loop->condition, name))
+					|| (loop->hasUpdate && _assignsInExpression(loop->update, name)) || _assignsInBlock(loop->block, name)) {
+				return true;
+			}
+			break;
+		}
+		case STATEMENT_RETURN:
+			if (statement->statementReturn->hasExpression && _assignsInExpression(statement->statementReturn->expression, name)) {
+				return true;
+			}
+			break;
+		case STATEMENT_EXPRESSION:
+			if (_assignsInExpression(statement->statementExpression->expression, name)) {
+				return true;
+			}
+			break;
+		case STATEMENT_BLOCK:
+			if (_assignsInBlock(statement->block, name)) {
+				return true;
+			}
+			break;
+		case STATEMENT_EMPTY:
+			break;
+	}
+	return false;
+}
+
+/**
+ * Converts a range to a type: if some value doesn't fit, it can be any value
+ * of the type (since it's truncated).
+ */
+static Range _clamp(const Range range, const DataType type) {
+	const Range limits = _typeRange(type);
+	return limits.minimum <= range.minimum && range.maximum <= limits.maximum ? range : limits;
+}
+
+/**
+ * Constrains the range of a variable (if the expression is one) by a
+ * relation with another range, which holds at this point. If no value
+ * satisfies it, the point is unreachable.
+ */
+static void _constrain(RangeWalk * walk, RangeState * state, Expression * expression, const ExpressionType relation, const Range other) {
+	const Expression * variable = _strip(expression);
+	const int number = variable->type == EXPRESSION_IDENTIFIER ? _resolve(walk, *variable->identifier, NULL) : -1;
+	if (number < 0 || walk->arrays[number]) {
+		return;
+	}
+	Range * range = &state->ranges[number];
+	switch (relation) {
+		case EXPRESSION_LESS:
+			range->maximum = other.maximum - 1 < range->maximum ? other.maximum - 1 : range->maximum;
+			break;
+		case EXPRESSION_LESS_EQUAL:
+			range->maximum = other.maximum < range->maximum ? other.maximum : range->maximum;
+			break;
+		case EXPRESSION_GREATER:
+			range->minimum = range->minimum < other.minimum + 1 ? other.minimum + 1 : range->minimum;
+			break;
+		case EXPRESSION_GREATER_EQUAL:
+			range->minimum = range->minimum < other.minimum ? other.minimum : range->minimum;
+			break;
+		case EXPRESSION_EQUAL:
+			range->minimum = range->minimum < other.minimum ? other.minimum : range->minimum;
+			range->maximum = other.maximum < range->maximum ? other.maximum : range->maximum;
+			break;
+		case EXPRESSION_NOT_EQUAL:
+			if (other.minimum == other.maximum && range->minimum == other.minimum) {
+				++range->minimum;
+			}
+			else if (other.minimum == other.maximum && range->maximum == other.maximum) {
+				--range->maximum;
+			}
+			break;
+		default:
+			break;
+	}
+	if (range->maximum < range->minimum) {
+		state->reachable = false;
+	}
+}
+
+/**
+ * Copies a state (which must be released).
+ */
+static RangeState _copyState(const RangeWalk * walk, const RangeState * state) {
+	RangeState copy = {
+		.ranges = malloc(walk->variableCapacity * sizeof(Range)),
+		.reachable = state->reachable
+	};
+	memcpy(copy.ranges, state->ranges, walk->variableCapacity * sizeof(Range));
+	return copy;
+}
+
+/**
+ * The amount of variables declared in a block (and the ones nested in it).
+ */
+static unsigned int _countDeclarations(const Block * block) {
+	unsigned int count = 0;
+	for (const Statements * statements = block->statements; statements != NULL; statements = statements->next) {
+		const Statement * statement = statements->statement;
+		switch (statement->type) {
+			case STATEMENT_DECLARATION:
+				++count;
+				break;
+			case STATEMENT_IF:
+				count += _countDeclarations(statement->statementIf->thenBlock);
+				if (statement->statementIf->hasElse) {
+					count += _countDeclarations(statement->statementIf->elseBlock);
+				}
+				break;
+			case STATEMENT_WHILE:
+				count += _countDeclarations(statement->statementWhile->block);
+				break;
+			case STATEMENT_FOR:
+				count += _countDeclarations(statement->statementFor->block);
+				break;
+			case STATEMENT_BLOCK:
+				count += _countDeclarations(statement->block);
+				break;
+			default:
+				break;
+		}
+	}
+	return count;
+}
+
+/**
+ * Declares a variable in the current scope, numbered by its declaration (a
+ * statement, or a parameter). Returns its number.
+ */
+static unsigned int _declare(RangeWalk * walk, const void * node, const char * name, const DataType type, const boolean array) {
+	int number = _lookupNode(walk->declarations, walk->numbers, walk->declarationCapacity, node);
+	if (number < 0) {
+		number = (int) walk->variableCount++;
+		_insertNode(walk->declarations, walk->numbers, walk->declarationCapacity, node, (unsigned int) number);
+		walk->types[number] = type;
+		walk->arrays[number] = array;
+	}
+	if (walk->scopeCount == walk->scopeCapacity) {
+		walk->scopeCapacity = walk->scopeCapacity == 0 ? _initialCapacity : 2 * walk->scopeCapacity;
+		walk->scope = realloc(walk->scope, walk->scopeCapacity * sizeof(ScopedVariable));
+	}
+	walk->scope[walk->scopeCount++] = (ScopedVariable) { .name = name, .number = (unsigned int) number };
+	return (unsigned int) number;
+}
+
+/**
+ * The range of an expression, which is evaluated as the generator does: it
+ * updates the ranges of the variables it assigns.
+ */
+static Range _evaluate(RangeWalk * walk, RangeState * state, Expression * expression) {
+	switch (expression->type) {
+		case EXPRESSION_CONSTANT: {
+			const int64_t value = computeConstant(expression->constant).value;
+			return (Range) { value, value };
+		}
+		case EXPRESSION_IDENTIFIER: {
+			const int number = _resolve(walk, *expression->identifier, NULL);
+			return number < 0 || walk->arrays[number] ? _intRange : state->ranges[number];
+		}
+		case EXPRESSION_PARENTHESIS:
+			return _evaluate(walk, state, expression->singleExpression);
+		case EXPRESSION_NOT: {
+			const Range operand = _evaluate(walk, state, expression->singleExpression);
+			if (operand.minimum == 0 && operand.maximum == 0) {
+				return (Range) { 1, 1 };
+			}
+			return 0 < operand.minimum || operand.maximum < 0 ? (Range) { 0, 0 } : _booleanRange;
+		}
+		case EXPRESSION_AND:
+		case EXPRESSION_OR: {
+			// The right operand is only evaluated if the left one doesn't decide.
+			_evaluate(walk, state, expression->leftExpression);
+			RangeState right = _copyState(walk, state);
+			_refine(walk, &right, expression->leftExpression, expression->type == EXPRESSION_AND);
+			_evaluate(walk, &right, expression->rightExpression);
+			_joinState(walk, state, &right);
+			free(right.ranges);
+			return _booleanRange;
+		}
+		case EXPRESSION_ASSIGNMENT: {
+			Expression * lvalue = expression->leftExpression;
+			const Range value = _evaluate(walk, state, expression->rightExpression);
+			if (lvalue->type == EXPRESSION_ARRAY_ACCESS) {
+				const Range element = _evaluateAccess(walk, state, lvalue);
+				return element.maximum == SCHAR_MAX ? _clamp(value, TYPE_CHAR) : _unknownElement(value);
+			}
+			const int number = _resolve(walk, *lvalue->identifier, NULL);
+			if (number < 0 || walk->arrays[number]) {
+				return _unknownElement(value);
+			}
+			const Range result = _clamp(value, walk->types[number]);
+			state->ranges[number] = walk->havoc ? _typeRange(walk->types[number]) : result;
+			return result;
+		}
+		case EXPRESSION_ARRAY_ACCESS:
+			return _evaluateAccess(walk, state, expression);
+		case EXPRESSION_FUNCTION_CALL:
+			for (ListArguments * argument = expression->arguments; argument != NULL; argument = argument->next) {
+				_evaluate(walk, state, argument->expression);
+			}
+			return _intRange;
+		default: {
+			const Range left = _evaluate(walk, state, expression->leftExpression);
+			const Range right = _evaluate(walk, state, expression->rightExpression);
+			return _arithmetic(expression->type, left, right);
+		}
+	}
+}
+
+/**
+ * Evaluates the index of an array access (and records its range). Returns
+ * the range of its elements: the one of a char for a local array of chars,
+ * and the one of an int otherwise.
+ */
+static Range _evaluateAccess(RangeWalk * walk, RangeState * state, Expression * access) {
+	const Range index = _evaluate(walk, state, access->indexExpression);
+	if (walk->recording && state->reachable) {
+		_recordAccess(walk, access, index);
+	}
+	const int number = _resolve(walk, *access->identifierArray, NULL);
+	return 0 <= number && walk->types[number] == TYPE_CHAR ? _charRange : _intRange;
+}
+
+/**
+ * Evaluates a whole expression (e.g., a statement, or a condition). If it
+ * has an assignment whose order with the rest of the expression matters, the
+ * variables that it assigns can take any value while it's evaluated.
+ */
+static Range _evaluateRoot(RangeWalk * walk, RangeState * state, Expression * expression) {
+	if (!_hasNestedAssignment(expression)) {
+		return _evaluate(walk, state, expression);
+	}
+	_forgetAssigned(walk, state, expression);
+	walk->havoc = true;
+	const Range range = _evaluate(walk, state, expression);
+	walk->havoc = false;
+	return range;
+}
+
+/**
+ * Forgets the range of every variable assigned in an expression.
+ */
+static void _forgetAssigned(RangeWalk * walk, RangeState * state, const Expression * expression) {
+	switch (expression->type) {
+		case EXPRESSION_IDENTIFIER:
+		case EXPRESSION_CONSTANT:
+			break;
+		case EXPRESSION_NOT:
+		case EXPRESSION_PARENTHESIS:
+			_forgetAssigned(walk, state, expression->singleExpression);
+			break;
+		case EXPRESSION_ARRAY_ACCESS:
+			_forgetAssigned(walk, state, expression->indexExpression);
+			break;
+		case EXPRESSION_FUNCTION_CALL:
+			for (const ListArguments * argument = expression->arguments; argument != NULL; argument = argument->next) {
+				_forgetAssigned(walk, state, argument->expression);
+			}
+			break;
+		case EXPRESSION_ASSIGNMENT:
+			if (expression->leftExpression->type == EXPRESSION_IDENTIFIER) {
+				const int number = _resolve(walk, *expression->leftExpression->identifier, NULL);
+				if (0 <= number && !walk->arrays[number]) {
+					state->ranges[number] = _typeRange(walk->types[number]);
+				}
+			}
+			_forgetAssigned(walk, state, expression->leftExpression);
+			_forgetAssigned(walk, state, expression->rightExpression);
+			break;
+		default:
+			_forgetAssigned(walk, state, expression->leftExpression);
+			_forgetAssigned(walk, state, expression->rightExpression);
+			break;
+	}
+}
+
+/**
+ * True if an expression has an assignment that isn't evaluated last: any
+ * assignment but the root one, or a chain of them to variables (such as
+ * "a = b = 0", evaluated from right to left).
+ */
+static boolean _hasNestedAssignment(const Expression * expression) {
+	while (expression->type == EXPRESSION_ASSIGNMENT && expression->leftExpression->type == EXPRESSION_IDENTIFIER) {
+		expression = expression->rightExpression;
+	}
+	if (expression->type == EXPRESSION_ASSIGNMENT) {
+		return _assignsInExpression(expression->leftExpression, NULL) || _assignsInExpression(expression->rightExpression, NULL);
+	}
+	return _assignsInExpression(expression, NULL);
+}
+
+/**
+ * Hashes the address of a node (the nodes are aligned, so the lowest bits
+ * are discarded).
+ */
+static unsigned int _hashNode(const void * node) {
+	return (unsigned int) (((uintptr_t) node >> 3) * 2654435761u);
+}
+
+/**
+ * The innermost canonical loop being walked that can check an array access
+ * before starting (or NULL): its index must be the induction variable of the
+ * loop (plus or minus a constant), and its array must be declared outside of
+ * the loop. The offset of the index is left in "offset".
+ */
+static const StatementFor * _hoistingLoop(const RangeWalk * walk, const Expression * access, int * offset) {
+	const Expression * index = _strip(access->indexExpression);
+	const Expression * variable = index;
+	int64_t constant = 0;
+	if (index->type == EXPRESSION_ADDITION || index->type == EXPRESSION_SUBTRACTION) {
+		const Expression * left = _strip(index->leftExpression);
+		const Expression * right = _strip(index->rightExpression);
+		if (right->type == EXPRESSION_CONSTANT) {
+			variable = left;
+			constant = computeConstant(right->constant).value;
+			constant = index->type == EXPRESSION_SUBTRACTION ? -constant : constant;
+		}
+		else if (index->type == EXPRESSION_ADDITION && left->type == EXPRESSION_CONSTANT) {
+			variable = right;
+			constant = computeConstant(left->constant).value;
+		}
+	}
+	if (variable->type != EXPRESSION_IDENTIFIER || constant < INT_MIN || INT_MAX < constant) {
+		return NULL;
+	}
+	const int number = _resolve(walk, *variable->identifier, NULL);
+	unsigned int position = 0;
+	const int array = _resolve(walk, *access->identifierArray, &position);
+	for (unsigned int k = walk->loopCount; 0 < k; --k) {
+		const WalkedLoop * loop = &walk->loops[k - 1];
+		if (0 <= number && loop->variable == (unsigned int) number) {
+			*offset = (int) constant;
+			return array < 0 || position < loop->scopeCount ? loop->loop : NULL;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * True if every range of a state includes the one of another state.
+ */
+static boolean _includes(const RangeWalk * walk, const RangeState * outer, const RangeState * inner) {
+	if (!inner->reachable) {
+		return true;
+	}
+	if (!outer->reachable) {
+		return false;
+	}
+	for (unsigned int k = 0; k < walk->variableCount; ++k) {
+		if (inner->ranges[k].minimum < outer->ranges[k].minimum || outer->ranges[k].maximum < inner->ranges[k].maximum) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * The name of the variable that an expression increments by one ("i = i + 1",
+ * or "i = 1 + i"), or NULL if it's not such an increment.
+ */
+static const char * _incremented(Expression * expression) {
+	const Expression * update = _strip(expression);
+	if (update->type != EXPRESSION_ASSIGNMENT || update->leftExpression->type != EXPRESSION_IDENTIFIER) {
+		return NULL;
+	}
+	const char * name = *update->leftExpression->identifier;
+	const Expression * sum = _strip(update->rightExpression);
+	if (sum->type != EXPRESSION_ADDITION) {
+		return NULL;
+	}
+	const Expression * left = _strip(sum->leftExpression);
+	const Expression * right = _strip(sum->rightExpression);
+	const Expression * step = left->type == EXPRESSION_IDENTIFIER ? right : left;
+	const Expression * same = left->type == EXPRESSION_IDENTIFIER ? left : right;
+	if (same->type != EXPRESSION_IDENTIFIER || strcmp(*same->identifier, name) != 0
+			|| step->type != EXPRESSION_CONSTANT || computeConstant(step->constant).value != 1) {
+		return NULL;
+	}
+	return name;
+}
+
+/**
+ * Inserts a node in a hash table (with linear probing), which has room.
+ */
+static void _insertNode(const void ** nodes, unsigned int * values, const unsigned int capacity, const void * node, const unsigned int value) {
+	unsigned int index = _hashNode(node) & (capacity - 1);
+	while (nodes[index] != NULL) {
+		index = (index + 1) & (capacity - 1);
+	}
+	nodes[index] = node;
+	values[index] = value;
+}
+
+/**
+ * True if a for-loop is canonical (see "RangeAnalysis.h"), which leaves its
+ * induction variable in "canonical", and records it.
+ */
+static boolean _isCanonical(RangeWalk * walk, const StatementFor * loop, WalkedLoop * canonical) {
+	if (!loop->hasCondition || !loop->hasUpdate) {
+		return false;
+	}
+	Expression * condition = _strip(loop->condition);
+	Expression * variable = NULL;
+	Expression * bound = NULL;
+	if (condition->type == EXPRESSION_LESS || condition->type == EXPRESSION_GREATER) {
+		variable = _strip(condition->type == EXPRESSION_LESS ? condition->leftExpression : condition->rightExpression);
+		bound = _strip(condition->type == EXPRESSION_LESS ? condition->rightExpression : condition->leftExpression);
+	}
+	if (variable == NULL || variable->type != EXPRESSION_IDENTIFIER || (bound->type != EXPRESSION_IDENTIFIER && bound->type != EXPRESSION_CONSTANT)) {
+		return false;
+	}
+	const char * name = *variable->identifier;
+	const int number = _resolve(walk, name, NULL);
+	if (number < 0 || walk->arrays[number] || walk->types[number] != TYPE_INT || _assignsInBlock(loop->block, name)) {
+		return false;
+	}
+	if (bound->type == EXPRESSION_IDENTIFIER) {
+		const int boundNumber = _resolve(walk, *bound->identifier, NULL);
+		if (boundNumber < 0 || boundNumber == number || walk->arrays[boundNumber] || _assignsInBlock(loop->block, *bound->identifier)) {
+			return false;
+		}
+	}
+	const char * incremented = _incremented(loop->update);
+	if (incremented == NULL || strcmp(incremented, name) != 0) {
+		return false;
+	}
+	*canonical = (WalkedLoop) {
+		.loop = loop,
+		.variable = (unsigned int) number,
+		.scopeCount = walk->scopeCount
+	};
+	_recordLoop(walk, loop, variable, bound);
+	return true;
+}
+
+/**
+ * Joins the ranges of another state into a state (the ranges of a point
+ * reached from both).
+ */
+static void _joinState(const RangeWalk * walk, RangeState * state, const RangeState * other) {
+	if (!other->reachable) {
+		return;
+	}
+	if (!state->reachable) {
+		_setState(walk, state, other);
+		return;
+	}
+	for (unsigned int k = 0; k < walk->variableCount; ++k) {
+		Range * range = &state->ranges[k];
+		range->minimum = other->ranges[k].minimum < range->minimum ? other->ranges[k].minimum : range->minimum;
+		range->maximum = range->maximum < other->ranges[k].maximum ? other->ranges[k].maximum : range->maximum;
+	}
+}
+
+/**
+ * The value of a node in a hash table, or -1 if it's not there.
+ */
+static int _lookupNode(const void * const * nodes, const unsigned int * values, const unsigned int capacity, const void * node) {
+	unsigned int index = _hashNode(node) & (capacity - 1);
+	while (nodes[index] != NULL) {
+		if (nodes[index] == node) {
+			return (int) values[index];
+		}
+		index = (index + 1) & (capacity - 1);
+	}
+	return -1;
+}
+
+/**
+ * The relation that holds when another one doesn't.
+ */
+static ExpressionType _negation(const ExpressionType relation) {
+	switch (relation) {
+		case EXPRESSION_EQUAL: return EXPRESSION_NOT_EQUAL;
+		case EXPRESSION_NOT_EQUAL: return EXPRESSION_EQUAL;
+		case EXPRESSION_LESS: return EXPRESSION_GREATER_EQUAL;
+		case EXPRESSION_LESS_EQUAL: return EXPRESSION_GREATER;
+		case EXPRESSION_GREATER: return EXPRESSION_LESS_EQUAL;
+		default: return EXPRESSION_LESS;
+	}
+}
+
+/**
+ * Records the range of the index of an array access (joined with the
+ * previous ones, if it's walked again), and the loop that can check it.
+ */
+static void _recordAccess(RangeWalk * walk, const Expression * access, const Range range) {
+	RangeAnalysis * analysis = walk->analysis;
+	const int index = analysis->capacity == 0 ? -1 : _lookupNode(analysis->nodes, analysis->indices, analysis->capacity, access->indexExpression);
+	if (0 <= index) {
+		Range * recorded = &analysis->accesses[index].range;
+		recorded->minimum = range.minimum < recorded->minimum ? range.minimum : recorded->minimum;
+		recorded->maximum = recorded->maximum < range.maximum ? range.maximum : recorded->maximum;
+		return;
+	}
+	if (analysis->accessCount == analysis->accessCapacity) {
+		// The table is rebuilt twice as large, so it's never more than half full.
+		analysis->accessCapacity = analysis->accessCapacity == 0 ? _initialCapacity : 2 * analysis->accessCapacity;
+		analysis->accesses = realloc(analysis->accesses, analysis->accessCapacity * sizeof(RangeAccess));
+		analysis->capacity = 2 * analysis->accessCapacity;
+		free(analysis->nodes);
+		free(analysis->indices);
+		analysis->nodes = calloc(analysis->capacity, sizeof(void *));
+		analysis->indices = calloc(analysis->capacity, sizeof(unsigned int));
+		for (unsigned int k = 0; k < analysis->accessCount; ++k) {
+			_insertNode(analysis->nodes, analysis->indices, analysis->capacity, analysis->accesses[k].index, k);
+		}
+	}
+	int offset = 0;
+	const StatementFor * loop = _hoistingLoop(walk, access, &offset);
+	analysis->accesses[analysis->accessCount] = (RangeAccess) {
+		.array = *access->identifierArray,
+		.index = access->indexExpression,
+		.range = range,
+		.loop = loop,
+		.offset = loop == NULL ? 0 : offset
+	};
+	_insertNode(analysis->nodes, analysis->indices, analysis->capacity, access->indexExpression, analysis->accessCount);
+	++analysis->accessCount;
+}
+
+/**
+ * Records a canonical for-loop, unless it's already recorded.
+ */
+static void _recordLoop(RangeWalk * walk, const StatementFor * loop, Expression * variable, Expression * bound) {
+	RangeAnalysis * analysis = walk->analysis;
+	if (rangeLoop(analysis, loop) != NULL) {
+		return;
+	}
+	if (analysis->loopCount == analysis->loopCapacity) {
+		analysis->loopCapacity = analysis->loopCapacity == 0 ? _initialCapacity : 2 * analysis->loopCapacity;
+		analysis->loops = realloc(analysis->loops, analysis->loopCapacity * sizeof(RangeLoop));
+	}
+	analysis->loops[analysis->loopCount++] = (RangeLoop) {
+		.loop = loop,
+		.variable = variable,
+		.bound = bound
+	};
+}
+
+/**
+ * Refines the ranges of a state with a condition, which evaluates to the
+ * specified truth value. A condition that assigns a variable is ignored.
+ */
+static void _refine(RangeWalk * walk, RangeState * state, Expression * condition, const boolean truth) {
+	if (!state->reachable || _assignsInExpression(condition, NULL)) {
+		return;
+	}
+	const boolean recording = walk->recording;
+	walk->recording = false;
+	switch (condition->type) {
+		case EXPRESSION_PARENTHESIS:
+			_refine(walk, state, condition->singleExpression, truth);
+			break;
+		case EXPRESSION_NOT:
+			_refine(walk, state, condition->singleExpression, !truth);
+			break;
+		case EXPRESSION_AND:
+		case EXPRESSION_OR:
+			if (truth == (condition->type == EXPRESSION_AND)) {
+				_refine(walk, state, condition->leftExpression, truth);
+				_refine(walk, state, condition->rightExpression, truth);
+			}
+			else {
+				// Either the left operand decides, or the right one does.
+				RangeState other = _copyState(walk, state);
+				_refine(walk, state, condition->leftExpression, truth);
+				_refine(walk, &other, condition->leftExpression, !truth);
+				_refine(walk, &other, condition->rightExpression, truth);
+				_joinState(walk, state, &other);
+				free(other.ranges);
+			}
+			break;
+		case EXPRESSION_EQUAL:
+		case EXPRESSION_NOT_EQUAL:
+		case EXPRESSION_LESS:
+		case EXPRESSION_LESS_EQUAL:
+		case EXPRESSION_GREATER:
+		case EXPRESSION_GREATER_EQUAL: {
+			const ExpressionType relation = truth ? condition->type : _negation(condition->type);
+			const Range left = _evaluate(walk, state, condition->leftExpression);
+			const Range right = _evaluate(walk, state, condition->rightExpression);
+			_constrain(walk, state, condition->leftExpression, relation, right);
+			_constrain(walk, state, condition->rightExpression, _reversal(relation), left);
+			break;
+		}
+		case EXPRESSION_IDENTIFIER:
+			_constrain(walk, state, condition, truth ? EXPRESSION_NOT_EQUAL : EXPRESSION_EQUAL, (Range) { 0, 0 });
+			break;
+		default:
+			break;
+	}
+	walk->recording = recording;
+}
+
+/**
+ * The number of the innermost variable in scope with the specified name (and
+ * its position in the scope, if requested), or -1 if it's not a local
+ * variable.
+ */
+static int _resolve(const RangeWalk * walk, const char * name, unsigned int * position) {
+	for (unsigned int k = walk->scopeCount; 0 < k; --k) {
+		if (strcmp(walk->scope[k - 1].name, name) == 0) {
+			if (position != NULL) {
+				*position = k - 1;
+			}
+			return (int) walk->scope[k - 1].number;
+		}
+	}
+	return -1;
+}
+
+/**
+ * The relation that holds with its operands swapped.
+ */
+static ExpressionType _reversal(const ExpressionType relation) {
+	switch (relation) {
+		case EXPRESSION_LESS: return EXPRESSION_GREATER;
+		case EXPRESSION_LESS_EQUAL: return EXPRESSION_GREATER_EQUAL;
+		case EXPRESSION_GREATER: return EXPRESSION_LESS;
+		case EXPRESSION_GREATER_EQUAL: return EXPRESSION_LESS_EQUAL;
+		default: return relation;
+	}
+}
+
+/**
+ * Copies the ranges of another state into a state.
+ */
+static void _setState(const RangeWalk * walk, RangeState * state, const RangeState * other) {
+	memcpy(state->ranges, other->ranges, walk->variableCapacity * sizeof(Range));
+	state->reachable = other->reachable;
+}
+
+/**
+ * The expression inside any parentheses.
+ */
+static Expression * _strip(Expression * expression) {
+	while (expression->type == EXPRESSION_PARENTHESIS) {
+		expression = expression->singleExpression;
+	}
+	return expression;
+}
+
+/**
+ * Every value of a type.
+ */
+static Range _typeRange(const DataType type) {
+	return type == TYPE_CHAR ? _charRange : _intRange;
+}
+
+/**
+ * The range of a value assigned to a variable (or an element) of unknown
+ * type: it's the same if it fits in a char, and any int otherwise.
+ */
+static Range _unknownElement(const Range value) {
+	return _clamp(value, TYPE_CHAR).minimum == value.minimum && _clamp(value, TYPE_CHAR).maximum == value.maximum ? value : _intRange;
+}
+
+/**
+ * Walks a block, in a scope of its own.
+ */
+static void _walkBlock(RangeWalk * walk, RangeState * state, const Block * block) {
+	const unsigned int scopeCount = walk->scopeCount;
+	for (const Statements * statements = block->statements; statements != NULL; statements = statements->next) {
+		_walkStatement(walk, state, statements->statement);
+	}
+	walk->scopeCount = scopeCount;
+}
+
+/**
+ * Walks a for-loop, whose accesses can be checked before it if it's
+ * canonical.
+ */
+static void _walkFor(RangeWalk * walk, RangeState * state, const StatementFor * loop) {
+	if (loop->hasInit) {
+		_evaluateRoot(walk, state, loop->init);
+	}
+	WalkedLoop canonical;
+	const boolean isCanonical = _isCanonical(walk, loop, &canonical);
+	_walkLoop(walk, state, loop->hasCondition ? loop->condition : NULL, loop->hasUpdate ? loop->update : NULL, loop->block, isCanonical ? &canonical : NULL);
+}
+
+/**
+ * Walks an iteration of a loop, from its head: its condition (if any) is
+ * true, then its block is executed, and then its update (if any).
+ */
+static void _walkIteration(RangeWalk * walk, RangeState * state, Expression * condition, Expression * update, const Block * block, const WalkedLoop * canonical) {
+	if (condition != NULL) {
+		_evaluateRoot(walk, state, condition);
+		_refine(walk, state, condition, true);
+	}
+	if (canonical != NULL) {
+		if (walk->loopCount == walk->loopCapacity) {
+			walk->loopCapacity = walk->loopCapacity == 0 ? _initialCapacity : 2 * walk->loopCapacity;
+			walk->loops = realloc(walk->loops, walk->loopCapacity * sizeof(WalkedLoop));
+		}
+		walk->loops[walk->loopCount++] = *canonical;
+	}
+	_walkBlock(walk, state, block);
+	if (canonical != NULL) {
+		--walk->loopCount;
+	}
+	if (update != NULL) {
+		_evaluateRoot(walk, state, update);
+	}
+}
+
+/**
+ * Walks a loop until the ranges at its head are stable: the ones before the
+ * loop, joined with the ones after each iteration. After a few iterations,
+ * the bounds that keep growing are widened to the limits of their type (and
+ * then narrowed once, with another iteration). Only the last iteration
+ * records the accesses. After the loop, its condition is false.
+ */
+static void _walkLoop(RangeWalk * walk, RangeState * state, Expression * condition, Expression * update, const Block * block, const WalkedLoop * canonical) {
+	const boolean recording = walk->recording;
+	walk->recording = false;
+	RangeState head = _copyState(walk, state);
+	RangeState next = _copyState(walk, state);
+	for (unsigned int iteration = 0; ; ++iteration) {
+		_setState(walk, &next, &head);
+		_walkIteration(walk, &next, condition, update, block, canonical);
+		_joinState(walk, &next, state);
+		if (_includes(walk, &head, &next)) {
+			break;
+		}
+		if (iteration < _iterationsBeforeWidening) {
+			_joinState(walk, &head, &next);
+		}
+		else {
+			_widenState(walk, &head, &next);
+		}
+	}
+	_setState(walk, &next, &head);
+	_walkIteration(walk, &next, condition, update, block, canonical);
+	_joinState(walk, &next, state);
+	if (_includes(walk, &head, &next)) {
+		_setState(walk, &head, &next);
+	}
+	walk->recording = recording;
+	_setState(walk, &next, &head);
+	_walkIteration(walk, &next, condition, update, block, canonical);
+	_setState(walk, state, &head);
+	if (condition != NULL) {
+		_evaluateRoot(walk, state, condition);
+		_refine(walk, state, condition, false);
+	}
+	else {
+		state->reachable = false;
+	}
+	free(head.ranges);
+	free(next.ranges);
+}
+
+/**
+ * Walks a statement. After a return, nothing is reachable.
+ */
+static void _walkStatement(RangeWalk * walk, RangeState * state, const Statement * statement) {
+	switch (statement->type) {
+		case STATEMENT_DECLARATION: {
+			const VariableSuffix * suffix = statement->variableSuffix;
+			Range value = _typeRange(statement->dataType);
+			if (suffix->type == VARIABLE_SUFFIX_ASSIGNMENT) {
+				value = _clamp(_evaluateRoot(walk, state, suffix->expression), statement->dataType);
+			}
+			const unsigned int number = _declare(walk, statement, *statement->identifier, statement->dataType, suffix->type == VARIABLE_SUFFIX_ARRAY);
+			state->ranges[number] = value;
+			break;
+		}
+		case STATEMENT_IF: {
+			const StatementIf * statementIf = statement->statementIf;
+			_evaluateRoot(walk, state, statementIf->condition);
+			RangeState then = _copyState(walk, state);
+			_refine(walk, &then, statementIf->condition, true);
+			_walkBlock(walk, &then, statementIf->thenBlock);
+			_refine(walk, state, statementIf->condition, false);
+			if (statementIf->hasElse) {
+				_walkBlock(walk, state, statementIf->elseBlock);
+			}
+			_joinState(walk, state, &then);
+			free(then.ranges);
+			break;
+		}
+		case STATEMENT_WHILE:
+			_walkLoop(walk, state, statement->statementWhile->condition, NULL, statement->statementWhile->block, NULL);
+			break;
+		case STATEMENT_FOR:
+			_walkFor(walk, state, statement->statementFor);
+			break;
+		case STATEMENT_RETURN:
+			if (statement->statementReturn->hasExpression) {
+				_evaluateRoot(walk, state, statement->statementReturn->expression);
+			}
+			state->reachable = false;
+			break;
+		case STATEMENT_EXPRESSION:
+			_evaluateRoot(walk, state, statement->statementExpression->expression);
+			break;
+		case STATEMENT_BLOCK:
+			_walkBlock(walk, state, statement->block);
+			break;
+		case STATEMENT_EMPTY:
+			break;
+	}
+}
+
+/**
+ * Widens the ranges of a state to include the ones of another state: a bound
+ * that grows goes to the limit of the type of its variable.
+ */
+static void _widenState(const RangeWalk * walk, RangeState * state, const RangeState * other) {
+	if (!other->reachable) {
+		return;
+	}
+	if (!state->reachable) {
+		_setState(walk, state, other);
+		return;
+	}
+	for (unsigned int k = 0; k < walk->variableCount; ++k) {
+		const Range limits = _typeRange(walk->types[k]);
+		Range * range = &state->ranges[k];
+		range->minimum = other->ranges[k].minimum < range->minimum ? limits.minimum : range->minimum;
+		range->maximum = range->maximum < other->ranges[k].maximum ? limits.maximum : range->maximum;
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+RangeAnalysis * analyzeRanges(const Declaration * function) {
+	RangeAnalysis * analysis = calloc(1, sizeof(RangeAnalysis));
+	const Parameters * parameters = function->declarationSuffix->parameters;
+	const Block * body = function->declarationSuffix->functionSuffix->block;
+	unsigned int count = _countDeclarations(body);
+	if (parameters->type == PARAMS_LIST) {
+		for (const ParameterList * node = parameters->list; node != NULL; node = node->next) {
+			++count;
+		}
+	}
+	RangeWalk walk = {
+		.analysis = analysis,
+		.variableCapacity = count == 0 ? 1 : count,
+		.declarationCapacity = _initialCapacity,
+		.recording = true,
+		.havoc = false
+	};
+	while (walk.declarationCapacity < 2 * walk.variableCapacity) {
+		walk.declarationCapacity *= 2;
+	}
+	walk.declarations = calloc(walk.declarationCapacity, sizeof(void *));
+	walk.numbers = calloc(walk.declarationCapacity, sizeof(unsigned int));
+	walk.types = calloc(walk.variableCapacity, sizeof(DataType));
+	walk.arrays = calloc(walk.variableCapacity, sizeof(boolean));
+	RangeState state = {
+		.ranges = malloc(walk.variableCapacity * sizeof(Range)),
+		.reachable = true
+	};
+	for (unsigned int k = 0; k < walk.variableCapacity; ++k) {
+		state.ranges[k] = _intRange;
+	}
+	if (parameters->type == PARAMS_LIST) {
+		for (const ParameterList * node = parameters->list; node != NULL; node = node->next) {
+			const Parameter * parameter = node->parameter;
+			const boolean array = parameter->array->type == PARAMETER_ARRAY_BRACKETS;
+			const unsigned int number = _declare(&walk, parameter, *parameter->identifier, parameter->type, array);
+			state.ranges[number] = _typeRange(parameter->type);
+		}
+	}
+	_walkBlock(&walk, &state, body);
+	free(state.ranges);
+	free(walk.declarations);
+	free(walk.numbers);
+	free(walk.types);
+	free(walk.arrays);
+	free(walk.scope);
+	free(walk.loops);
+	return analysis;
+}
+
+void destroyRangeAnalysis(RangeAnalysis * analysis) {
+	if (analysis != NULL) {
+		free(analysis->accesses);
+		free(analysis->nodes);
+		free(analysis->indices);
+		free(analysis->loops);
+		free(analysis);
+	}
+}
+
+const RangeAccess * rangeAccess(const RangeAnalysis * analysis, const Expression * index) {
+	if (analysis->capacity == 0) {
+		return NULL;
+	}
+	const int access = _lookupNode(analysis->nodes, analysis->indices, analysis->capacity, index);
+	return access < 0 ? NULL : &analysis->accesses[access];
+}
+
+const RangeLoop * rangeLoop(const RangeAnalysis * analysis, const StatementFor * loop) {
+	for (unsigned int k = 0; k < analysis->loopCount; ++k) {
+		if (analysis->loops[k].loop == loop) {
+			return &analysis->loops[k];
+		}
+	}
+	return NULL;
+}
+
+const char * countedWhileVariable(const StatementWhile * loop) {
+	const Statements * last = loop->block->statements;
+	if (last == NULL) {
+		return NULL;
+	}
+	while (last->next != NULL) {
+		last = last->next;
+	}
+	if (last->statement->type != STATEMENT_EXPRESSION) {
+		return NULL;
+	}
+	const char * name = _incremented(last->statement->statementExpression->expression);
+	if (name == NULL || _assignsInExpression(loop->condition, name)) {
+		return NULL;
+	}
+	// A declaration of another "i" in the block would be the one incremented.
+	for (const Statements * statements = loop->block->statements; statements != last; statements = statements->next) {
+		const Statement * statement = statements->statement;
+		if (_assignsInStatement(statement, name) || (statement->type == STATEMENT_DECLARATION && strcmp(*statement->identifier, name) == 0)) {
+			return NULL;
+		}
+	}
+	return name;
+}
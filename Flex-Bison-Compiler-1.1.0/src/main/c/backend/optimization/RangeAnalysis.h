@@ -0,0 +1,111 @@
+#ifndef RANGE_ANALYSIS_HEADER
+#define RANGE_ANALYSIS_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Type.h"
+#include "../domain-specific/Calculator.h"
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * An interval analysis of a function, which finds the values that the index
+ * of each array access can take, so the bounds checks that always pass can be
+ * removed (see "BOUNDS_CHECKS"). It interprets the AST abstractly: every local
+ * variable (and parameter) has a range at each point of the function, which
+ * the conditions of the if-statements and the loops refine, and which are
+ * joined where the paths join. A loop is walked until its ranges are stable,
+ * widening the bounds that keep growing to the limits of their type, so the
+ * analysis always ends. The globals and the elements of the arrays are
+ * unknown, since a call can change them.
+ *
+ * A canonical for-loop, "for (...; i < n; i = i + 1)", where "i" is a local
+ * integer and "n" is a constant or a local variable, and neither of them is
+ * assigned in its block, can check its accesses once, before it: the index
+ * "i + c" of an array declared outside the loop takes every value from the
+ * initial one of "i" (plus "c") up to "n - 1 + c", and nothing else.
+ */
+
+/**
+ * The values of an integer, from the minimum to the maximum (both included).
+ */
+typedef struct {
+	int64_t minimum;
+	int64_t maximum;
+} Range;
+
+/**
+ * A reachable array access of a function (indexed by its index expression):
+ * the name of its array, the range of its index, and the canonical loop that
+ * can check it before starting (or NULL), with the offset of the index from
+ * the induction variable of that loop.
+ */
+typedef struct {
+	const char * array;
+	const Expression * index;
+	Range range;
+	const StatementFor * loop;
+	int offset;
+} RangeAccess;
+
+/**
+ * A canonical for-loop, with its induction variable (the identifier in its
+ * condition), and its bound (a constant, or an identifier), which the
+ * induction variable never reaches inside the loop.
+ */
+typedef struct {
+	const StatementFor * loop;
+	Expression * variable;
+	Expression * bound;
+} RangeLoop;
+
+/**
+ * The array accesses of a function (in a hash table, indexed by their index
+ * expression), and its canonical for-loops.
+ */
+typedef struct {
+	RangeAccess * accesses;
+	unsigned int accessCount;
+	unsigned int accessCapacity;
+	const void ** nodes;
+	unsigned int * indices;
+	unsigned int capacity;
+	RangeLoop * loops;
+	unsigned int loopCount;
+	unsigned int loopCapacity;
+} RangeAnalysis;
+
+/**
+ * Analyzes the ranges of the array indices of a function definition.
+ */
+RangeAnalysis * analyzeRanges(const Declaration * function);
+
+/**
+ * Destroys the analysis of a function.
+ */
+void destroyRangeAnalysis(RangeAnalysis * analysis);
+
+/**
+ * The array access with the specified index expression, or NULL if it's not
+ * a reachable access of the analyzed function.
+ */
+const RangeAccess * rangeAccess(const RangeAnalysis * analysis, const Expression * index);
+
+/**
+ * The canonical for-loop of a statement, or NULL if it's not canonical.
+ */
+const RangeLoop * rangeLoop(const RangeAnalysis * analysis, const StatementFor * loop);
+
+/**
+ * The induction variable of a counted while-loop, "while (...) { ...; i = i +
+ * 1; }", whose block ends incrementing "i", which neither the rest of its
+ * block nor its condition assign (nor declare again), so its block is
+ * executed as many times as "i" is incremented. Or NULL if the loop isn't
+ * counted. Unlike the one of a
+ * canonical for-loop, the variable isn't resolved: the caller must check
+ * that it's a local integer.
+ */
+const char * countedWhileVariable(const StatementWhile * loop);
+
+#endif
@@ -0,0 +1,517 @@
+#include "Specialization.h"
+
+/* MODULE INTERNAL STATE */
+
+static const unsigned int _initialCapacity = 16;
+
+/**
+ * The most clones of each function.
+ */
+static const unsigned int _maximumClones = 8;
+
+/**
+ * How much more a call weighs for each loop around it, up to a depth.
+ */
+static const unsigned int _loopWeightBits = 3;
+static const unsigned int _maximumLoopDepth = 4;
+
+static const unsigned int _noPattern = UINT_MAX;
+
+/**
+ * A function that can be cloned: its definition (and its node in the
+ * program), its amount of parameters and nodes, and its clones so far (the
+ * last of them is the node after which the next one is inserted).
+ */
+typedef struct {
+	Declaration * declaration;
+	DeclarationList * last;
+	unsigned int parameterCount;
+	unsigned int nodes;
+	unsigned int clones;
+} Candidate;
+
+/**
+ * The constant arguments of a group of calls to a candidate: the parameters
+ * with a constant (one bit each) and their values, the weight and the amount
+ * of the calls, the order of the first one, and the name of its clone (or
+ * NULL, if it's not cloned).
+ */
+typedef struct {
+	unsigned int candidate;
+	uint32_t mask;
+	int * values;
+	uint64_t weight;
+	unsigned int first;
+	unsigned int callCount;
+	char * name;
+} Pattern;
+
+/**
+ * A call to a candidate with some constant arguments, and its pattern.
+ */
+typedef struct {
+	Expression * call;
+	unsigned int pattern;
+} CallSite;
+
+/**
+ * The state of the search of the patterns: the candidates (by name, where
+ * the slot of a symbol is the index of its candidate, or -1 if the function
+ * is defined more than once), the patterns (in a hash table), the calls, and
+ * the loops around the current one.
+ */
+typedef struct {
+	SymbolTable * names;
+	Candidate * candidates;
+	unsigned int candidateCount;
+	unsigned int candidateCapacity;
+	Pattern * patterns;
+	unsigned int patternCount;
+	unsigned int patternCapacity;
+	unsigned int * table;
+	unsigned int tableCapacity;
+	CallSite * sites;
+	unsigned int siteCount;
+	unsigned int siteCapacity;
+	unsigned int depth;
+} SpecializationWalk;
+
+/* PRIVATE FUNCTIONS */
+
+static void _addCall(SpecializationWalk * walk, Expression * call);
+static unsigned int _addPattern(SpecializationWalk * walk, const unsigned int candidate, const uint32_t mask, const int * values);
+static int _comparePatterns(const void * left, const void * right);
+static Expression * _constantExpression(const int value);
+static Declaration * _createClone(const Candidate * candidate, const Pattern * pattern);
+static unsigned int _hashPattern(const unsigned int candidate, const uint32_t mask, const int * values, const unsigned int count);
+static void _redirect(const CallSite * site, const Pattern * pattern);
+static void _walkBlock(SpecializationWalk * walk, const Block * block);
+static void _walkExpression(SpecializationWalk * walk, Expression * expression);
+static void _walkLoopExpression(SpecializationWalk * walk, Expression * expression);
+static void _walkStatement(SpecializationWalk * walk, const Statement * statement);
+
+/**
+ * Adds a call to the pattern of its constant arguments, if its callee is a
+ * candidate, and some of the arguments for its scalar parameters are
+ * constant expressions (converted to the type of their parameter).
+ */
+static void _addCall(SpecializationWalk * walk, Expression * call) {
+	const Symbol * symbol = lookupSymbol(walk->names, *call->identifierFunc);
+	if (symbol == NULL || symbol->slot < 0) {
+		return;
+	}
+	const Candidate * candidate = &walk->candidates[symbol->slot];
+	int values[MAXIMUM_SPECIALIZED_PARAMETERS];
+	uint32_t mask = 0;
+	unsigned int k = 0;
+	const ParameterList * parameter = candidate->declaration->declarationSuffix->parameters->list;
+	for (const ListArguments * argument = call->arguments; argument != NULL; argument = argument->next, ++k) {
+		if (k == candidate->parameterCount) {
+			return;
+		}
+		values[k] = 0;
+		if (parameter->parameter->array->type == PARAMETER_ARRAY_NONE) {
+			const ComputationResult result = computeExpression(argument->expression, NULL, NULL);
+			if (result.succeed) {
+				mask |= 1u << k;
+				values[k] = parameter->parameter->type == TYPE_CHAR ? (char) result.value : result.value;
+			}
+		}
+		parameter = parameter->next;
+	}
+	if (k != candidate->parameterCount || mask == 0) {
+		return;
+	}
+	const unsigned int index = _addPattern(walk, symbol->slot, mask, values);
+	Pattern * pattern = &walk->patterns[index];
+	const unsigned int depth = walk->depth < _maximumLoopDepth ? walk->depth : _maximumLoopDepth;
+	pattern->weight += UINT64_C(1) << (_loopWeightBits * depth);
+	++pattern->callCount;
+	if (walk->siteCount == walk->siteCapacity) {
+		walk->siteCapacity = walk->siteCapacity == 0 ? _initialCapacity : 2 * walk->siteCapacity;
+		walk->sites = realloc(walk->sites, walk->siteCapacity * sizeof(CallSite));
+	}
+	walk->sites[walk->siteCount].call = call;
+	walk->sites[walk->siteCount++].pattern = index;
+}
+
+/**
+ * Finds the pattern with the specified constant arguments, or creates it.
+ * Returns its index.
+ */
+static unsigned int _addPattern(SpecializationWalk * walk, const unsigned int candidate, const uint32_t mask, const int * values) {
+	const unsigned int count = walk->candidates[candidate].parameterCount;
+	if (walk->tableCapacity < 2 * (walk->patternCount + 1)) {
+		const unsigned int capacity = walk->tableCapacity == 0 ? _initialCapacity : 2 * walk->tableCapacity;
+		free(walk->table);
+		walk->table = malloc(capacity * sizeof(unsigned int));
+		memset(walk->table, 0xFF, capacity * sizeof(unsigned int));
+		walk->tableCapacity = capacity;
+		for (unsigned int p = 0; p < walk->patternCount; ++p) {
+			const Pattern * pattern = &walk->patterns[p];
+			unsigned int k = _hashPattern(pattern->candidate, pattern->mask, pattern->values, walk->candidates[pattern->candidate].parameterCount) & (capacity - 1);
+			while (walk->table[k] != _noPattern) {
+				k = (k + 1) & (capacity - 1);
+			}
+			walk->table[k] = p;
+		}
+	}
+	unsigned int k = _hashPattern(candidate, mask, values, count) & (walk->tableCapacity - 1);
+	for (; walk->table[k] != _noPattern; k = (k + 1) & (walk->tableCapacity - 1)) {
+		const Pattern * pattern = &walk->patterns[walk->table[k]];
+		if (pattern->candidate == candidate && pattern->mask == mask && memcmp(pattern->values, values, count * sizeof(int)) == 0) {
+			return walk->table[k];
+		}
+	}
+	if (walk->patternCount == walk->patternCapacity) {
+		walk->patternCapacity = walk->patternCapacity == 0 ? _initialCapacity : 2 * walk->patternCapacity;
+		walk->patterns = realloc(walk->patterns, walk->patternCapacity * sizeof(Pattern));
+	}
+	Pattern * pattern = &walk->patterns[walk->patternCount];
+	*pattern = (Pattern) {
+		.candidate = candidate,
+		.mask = mask,
+		.values = malloc(count * sizeof(int)),
+		.weight = 0,
+		.first = walk->patternCount,
+		.callCount = 0,
+		.name = NULL
+	};
+	memcpy(pattern->values, values, count * sizeof(int));
+	walk->table[k] = walk->patternCount;
+	return walk->patternCount++;
+}
+
+/**
+ * Orders the patterns from the heaviest, and then by their first call.
+ */
+static int _comparePatterns(const void * left, const void * right) {
+	const Pattern * leftPattern = *(const Pattern * const *) left;
+	const Pattern * rightPattern = *(const Pattern * const *) right;
+	if (leftPattern->weight != rightPattern->weight) {
+		return leftPattern->weight < rightPattern->weight ? 1 : -1;
+	}
+	return leftPattern->first < rightPattern->first ? -1 : (leftPattern->first > rightPattern->first ? 1 : 0);
+}
+
+/**
+ * A new integer constant expression.
+ */
+static Expression * _constantExpression(const int value) {
+	Constant * constant = calloc(1, sizeof(Constant));
+	constant->type = TYPE_INT;
+	constant->integer = malloc(sizeof(ConstantInteger));
+	*constant->integer = value;
+	Expression * expression = calloc(1, sizeof(Expression));
+	expression->type = EXPRESSION_CONSTANT;
+	expression->constant = constant;
+	return expression;
+}
+
+/**
+ * Creates the clone of a candidate for a pattern: a copy of its definition
+ * without the constant parameters, which are declared (and initialized) at
+ * the start of its body instead.
+ */
+static Declaration * _createClone(const Candidate * candidate, const Pattern * pattern) {
+	const Declaration * original = candidate->declaration;
+	const Block * body = original->declarationSuffix->functionSuffix->block;
+	Parameters * parameters = calloc(1, sizeof(Parameters));
+	ParameterList ** parameterLink = &parameters->list;
+	Statements * constants = NULL;
+	Statements ** constantLink = &constants;
+	unsigned int k = 0;
+	for (const ParameterList * node = original->declarationSuffix->parameters->list; node != NULL; node = node->next, ++k) {
+		if ((pattern->mask & (1u << k)) == 0) {
+			*parameterLink = calloc(1, sizeof(ParameterList));
+			(*parameterLink)->parameter = copyParameter(node->parameter);
+			parameterLink = &(*parameterLink)->next;
+			continue;
+		}
+		Statement * statement = calloc(1, sizeof(Statement));
+		statement->type = STATEMENT_DECLARATION;
+		statement->line = body->line;
+		statement->dataType = node->parameter->type;
+		statement->identifier = copyIdentifier(node->parameter->identifier);
+		statement->variableSuffix = calloc(1, sizeof(VariableSuffix));
+		statement->variableSuffix->type = VARIABLE_SUFFIX_ASSIGNMENT;
+		statement->variableSuffix->expression = _constantExpression(pattern->values[k]);
+		*constantLink = calloc(1, sizeof(Statements));
+		(*constantLink)->statement = statement;
+		constantLink = &(*constantLink)->next;
+	}
+	parameters->type = parameters->list == NULL ? PARAMS_VOID : PARAMS_LIST;
+	Block * block = copyBlock(body);
+	*constantLink = block->statements;
+	block->statements = constants;
+	FunctionSuffix * functionSuffix = calloc(1, sizeof(FunctionSuffix));
+	functionSuffix->type = SUFFIX_BLOCK;
+	functionSuffix->block = block;
+	DeclarationSuffix * suffix = calloc(1, sizeof(DeclarationSuffix));
+	suffix->type = DECLARATION_SUFFIX_FUNCTION;
+	suffix->parameters = parameters;
+	suffix->functionSuffix = functionSuffix;
+	Declaration * clone = calloc(1, sizeof(Declaration));
+	clone->dataType = original->dataType;
+	clone->identifier = malloc(sizeof(Identifier));
+	*clone->identifier = strdup(pattern->name);
+	clone->declarationSuffix = suffix;
+	clone->declarationType = DECLARATION_INTERNAL;
+	return clone;
+}
+
+/**
+ * Hashes the constant arguments of a pattern (FNV-1a, by value).
+ */
+static unsigned int _hashPattern(const unsigned int candidate, const uint32_t mask, const int * values, const unsigned int count) {
+	unsigned int hash = 2166136261u;
+	hash = (hash ^ candidate) * 16777619u;
+	hash = (hash ^ mask) * 16777619u;
+	for (unsigned int k = 0; k < count; ++k) {
+		hash = (hash ^ (unsigned int) values[k]) * 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * Redirects a call to the clone of its pattern, removing its constant
+ * arguments (which have no calls, so no other site is in them).
+ */
+static void _redirect(const CallSite * site, const Pattern * pattern) {
+	Expression * call = site->call;
+	free(*call->identifierFunc);
+	*call->identifierFunc = strdup(pattern->name);
+	unsigned int k = 0;
+	for (ListArguments ** link = &call->arguments; *link != NULL; ++k) {
+		ListArguments * argument = *link;
+		if ((pattern->mask & (1u << k)) == 0) {
+			link = &argument->next;
+			continue;
+		}
+		*link = argument->next;
+		freeExpression(argument->expression);
+		free(argument);
+	}
+}
+
+/**
+ * Walks a block (and the ones nested in it).
+ */
+static void _walkBlock(SpecializationWalk * walk, const Block * block) {
+	for (const Statements * statements = block->statements; statements != NULL; statements = statements->next) {
+		_walkStatement(walk, statements->statement);
+	}
+}
+
+/**
+ * Walks an expression, adding its calls (the innermost first).
+ */
+static void _walkExpression(SpecializationWalk * walk, Expression * expression) {
+	switch (expression->type) {
+		case EXPRESSION_NOT:
+		case EXPRESSION_PARENTHESIS:
+			_walkExpression(walk, expression->singleExpression);
+			break;
+		case EXPRESSION_IDENTIFIER:
+		case EXPRESSION_CONSTANT:
+			break;
+		case EXPRESSION_ARRAY_ACCESS:
+			_walkExpression(walk, expression->indexExpression);
+			break;
+		case EXPRESSION_FUNCTION_CALL:
+			for (ListArguments * argument = expression->arguments; argument != NULL; argument = argument->next) {
+				_walkExpression(walk, argument->expression);
+			}
+			_addCall(walk, expression);
+			break;
+		default:
+			_walkExpression(walk, expression->leftExpression);
+			_walkExpression(walk, expression->rightExpression);
+			break;
+	}
+}
+
+/**
+ * Walks an expression evaluated on each iteration of a loop.
+ */
+static void _walkLoopExpression(SpecializationWalk * walk, Expression * expression) {
+	++walk->depth;
+	_walkExpression(walk, expression);
+	--walk->depth;
+}
+
+/**
+ * Walks a statement, adding the calls in its expressions.
+ */
+static void _walkStatement(SpecializationWalk * walk, const Statement * statement) {
+	switch (statement->type) {
+		case STATEMENT_DECLARATION:
+			if (statement->variableSuffix->type == VARIABLE_SUFFIX_ASSIGNMENT) {
+				_walkExpression(walk, statement->variableSuffix->expression);
+			}
+			break;
+		case STATEMENT_IF:
+			_walkExpression(walk, statement->statementIf->condition);
+			_walkBlock(walk, statement->statementIf->thenBlock);
+			if (statement->statementIf->hasElse) {
+				_walkBlock(walk, statement->statementIf->elseBlock);
+			}
+			break;
+		case STATEMENT_WHILE:
+			_walkLoopExpression(walk, statement->statementWhile->condition);
+			++walk->depth;
+			_walkBlock(walk, statement->statementWhile->block);
+			--walk->depth;
+			break;
+		case STATEMENT_FOR: {
+			const StatementFor * loop = statement->statementFor;
+			if (loop->hasInit) {
+				_walkExpression(walk, loop->init);
+			}
+			if (loop->hasCondition) {
+				_walkLoopExpression(walk, loop->condition);
+			}
+			if (loop->hasUpdate) {
+				_walkLoopExpression(walk, loop->update);
+			}
+			++walk->depth;
+			_walkBlock(walk, loop->block);
+			--walk->depth;
+			break;
+		}
+		case STATEMENT_RETURN:
+			if (statement->statementReturn->hasExpression) {
+				_walkExpression(walk, statement->statementReturn->expression);
+			}
+			break;
+		case STATEMENT_EXPRESSION:
+			_walkExpression(walk, statement->statementExpression->expression);
+			break;
+		case STATEMENT_BLOCK:
+			_walkBlock(walk, statement->block);
+			break;
+		case STATEMENT_EMPTY:
+			break;
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+Specializations specializeFunctions(Program * program, const unsigned int growth) {
+	Specializations specializations = {
+		.clones = 0,
+		.redirected = 0
+	};
+	if (program->type != PROGRAM_DECLARATIONS || growth == 0) {
+		return specializations;
+	}
+	SpecializationWalk walk = {
+		.names = createSymbolTable(),
+		.candidates = NULL,
+		.candidateCount = 0,
+		.candidateCapacity = 0,
+		.patterns = NULL,
+		.patternCount = 0,
+		.patternCapacity = 0,
+		.table = NULL,
+		.tableCapacity = 0,
+		.sites = NULL,
+		.siteCount = 0,
+		.siteCapacity = 0,
+		.depth = 0
+	};
+	uint64_t programNodes = 0;
+	for (DeclarationList * node = program->declarationList; node != NULL; node = node->next) {
+		Declaration * declaration = node->declaration;
+		DeclarationSuffix * suffix = declaration->declarationSuffix;
+		if (suffix->type != DECLARATION_SUFFIX_FUNCTION || suffix->functionSuffix->type != SUFFIX_BLOCK) {
+			continue;
+		}
+		const unsigned int nodes = countBlockNodes(suffix->functionSuffix->block);
+		programNodes += nodes;
+		const char * name = *declaration->identifier;
+		Symbol * symbol = lookupSymbol(walk.names, name);
+		if (symbol != NULL) {
+			symbol->slot = -1;
+			continue;
+		}
+		symbol = declareSymbol(walk.names, name, SYMBOL_FUNCTION, declaration->dataType);
+		symbol->slot = -1;
+		unsigned int parameterCount = 0;
+		for (const ParameterList * parameter = suffix->parameters->type == PARAMS_LIST ? suffix->parameters->list : NULL; parameter != NULL; parameter = parameter->next) {
+			++parameterCount;
+		}
+		if (strcmp(name, "main") == 0 || declaration->declarationType == DECLARATION_INTERNAL || parameterCount == 0 || MAXIMUM_SPECIALIZED_PARAMETERS < parameterCount) {
+			continue;
+		}
+		if (walk.candidateCount == walk.candidateCapacity) {
+			walk.candidateCapacity = walk.candidateCapacity == 0 ? _initialCapacity : 2 * walk.candidateCapacity;
+			walk.candidates = realloc(walk.candidates, walk.candidateCapacity * sizeof(Candidate));
+		}
+		walk.candidates[walk.candidateCount] = (Candidate) {
+			.declaration = declaration,
+			.last = node,
+			.parameterCount = parameterCount,
+			.nodes = nodes,
+			.clones = 0
+		};
+		symbol->slot = (int) walk.candidateCount++;
+	}
+	for (DeclarationList * node = program->declarationList; node != NULL; node = node->next) {
+		DeclarationSuffix * suffix = node->declaration->declarationSuffix;
+		if (suffix->type == DECLARATION_SUFFIX_FUNCTION && suffix->functionSuffix->type == SUFFIX_BLOCK) {
+			_walkBlock(&walk, suffix->functionSuffix->block);
+		}
+	}
+	// The heaviest patterns are cloned first, while they fit in the budget
+	// (a lighter one can still fit after a heavier one didn't).
+	Pattern ** order = malloc((walk.patternCount + 1) * sizeof(Pattern *));
+	for (unsigned int p = 0; p < walk.patternCount; ++p) {
+		order[p] = &walk.patterns[p];
+	}
+	qsort(order, walk.patternCount, sizeof(Pattern *), _comparePatterns);
+	const uint64_t budget = programNodes * growth / 100;
+	uint64_t grown = 0;
+	unsigned int cloneCount = 0;
+	for (unsigned int p = 0; p < walk.patternCount; ++p) {
+		Pattern * pattern = order[p];
+		Candidate * candidate = &walk.candidates[pattern->candidate];
+		const uint64_t nodes = candidate->nodes + __builtin_popcount(pattern->mask);
+		if (candidate->clones == _maximumClones || budget < grown + nodes) {
+			continue;
+		}
+		const char * name = *candidate->declaration->identifier;
+		const size_t length = strlen(name) + 24;
+		pattern->name = malloc(length);
+		snprintf(pattern->name, length, "%s.constprop.%u", name, candidate->clones++);
+		grown += nodes;
+		order[cloneCount++] = pattern;
+	}
+	for (unsigned int k = 0; k < walk.siteCount; ++k) {
+		const Pattern * pattern = &walk.patterns[walk.sites[k].pattern];
+		if (pattern->name != NULL) {
+			_redirect(&walk.sites[k], pattern);
+			++specializations.redirected;
+		}
+	}
+	for (unsigned int p = 0; p < cloneCount; ++p) {
+		Candidate * candidate = &walk.candidates[order[p]->candidate];
+		DeclarationList * node = calloc(1, sizeof(DeclarationList));
+		node->declaration = _createClone(candidate, order[p]);
+		node->next = candidate->last->next;
+		candidate->last->next = node;
+		candidate->last = node;
+	}
+	specializations.clones = cloneCount;
+	for (unsigned int p = 0; p < walk.patternCount; ++p) {
+		free(walk.patterns[p].values);
+		free(walk.patterns[p].name);
+	}
+	free(order);
+	free(walk.patterns);
+	free(walk.table);
+	free(walk.sites);
+	free(walk.candidates);
+	destroySymbolTable(walk.names);
+	return specializations;
+}
@@ -0,0 +1,61 @@
+#ifndef SPECIALIZATION_HEADER
+#define SPECIALIZATION_HEADER
+
+#include "../../frontend/semantic-analysis/SymbolTable.h"
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Type.h"
+#include "../domain-specific/Calculator.h"
+#include "Profile.h"
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * An interprocedural constant propagation that clones the functions of a
+ * program for the constant arguments of their calls (see
+ * "SPECIALIZATION_GROWTH"). A call whose arguments for some scalar
+ * parameters are constant expressions has a pattern: its callee, which of
+ * them are constant, and their values. The calls with the same pattern share
+ * a single clone, named after its callee (e.g., "gcd.constprop.0"), without
+ * those parameters: its body starts declaring each of them as a local
+ * variable, initialized with its value. The calls are redirected to it, and
+ * its constant arguments are removed.
+ *
+ * The patterns are cloned from the hottest, where a call weighs eight times
+ * more for each loop around it (up to four), until the clones would exceed a
+ * percentage of the nodes of the functions of the program, or their callee
+ * has too many clones already. The calls are redirected before the clones
+ * are copied, so a recursive call with the same pattern calls its own clone.
+ * The clones are re-optimized later, by the generator (e.g., dividing by a
+ * constant parameter), and by the partial evaluation of their calls.
+ *
+ * Only the functions with a single definition in the program are cloned
+ * (except "main"), and the originals are kept, since they can be called from
+ * outside of it. The clones are internal declarations, which aren't visible
+ * outside of the program.
+ */
+
+/**
+ * The most parameters of a function that can be cloned (one bit of a
+ * pattern each).
+ */
+#define MAXIMUM_SPECIALIZED_PARAMETERS 32
+
+/**
+ * The amount of created clones, and of calls redirected to them.
+ */
+typedef struct {
+	unsigned int clones;
+	unsigned int redirected;
+} Specializations;
+
+/**
+ * Clones the functions of a program for the constant arguments of their
+ * calls, while the clones grow its functions up to a percentage of their
+ * nodes. Each clone is inserted right after its original.
+ */
+Specializations specializeFunctions(Program * program, const unsigned int growth);
+
+#endif
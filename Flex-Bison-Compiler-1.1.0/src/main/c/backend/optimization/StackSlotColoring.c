@@ -0,0 +1,192 @@
+#include "StackSlotColoring.h"
+
+/* MODULE INTERNAL STATE */
+
+/**
+ * The interference graph is a bit-matrix (a row per slot), so a write adds
+ * every live slot as a neighbour in a single word-wise union. Beyond this
+ * amount of slots the matrix would be too large, and the slots are not
+ * shared (but the unused ones are still dropped).
+ */
+static const int _maximumColoredSlots = 16384;
+
+/**
+ * The frame being sorted, for the comparison functions of "qsort" (one for
+ * each thread, since many functions can be colored at the same time).
+ */
+static __thread const Slot * _slots = NULL;
+
+/* PRIVATE FUNCTIONS */
+
+static void _buildInterferenceGraph(AssemblyFunction * function, const SlotLiveness * liveness, BitSet ** graph, BitSet * accessed);
+static int _compareColors(const void * left, const void * right);
+static int _compareSlots(const void * left, const void * right);
+
+/**
+ * Walks each block backwards from its live-out slots, and makes every
+ * written slot interfere with the slots live after the write. A write
+ * counts even if the written slot is dead, since it still clobbers its
+ * storage.
+ */
+static void _buildInterferenceGraph(AssemblyFunction * function, const SlotLiveness * liveness, BitSet ** graph, BitSet * accessed) {
+	const ControlFlowGraph * controlFlowGraph = liveness->graph;
+	BitSet * live = createBitSet(liveness->slotCount);
+	SlotAccess accesses[3];
+	for (unsigned int b = 0; b < controlFlowGraph->blockCount; ++b) {
+		const BasicBlock * block = &controlFlowGraph->blocks[b];
+		copyBitSet(live, liveness->solution->out[b]);
+		for (const Instruction * instruction = block->last; ; instruction = instruction->previous) {
+			const unsigned int count = getSlotAccesses(function, instruction, accesses);
+			for (unsigned int k = 0; k < count; ++k) {
+				const int slot = accesses[k].slot;
+				addBit(accessed, (unsigned int) slot);
+				if (graph != NULL && accesses[k].written) {
+					unionBitSet(graph[slot], live);
+				}
+			}
+			transferSlotLiveness(liveness, function, instruction, live);
+			if (instruction == block->first) {
+				break;
+			}
+		}
+	}
+	destroyBitSet(live);
+	if (graph == NULL) {
+		return;
+	}
+	// The rows only have the slots live at the writes of each slot, so the
+	// matrix is made symmetric.
+	for (unsigned int slot = 0; slot < liveness->slotCount; ++slot) {
+		for (int other = nextBit(graph[slot], 0); 0 <= other; other = nextBit(graph[slot], (unsigned int) other + 1)) {
+			addBit(graph[other], slot);
+		}
+	}
+}
+
+/**
+ * Sorts the colors by decreasing alignment (and then by index, so the layout
+ * is deterministic).
+ */
+static int _compareColors(const void * left, const void * right) {
+	const Slot * leftSlot = &_slots[*(const int *) left];
+	const Slot * rightSlot = &_slots[*(const int *) right];
+	if (leftSlot->alignment != rightSlot->alignment) {
+		return rightSlot->alignment - leftSlot->alignment;
+	}
+	return *(const int *) left - *(const int *) right;
+}
+
+/**
+ * Sorts the slots by decreasing size (and then by index).
+ */
+static int _compareSlots(const void * left, const void * right) {
+	const Slot * leftSlot = &_slots[*(const int *) left];
+	const Slot * rightSlot = &_slots[*(const int *) right];
+	if (leftSlot->size != rightSlot->size) {
+		return rightSlot->size - leftSlot->size;
+	}
+	return *(const int *) left - *(const int *) right;
+}
+
+/* PUBLIC FUNCTIONS */
+
+int colorStackSlots(AssemblyFunction * function) {
+	StackFrame * frame = &function->frame;
+	const int count = frame->count;
+	if (count == 0) {
+		return 0;
+	}
+	SlotLiveness * liveness = computeSlotLiveness(function);
+	BitSet ** graph = NULL;
+	if (count <= _maximumColoredSlots) {
+		graph = calloc(count, sizeof(BitSet *));
+		for (int k = 0; k < count; ++k) {
+			graph[k] = createBitSet((unsigned int) count);
+		}
+	}
+	BitSet * accessed = createBitSet((unsigned int) count);
+	_buildInterferenceGraph(function, liveness, graph, accessed);
+	// Greedy coloring: the colors of the neighbours are marked with the
+	// current slot, so the lowest free color is found without clearing.
+	int * order = calloc(count, sizeof(int));
+	int * colorOf = calloc(count, sizeof(int));
+	int * marks = calloc(count, sizeof(int));
+	Slot * colors = calloc(count, sizeof(Slot));
+	boolean * reserved = calloc(count, sizeof(boolean));
+	int colorCount = 0;
+	for (int k = 0; k < count; ++k) {
+		order[k] = k;
+		colorOf[k] = -1;
+		marks[k] = -1;
+	}
+	_slots = frame->slots;
+	qsort(order, count, sizeof(int), _compareSlots);
+	for (int k = 0; k < count; ++k) {
+		const int slot = order[k];
+		if (!containsBit(accessed, (unsigned int) slot)) {
+			continue;
+		}
+		int color = colorCount;
+		if (graph != NULL && !containsBit(liveness->escaping, (unsigned int) slot)) {
+			for (int neighbour = nextBit(graph[slot], 0); 0 <= neighbour; neighbour = nextBit(graph[slot], (unsigned int) neighbour + 1)) {
+				if (neighbour != slot && 0 <= colorOf[neighbour]) {
+					marks[colorOf[neighbour]] = slot;
+				}
+			}
+			for (color = 0; color < colorCount; ++color) {
+				if (!reserved[color] && marks[color] != slot) {
+					break;
+				}
+			}
+		}
+		if (color == colorCount) {
+			colors[colorCount].size = 0;
+			colors[colorCount].alignment = 1;
+			reserved[colorCount] = containsBit(liveness->escaping, (unsigned int) slot);
+			++colorCount;
+		}
+		// The slots are visited by decreasing size, so only the alignment grows.
+		const Slot * original = &frame->slots[slot];
+		colors[color].size = original->size < colors[color].size ? colors[color].size : original->size;
+		colors[color].alignment = original->alignment < colors[color].alignment ? colors[color].alignment : original->alignment;
+		colorOf[slot] = color;
+	}
+	// Each color becomes a slot of the new frame, sorted by alignment.
+	int * colorOrder = calloc(colorCount == 0 ? 1 : colorCount, sizeof(int));
+	int * newSlotOf = calloc(colorCount == 0 ? 1 : colorCount, sizeof(int));
+	for (int c = 0; c < colorCount; ++c) {
+		colorOrder[c] = c;
+	}
+	_slots = colors;
+	qsort(colorOrder, colorCount, sizeof(int), _compareColors);
+	_slots = NULL;
+	frame->count = 0;
+	for (int c = 0; c < colorCount; ++c) {
+		const Slot * color = &colors[colorOrder[c]];
+		newSlotOf[colorOrder[c]] = createSlot(frame, color->size, color->alignment);
+	}
+	for (Instruction * instruction = function->instructions.first; instruction != NULL; instruction = instruction->next) {
+		for (unsigned int k = 0; k < instruction->operandCount; ++k) {
+			Operand * operand = &instruction->operands[k];
+			if (operand->type == OPERAND_MEMORY && 0 <= operand->slot) {
+				operand->slot = newSlotOf[colorOf[operand->slot]];
+			}
+		}
+	}
+	free(newSlotOf);
+	free(colorOrder);
+	free(reserved);
+	free(colors);
+	free(marks);
+	free(colorOf);
+	free(order);
+	destroyBitSet(accessed);
+	if (graph != NULL) {
+		for (int k = 0; k < count; ++k) {
+			destroyBitSet(graph[k]);
+		}
+		free(graph);
+	}
+	destroySlotLiveness(liveness);
+	return count - colorCount;
+}
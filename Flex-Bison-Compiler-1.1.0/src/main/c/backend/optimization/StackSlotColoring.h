@@ -0,0 +1,27 @@
+#ifndef STACK_SLOT_COLORING_HEADER
+#define STACK_SLOT_COLORING_HEADER
+
+#include "../../shared/Type.h"
+#include "../code-generation/Assembly.h"
+#include "BitSet.h"
+#include "Liveness.h"
+#include <stdlib.h>
+
+/**
+ * Compacts the stack frame of a function, so the slots that are never live
+ * at the same time (like the locals of sibling blocks, or temporaries) share
+ * the same storage, and the slots that are never accessed are dropped.
+ *
+ * Two slots interfere if one of them is written while the other is live.
+ * The interference graph is colored greedily, from the largest slot to the
+ * smallest one, and each color becomes a slot of the new frame. The slots
+ * whose address escapes are never shared. The new slots are sorted by
+ * alignment, so the arrays (aligned to 16 bytes, the largest alignment the
+ * System V ABI guarantees for %rbp) don't waste padding.
+ *
+ * It must run before the frame layout, and returns the amount of slots
+ * removed from the frame.
+ */
+int colorStackSlots(AssemblyFunction * function);
+
+#endif
@@ -0,0 +1,147 @@
+#include "StrengthReduction.h"
+
+/* PRIVATE FUNCTIONS */
+
+static void _emit(InstructionList * list, const Opcode opcode, const Width width, const Operand source, const Operand destination);
+static void _generateMagicDivision(InstructionList * list, const int divisor, const boolean remainder);
+static void _generatePowerOfTwoDivision(InstructionList * list, const int divisor, const unsigned int exponent, const boolean remainder);
+
+/**
+ * Appends a two-operand instruction.
+ */
+static void _emit(InstructionList * list, const Opcode opcode, const Width width, const Operand source, const Operand destination) {
+	appendInstruction(list, createInstruction(opcode, width, 2, source, destination));
+}
+
+/**
+ * Divides by a constant that is not a power of two, with a multiply-high
+ * instruction (emulated by a 64-bit product) and arithmetic shifts. The
+ * quotient is truncated towards zero adding its own sign bit.
+ */
+static void _generateMagicDivision(InstructionList * list, const int divisor, const boolean remainder) {
+	const DivisionMagic magic = computeDivisionMagic(divisor);
+	const Operand eax = registerOperand(REGISTER_RAX);
+	const Operand ecx = registerOperand(REGISTER_RCX);
+	const Operand edx = registerOperand(REGISTER_RDX);
+	_emit(list, OPCODE_MOVSL, WIDTH_QUAD, eax, ecx);
+	appendInstruction(list, createInstruction(OPCODE_IMUL, WIDTH_QUAD, 3, immediateOperand(magic.multiplier), ecx, edx));
+	if (0 < divisor && magic.multiplier < 0) {
+		_emit(list, OPCODE_SAR, WIDTH_QUAD, immediateOperand(32), edx);
+		_emit(list, OPCODE_ADD, WIDTH_LONG, eax, edx);
+		if (0 < magic.shift) {
+			_emit(list, OPCODE_SAR, WIDTH_LONG, immediateOperand(magic.shift), edx);
+		}
+	}
+	else if (divisor < 0 && 0 < magic.multiplier) {
+		_emit(list, OPCODE_SAR, WIDTH_QUAD, immediateOperand(32), edx);
+		_emit(list, OPCODE_SUB, WIDTH_LONG, eax, edx);
+		if (0 < magic.shift) {
+			_emit(list, OPCODE_SAR, WIDTH_LONG, immediateOperand(magic.shift), edx);
+		}
+	}
+	else {
+		_emit(list, OPCODE_SAR, WIDTH_QUAD, immediateOperand(32 + magic.shift), edx);
+	}
+	_emit(list, OPCODE_MOV, WIDTH_LONG, edx, ecx);
+	_emit(list, OPCODE_SHR, WIDTH_LONG, immediateOperand(31), ecx);
+	_emit(list, OPCODE_ADD, WIDTH_LONG, ecx, edx);
+	if (remainder) {
+		appendInstruction(list, createInstruction(OPCODE_IMUL, WIDTH_LONG, 3, immediateOperand(divisor), edx, edx));
+		_emit(list, OPCODE_SUB, WIDTH_LONG, edx, eax);
+	}
+	else {
+		_emit(list, OPCODE_MOV, WIDTH_LONG, edx, eax);
+	}
+}
+
+/**
+ * Divides by +/-2^exponent with shifts. Negative dividends are biased by
+ * 2^exponent - 1 first, so the result is truncated towards zero like "idiv".
+ */
+static void _generatePowerOfTwoDivision(InstructionList * list, const int divisor, const unsigned int exponent, const boolean remainder) {
+	const Operand eax = registerOperand(REGISTER_RAX);
+	const Operand ecx = registerOperand(REGISTER_RCX);
+	_emit(list, OPCODE_MOV, WIDTH_LONG, eax, ecx);
+	if (1 < exponent) {
+		_emit(list, OPCODE_SAR, WIDTH_LONG, immediateOperand(31), ecx);
+	}
+	_emit(list, OPCODE_SHR, WIDTH_LONG, immediateOperand(32 - exponent), ecx);
+	_emit(list, OPCODE_ADD, WIDTH_LONG, ecx, eax);
+	if (remainder) {
+		_emit(list, OPCODE_AND, WIDTH_LONG, immediateOperand((1L << exponent) - 1), eax);
+		_emit(list, OPCODE_SUB, WIDTH_LONG, ecx, eax);
+	}
+	else {
+		_emit(list, OPCODE_SAR, WIDTH_LONG, immediateOperand(exponent), eax);
+		if (divisor < 0) {
+			appendInstruction(list, createInstruction(OPCODE_NEG, WIDTH_LONG, 1, eax));
+		}
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+DivisionMagic computeDivisionMagic(const int divisor) {
+	const unsigned int two31 = 0x80000000u;
+	const unsigned int absolute = divisor < 0 ? -(unsigned int) divisor : (unsigned int) divisor;
+	const unsigned int t = two31 + ((unsigned int) divisor >> 31);
+	const unsigned int absoluteNc = t - 1 - t % absolute;
+	int p = 31;
+	unsigned int q1 = two31 / absoluteNc;
+	unsigned int r1 = two31 - q1 * absoluteNc;
+	unsigned int q2 = two31 / absolute;
+	unsigned int r2 = two31 - q2 * absolute;
+	unsigned int delta;
+	do {
+		++p;
+		q1 = 2 * q1;
+		r1 = 2 * r1;
+		if (r1 >= absoluteNc) {
+			++q1;
+			r1 -= absoluteNc;
+		}
+		q2 = 2 * q2;
+		r2 = 2 * r2;
+		if (r2 >= absolute) {
+			++q2;
+			r2 -= absolute;
+		}
+		delta = absolute - r2;
+	} while (q1 < delta || (q1 == delta && r1 == 0));
+	DivisionMagic magic = {
+		.multiplier = (int) (q2 + 1),
+		.shift = p - 32
+	};
+	if (divisor < 0) {
+		magic.multiplier = (int) -(q2 + 1);
+	}
+	return magic;
+}
+
+boolean generateConstantDivision(InstructionList * list, const int divisor, const boolean remainder) {
+	if (divisor == 0 || divisor == INT_MIN) {
+		return false;
+	}
+	const Operand eax = registerOperand(REGISTER_RAX);
+	if (divisor == 1 || divisor == -1) {
+		if (remainder) {
+			_emit(list, OPCODE_XOR, WIDTH_LONG, eax, eax);
+		}
+		else if (divisor == -1) {
+			appendInstruction(list, createInstruction(OPCODE_NEG, WIDTH_LONG, 1, eax));
+		}
+		return true;
+	}
+	const unsigned int absolute = divisor < 0 ? -(unsigned int) divisor : (unsigned int) divisor;
+	if ((absolute & (absolute - 1)) == 0) {
+		unsigned int exponent = 0;
+		while ((1u << exponent) != absolute) {
+			++exponent;
+		}
+		_generatePowerOfTwoDivision(list, divisor, exponent, remainder);
+	}
+	else {
+		_generateMagicDivision(list, divisor, remainder);
+	}
+	return true;
+}
@@ -0,0 +1,34 @@
+#ifndef STRENGTH_REDUCTION_HEADER
+#define STRENGTH_REDUCTION_HEADER
+
+#include "../../shared/Type.h"
+#include "../code-generation/Assembly.h"
+#include <limits.h>
+#include <stdlib.h>
+
+/**
+ * The "magic" multiplier and shift that replace a signed 32-bit division by
+ * a constant, such that n/d == mulhs(multiplier, n) >> shift, plus the
+ * corrections described in "Hacker's Delight" (2nd ed., chapter 10).
+ */
+typedef struct {
+	int multiplier;
+	int shift;
+} DivisionMagic;
+
+/**
+ * Computes the magic numbers of a divisor. The divisor must satisfy
+ * 2 <= |divisor| and divisor != INT_MIN.
+ */
+DivisionMagic computeDivisionMagic(const int divisor);
+
+/**
+ * Replaces the quotient (or the remainder) of the signed value in %eax by a
+ * constant divisor with shifts and a multiplication, leaving the result in
+ * %eax and clobbering %ecx and %edx. Returns false without generating any
+ * instruction if the divisor cannot be reduced (zero or INT_MIN), so the
+ * caller must fall back to "idiv".
+ */
+boolean generateConstantDivision(InstructionList * list, const int divisor, const boolean remainder);
+
+#endif
@@ -0,0 +1,324 @@
+#include "../backend/code-generation/Emitter.h"
+#include "../backend/code-generation/Generator.h"
+#include "../backend/domain-specific/Calculator.h"
+#include "../backend/optimization/Peephole.h"
+#include "../frontend/lexical-analysis/FlexActions.h"
+#include "../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../frontend/syntactic-analysis/BisonActions.h"
+#include "../frontend/syntactic-analysis/SyntacticAnalyzer.h"
+#include "../shared/CompilerState.h"
+#include "../shared/Logger.h"
+#include "../shared/Statistics.h"
+#include "ProgramGenerator.h"
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+/**
+ * The phases of a compilation, timed separately. The semantic analysis is
+ * part of the generation, since the generator resolves (and checks) every
+ * symbol while it lowers the program.
+ */
+typedef enum {
+	PHASE_LEXING,
+	PHASE_PARSING,
+	PHASE_GENERATION,
+	PHASE_RELEASE,
+	PHASE_TOTAL,
+	PHASE_COUNT
+} Phase;
+
+static const char * _phaseNames[PHASE_COUNT] = { "lexing", "parsing", "generation", "release", "total" };
+
+/**
+ * The configuration of a benchmark run.
+ */
+typedef struct {
+	ProgramShape shape;
+	unsigned int iterations;
+	unsigned int warmups;
+	boolean emit;
+	boolean parallelParse;
+} BenchmarkOptions;
+
+/* PRIVATE FUNCTIONS */
+
+static int _compareDurations(const void * left, const void * right);
+static boolean _compileOnce(const GeneratedProgram * program, const boolean parallelParse, uint64_t durations[PHASE_COUNT], unsigned long * tokens);
+static FILE * _openProgram(const GeneratedProgram * program);
+static boolean _parseOptions(const int count, const char ** arguments, BenchmarkOptions * options);
+static uint64_t _percentile(const uint64_t * sorted, const unsigned int count, const unsigned int percent);
+static void _report(const BenchmarkOptions * options, const GeneratedProgram * program, const unsigned long tokens, uint64_t * durations[PHASE_COUNT]);
+
+static int _compareDurations(const void * left, const void * right) {
+	const uint64_t a = *(const uint64_t *) left;
+	const uint64_t b = *(const uint64_t *) right;
+	return (a > b) - (a < b);
+}
+
+/**
+ * Compiles the program once, phase by phase, with the output discarded. The
+ * lexing phase scans the whole input into a token array, which is then
+ * parsed (in parallel, with "--parallel-parse"), so the parsing phase doesn't
+ * include the lexing.
+ */
+static boolean _compileOnce(const GeneratedProgram * program, const boolean parallelParse, uint64_t durations[PHASE_COUNT], unsigned long * tokens) {
+	FILE * input = _openProgram(program);
+	if (input == NULL) {
+		return false;
+	}
+	uint64_t start = monotonicTime();
+	restartSyntacticAnalyzer(input);
+	TokenArray * tokenArray = lexTokens();
+	durations[PHASE_LEXING] = monotonicTime() - start;
+	fclose(input);
+	*tokens = tokenArray->count;
+
+	CompilerState compilerState = {
+		.abstractSyntaxtTree = NULL,
+		.succeed = false,
+		.value = 0
+	};
+	start = monotonicTime();
+	const SyntacticAnalysisStatus status = parallelParse
+		? parseTokensInParallel(&compilerState, tokenArray)
+		: parseTokens(&compilerState, tokenArray);
+	durations[PHASE_PARSING] = monotonicTime() - start;
+	destroyTokenArray(tokenArray);
+	if (status != ACCEPT) {
+		logError(_logger, "The synthetic program was rejected by the syntactic analysis.");
+		return false;
+	}
+
+	start = monotonicTime();
+	generate(&compilerState);
+	durations[PHASE_GENERATION] = monotonicTime() - start;
+
+	start = monotonicTime();
+	freeProgram(compilerState.abstractSyntaxtTree);
+	durations[PHASE_RELEASE] = monotonicTime() - start;
+
+	durations[PHASE_TOTAL] = durations[PHASE_LEXING] + durations[PHASE_PARSING] + durations[PHASE_GENERATION] + durations[PHASE_RELEASE];
+	if (!compilerState.succeed) {
+		logError(_logger, "The synthetic program was rejected by the code-generation phase.");
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Opens the text of the program as a stream, like the standard input of
+ * a regular compilation.
+ */
+static FILE * _openProgram(const GeneratedProgram * program) {
+	FILE * input = fmemopen(program->text, program->length, "r");
+	if (input == NULL) {
+		logError(_logger, "Cannot open the synthetic program as a stream.");
+	}
+	return input;
+}
+
+/**
+ * Parses the "--name value" options (and the "--emit" and "--parallel-parse"
+ * flags).
+ */
+static boolean _parseOptions(const int count, const char ** arguments, BenchmarkOptions * options) {
+	for (int k = 1; k < count; ++k) {
+		const char * name = arguments[k];
+		if (strcmp(name, "--emit") == 0) {
+			options->emit = true;
+			continue;
+		}
+		if (strcmp(name, "--parallel-parse") == 0) {
+			options->parallelParse = true;
+			continue;
+		}
+		if (count <= k + 1) {
+			logError(_logger, "The option \"%s\" is unknown, or has no value.", name);
+			return false;
+		}
+		const unsigned long value = strtoul(arguments[++k], NULL, 10);
+		if (strcmp(name, "--seed") == 0) options->shape.seed = value;
+		else if (strcmp(name, "--functions") == 0) options->shape.functions = (unsigned int) value;
+		else if (strcmp(name, "--statements") == 0) options->shape.statements = (unsigned int) value;
+		else if (strcmp(name, "--depth") == 0) options->shape.depth = (unsigned int) value;
+		else if (strcmp(name, "--terms") == 0) options->shape.terms = (unsigned int) value;
+		else if (strcmp(name, "--identifiers") == 0) options->shape.identifiers = (unsigned int) value;
+		else if (strcmp(name, "--iterations") == 0) options->iterations = (unsigned int) value;
+		else if (strcmp(name, "--warmups") == 0) options->warmups = (unsigned int) value;
+		else {
+			logError(_logger, "The option \"%s\" is unknown.", name);
+			return false;
+		}
+	}
+	if (options->iterations == 0) {
+		logError(_logger, "At least one iteration is required.");
+		return false;
+	}
+	return true;
+}
+
+/**
+ * The nearest-rank percentile of a sorted sample.
+ */
+static uint64_t _percentile(const uint64_t * sorted, const unsigned int count, const unsigned int percent) {
+	unsigned int rank = (percent * count + 99) / 100;
+	return sorted[rank == 0 ? 0 : rank - 1];
+}
+
+/**
+ * Writes the results as a JSON object in the standard output. The
+ * throughput of each phase is computed with its median duration.
+ */
+static void _report(const BenchmarkOptions * options, const GeneratedProgram * program, const unsigned long tokens, uint64_t * durations[PHASE_COUNT]) {
+	const ProgramShape * shape = &options->shape;
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	printf("{\n");
+	printf("\t\"shape\": { \"seed\": %llu, \"functions\": %u, \"statements\": %u, \"depth\": %u, \"terms\": %u, \"identifiers\": %u },\n",
+		(unsigned long long) shape->seed, shape->functions, shape->statements, shape->depth, shape->terms, shape->identifiers);
+	printf("\t\"input\": { \"bytes\": %zu, \"lines\": %u, \"tokens\": %lu },\n", program->length, program->lines, tokens);
+	printf("\t\"iterations\": %u,\n", options->iterations);
+	printf("\t\"parallelParse\": %s,\n", options->parallelParse ? "true" : "false");
+	printf("\t\"phases\": {\n");
+	for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+		uint64_t * sorted = durations[phase];
+		const unsigned int count = options->iterations;
+		qsort(sorted, count, sizeof(uint64_t), _compareDurations);
+		long double sum = 0;
+		for (unsigned int k = 0; k < count; ++k) {
+			sum += sorted[k];
+		}
+		const uint64_t median = _percentile(sorted, count, 50);
+		const double seconds = median == 0 ? 1e-9 : median / 1e9;
+		printf("\t\t\"%s\": { \"meanNanoseconds\": %.0Lf, \"minimumNanoseconds\": %llu, \"p50Nanoseconds\": %llu, \"p90Nanoseconds\": %llu, \"p99Nanoseconds\": %llu, \"maximumNanoseconds\": %llu, ",
+			_phaseNames[phase],
+			sum / count,
+			(unsigned long long) sorted[0],
+			(unsigned long long) median,
+			(unsigned long long) _percentile(sorted, count, 90),
+			(unsigned long long) _percentile(sorted, count, 99),
+			(unsigned long long) sorted[count - 1]);
+		printf("\"tokensPerSecond\": %.0f, \"linesPerSecond\": %.0f, \"megabytesPerSecond\": %.3f }%s\n",
+			tokens / seconds,
+			program->lines / seconds,
+			program->length / seconds / 1e6,
+			phase + 1 < PHASE_COUNT ? "," : "");
+	}
+	printf("\t},\n");
+	printf("\t\"peakResidentKilobytes\": %ld\n", usage.ru_maxrss);
+	printf("}\n");
+}
+
+/* PUBLIC FUNCTIONS */
+
+/**
+ * Generates a synthetic program with the specified shape, and compiles it
+ * in-process many times, timing each phase. With "--emit", only writes the
+ * program in the standard output (to feed the compiler with it).
+ */
+int main(const int count, const char ** arguments) {
+	_logger = createLogger("Benchmark");
+	initializeStatisticsModule();
+	initializeLineCounterModule();
+	initializeFlexActionsModule();
+	initializeBisonActionsModule();
+	initializeSyntacticAnalyzerModule();
+	initializeAbstractSyntaxTreeModule();
+	initializeInterfaceResolverModule();
+	initializeTypeCheckerModule();
+	initializeCalculatorModule();
+	initializePeepholeModule();
+	initializeEmitterModule();
+	initializeGeneratorModule();
+	initializeProgramGeneratorModule();
+
+	BenchmarkOptions options = {
+		.shape = {
+			.seed = 1,
+			.functions = 20,
+			.statements = 20,
+			.depth = 4,
+			.terms = 8,
+			.identifiers = 16
+		},
+		.iterations = 10,
+		.warmups = 1,
+		.emit = false,
+		.parallelParse = false
+	};
+	CompilationStatus compilationStatus = FAILED;
+	GeneratedProgram * program = NULL;
+	uint64_t * durations[PHASE_COUNT] = { NULL };
+	if (_parseOptions(count, arguments, &options) && (program = generateProgram(&options.shape)) != NULL) {
+		if (options.emit) {
+			fwrite(program->text, 1, program->length, stdout);
+			compilationStatus = SUCCEED;
+		}
+		else {
+			boolean allocated = true;
+			for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+				allocated = (durations[phase] = calloc(options.iterations, sizeof(uint64_t))) != NULL && allocated;
+			}
+			// The generated code (and any log below the ERROR level) is discarded.
+			fflush(stdout);
+			const int terminal = dup(STDOUT_FILENO);
+			const int discard = open("/dev/null", O_WRONLY);
+			boolean succeed = allocated && 0 <= terminal && 0 <= discard && 0 <= dup2(discard, STDOUT_FILENO);
+			unsigned long tokens = 0;
+			uint64_t sample[PHASE_COUNT];
+			for (unsigned int k = 0; succeed && k < options.warmups; ++k) {
+				succeed = _compileOnce(program, options.parallelParse, sample, &tokens);
+			}
+			for (unsigned int k = 0; succeed && k < options.iterations; ++k) {
+				succeed = _compileOnce(program, options.parallelParse, sample, &tokens);
+				for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+					durations[phase][k] = sample[phase];
+				}
+			}
+			fflush(stdout);
+			if (0 <= terminal) {
+				dup2(terminal, STDOUT_FILENO);
+				close(terminal);
+			}
+			if (0 <= discard) {
+				close(discard);
+			}
+			if (succeed) {
+				_report(&options, program, tokens, durations);
+				compilationStatus = SUCCEED;
+			}
+			else {
+				logError(_logger, "The benchmark cannot be completed.");
+			}
+		}
+	}
+	for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+		free(durations[phase]);
+	}
+	destroyGeneratedProgram(program);
+
+	shutdownProgramGeneratorModule();
+	shutdownGeneratorModule();
+	shutdownEmitterModule();
+	shutdownPeepholeModule();
+	shutdownCalculatorModule();
+	shutdownTypeCheckerModule();
+	shutdownInterfaceResolverModule();
+	shutdownAbstractSyntaxTreeModule();
+	shutdownSyntacticAnalyzerModule();
+	shutdownBisonActionsModule();
+	shutdownFlexActionsModule();
+	shutdownLineCounterModule();
+	shutdownStatisticsModule();
+	destroyLogger(_logger);
+	return compilationStatus;
+}
@@ -0,0 +1,406 @@
+#include "ProgramGenerator.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+/**
+ * The size of the global array (an index is always "x % 16 + 16", which lies
+ * in [1, 31]).
+ */
+static const int _tableSize = 32;
+
+/**
+ * The iterations of every generated loop.
+ */
+static const int _loopIterations = 3;
+
+/**
+ * The amount of calls that run the body of a function, since the call graph
+ * is acyclic but its paths grow exponentially with the amount of functions.
+ */
+static const int _fuel = 10000;
+
+void initializeProgramGeneratorModule() {
+	_logger = createLogger("ProgramGenerator");
+}
+
+void shutdownProgramGeneratorModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/**
+ * The state of the generation of a program: the pseudo-random generator, the
+ * function being generated (it can only call the previous ones), and
+ * a counter to give a unique name to every loop variable.
+ */
+typedef struct {
+	const ProgramShape * shape;
+	FILE * output;
+	uint64_t random;
+	unsigned int function;
+	unsigned int counters;
+} SyntheticContext;
+
+/* PRIVATE FUNCTIONS */
+
+static void _writeBlock(SyntheticContext * context, const unsigned int depth, const unsigned int level);
+static void _writeCompoundStatement(SyntheticContext * context, const unsigned int depth, const unsigned int level);
+static void _writeCondition(SyntheticContext * context, const unsigned int nesting);
+static void _writeExpression(SyntheticContext * context, const unsigned int terms, const unsigned int nesting);
+static void _writeFunction(SyntheticContext * context);
+static void _writeIndentation(SyntheticContext * context, const unsigned int level);
+static void _writeLocal(SyntheticContext * context);
+static void _writeSimpleStatement(SyntheticContext * context, const unsigned int level);
+static void _writeStatements(SyntheticContext * context, const unsigned int depth, const unsigned int level);
+static void _writeTerm(SyntheticContext * context, const unsigned int nesting);
+static unsigned int _random(SyntheticContext * context, const unsigned int bound);
+
+/**
+ * A uniformly distributed number in [0, bound), from a SplitMix64 sequence
+ * (which is well distributed for every seed, including zero).
+ */
+static unsigned int _random(SyntheticContext * context, const unsigned int bound) {
+	uint64_t value = (context->random += 0x9E3779B97F4A7C15ULL);
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+	value ^= value >> 31;
+	return bound == 0 ? 0 : (unsigned int) (value % bound);
+}
+
+/**
+ * Writes a braced block (see "_writeStatements").
+ */
+static void _writeBlock(SyntheticContext * context, const unsigned int depth, const unsigned int level) {
+	fputs("{\n", context->output);
+	_writeStatements(context, depth, level + 1);
+	_writeIndentation(context, level);
+	fputc('}', context->output);
+}
+
+/**
+ * Writes an "if" (with or without "else"), a bounded "while" or "for" loop,
+ * or a nested block that shadows a local variable.
+ */
+static void _writeCompoundStatement(SyntheticContext * context, const unsigned int depth, const unsigned int level) {
+	FILE * output = context->output;
+	const unsigned int counter = context->counters++;
+	_writeIndentation(context, level);
+	switch (_random(context, 5)) {
+		case 0:
+		case 1:
+			fputs("if (", output);
+			_writeCondition(context, 1);
+			fputs(") ", output);
+			_writeBlock(context, depth, level);
+			if (_random(context, 2) == 0) {
+				fputs(" else ", output);
+				_writeBlock(context, depth, level);
+			}
+			fputc('\n', output);
+			break;
+		case 2:
+			fprintf(output, "{\n");
+			_writeIndentation(context, level + 1);
+			fprintf(output, "int counter%u = 0;\n", counter);
+			_writeIndentation(context, level + 1);
+			fprintf(output, "while (counter%u < %d) {\n", counter, _loopIterations);
+			_writeIndentation(context, level + 2);
+			fprintf(output, "counter%u = counter%u + 1;\n", counter, counter);
+			_writeStatements(context, depth, level + 2);
+			_writeIndentation(context, level + 1);
+			fputs("}\n", output);
+			_writeIndentation(context, level);
+			fputs("}\n", output);
+			break;
+		case 3:
+			fprintf(output, "{\n");
+			_writeIndentation(context, level + 1);
+			fprintf(output, "int counter%u;\n", counter);
+			_writeIndentation(context, level + 1);
+			fprintf(output, "for (counter%u = 0; counter%u < %d; counter%u = counter%u + 1) ",
+				counter, counter, _loopIterations, counter, counter);
+			_writeBlock(context, depth, level + 1);
+			fputs("\n", output);
+			_writeIndentation(context, level);
+			fputs("}\n", output);
+			break;
+		default:
+			fprintf(output, "{\n");
+			_writeIndentation(context, level + 1);
+			// The initializer cannot use the other variables, since it would see the new one.
+			fprintf(output, "int value%u = %u;\n", _random(context, context->shape->identifiers), _random(context, 1000));
+			_writeIndentation(context, level + 1);
+			_writeBlock(context, depth, level + 1);
+			fputs("\n", output);
+			_writeIndentation(context, level);
+			fputs("}\n", output);
+	}
+}
+
+/**
+ * Writes a comparison of two short expression chains, possibly negated or
+ * combined with another comparison.
+ */
+static void _writeCondition(SyntheticContext * context, const unsigned int nesting) {
+	static const char * relations[] = { " < ", " > ", " <= ", " >= ", " == ", " != " };
+	FILE * output = context->output;
+	const unsigned int terms = 1 + context->shape->terms / 4;
+	if (_random(context, 4) == 0) {
+		fputs("!(", output);
+		_writeExpression(context, terms, nesting);
+		fputc(')', output);
+	}
+	else {
+		_writeExpression(context, terms, nesting);
+		fputs(relations[_random(context, 6)], output);
+		_writeExpression(context, terms, nesting);
+	}
+	switch (_random(context, 4)) {
+		case 0:
+			fputs(" && mark == 'x'", output);
+			break;
+		case 1:
+			fputs(" || ", output);
+			_writeTerm(context, 0);
+			fputs(" != 0", output);
+			break;
+		default:
+			break;
+	}
+}
+
+/**
+ * Writes a chain of terms joined by arithmetic operators. The divisors are
+ * always "(x % 7 + 8)", which is positive for every x.
+ */
+static void _writeExpression(SyntheticContext * context, const unsigned int terms, const unsigned int nesting) {
+	FILE * output = context->output;
+	_writeTerm(context, nesting);
+	for (unsigned int k = 1; k < terms; ++k) {
+		const unsigned int operator = _random(context, 10);
+		if (operator < 8) {
+			fputs(operator < 4 ? " + " : operator < 6 ? " - " : " * ", output);
+			_writeTerm(context, nesting);
+		}
+		else {
+			fputs(operator == 8 ? " / (" : " % (", output);
+			_writeTerm(context, 0);
+			fputs(" % 7 + 8)", output);
+		}
+	}
+}
+
+/**
+ * Writes a function with two parameters, its local variables, the body and
+ * the final return.
+ */
+static void _writeFunction(SyntheticContext * context) {
+	FILE * output = context->output;
+	const ProgramShape * shape = context->shape;
+	fprintf(output, "/* Function %u of the synthetic program. */\n", context->function);
+	fprintf(output, "int function%u(int left, int right) {\n", context->function);
+	for (unsigned int k = 0; k < shape->identifiers; ++k) {
+		_writeIndentation(context, 1);
+		if (k < 2) {
+			fprintf(output, "int value%u = %s;\n", k, k == 0 ? "left" : "right");
+		}
+		else {
+			fprintf(output, "int value%u = %u;\n", k, _random(context, 1000));
+		}
+	}
+	_writeIndentation(context, 1);
+	fputs("char mark = 'x';\n", output);
+	_writeIndentation(context, 1);
+	fputs("if (fuel <= 0) {\n", output);
+	_writeIndentation(context, 2);
+	fputs("return left;\n", output);
+	_writeIndentation(context, 1);
+	fputs("}\n", output);
+	_writeIndentation(context, 1);
+	fputs("fuel = fuel - 1;\n", output);
+	for (unsigned int k = 0; k < shape->statements; ++k) {
+		if (0 < shape->depth && _random(context, 3) == 0) {
+			_writeCompoundStatement(context, shape->depth, 1);
+		}
+		else {
+			_writeSimpleStatement(context, 1);
+		}
+	}
+	_writeIndentation(context, 1);
+	fputs("return ", output);
+	_writeExpression(context, shape->terms, 1);
+	fputs(";\n}\n\n", output);
+}
+
+static void _writeIndentation(SyntheticContext * context, const unsigned int level) {
+	for (unsigned int k = 0; k < level; ++k) {
+		fputc('\t', context->output);
+	}
+}
+
+/**
+ * Writes the name of a random local variable (or parameter).
+ */
+static void _writeLocal(SyntheticContext * context) {
+	const unsigned int local = _random(context, context->shape->identifiers + 2);
+	if (local < context->shape->identifiers) {
+		fprintf(context->output, "value%u", local);
+	}
+	else {
+		fputs(local == context->shape->identifiers ? "left" : "right", context->output);
+	}
+}
+
+/**
+ * Writes an assignment to a local, a global or an element of the global
+ * array. A call to a previous function is always the whole value of an
+ * assignment to a local, so no expression depends on the order of
+ * evaluation of its operands (a call can change the globals).
+ */
+static void _writeSimpleStatement(SyntheticContext * context, const unsigned int level) {
+	FILE * output = context->output;
+	_writeIndentation(context, level);
+	switch (_random(context, 8)) {
+		case 0:
+			fprintf(output, "global%u = ", _random(context, context->shape->identifiers));
+			break;
+		case 1:
+			fputs("table[", output);
+			_writeLocal(context);
+			fputs(" % 16 + 16] = ", output);
+			break;
+		case 2:
+		case 3:
+			if (0 < context->function) {
+				const unsigned int terms = 1 + context->shape->terms / 2;
+				_writeLocal(context);
+				fprintf(output, " = function%u(", _random(context, context->function));
+				_writeExpression(context, terms, 1);
+				fputs(", ", output);
+				_writeExpression(context, terms, 1);
+				fputs(");\n", output);
+				return;
+			}
+			// Falls through.
+		default:
+			_writeLocal(context);
+			fputs(" = ", output);
+	}
+	_writeExpression(context, context->shape->terms, 1);
+	fputs(";\n", output);
+}
+
+/**
+ * Writes one or two simple statements, and a compound statement while the
+ * depth allows it (so the size of a nest grows linearly with its depth).
+ */
+static void _writeStatements(SyntheticContext * context, const unsigned int depth, const unsigned int level) {
+	const unsigned int statements = 1 + _random(context, 2);
+	for (unsigned int k = 0; k < statements; ++k) {
+		_writeSimpleStatement(context, level);
+	}
+	if (1 < depth) {
+		_writeCompoundStatement(context, depth - 1, level);
+	}
+	else {
+		_writeSimpleStatement(context, level);
+	}
+}
+
+/**
+ * Writes a variable, a constant, an element of the global array or, while
+ * the nesting allows it, a parenthesized expression chain.
+ */
+static void _writeTerm(SyntheticContext * context, const unsigned int nesting) {
+	FILE * output = context->output;
+	const unsigned int terms = 1 + context->shape->terms / 2;
+	switch (_random(context, 8)) {
+		case 0:
+			fprintf(output, "%u", _random(context, 1000));
+			break;
+		case 1:
+			fprintf(output, "global%u", _random(context, context->shape->identifiers));
+			break;
+		case 2:
+			fputs("table[", output);
+			_writeLocal(context);
+			fputs(" % 16 + 16]", output);
+			break;
+		case 3:
+			if (0 < nesting) {
+				fputc('(', output);
+				_writeExpression(context, terms, nesting - 1);
+				fputc(')', output);
+				break;
+			}
+			// Falls through.
+		default:
+			_writeLocal(context);
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+GeneratedProgram * generateProgram(const ProgramShape * shape) {
+	ProgramShape bounded = *shape;
+	if (bounded.identifiers < 2) {
+		bounded.identifiers = 2;
+	}
+	if (bounded.terms < 1) {
+		bounded.terms = 1;
+	}
+	GeneratedProgram * program = calloc(1, sizeof(GeneratedProgram));
+	FILE * output = program == NULL ? NULL : open_memstream(&program->text, &program->length);
+	if (output == NULL) {
+		logError(_logger, "Cannot allocate the synthetic program.");
+		free(program);
+		return NULL;
+	}
+	SyntheticContext context = {
+		.shape = &bounded,
+		.output = output,
+		.random = bounded.seed,
+		.function = 0,
+		.counters = 0
+	};
+	fprintf(output, "/* Synthetic program (seed %llu). */\n\n", (unsigned long long) bounded.seed);
+	for (unsigned int k = 0; k < bounded.identifiers; ++k) {
+		fprintf(output, "int global%u = %u;\n", k, _random(&context, 1000));
+	}
+	fprintf(output, "int table[%d];\n", _tableSize);
+	fputs("int fuel;\n\n", output);
+	for (; context.function < bounded.functions; ++context.function) {
+		_writeFunction(&context);
+	}
+	fputs("int main(void) {\n", output);
+	fprintf(output, "\tfuel = %d;\n", _fuel);
+	if (0 < bounded.functions) {
+		fprintf(output, "\treturn function%u(1, 2) %% 256;\n", bounded.functions - 1);
+	}
+	else {
+		fputs("\treturn 0;\n", output);
+	}
+	fputs("}\n", output);
+	if (fclose(output) != 0) {
+		logError(_logger, "Cannot allocate the synthetic program.");
+		destroyGeneratedProgram(program);
+		return NULL;
+	}
+	for (size_t k = 0; k < program->length; ++k) {
+		if (program->text[k] == '\n') {
+			++program->lines;
+		}
+	}
+	logDebugging(_logger, "Generated %zu bytes in %u lines.", program->length, program->lines);
+	return program;
+}
+
+void destroyGeneratedProgram(GeneratedProgram * program) {
+	if (program != NULL) {
+		free(program->text);
+		free(program);
+	}
+}
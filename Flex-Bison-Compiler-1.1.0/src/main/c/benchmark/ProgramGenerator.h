@@ -0,0 +1,67 @@
+#ifndef PROGRAM_GENERATOR_HEADER
+#define PROGRAM_GENERATOR_HEADER
+
+#include "../shared/Logger.h"
+#include "../shared/Type.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * The size and shape of a synthetic program. The same shape (and seed)
+ * always generates exactly the same program.
+ */
+typedef struct {
+	// The seed of the pseudo-random generator.
+	uint64_t seed;
+
+	// The amount of functions (besides "main").
+	unsigned int functions;
+
+	// The amount of statements in the body of each function.
+	unsigned int statements;
+
+	// The maximum nesting depth of the blocks inside a function body.
+	unsigned int depth;
+
+	// The amount of terms of each expression chain.
+	unsigned int terms;
+
+	// The amount of local variables of each function, and of global ones.
+	unsigned int identifiers;
+} ProgramShape;
+
+/**
+ * A generated program, with the source text and its amount of lines.
+ */
+typedef struct {
+	char * text;
+	size_t length;
+	unsigned int lines;
+} GeneratedProgram;
+
+/** Initialize module's internal state. */
+void initializeProgramGeneratorModule();
+
+/** Shutdown module's internal state. */
+void shutdownProgramGeneratorModule();
+
+/**
+ * Generates a valid program of the accepted C subset. Every function only
+ * calls the ones defined before it (and only runs its body while a global
+ * budget of calls lasts), every loop is bounded, and every divisor is
+ * positive, so the program also terminates without traps when executed.
+ * No expression depends on the order of evaluation of its operands either,
+ * so its exit status is the same with any compiler (if the arithmetic
+ * wraps around on overflow, as in the generated code).
+ *
+ * Returns NULL if the program cannot be allocated.
+ */
+GeneratedProgram * generateProgram(const ProgramShape * shape);
+
+/**
+ * Destroys a generated program.
+ */
+void destroyGeneratedProgram(GeneratedProgram * program);
+
+#endif
@@ -0,0 +1,326 @@
+#include "../shared/CompilerState.h"
+#include "../shared/Logger.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+/**
+ * The basic block counters of a function (added up over every run), and the
+ * line where each block starts. Its executions are the ones of all of its
+ * blocks, and its calls are the ones of its first block (its body).
+ */
+typedef struct {
+	char * name;
+	unsigned int line;
+	unsigned int blockCount;
+	unsigned int * lines;
+	uint64_t * counts;
+	uint64_t executions;
+} CoveredFunction;
+
+/**
+ * A line of a function, executed as many times as the hottest block that
+ * starts on it.
+ */
+typedef struct {
+	const CoveredFunction * function;
+	unsigned int line;
+	uint64_t count;
+} CoveredLine;
+
+/**
+ * The configuration of a report.
+ */
+typedef struct {
+	const char * coverage;
+	const char * source;
+	unsigned int lines;
+} ReportOptions;
+
+/* PRIVATE FUNCTIONS */
+
+static int _compareExecutions(const void * left, const void * right);
+static int _compareFunctions(const void * left, const void * right);
+static int _compareLines(const void * left, const void * right);
+static CoveredFunction * _loadCoverage(const char * path, unsigned int * count);
+static char ** _loadSource(const char * path, unsigned int * count);
+static boolean _parseOptions(const int count, const char ** arguments, ReportOptions * options);
+static void _report(const ReportOptions * options, CoveredFunction * functions, const unsigned int count, char ** source, const unsigned int sourceLines);
+
+/**
+ * Orders the functions from the most executed one (and then by name).
+ */
+static int _compareExecutions(const void * left, const void * right) {
+	const CoveredFunction * first = left;
+	const CoveredFunction * second = right;
+	if (first->executions != second->executions) {
+		return first->executions < second->executions ? 1 : -1;
+	}
+	return strcmp(first->name, second->name);
+}
+
+/**
+ * Orders the records of the functions by name, line and amount of blocks, so
+ * the records of the same function are adjacent.
+ */
+static int _compareFunctions(const void * left, const void * right) {
+	const CoveredFunction * first = left;
+	const CoveredFunction * second = right;
+	const int comparison = strcmp(first->name, second->name);
+	if (comparison != 0) {
+		return comparison;
+	}
+	if (first->line != second->line) {
+		return first->line < second->line ? -1 : 1;
+	}
+	return first->blockCount < second->blockCount ? -1 : (first->blockCount == second->blockCount ? 0 : 1);
+}
+
+/**
+ * Orders the lines from the most executed one (and then by function, and
+ * line).
+ */
+static int _compareLines(const void * left, const void * right) {
+	const CoveredLine * first = left;
+	const CoveredLine * second = right;
+	if (first->count != second->count) {
+		return first->count < second->count ? 1 : -1;
+	}
+	const int comparison = strcmp(first->function->name, second->function->name);
+	if (comparison != 0) {
+		return comparison;
+	}
+	return first->line < second->line ? -1 : (first->line == second->line ? 0 : 1);
+}
+
+/**
+ * Reads a coverage file (see "COVERAGE_OUTPUT_FILE"), adding up the records
+ * of the same function. A malformed record ends the file, but the previous
+ * ones are kept. Returns NULL if the file cannot be read.
+ */
+static CoveredFunction * _loadCoverage(const char * path, unsigned int * count) {
+	FILE * stream = fopen(path, "r");
+	if (stream == NULL) {
+		logError(_logger, "Cannot read the coverage \"%s\": %s", path, strerror(errno));
+		return NULL;
+	}
+	CoveredFunction * functions = NULL;
+	unsigned int capacity = 0;
+	char name[1024];
+	unsigned int line;
+	unsigned int blockCount;
+	*count = 0;
+	while (fscanf(stream, " function %1023s %u %u", name, &line, &blockCount) == 3) {
+		unsigned int * lines = calloc(blockCount == 0 ? 1 : blockCount, sizeof(unsigned int));
+		uint64_t * counts = calloc(blockCount == 0 ? 1 : blockCount, sizeof(uint64_t));
+		unsigned int block = 0;
+		while (block < blockCount && fscanf(stream, "%u %" SCNu64, &lines[block], &counts[block]) == 2) {
+			++block;
+		}
+		if (block < blockCount) {
+			free(lines);
+			free(counts);
+			break;
+		}
+		if (*count == capacity) {
+			capacity = capacity == 0 ? 16 : 2 * capacity;
+			functions = realloc(functions, capacity * sizeof(CoveredFunction));
+		}
+		functions[(*count)++] = (CoveredFunction) {
+			.name = strdup(name),
+			.line = line,
+			.blockCount = blockCount,
+			.lines = lines,
+			.counts = counts,
+			.executions = 0
+		};
+	}
+	fclose(stream);
+	qsort(functions, *count, sizeof(CoveredFunction), _compareFunctions);
+	unsigned int merged = 0;
+	for (unsigned int k = 0; k < *count; ++k) {
+		CoveredFunction * function = &functions[k];
+		CoveredFunction * last = merged == 0 ? NULL : &functions[merged - 1];
+		if (last != NULL && _compareFunctions(function, last) == 0) {
+			for (unsigned int block = 0; block < function->blockCount; ++block) {
+				last->counts[block] += function->counts[block];
+			}
+			free(function->name);
+			free(function->lines);
+			free(function->counts);
+		}
+		else {
+			functions[merged++] = *function;
+		}
+	}
+	*count = merged;
+	return functions == NULL ? calloc(1, sizeof(CoveredFunction)) : functions;
+}
+
+/**
+ * Reads the lines of a source file (without their new-lines).
+ */
+static char ** _loadSource(const char * path, unsigned int * count) {
+	FILE * stream = fopen(path, "r");
+	if (stream == NULL) {
+		logError(_logger, "Cannot read the source \"%s\": %s", path, strerror(errno));
+		return NULL;
+	}
+	char ** lines = NULL;
+	unsigned int capacity = 0;
+	char * buffer = NULL;
+	size_t size = 0;
+	ssize_t length;
+	*count = 0;
+	while (0 <= (length = getline(&buffer, &size, stream))) {
+		while (0 < length && (buffer[length - 1] == '\n' || buffer[length - 1] == '\r')) {
+			buffer[--length] = '\0';
+		}
+		if (*count == capacity) {
+			capacity = capacity == 0 ? 64 : 2 * capacity;
+			lines = realloc(lines, capacity * sizeof(char *));
+		}
+		lines[(*count)++] = strdup(buffer);
+	}
+	free(buffer);
+	fclose(stream);
+	return lines == NULL ? calloc(1, sizeof(char *)) : lines;
+}
+
+/**
+ * Parses the "--name value" options.
+ */
+static boolean _parseOptions(const int count, const char ** arguments, ReportOptions * options) {
+	for (int k = 1; k < count; ++k) {
+		const char * name = arguments[k];
+		if (count <= k + 1) {
+			logError(_logger, "The option \"%s\" is unknown, or has no value.", name);
+			return false;
+		}
+		const char * value = arguments[++k];
+		if (strcmp(name, "--coverage") == 0) options->coverage = value;
+		else if (strcmp(name, "--source") == 0) options->source = value;
+		else if (strcmp(name, "--lines") == 0) options->lines = (unsigned int) strtoul(value, NULL, 10);
+		else {
+			logError(_logger, "The option \"%s\" is unknown.", name);
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Writes the executions of each function (most executed first), and the
+ * hottest lines of the program, with their source (if it's available).
+ */
+static void _report(const ReportOptions * options, CoveredFunction * functions, const unsigned int count, char ** source, const unsigned int sourceLines) {
+	uint64_t total = 0;
+	unsigned int blocks = 0;
+	unsigned int executed = 0;
+	for (unsigned int k = 0; k < count; ++k) {
+		CoveredFunction * function = &functions[k];
+		for (unsigned int block = 0; block < function->blockCount; ++block) {
+			function->executions += function->counts[block];
+			executed += 0 < function->counts[block];
+		}
+		total += function->executions;
+		blocks += function->blockCount;
+	}
+	qsort(functions, count, sizeof(CoveredFunction), _compareExecutions);
+	printf("%u functions, %u of %u basic blocks executed (%.1f%%), %" PRIu64 " block executions.\n\n",
+		count, executed, blocks, blocks == 0 ? 0.0 : 100.0 * executed / blocks, total);
+	printf("%14s %7s %12s %9s  %s\n", "Executions", "Share", "Calls", "Blocks", "Function");
+	for (unsigned int k = 0; k < count; ++k) {
+		const CoveredFunction * function = &functions[k];
+		unsigned int covered = 0;
+		for (unsigned int block = 0; block < function->blockCount; ++block) {
+			covered += 0 < function->counts[block];
+		}
+		char coverage[32];
+		snprintf(coverage, sizeof(coverage), "%u/%u", covered, function->blockCount);
+		printf("%14" PRIu64 " %6.1f%% %12" PRIu64 " %9s  %s (line %u)\n",
+			function->executions, total == 0 ? 0.0 : 100.0 * function->executions / total,
+			function->blockCount == 0 ? 0 : function->counts[0], coverage, function->name, function->line);
+	}
+
+	// The blocks of a function that start on the same line are one line.
+	CoveredLine * lines = calloc(blocks == 0 ? 1 : blocks, sizeof(CoveredLine));
+	unsigned int distinct = 0;
+	for (unsigned int k = 0; k < count; ++k) {
+		const CoveredFunction * function = &functions[k];
+		const unsigned int first = distinct;
+		for (unsigned int block = 0; block < function->blockCount; ++block) {
+			CoveredLine * line = NULL;
+			for (unsigned int j = first; j < distinct && line == NULL; ++j) {
+				line = lines[j].line == function->lines[block] ? &lines[j] : NULL;
+			}
+			if (line == NULL) {
+				line = &lines[distinct++];
+				*line = (CoveredLine) { .function = function, .line = function->lines[block], .count = 0 };
+			}
+			if (line->count < function->counts[block]) {
+				line->count = function->counts[block];
+			}
+		}
+	}
+	qsort(lines, distinct, sizeof(CoveredLine), _compareLines);
+	const unsigned int shown = options->lines < distinct ? options->lines : distinct;
+	printf("\nThe %u hottest lines:\n\n", shown);
+	printf("%14s  %-24s %s\n", "Count", "Function:Line", source == NULL ? "" : "Source");
+	for (unsigned int k = 0; k < shown; ++k) {
+		const CoveredLine * line = &lines[k];
+		char location[1100];
+		snprintf(location, sizeof(location), "%s:%u", line->function->name, line->line);
+		const char * text = source != NULL && 0 < line->line && line->line <= sourceLines ? source[line->line - 1] : "";
+		while (*text == ' ' || *text == '\t') {
+			++text;
+		}
+		printf("%14" PRIu64 "  %-24s %s\n", line->count, location, text);
+	}
+	free(lines);
+}
+
+/* PUBLIC FUNCTIONS */
+
+/**
+ * Reports the basic block counts written by programs compiled with coverage
+ * (see "COVERAGE_OUTPUT_FILE"), aggregated by function and line.
+ */
+int main(const int count, const char ** arguments) {
+	_logger = createLogger("CoverageReport");
+	ReportOptions options = {
+		.coverage = "coverage.txt",
+		.source = NULL,
+		.lines = 20
+	};
+	CompilationStatus compilationStatus = FAILED;
+	unsigned int functionCount = 0;
+	CoveredFunction * functions = NULL;
+	unsigned int sourceLines = 0;
+	char ** source = NULL;
+	if (_parseOptions(count, arguments, &options)
+			&& (functions = _loadCoverage(options.coverage, &functionCount)) != NULL
+			&& (options.source == NULL || (source = _loadSource(options.source, &sourceLines)) != NULL)) {
+		_report(&options, functions, functionCount, source, sourceLines);
+		compilationStatus = SUCCEED;
+	}
+	for (unsigned int k = 0; k < functionCount; ++k) {
+		free(functions[k].name);
+		free(functions[k].lines);
+		free(functions[k].counts);
+	}
+	free(functions);
+	for (unsigned int k = 0; k < sourceLines; ++k) {
+		free(source[k]);
+	}
+	free(source);
+	destroyLogger(_logger);
+	return compilationStatus;
+}
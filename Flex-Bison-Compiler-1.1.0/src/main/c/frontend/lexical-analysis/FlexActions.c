@@ -36,67 +36,82 @@ static void _logLexicalAnalyzerContext(const char * functionName, LexicalAnalyze
 
 /* PUBLIC FUNCTIONS */
 
+boolean logsIgnoredLexemes() {
+    return _logIgnoredLexemes && _logger->loggingLevel <= DEBUGGING;
+}
+
 void BeginMultilineCommentLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext) {
     if (_logIgnoredLexemes) {
         _logLexicalAnalyzerContext(__FUNCTION__, lexicalAnalyzerContext);
     }
+    destroyLexicalAnalyzerContext(lexicalAnalyzerContext);
 }
 
 void EndMultilineCommentLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext) {
     if (_logIgnoredLexemes) {
         _logLexicalAnalyzerContext(__FUNCTION__, lexicalAnalyzerContext);
     }
+    destroyLexicalAnalyzerContext(lexicalAnalyzerContext);
 }
 
 void IgnoredLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext) {
     if (_logIgnoredLexemes) {
         _logLexicalAnalyzerContext(__FUNCTION__, lexicalAnalyzerContext);
     }
+    destroyLexicalAnalyzerContext(lexicalAnalyzerContext);
 }
 
 Token KeywordLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext, Token token) {
     _logLexicalAnalyzerContext(__FUNCTION__, lexicalAnalyzerContext);
     lexicalAnalyzerContext->semanticValue->token = token;
+    destroyLexicalAnalyzerContext(lexicalAnalyzerContext);
     return token;
 }
 
 Token OperatorLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext, Token token) {
     _logLexicalAnalyzerContext(__FUNCTION__, lexicalAnalyzerContext);
     lexicalAnalyzerContext->semanticValue->token = token;
+    destroyLexicalAnalyzerContext(lexicalAnalyzerContext);
     return token;
 }
 
 Token PunctuationLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext, Token token) {
     _logLexicalAnalyzerContext(__FUNCTION__, lexicalAnalyzerContext);
     lexicalAnalyzerContext->semanticValue->token = token;
+    destroyLexicalAnalyzerContext(lexicalAnalyzerContext);
     return token;
 }
 
 Token IntegerLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext) {
     _logLexicalAnalyzerContext(__FUNCTION__, lexicalAnalyzerContext);
     lexicalAnalyzerContext->semanticValue->integer = atoi(lexicalAnalyzerContext->lexeme);
+    destroyLexicalAnalyzerContext(lexicalAnalyzerContext);
     return INTEGER;
 }
 
 Token CharacterLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext) {
     _logLexicalAnalyzerContext(__FUNCTION__, lexicalAnalyzerContext);
     lexicalAnalyzerContext->semanticValue->character = lexicalAnalyzerContext->lexeme[1];
+    destroyLexicalAnalyzerContext(lexicalAnalyzerContext);
     return CHARACTER;
 }
 
 Token EscapeCharacterLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext, char character) {
     _logLexicalAnalyzerContext(__FUNCTION__, lexicalAnalyzerContext);
     lexicalAnalyzerContext->semanticValue->character = character;
+    destroyLexicalAnalyzerContext(lexicalAnalyzerContext);
     return CHARACTER;
 }
 
 Token IdentifierLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext) {
     _logLexicalAnalyzerContext(__FUNCTION__, lexicalAnalyzerContext);
     lexicalAnalyzerContext->semanticValue->string = strdup(lexicalAnalyzerContext->lexeme);
+    destroyLexicalAnalyzerContext(lexicalAnalyzerContext);
     return IDENTIFIER;
 }
 
 Token UnknownLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext) {
     _logLexicalAnalyzerContext(__FUNCTION__, lexicalAnalyzerContext);
+    destroyLexicalAnalyzerContext(lexicalAnalyzerContext);
     return UNKNOWN;
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include "../syntactic-analysis/AbstractSyntaxTree.h"
 #include "../syntactic-analysis/BisonParser.h"
 #include "LexicalAnalyzerContext.h"
+#include "LineCounter.h"
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -17,6 +18,13 @@ void initializeFlexActionsModule();
 /** Shutdown module's internal state. */
 void shutdownFlexActionsModule();
 
+/**
+ * True if the ignored lexemes are logged (see "LOG_IGNORED_LEXEMES", and the
+ * logging level). Otherwise, the scanner skips them without executing their
+ * actions, nor creating a context for each one.
+ */
+boolean logsIgnoredLexemes();
+
 /**
  * Flex lexeme processing actions.
  */
@@ -10,4 +10,23 @@ unsigned int flexCurrentContext(void) {
 	return YY_START;
 }
 
+/**
+ * Hook that exports the offset of the current lexeme in the input, in bytes.
+ */
+unsigned int flexLexemeOffset(void) {
+	return _flexOffset - yyleng;
+}
+
+/**
+ * Hook that restarts the scanner over a new input, discarding any buffered
+ * lexeme, the current context, the line number and the offset, so the same
+ * process can scan many inputs.
+ */
+void flexRestart(FILE * input) {
+	yyrestart(input);
+	BEGIN(INITIAL);
+	yylineno = 1;
+	_flexOffset = 0;
+}
+
 #endif
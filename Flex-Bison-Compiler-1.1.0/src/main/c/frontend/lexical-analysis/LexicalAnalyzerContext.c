@@ -15,7 +15,7 @@ extern int yyleng;
 // The line number (provided by Flex).
 extern int yylineno;
 
-// The semantic value of the lookahead symbol (provided by Bison).
+// The semantic value of the current lexeme (see "SyntacticAnalyzer.c").
 extern union SemanticValue yylval;
 
 // The current lexeme (provided by Flex).
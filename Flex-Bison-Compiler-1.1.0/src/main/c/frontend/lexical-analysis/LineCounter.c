@@ -0,0 +1,94 @@
+#include "LineCounter.h"
+
+/**
+ * The vectorized counters need SSE2 (which every x86-64 processor has), and
+ * the GCC builtins to select AVX2 at runtime. Otherwise, only the scalar
+ * counter is available.
+ */
+#if defined(__GNUC__) && defined(__x86_64__)
+#define LINE_COUNTER_VECTORIZED
+#include <immintrin.h>
+#endif
+
+/* MODULE INTERNAL STATE */
+
+typedef unsigned int (*Counter)(const char * position, const char * end);
+
+static Logger * _logger = NULL;
+static Counter _lineCounter = NULL;
+
+/* PRIVATE FUNCTIONS */
+
+static unsigned int _countLinesScalar(const char * position, const char * end);
+
+#ifdef LINE_COUNTER_VECTORIZED
+static unsigned int _countLinesAVX2(const char * position, const char * end);
+static unsigned int _countLinesSSE2(const char * position, const char * end);
+#endif
+
+static unsigned int _countLinesScalar(const char * position, const char * end) {
+	unsigned int lines = 0;
+	for (; position < end; ++position) {
+		lines += *position == '\n';
+	}
+	return lines;
+}
+
+#ifdef LINE_COUNTER_VECTORIZED
+
+/**
+ * Counts the new-lines of each block with the population count of its mask,
+ * and the remainder (shorter than a block) with the scalar counter.
+ */
+__attribute__((target("avx2")))
+static unsigned int _countLinesAVX2(const char * position, const char * end) {
+	const __m256i newline = _mm256_set1_epi8('\n');
+	unsigned int lines = 0;
+	while (32 <= end - position) {
+		const __m256i block = _mm256_loadu_si256((const __m256i *) position);
+		lines += __builtin_popcount((unsigned int) _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newline)));
+		position += 32;
+	}
+	return lines + _countLinesScalar(position, end);
+}
+
+static unsigned int _countLinesSSE2(const char * position, const char * end) {
+	const __m128i newline = _mm_set1_epi8('\n');
+	unsigned int lines = 0;
+	while (16 <= end - position) {
+		const __m128i block = _mm_loadu_si128((const __m128i *) position);
+		lines += __builtin_popcount((unsigned int) _mm_movemask_epi8(_mm_cmpeq_epi8(block, newline)));
+		position += 16;
+	}
+	return lines + _countLinesScalar(position, end);
+}
+
+#endif
+
+/* PUBLIC FUNCTIONS */
+
+void initializeLineCounterModule() {
+	_logger = createLogger("LineCounter");
+	_lineCounter = _countLinesScalar;
+#ifdef LINE_COUNTER_VECTORIZED
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		_lineCounter = _countLinesAVX2;
+		logDebugging(_logger, "The lines are counted with AVX2.");
+	}
+	else {
+		_lineCounter = _countLinesSSE2;
+		logDebugging(_logger, "The lines are counted with SSE2.");
+	}
+#endif
+}
+
+void shutdownLineCounterModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+unsigned int countLines(const char * position, const char * end) {
+	return _lineCounter(position, end);
+}
@@ -0,0 +1,28 @@
+#ifndef LINE_COUNTER_HEADER
+#define LINE_COUNTER_HEADER
+
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include <stdlib.h>
+
+/**
+ * The line number of the scanner, which counts the new-lines of every lexeme
+ * (instead of the "yylineno" option of Flex, that counts them byte by byte).
+ * The DFA of Flex matches the whole runs of whitespace and of the body of a
+ * multiline comment, so they are counted in blocks of 16 or 32 bytes (with
+ * SSE2 or AVX2, if available).
+ */
+
+/** Initialize module's internal state. */
+void initializeLineCounterModule();
+
+/** Shutdown module's internal state. */
+void shutdownLineCounterModule();
+
+/**
+ * Counts the new-lines from the specified position, up to the end
+ * (exclusive).
+ */
+unsigned int countLines(const char * position, const char * end);
+
+#endif
@@ -0,0 +1,120 @@
+#include "TokenArray.h"
+
+/* MODULE INTERNAL STATE */
+
+static const unsigned int _initialCapacity = 1024;
+static const unsigned int _initialNameSlots = 256;
+
+/**
+ * The first token of Bison (every other token, but the end of the input,
+ * is above it).
+ */
+static const Token _firstToken = 256;
+
+/* PRIVATE FUNCTIONS */
+
+static unsigned int _hash(const char * name);
+static void _growNameSlots(TokenArray * tokens);
+
+/**
+ * The FNV-1a hash of a name.
+ */
+static unsigned int _hash(const char * name) {
+	unsigned int hash = 2166136261u;
+	for (const unsigned char * character = (const unsigned char *) name; *character != '\0'; ++character) {
+		hash = (hash ^ *character) * 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * Doubles the hash table of the names (with linear probing, where each slot
+ * is the index of a name plus one, or zero if it's empty).
+ */
+static void _growNameSlots(TokenArray * tokens) {
+	const unsigned int slotCount = tokens->nameSlotCount == 0 ? _initialNameSlots : 2 * tokens->nameSlotCount;
+	unsigned int * slots = calloc(slotCount, sizeof(unsigned int));
+	for (unsigned int k = 0; k < tokens->nameCount; ++k) {
+		unsigned int slot = _hash(tokens->names[k]) & (slotCount - 1);
+		while (slots[slot] != 0) {
+			slot = (slot + 1) & (slotCount - 1);
+		}
+		slots[slot] = k + 1;
+	}
+	free(tokens->nameSlots);
+	tokens->nameSlots = slots;
+	tokens->nameSlotCount = slotCount;
+}
+
+/* PUBLIC FUNCTIONS */
+
+TokenArray * createTokenArray() {
+	TokenArray * tokens = calloc(1, sizeof(TokenArray));
+	_growNameSlots(tokens);
+	return tokens;
+}
+
+void destroyTokenArray(TokenArray * tokens) {
+	if (tokens != NULL) {
+		for (unsigned int k = 0; k < tokens->nameCount; ++k) {
+			free(tokens->names[k]);
+		}
+		free(tokens->names);
+		free(tokens->nameSlots);
+		free(tokens->kinds);
+		free(tokens->offsets);
+		free(tokens->lengths);
+		free(tokens->lines);
+		free(tokens->values);
+		free(tokens);
+	}
+}
+
+void appendToken(TokenArray * tokens, const Token token, const uint32_t offset, const uint32_t length, const uint32_t line, const int32_t value) {
+	if (tokens->count == tokens->capacity) {
+		tokens->capacity = tokens->capacity == 0 ? _initialCapacity : 2 * tokens->capacity;
+		tokens->kinds = realloc(tokens->kinds, tokens->capacity * sizeof(uint8_t));
+		tokens->offsets = realloc(tokens->offsets, tokens->capacity * sizeof(uint32_t));
+		tokens->lengths = realloc(tokens->lengths, tokens->capacity * sizeof(uint32_t));
+		tokens->lines = realloc(tokens->lines, tokens->capacity * sizeof(uint32_t));
+		tokens->values = realloc(tokens->values, tokens->capacity * sizeof(int32_t));
+	}
+	const unsigned int position = tokens->count++;
+	tokens->kinds[position] = tokenKind(token);
+	tokens->offsets[position] = offset;
+	tokens->lengths[position] = length;
+	tokens->lines[position] = line;
+	tokens->values[position] = value;
+}
+
+int32_t internName(TokenArray * tokens, const char * name) {
+	const unsigned int mask = tokens->nameSlotCount - 1;
+	unsigned int slot = _hash(name) & mask;
+	for (; tokens->nameSlots[slot] != 0; slot = (slot + 1) & mask) {
+		const unsigned int index = tokens->nameSlots[slot] - 1;
+		if (strcmp(tokens->names[index], name) == 0) {
+			return (int32_t) index;
+		}
+	}
+	if (tokens->nameCount == tokens->nameCapacity) {
+		tokens->nameCapacity = tokens->nameCapacity == 0 ? _initialNameSlots : 2 * tokens->nameCapacity;
+		tokens->names = realloc(tokens->names, tokens->nameCapacity * sizeof(char *));
+	}
+	const unsigned int index = tokens->nameCount++;
+	tokens->names[index] = strdup(name);
+	tokens->nameSlots[slot] = index + 1;
+	// Keeps the table at most half full.
+	if (tokens->nameSlotCount < 2 * tokens->nameCount) {
+		_growNameSlots(tokens);
+	}
+	return (int32_t) index;
+}
+
+Token tokenAt(const TokenArray * tokens, const unsigned int position) {
+	const uint8_t kind = tokens->kinds[position];
+	return kind == 0 ? 0 : _firstToken + kind;
+}
+
+uint8_t tokenKind(const Token token) {
+	return token <= 0 ? 0 : (uint8_t) (token - _firstToken);
+}
@@ -0,0 +1,69 @@
+#ifndef TOKEN_ARRAY_HEADER
+#define TOKEN_ARRAY_HEADER
+
+#include "../../shared/Type.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The tokens of a whole input, lexed once (see "lexTokens"), so the parser
+ * can consume them later, as many times as needed. The tokens are stored as
+ * a structure of arrays, indexed by the position of each token:
+ *
+ *	- kinds: the token, in a byte (see "tokenKind").
+ *	- offsets, lengths: the position of the lexeme in the input, in bytes.
+ *	- lines: the line of the lexeme, for the syntax errors.
+ *	- values: the index of the interned name of an identifier, or the value
+ *	  of an integer or character constant (zero for any other token).
+ */
+typedef struct {
+	uint8_t * kinds;
+	uint32_t * offsets;
+	uint32_t * lengths;
+	uint32_t * lines;
+	int32_t * values;
+	unsigned int count;
+	unsigned int capacity;
+
+	// The interned names of the identifiers (and their hash table).
+	char ** names;
+	unsigned int nameCount;
+	unsigned int nameCapacity;
+	unsigned int * nameSlots;
+	unsigned int nameSlotCount;
+} TokenArray;
+
+/**
+ * Creates an empty token array.
+ */
+TokenArray * createTokenArray();
+
+/**
+ * Destroys a token array, and its interned names.
+ */
+void destroyTokenArray(TokenArray * tokens);
+
+/**
+ * Appends a token. The value is interpreted according to the token (see
+ * "internName" for the identifiers).
+ */
+void appendToken(TokenArray * tokens, const Token token, const uint32_t offset, const uint32_t length, const uint32_t line, const int32_t value);
+
+/**
+ * Interns a name, and returns its index in the names of the array. Every
+ * occurrence of the same name has the same index.
+ */
+int32_t internName(TokenArray * tokens, const char * name);
+
+/**
+ * The token at the specified position of the array.
+ */
+Token tokenAt(const TokenArray * tokens, const unsigned int position);
+
+/**
+ * The kind of a token, in a byte (Bison numbers its tokens from 256).
+ */
+uint8_t tokenKind(const Token token);
+
+#endif
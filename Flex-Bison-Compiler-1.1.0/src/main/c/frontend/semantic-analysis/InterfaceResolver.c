@@ -0,0 +1,76 @@
+#include "InterfaceResolver.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeInterfaceResolverModule() {
+	_logger = createLogger("InterfaceResolver");
+}
+
+void shutdownInterfaceResolverModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+void declareInterfaceSymbols(SymbolTable * symbolTable, const InterfaceSummary * summary) {
+	for (uint32_t k = 0; k < summary->header->entryCount; ++k) {
+		const InterfaceEntry * entry = &summary->entries[k];
+		const char * name = interfaceEntryName(summary, entry);
+		const SymbolType type = entry->kind == INTERFACE_FUNCTION ? SYMBOL_FUNCTION : SYMBOL_GLOBAL_VARIABLE;
+		Symbol * symbol = lookupSymbol(symbolTable, name);
+		if (symbol == NULL) {
+			symbol = declareSymbol(symbolTable, name, type, (DataType) entry->dataType);
+			symbol->external = true;
+		}
+		symbol->dataType = (DataType) entry->dataType;
+		symbol->array = entry->array;
+		symbol->arraySize = entry->arraySize;
+		symbol->parameterCount = entry->parameterCount;
+		symbol->parameters = summary->parameters + entry->firstParameter;
+	}
+}
+
+boolean checkInterfaceCall(const SymbolTable * symbolTable, const char * name, const Symbol * symbol, ListArguments * arguments, const int count) {
+	if (symbol == NULL || symbol->type != SYMBOL_FUNCTION || symbol->parameterCount < 0) {
+		return true;
+	}
+	if (count != symbol->parameterCount) {
+		logError(_logger, "The function \"%s\" expects %d argument(s), but it's called with %d.", name, symbol->parameterCount, count);
+		return false;
+	}
+	boolean succeed = true;
+	int k = 0;
+	for (ListArguments * argument = arguments; argument != NULL; argument = argument->next, ++k) {
+		const Expression * expression = argument->expression;
+		const Symbol * argumentSymbol = expression->type == EXPRESSION_IDENTIFIER
+			? lookupSymbol(symbolTable, *expression->identifier)
+			: NULL;
+		const boolean array = argumentSymbol != NULL && argumentSymbol->array;
+		if (array != symbol->parameters[k].array) {
+			logError(_logger, "The argument %d of the function \"%s\" %s an array.", k + 1, name, array ? "cannot be" : "must be");
+			succeed = false;
+		}
+	}
+	return succeed;
+}
+
+void exportInterfaceDeclaration(InterfaceWriter * writer, Declaration * declaration) {
+	if (writer == NULL) {
+		return;
+	}
+	const char * name = *declaration->identifier;
+	DeclarationSuffix * suffix = declaration->declarationSuffix;
+	if (suffix->type == DECLARATION_SUFFIX_FUNCTION) {
+		if (suffix->functionSuffix->type == SUFFIX_BLOCK && declaration->declarationType != DECLARATION_INTERNAL) {
+			addInterfaceFunction(writer, name, declaration->dataType, suffix->parameters);
+		}
+	}
+	else if (declaration->declarationType == DECLARATION_REGULAR || suffix->variableSuffix->type == VARIABLE_SUFFIX_ASSIGNMENT) {
+		const boolean array = suffix->variableSuffix->type == VARIABLE_SUFFIX_ARRAY;
+		addInterfaceVariable(writer, name, declaration->dataType, array, array ? *suffix->variableSuffix->arraySize : 0);
+	}
+}
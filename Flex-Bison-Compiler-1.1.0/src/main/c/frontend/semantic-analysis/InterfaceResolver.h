@@ -0,0 +1,43 @@
+#ifndef INTERFACE_RESOLVER_HEADER
+#define INTERFACE_RESOLVER_HEADER
+
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "../syntactic-analysis/AbstractSyntaxTree.h"
+#include "InterfaceSummary.h"
+#include "SymbolTable.h"
+
+/**
+ * Binds the interface summaries to a compilation: the loaded ones declare
+ * external symbols and check the calls to their functions, and the
+ * definitions of the program are exported to the one being built.
+ */
+
+/** Initialize module's internal state. */
+void initializeInterfaceResolverModule();
+
+/** Shutdown module's internal state. */
+void shutdownInterfaceResolverModule();
+
+/**
+ * Registers the functions and variables of a summary as external symbols (a
+ * later definition in this program makes them internal). The symbols point
+ * into the summary, so it must stay loaded while they're in use.
+ */
+void declareInterfaceSymbols(SymbolTable * symbolTable, const InterfaceSummary * summary);
+
+/**
+ * Checks a call to a function described by a summary: the amount of
+ * arguments, and which of them are arrays. Other calls are not checked.
+ * Every error is logged, and the result is false if there was any.
+ */
+boolean checkInterfaceCall(const SymbolTable * symbolTable, const char * name, const Symbol * symbol, ListArguments * arguments, const int count);
+
+/**
+ * Exports a definition to a summary being built (if any). The external
+ * declarations, the prototypes and the internal functions are not part of
+ * the interface.
+ */
+void exportInterfaceDeclaration(InterfaceWriter * writer, Declaration * declaration);
+
+#endif
@@ -0,0 +1,167 @@
+#include "InterfaceSummary.h"
+
+/* MODULE INTERNAL STATE */
+
+/**
+ * The "MGCI" signature (in little-endian), and the version of the layout.
+ */
+static const uint32_t _magic = 0x4943474Du;
+static const uint32_t _version = 1;
+
+static const unsigned int _initialCapacity = 16;
+
+/* PRIVATE FUNCTIONS */
+
+static InterfaceEntry * _appendEntry(InterfaceWriter * writer, const char * name, const InterfaceKind kind, const DataType dataType);
+static void * _ensureCapacity(void * elements, unsigned int * capacity, const unsigned int required, const size_t size);
+
+/**
+ * Appends an entry (and its name), with no parameters.
+ */
+static InterfaceEntry * _appendEntry(InterfaceWriter * writer, const char * name, const InterfaceKind kind, const DataType dataType) {
+	const unsigned int length = (unsigned int) strlen(name) + 1;
+	writer->entries = _ensureCapacity(writer->entries, &writer->entryCapacity, writer->entryCount + 1, sizeof(InterfaceEntry));
+	writer->names = _ensureCapacity(writer->names, &writer->nameCapacity, writer->nameBytes + length, sizeof(char));
+	InterfaceEntry * entry = &writer->entries[writer->entryCount++];
+	*entry = (InterfaceEntry) {
+		.name = writer->nameBytes,
+		.kind = (uint8_t) kind,
+		.dataType = (uint8_t) dataType,
+		.array = false,
+		.reserved = 0,
+		.arraySize = 0,
+		.firstParameter = writer->parameterCount,
+		.parameterCount = 0
+	};
+	memcpy(writer->names + writer->nameBytes, name, length);
+	writer->nameBytes += length;
+	return entry;
+}
+
+/**
+ * Doubles the capacity of an array until it fits the required amount of
+ * elements.
+ */
+static void * _ensureCapacity(void * elements, unsigned int * capacity, const unsigned int required, const size_t size) {
+	if (required <= *capacity) {
+		return elements;
+	}
+	unsigned int newCapacity = *capacity == 0 ? _initialCapacity : *capacity;
+	while (newCapacity < required) {
+		newCapacity *= 2;
+	}
+	*capacity = newCapacity;
+	return realloc(elements, newCapacity * size);
+}
+
+/* PUBLIC FUNCTIONS */
+
+InterfaceSummary * loadInterfaceSummary(const char * path) {
+	const int descriptor = open(path, O_RDONLY);
+	if (descriptor < 0) {
+		return NULL;
+	}
+	struct stat status;
+	void * mapping = MAP_FAILED;
+	if (fstat(descriptor, &status) == 0 && sizeof(InterfaceHeader) <= (size_t) status.st_size) {
+		mapping = mmap(NULL, (size_t) status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+	}
+	close(descriptor);
+	if (mapping == MAP_FAILED) {
+		return NULL;
+	}
+	const size_t size = (size_t) status.st_size;
+	const InterfaceHeader * header = mapping;
+	const size_t entries = sizeof(InterfaceHeader);
+	const size_t parameters = entries + (size_t) header->entryCount * sizeof(InterfaceEntry);
+	const size_t names = parameters + (size_t) header->parameterCount * sizeof(InterfaceParameter);
+	boolean valid = header->magic == _magic && header->version == _version && names + header->nameBytes == size;
+	valid = valid && (header->nameBytes == 0 || ((const char *) mapping)[size - 1] == '\0');
+	const InterfaceEntry * entry = (const InterfaceEntry *) ((const char *) mapping + entries);
+	for (uint32_t k = 0; valid && k < header->entryCount; ++k, ++entry) {
+		valid = entry->name < header->nameBytes
+			&& entry->kind <= INTERFACE_VARIABLE
+			&& entry->dataType <= TYPE_CHAR
+			&& (entry->parameterCount < 0 || (uint64_t) entry->firstParameter + (uint64_t) entry->parameterCount <= header->parameterCount);
+	}
+	if (!valid) {
+		munmap(mapping, size);
+		return NULL;
+	}
+	InterfaceSummary * summary = calloc(1, sizeof(InterfaceSummary));
+	summary->mapping = mapping;
+	summary->size = size;
+	summary->header = header;
+	summary->entries = (const InterfaceEntry *) ((const char *) mapping + entries);
+	summary->parameters = (const InterfaceParameter *) ((const char *) mapping + parameters);
+	summary->names = (const char *) mapping + names;
+	return summary;
+}
+
+void unloadInterfaceSummary(InterfaceSummary * summary) {
+	if (summary != NULL) {
+		munmap(summary->mapping, summary->size);
+		free(summary);
+	}
+}
+
+const char * interfaceEntryName(const InterfaceSummary * summary, const InterfaceEntry * entry) {
+	return summary->names + entry->name;
+}
+
+InterfaceWriter * createInterfaceWriter() {
+	return calloc(1, sizeof(InterfaceWriter));
+}
+
+void destroyInterfaceWriter(InterfaceWriter * writer) {
+	if (writer != NULL) {
+		free(writer->entries);
+		free(writer->parameters);
+		free(writer->names);
+		free(writer);
+	}
+}
+
+void addInterfaceFunction(InterfaceWriter * writer, const char * name, const DataType dataType, const Parameters * parameters) {
+	InterfaceEntry * entry = _appendEntry(writer, name, INTERFACE_FUNCTION, dataType);
+	if (parameters->type == PARAMS_EMPTY) {
+		entry->parameterCount = -1;
+		return;
+	}
+	if (parameters->type != PARAMS_LIST) {
+		return;
+	}
+	for (const ParameterList * node = parameters->list; node != NULL; node = node->next) {
+		writer->parameters = _ensureCapacity(writer->parameters, &writer->parameterCapacity, writer->parameterCount + 1, sizeof(InterfaceParameter));
+		writer->parameters[writer->parameterCount++] = (InterfaceParameter) {
+			.dataType = (uint8_t) node->parameter->type,
+			.array = node->parameter->array->type == PARAMETER_ARRAY_BRACKETS
+		};
+		++entry->parameterCount;
+	}
+}
+
+void addInterfaceVariable(InterfaceWriter * writer, const char * name, const DataType dataType, const boolean array, const int arraySize) {
+	InterfaceEntry * entry = _appendEntry(writer, name, INTERFACE_VARIABLE, dataType);
+	entry->array = array;
+	entry->arraySize = array ? arraySize : 0;
+}
+
+boolean writeInterfaceSummary(const InterfaceWriter * writer, const char * path) {
+	FILE * file = fopen(path, "wb");
+	if (file == NULL) {
+		return false;
+	}
+	const InterfaceHeader header = {
+		.magic = _magic,
+		.version = _version,
+		.entryCount = writer->entryCount,
+		.parameterCount = writer->parameterCount,
+		.nameBytes = writer->nameBytes
+	};
+	boolean succeed = fwrite(&header, sizeof(InterfaceHeader), 1, file) == 1;
+	succeed = succeed && fwrite(writer->entries, sizeof(InterfaceEntry), writer->entryCount, file) == writer->entryCount;
+	succeed = succeed && fwrite(writer->parameters, sizeof(InterfaceParameter), writer->parameterCount, file) == writer->parameterCount;
+	succeed = succeed && fwrite(writer->names, sizeof(char), writer->nameBytes, file) == writer->nameBytes;
+	return fclose(file) == 0 && succeed;
+}
@@ -0,0 +1,136 @@
+#ifndef INTERFACE_SUMMARY_HEADER
+#define INTERFACE_SUMMARY_HEADER
+
+#include "../../shared/Type.h"
+#include "../syntactic-analysis/AbstractSyntaxTree.h"
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * A compact binary summary of the interface of a compiled file, that is,
+ * the functions and global variables that it defines, which is written (see
+ * "INTERFACE_OUTPUT_FILE") so other compilations can load it (see
+ * "INTERFACE_FILES") to resolve their external declarations and check their
+ * calls, without parsing the source again. The summary is mapped in memory,
+ * and read in place:
+ *
+ *	- A header, with the amount of entries, parameters, and bytes of names.
+ *	- The entries, each one with the offset of its name, its kind, its type,
+ *	  and its parameters (a function) or its array size (a variable).
+ *	- The parameters of every function, one after the other.
+ *	- The names, each one terminated with a null character.
+ */
+
+/**
+ * The kind of an entry of a summary.
+ */
+typedef enum {
+	INTERFACE_FUNCTION = 0,
+	INTERFACE_VARIABLE = 1
+} InterfaceKind;
+
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t entryCount;
+	uint32_t parameterCount;
+	uint32_t nameBytes;
+} InterfaceHeader;
+
+/**
+ * An exported function or global variable. The parameter count of a function
+ * is negative if its parameters are unspecified (as in "int f()").
+ */
+typedef struct {
+	uint32_t name;
+	uint8_t kind;
+	uint8_t dataType;
+	uint8_t array;
+	uint8_t reserved;
+	int32_t arraySize;
+	uint32_t firstParameter;
+	int32_t parameterCount;
+} InterfaceEntry;
+
+typedef struct {
+	uint8_t dataType;
+	uint8_t array;
+} InterfaceParameter;
+
+/**
+ * A summary mapped in memory (read-only).
+ */
+typedef struct {
+	void * mapping;
+	size_t size;
+	const InterfaceHeader * header;
+	const InterfaceEntry * entries;
+	const InterfaceParameter * parameters;
+	const char * names;
+} InterfaceSummary;
+
+/**
+ * A summary being built, before it's written.
+ */
+typedef struct {
+	InterfaceEntry * entries;
+	unsigned int entryCount;
+	unsigned int entryCapacity;
+	InterfaceParameter * parameters;
+	unsigned int parameterCount;
+	unsigned int parameterCapacity;
+	char * names;
+	unsigned int nameBytes;
+	unsigned int nameCapacity;
+} InterfaceWriter;
+
+/**
+ * Maps a summary in memory, and validates its layout. Returns NULL if the
+ * file cannot be mapped, or if it's not a valid summary.
+ */
+InterfaceSummary * loadInterfaceSummary(const char * path);
+
+/**
+ * Unmaps a summary (the entries and names are no longer valid).
+ */
+void unloadInterfaceSummary(InterfaceSummary * summary);
+
+/**
+ * The name of an entry of a summary.
+ */
+const char * interfaceEntryName(const InterfaceSummary * summary, const InterfaceEntry * entry);
+
+/**
+ * Creates an empty summary.
+ */
+InterfaceWriter * createInterfaceWriter();
+
+/**
+ * Destroys a summary being built.
+ */
+void destroyInterfaceWriter(InterfaceWriter * writer);
+
+/**
+ * Appends a function, with its parameters (the name is copied).
+ */
+void addInterfaceFunction(InterfaceWriter * writer, const char * name, const DataType dataType, const Parameters * parameters);
+
+/**
+ * Appends a global variable (the name is copied). The array size is only
+ * meaningful for arrays.
+ */
+void addInterfaceVariable(InterfaceWriter * writer, const char * name, const DataType dataType, const boolean array, const int arraySize);
+
+/**
+ * Writes the summary in a new (or truncated) file. Returns false if the file
+ * cannot be written.
+ */
+boolean writeInterfaceSummary(const InterfaceWriter * writer, const char * path);
+
+#endif
@@ -0,0 +1,200 @@
+#include "SymbolTable.h"
+
+/* MODULE INTERNAL STATE */
+
+static const unsigned int _initialCapacity = 64;
+
+/**
+ * A scope owns the list of symbols declared inside of it, from the most
+ * recent to the oldest one.
+ */
+struct Scope {
+	Symbol * symbols;
+	Scope * parent;
+};
+
+/* PRIVATE FUNCTIONS */
+
+static Symbol * _declare(SymbolTable * symbolTable, const char * name, const SymbolType type, const DataType dataType);
+static unsigned int _hash(const char * name);
+static void _grow(SymbolTable * symbolTable);
+static void _unlink(SymbolTable * symbolTable, Symbol * symbol);
+
+/**
+ * Declares a new symbol in the current scope (see "declareSymbol"), without
+ * counting it.
+ */
+static Symbol * _declare(SymbolTable * symbolTable, const char * name, const SymbolType type, const DataType dataType) {
+	if (symbolTable->capacity < 2 * (symbolTable->size + 1)) {
+		_grow(symbolTable);
+	}
+	Symbol * symbol = calloc(1, sizeof(Symbol));
+	symbol->type = type;
+	symbol->name = strdup(name);
+	symbol->dataType = dataType;
+	symbol->slot = -1;
+	symbol->parameterCount = -1;
+	symbol->depth = symbolTable->depth;
+	symbol->hash = _hash(name);
+	const unsigned int index = symbol->hash & (symbolTable->capacity - 1);
+	symbol->nextInBucket = symbolTable->buckets[index];
+	symbolTable->buckets[index] = symbol;
+	symbol->nextInScope = symbolTable->scope->symbols;
+	symbolTable->scope->symbols = symbol;
+	++symbolTable->size;
+	return symbol;
+}
+
+/**
+ * The FNV-1a hash of a name.
+ *
+ * @see http://www.isthe.com/chongo/tech/comp/fnv/
+ */
+static unsigned int _hash(const char * name) {
+	unsigned int hash = 2166136261u;
+	for (const unsigned char * character = (const unsigned char *) name; *character != '\0'; ++character) {
+		hash = (hash ^ *character) * 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * Doubles the amount of buckets. Symbols with the same name always share a
+ * bucket, so appending them in order keeps the innermost binding first.
+ */
+static void _grow(SymbolTable * symbolTable) {
+	const unsigned int capacity = 2 * symbolTable->capacity;
+	Symbol ** buckets = calloc(capacity, sizeof(Symbol *));
+	Symbol ** tails = calloc(capacity, sizeof(Symbol *));
+	for (unsigned int k = 0; k < symbolTable->capacity; ++k) {
+		Symbol * symbol = symbolTable->buckets[k];
+		while (symbol != NULL) {
+			Symbol * next = symbol->nextInBucket;
+			const unsigned int index = symbol->hash & (capacity - 1);
+			symbol->nextInBucket = NULL;
+			if (tails[index] == NULL) {
+				buckets[index] = symbol;
+			}
+			else {
+				tails[index]->nextInBucket = symbol;
+			}
+			tails[index] = symbol;
+			symbol = next;
+		}
+	}
+	free(tails);
+	free(symbolTable->buckets);
+	symbolTable->buckets = buckets;
+	symbolTable->capacity = capacity;
+}
+
+/**
+ * Removes a symbol from its bucket.
+ */
+static void _unlink(SymbolTable * symbolTable, Symbol * symbol) {
+	Symbol ** link = &symbolTable->buckets[symbol->hash & (symbolTable->capacity - 1)];
+	while (*link != symbol) {
+		link = &(*link)->nextInBucket;
+	}
+	*link = symbol->nextInBucket;
+	--symbolTable->size;
+}
+
+/* PUBLIC FUNCTIONS */
+
+SymbolTable * createSymbolTable() {
+	SymbolTable * symbolTable = calloc(1, sizeof(SymbolTable));
+	symbolTable->capacity = _initialCapacity;
+	symbolTable->buckets = calloc(symbolTable->capacity, sizeof(Symbol *));
+	symbolTable->scope = calloc(1, sizeof(Scope));
+	return symbolTable;
+}
+
+void destroySymbolTable(SymbolTable * symbolTable) {
+	if (symbolTable != NULL) {
+		while (symbolTable->scope != NULL) {
+			endScope(symbolTable);
+		}
+		free(symbolTable->buckets);
+		free(symbolTable);
+	}
+}
+
+SymbolTable * copyGlobalScope(const SymbolTable * symbolTable) {
+	SymbolTable * copy = createSymbolTable();
+	const Scope * global = symbolTable->scope;
+	while (global->parent != NULL) {
+		global = global->parent;
+	}
+	// The symbols are listed from the most recent one, so they're copied
+	// backwards to keep the same order (and shadowing) in the buckets.
+	unsigned int count = 0;
+	for (const Symbol * symbol = global->symbols; symbol != NULL; symbol = symbol->nextInScope) {
+		++count;
+	}
+	const Symbol ** symbols = calloc(count, sizeof(Symbol *));
+	unsigned int index = count;
+	for (const Symbol * symbol = global->symbols; symbol != NULL; symbol = symbol->nextInScope) {
+		symbols[--index] = symbol;
+	}
+	for (unsigned int k = 0; k < count; ++k) {
+		Symbol * symbol = _declare(copy, symbols[k]->name, symbols[k]->type, symbols[k]->dataType);
+		symbol->array = symbols[k]->array;
+		symbol->arraySize = symbols[k]->arraySize;
+		symbol->external = symbols[k]->external;
+		symbol->parameterCount = symbols[k]->parameterCount;
+		symbol->parameters = symbols[k]->parameters;
+		symbol->definition = symbols[k]->definition;
+	}
+	free(symbols);
+	return copy;
+}
+
+void beginScope(SymbolTable * symbolTable) {
+	Scope * scope = calloc(1, sizeof(Scope));
+	scope->parent = symbolTable->scope;
+	symbolTable->scope = scope;
+	++symbolTable->depth;
+}
+
+void endScope(SymbolTable * symbolTable) {
+	Scope * scope = symbolTable->scope;
+	Symbol * symbol = scope->symbols;
+	while (symbol != NULL) {
+		Symbol * next = symbol->nextInScope;
+		_unlink(symbolTable, symbol);
+		free(symbol->name);
+		free(symbol);
+		symbol = next;
+	}
+	symbolTable->scope = scope->parent;
+	if (0 < symbolTable->depth) {
+		--symbolTable->depth;
+	}
+	free(scope);
+}
+
+Symbol * declareSymbol(SymbolTable * symbolTable, const char * name, const SymbolType type, const DataType dataType) {
+	Symbol * symbol = _declare(symbolTable, name, type, dataType);
+	if (statisticsEnabled) {
+		countSymbolDeclaration();
+	}
+	return symbol;
+}
+
+Symbol * lookupSymbol(const SymbolTable * symbolTable, const char * name) {
+	const unsigned int hash = _hash(name);
+	Symbol * symbol = symbolTable->buckets[hash & (symbolTable->capacity - 1)];
+	unsigned int probes = 0;
+	while (symbol != NULL) {
+		++probes;
+		if (symbol->hash == hash && strcmp(symbol->name, name) == 0) {
+			break;
+		}
+		symbol = symbol->nextInBucket;
+	}
+	if (statisticsEnabled) {
+		countSymbolLookup(probes);
+	}
+	return symbol;
+}
@@ -0,0 +1,115 @@
+#ifndef SYMBOL_TABLE_HEADER
+#define SYMBOL_TABLE_HEADER
+
+#include "../../shared/Statistics.h"
+#include "../../shared/Type.h"
+#include "../syntactic-analysis/AbstractSyntaxTree.h"
+#include "InterfaceSummary.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The kind of entity bound to an identifier.
+ */
+typedef enum {
+	SYMBOL_FUNCTION,
+	SYMBOL_GLOBAL_VARIABLE,
+	SYMBOL_LOCAL_VARIABLE,
+	SYMBOL_PARAMETER
+} SymbolType;
+
+typedef struct Scope Scope;
+typedef struct Symbol Symbol;
+
+/**
+ * A binding between an identifier and the entity it names. Inner bindings
+ * shadow the outer ones with the same name until their scope ends.
+ */
+struct Symbol {
+	SymbolType type;
+	char * name;
+	DataType dataType;
+
+	// True for arrays (and array parameters, whose size is unknown).
+	boolean array;
+	int arraySize;
+
+	// True if declared with "extern" and never defined in this program.
+	boolean external;
+
+	// The parameters of a function loaded from an interface summary, to check
+	// its calls (the count is negative if they're unknown, or unspecified).
+	int parameterCount;
+	const InterfaceParameter * parameters;
+
+	// The definition of a function of this program, when the whole program
+	// is generated at once (so the backend can inline its calls).
+	Declaration * definition;
+
+	// The stack slot assigned by the backend (locals and parameters only).
+	int slot;
+
+	// The value of the symbol at the current point of the generated code, if
+	// the backend knows that it's constant (locals and parameters only).
+	boolean constant;
+	int value;
+
+	// The nesting depth of the declaring scope (zero is the global scope).
+	unsigned int depth;
+
+	unsigned int hash;
+	Symbol * nextInBucket;
+	Symbol * nextInScope;
+};
+
+/**
+ * A hashed symbol table with a stack of nested scopes. Lookups are
+ * constant-time on average, regardless of the nesting depth.
+ */
+typedef struct {
+	Symbol ** buckets;
+	unsigned int capacity;
+	unsigned int size;
+	unsigned int depth;
+	Scope * scope;
+} SymbolTable;
+
+/**
+ * Creates an empty symbol table, with the global scope already open.
+ */
+SymbolTable * createSymbolTable();
+
+/**
+ * Destroy a symbol table, its scopes and all of its symbols.
+ */
+void destroySymbolTable(SymbolTable * symbolTable);
+
+/**
+ * Creates a new symbol table with a copy of every symbol of the global scope
+ * of another one (e.g., for a thread that declares its own local symbols).
+ */
+SymbolTable * copyGlobalScope(const SymbolTable * symbolTable);
+
+/**
+ * Opens a new scope, nested in the current one.
+ */
+void beginScope(SymbolTable * symbolTable);
+
+/**
+ * Closes the current scope, releasing every symbol declared in it.
+ */
+void endScope(SymbolTable * symbolTable);
+
+/**
+ * Declares a new symbol in the current scope, which shadows any other symbol
+ * with the same name. The name is copied.
+ */
+Symbol * declareSymbol(SymbolTable * symbolTable, const char * name, const SymbolType type, const DataType dataType);
+
+/**
+ * Finds the innermost visible symbol with the specified name, or NULL if
+ * there is none.
+ */
+Symbol * lookupSymbol(const SymbolTable * symbolTable, const char * name);
+
+#endif
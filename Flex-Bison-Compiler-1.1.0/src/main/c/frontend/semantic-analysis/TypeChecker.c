@@ -0,0 +1,228 @@
+#include "TypeChecker.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+/**
+ * The state of the check of a function: its symbols (the globals, and the
+ * scopes opened so far), and whether it had no errors.
+ */
+typedef struct {
+	SymbolTable * symbolTable;
+	boolean succeed;
+} TypeCheckerContext;
+
+void initializeTypeCheckerModule() {
+	_logger = createLogger("TypeChecker");
+}
+
+void shutdownTypeCheckerModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static void _checkAssignedType(TypeCheckerContext * context, const char * name, const DataType target, const boolean typed, const DataType type);
+static void _checkBlock(TypeCheckerContext * context, Block * block);
+static boolean _checkExpression(TypeCheckerContext * context, Expression * expression, DataType * type);
+static void _checkStatement(TypeCheckerContext * context, Statement * statement);
+
+/**
+ * Checks that the value assigned to a variable (or to an element of an
+ * array) fits its type: only an integer doesn't fit a character.
+ */
+static void _checkAssignedType(TypeCheckerContext * context, const char * name, const DataType target, const boolean typed, const DataType type) {
+	if (target == TYPE_CHAR && typed && type == TYPE_INT) {
+		logError(_logger, "An integer cannot be assigned to the character \"%s\".", name);
+		context->succeed = false;
+	}
+}
+
+/**
+ * Checks the statements of a block, in its own scope.
+ */
+static void _checkBlock(TypeCheckerContext * context, Block * block) {
+	beginScope(context->symbolTable);
+	for (Statements * statements = block->statements; statements != NULL; statements = statements->next) {
+		_checkStatement(context, statements->statement);
+	}
+	endScope(context->symbolTable);
+}
+
+/**
+ * Checks an expression, and returns whether it has a type (and which one).
+ * The literals, the undeclared identifiers and the arrays have none.
+ */
+static boolean _checkExpression(TypeCheckerContext * context, Expression * expression, DataType * type) {
+	DataType left;
+	DataType right;
+	boolean leftTyped;
+	boolean rightTyped;
+	switch (expression->type) {
+		case EXPRESSION_ASSIGNMENT: {
+			Expression * lvalue = expression->leftExpression;
+			const char * name = lvalue->type == EXPRESSION_ARRAY_ACCESS ? *lvalue->identifierArray : *lvalue->identifier;
+			if (lvalue->type == EXPRESSION_ARRAY_ACCESS) {
+				_checkExpression(context, lvalue->indexExpression, &left);
+			}
+			rightTyped = _checkExpression(context, expression->rightExpression, &right);
+			const Symbol * symbol = lookupSymbol(context->symbolTable, name);
+			if (symbol == NULL) {
+				logError(_logger, "The identifier \"%s\" is undeclared.", name);
+				context->succeed = false;
+				return false;
+			}
+			if (symbol->type == SYMBOL_FUNCTION) {
+				return false;
+			}
+			_checkAssignedType(context, name, symbol->dataType, rightTyped, right);
+			*type = symbol->dataType;
+			return true;
+		}
+		case EXPRESSION_AND:
+		case EXPRESSION_OR:
+		case EXPRESSION_EQUAL:
+		case EXPRESSION_NOT_EQUAL:
+		case EXPRESSION_LESS:
+		case EXPRESSION_GREATER:
+		case EXPRESSION_LESS_EQUAL:
+		case EXPRESSION_GREATER_EQUAL:
+			_checkExpression(context, expression->leftExpression, &left);
+			_checkExpression(context, expression->rightExpression, &right);
+			*type = TYPE_INT;
+			return true;
+		case EXPRESSION_ADDITION:
+		case EXPRESSION_SUBTRACTION:
+		case EXPRESSION_MULTIPLICATION:
+		case EXPRESSION_DIVISION:
+		case EXPRESSION_MODULO:
+			leftTyped = _checkExpression(context, expression->leftExpression, &left);
+			rightTyped = _checkExpression(context, expression->rightExpression, &right);
+			if (leftTyped && rightTyped) {
+				*type = left == right ? left : TYPE_INT;
+			}
+			else {
+				*type = leftTyped ? left : right;
+			}
+			return leftTyped || rightTyped;
+		case EXPRESSION_NOT:
+			_checkExpression(context, expression->singleExpression, &left);
+			*type = TYPE_INT;
+			return true;
+		case EXPRESSION_PARENTHESIS:
+			return _checkExpression(context, expression->singleExpression, type);
+		case EXPRESSION_IDENTIFIER: {
+			const Symbol * symbol = lookupSymbol(context->symbolTable, *expression->identifier);
+			if (symbol == NULL || symbol->array || symbol->type == SYMBOL_FUNCTION) {
+				return false;
+			}
+			*type = symbol->dataType;
+			return true;
+		}
+		case EXPRESSION_ARRAY_ACCESS: {
+			_checkExpression(context, expression->indexExpression, &right);
+			const Symbol * symbol = lookupSymbol(context->symbolTable, *expression->identifierArray);
+			if (symbol == NULL) {
+				return false;
+			}
+			*type = symbol->dataType;
+			return true;
+		}
+		case EXPRESSION_FUNCTION_CALL: {
+			for (ListArguments * argument = expression->arguments; argument != NULL; argument = argument->next) {
+				_checkExpression(context, argument->expression, &right);
+			}
+			const Symbol * symbol = lookupSymbol(context->symbolTable, *expression->identifierFunc);
+			if (symbol == NULL || symbol->type != SYMBOL_FUNCTION) {
+				return false;
+			}
+			*type = symbol->dataType;
+			return true;
+		}
+		default:
+			return false;
+	}
+}
+
+/**
+ * Checks the expressions of a statement (and its inner statements),
+ * declaring its local variable in the current scope, if it's a declaration.
+ */
+static void _checkStatement(TypeCheckerContext * context, Statement * statement) {
+	DataType type;
+	switch (statement->type) {
+		case STATEMENT_DECLARATION: {
+			VariableSuffix * suffix = statement->variableSuffix;
+			if (suffix->type == VARIABLE_SUFFIX_ASSIGNMENT) {
+				const boolean typed = _checkExpression(context, suffix->expression, &type);
+				_checkAssignedType(context, *statement->identifier, statement->dataType, typed, type);
+			}
+			Symbol * symbol = declareSymbol(context->symbolTable, *statement->identifier, SYMBOL_LOCAL_VARIABLE, statement->dataType);
+			symbol->array = suffix->type == VARIABLE_SUFFIX_ARRAY;
+			break;
+		}
+		case STATEMENT_IF:
+			_checkExpression(context, statement->statementIf->condition, &type);
+			_checkBlock(context, statement->statementIf->thenBlock);
+			if (statement->statementIf->hasElse) {
+				_checkBlock(context, statement->statementIf->elseBlock);
+			}
+			break;
+		case STATEMENT_WHILE:
+			_checkExpression(context, statement->statementWhile->condition, &type);
+			_checkBlock(context, statement->statementWhile->block);
+			break;
+		case STATEMENT_FOR:
+			if (statement->statementFor->hasInit) {
+				_checkExpression(context, statement->statementFor->init, &type);
+			}
+			if (statement->statementFor->hasCondition) {
+				_checkExpression(context, statement->statementFor->condition, &type);
+			}
+			if (statement->statementFor->hasUpdate) {
+				_checkExpression(context, statement->statementFor->update, &type);
+			}
+			_checkBlock(context, statement->statementFor->block);
+			break;
+		case STATEMENT_RETURN:
+			if (statement->statementReturn->hasExpression) {
+				_checkExpression(context, statement->statementReturn->expression, &type);
+			}
+			break;
+		case STATEMENT_EXPRESSION:
+			_checkExpression(context, statement->statementExpression->expression, &type);
+			break;
+		case STATEMENT_BLOCK:
+			_checkBlock(context, statement->block);
+			break;
+		default:
+			break;
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+boolean checkFunctionTypes(SymbolTable * symbolTable, Declaration * declaration) {
+	DeclarationSuffix * suffix = declaration->declarationSuffix;
+	if (suffix->type != DECLARATION_SUFFIX_FUNCTION || suffix->functionSuffix->type != SUFFIX_BLOCK) {
+		return true;
+	}
+	TypeCheckerContext context = {
+		.symbolTable = symbolTable,
+		.succeed = true
+	};
+	beginScope(symbolTable);
+	if (suffix->parameters->type == PARAMS_LIST) {
+		for (ParameterList * node = suffix->parameters->list; node != NULL; node = node->next) {
+			Parameter * parameter = node->parameter;
+			Symbol * symbol = declareSymbol(symbolTable, *parameter->identifier, SYMBOL_PARAMETER, parameter->type);
+			symbol->array = parameter->array->type == PARAMETER_ARRAY_BRACKETS;
+		}
+	}
+	_checkBlock(&context, suffix->functionSuffix->block);
+	endScope(symbolTable);
+	return context.succeed;
+}
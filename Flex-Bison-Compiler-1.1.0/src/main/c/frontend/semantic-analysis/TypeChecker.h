@@ -0,0 +1,36 @@
+#ifndef TYPE_CHECKER_HEADER
+#define TYPE_CHECKER_HEADER
+
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "../syntactic-analysis/AbstractSyntaxTree.h"
+#include "SymbolTable.h"
+
+/**
+ * The semantic checks of the bodies of the functions, which the grammar
+ * cannot express:
+ *
+ *	- An identifier that was never declared cannot be assigned (reading one
+ *	  is allowed, as an external integer defined by another object).
+ *	- An integer cannot be assigned to a character (or initialize one).
+ *
+ * The literals have no type, so they fit both, and an arithmetic operation
+ * between a character and an integer is an integer (as in C). The relational
+ * and logical operations are integers too.
+ */
+
+/** Initialize module's internal state. */
+void initializeTypeCheckerModule();
+
+/** Shutdown module's internal state. */
+void shutdownTypeCheckerModule();
+
+/**
+ * Checks the body of a function definition (and ignores any other
+ * declaration), declaring its parameters and locals in a scope of its own,
+ * over the global symbols of the table. Every error is logged, and the
+ * result is false if there was any.
+ */
+boolean checkFunctionTypes(SymbolTable * symbolTable, Declaration * declaration);
+
+#endif
@@ -1,5 +1,6 @@
 #include "AbstractSyntaxTree.h"
 #include <stdlib.h>
+#include <string.h>
 
 static Logger* _logger = NULL;
 
@@ -29,17 +30,19 @@ void freeBlock(Block* node) {
 }
 
 void freeStatements(Statements* node) {
-    if (node == NULL) return;
-    freeStatement(node->statement);
-    freeStatements(node->next);
-    free(node);
+    while (node != NULL) {
+        Statements* next = node->next;
+        freeStatement(node->statement);
+        free(node);
+        node = next;
+    }
 }
 
 void freeStatement(Statement* node) {
     if (node == NULL) return;
     switch (node->type) {
         case STATEMENT_DECLARATION:
-            free(node->identifier);
+            freeIdentifier(node->identifier);
             freeVariableSuffix(node->variableSuffix);
             break;
         case STATEMENT_IF:
@@ -103,15 +106,17 @@ void freeStatementExpression(StatementExpression* node) {
 }
 
 void freeDeclarationList(DeclarationList* node) {
-    if (node == NULL) return;
-    freeDeclaration(node->declaration);
-    freeDeclarationList(node->next);
-    free(node);
+    while (node != NULL) {
+        DeclarationList* next = node->next;
+        freeDeclaration(node->declaration);
+        free(node);
+        node = next;
+    }
 }
 
 void freeDeclaration(Declaration* node) {
     if (node == NULL) return;
-    free(node->identifier);
+    freeIdentifier(node->identifier);
     freeDeclarationSuffix(node->declarationSuffix);
     free(node);
 }
@@ -143,15 +148,17 @@ void freeParameters(Parameters* node) {
 }
 
 void freeParameterList(ParameterList* node) {
-    if (node == NULL) return;
-    freeParameter(node->parameter);
-    freeParameterList(node->next);
-    free(node);
+    while (node != NULL) {
+        ParameterList* next = node->next;
+        freeParameter(node->parameter);
+        free(node);
+        node = next;
+    }
 }
 
 void freeParameter(Parameter* node) {
     if (node == NULL) return;
-    free(node->identifier);
+    freeIdentifier(node->identifier);
     freeParameterArray(node->array);
     free(node);
 }
@@ -190,10 +197,12 @@ void freeIdentifierSuffix(IdentifierSuffix* node) {
 }
 
 void freeListArguments(ListArguments* node) {
-    if (node == NULL) return;
-    freeExpression(node->expression);
-    freeListArguments(node->next);
-    free(node);
+    while (node != NULL) {
+        ListArguments* next = node->next;
+        freeExpression(node->expression);
+        free(node);
+        node = next;
+    }
 }
 
 void freeExpression(Expression* node) {
@@ -211,17 +220,17 @@ void freeExpression(Expression* node) {
             freeExpression(node->singleExpression);
             break;
         case EXPRESSION_IDENTIFIER:
-            free(node->identifier);
+            freeIdentifier(node->identifier);
             break;
         case EXPRESSION_CONSTANT:
             freeConstant(node->constant);
             break;
         case EXPRESSION_ARRAY_ACCESS:
-            free(node->identifierArray);
+            freeIdentifier(node->identifierArray);
             freeExpression(node->indexExpression);
             break;
         case EXPRESSION_FUNCTION_CALL:
-            free(node->identifierFunc);
+            freeIdentifier(node->identifierFunc);
             freeListArguments(node->arguments);
             break;
     }
@@ -239,4 +248,203 @@ void freeIdentifier(Identifier* identifier) {
     if (identifier == NULL) return;
     free(*identifier);
     free(identifier);
-}
\ No newline at end of file
+}
+
+/* --- Copy Functions --- */
+
+
+Block* copyBlock(const Block* node) {
+    if (node == NULL) return NULL;
+    Block* copy = calloc(1, sizeof(Block));
+    copy->statements = copyStatements(node->statements);
+    copy->line = node->line;
+    return copy;
+}
+
+Statements* copyStatements(const Statements* node) {
+    Statements* first = NULL;
+    Statements** link = &first;
+    for (; node != NULL; node = node->next) {
+        *link = calloc(1, sizeof(Statements));
+        (*link)->statement = copyStatement(node->statement);
+        link = &(*link)->next;
+    }
+    return first;
+}
+
+Statement* copyStatement(const Statement* node) {
+    if (node == NULL) return NULL;
+    Statement* copy = calloc(1, sizeof(Statement));
+    copy->type = node->type;
+    copy->line = node->line;
+    switch (node->type) {
+        case STATEMENT_DECLARATION:
+            copy->dataType = node->dataType;
+            copy->identifier = copyIdentifier(node->identifier);
+            copy->variableSuffix = copyVariableSuffix(node->variableSuffix);
+            break;
+        case STATEMENT_IF:
+            copy->statementIf = copyStatementIf(node->statementIf);
+            break;
+        case STATEMENT_WHILE:
+            copy->statementWhile = copyStatementWhile(node->statementWhile);
+            break;
+        case STATEMENT_FOR:
+            copy->statementFor = copyStatementFor(node->statementFor);
+            break;
+        case STATEMENT_RETURN:
+            copy->statementReturn = copyStatementReturn(node->statementReturn);
+            break;
+        case STATEMENT_EXPRESSION:
+            copy->statementExpression = copyStatementExpression(node->statementExpression);
+            break;
+        case STATEMENT_BLOCK:
+            copy->block = copyBlock(node->block);
+            break;
+        case STATEMENT_EMPTY:
+            break;
+    }
+    return copy;
+}
+
+StatementReturn* copyStatementReturn(const StatementReturn* node) {
+    if (node == NULL) return NULL;
+    StatementReturn* copy = calloc(1, sizeof(StatementReturn));
+    copy->hasExpression = node->hasExpression;
+    if (node->hasExpression) copy->expression = copyExpression(node->expression);
+    return copy;
+}
+
+StatementFor* copyStatementFor(const StatementFor* node) {
+    if (node == NULL) return NULL;
+    StatementFor* copy = calloc(1, sizeof(StatementFor));
+    copy->hasInit = node->hasInit;
+    copy->hasCondition = node->hasCondition;
+    copy->hasUpdate = node->hasUpdate;
+    if (node->hasInit) copy->init = copyExpression(node->init);
+    if (node->hasCondition) copy->condition = copyExpression(node->condition);
+    if (node->hasUpdate) copy->update = copyExpression(node->update);
+    copy->block = copyBlock(node->block);
+    return copy;
+}
+
+StatementWhile* copyStatementWhile(const StatementWhile* node) {
+    if (node == NULL) return NULL;
+    StatementWhile* copy = calloc(1, sizeof(StatementWhile));
+    copy->condition = copyExpression(node->condition);
+    copy->block = copyBlock(node->block);
+    return copy;
+}
+
+StatementIf* copyStatementIf(const StatementIf* node) {
+    if (node == NULL) return NULL;
+    StatementIf* copy = calloc(1, sizeof(StatementIf));
+    copy->condition = copyExpression(node->condition);
+    copy->thenBlock = copyBlock(node->thenBlock);
+    copy->hasElse = node->hasElse;
+    if (node->hasElse) copy->elseBlock = copyBlock(node->elseBlock);
+    return copy;
+}
+
+StatementExpression* copyStatementExpression(const StatementExpression* node) {
+    if (node == NULL) return NULL;
+    StatementExpression* copy = calloc(1, sizeof(StatementExpression));
+    copy->expression = copyExpression(node->expression);
+    return copy;
+}
+
+Parameter* copyParameter(const Parameter* node) {
+    if (node == NULL) return NULL;
+    Parameter* copy = calloc(1, sizeof(Parameter));
+    copy->type = node->type;
+    copy->identifier = copyIdentifier(node->identifier);
+    if (node->array != NULL) {
+        copy->array = calloc(1, sizeof(ParameterArray));
+        copy->array->type = node->array->type;
+    }
+    return copy;
+}
+
+VariableSuffix* copyVariableSuffix(const VariableSuffix* node) {
+    if (node == NULL) return NULL;
+    VariableSuffix* copy = calloc(1, sizeof(VariableSuffix));
+    copy->type = node->type;
+    switch (node->type) {
+        case VARIABLE_SUFFIX_ASSIGNMENT:
+            copy->expression = copyExpression(node->expression);
+            break;
+        case VARIABLE_SUFFIX_ARRAY:
+            copy->arraySize = malloc(sizeof(ConstantInteger));
+            *copy->arraySize = *node->arraySize;
+            break;
+        default: break;
+    }
+    return copy;
+}
+
+ListArguments* copyListArguments(const ListArguments* node) {
+    ListArguments* first = NULL;
+    ListArguments** link = &first;
+    for (; node != NULL; node = node->next) {
+        *link = calloc(1, sizeof(ListArguments));
+        (*link)->expression = copyExpression(node->expression);
+        link = &(*link)->next;
+    }
+    return first;
+}
+
+Expression* copyExpression(const Expression* node) {
+    if (node == NULL) return NULL;
+    Expression* copy = calloc(1, sizeof(Expression));
+    copy->type = node->type;
+    switch (node->type) {
+        case EXPRESSION_ASSIGNMENT: case EXPRESSION_OR: case EXPRESSION_AND:
+        case EXPRESSION_EQUAL: case EXPRESSION_NOT_EQUAL: case EXPRESSION_LESS:
+        case EXPRESSION_GREATER: case EXPRESSION_LESS_EQUAL: case EXPRESSION_GREATER_EQUAL:
+        case EXPRESSION_ADDITION: case EXPRESSION_SUBTRACTION: case EXPRESSION_MULTIPLICATION:
+        case EXPRESSION_DIVISION: case EXPRESSION_MODULO:
+            copy->leftExpression = copyExpression(node->leftExpression);
+            copy->rightExpression = copyExpression(node->rightExpression);
+            break;
+        case EXPRESSION_NOT: case EXPRESSION_PARENTHESIS:
+            copy->singleExpression = copyExpression(node->singleExpression);
+            break;
+        case EXPRESSION_IDENTIFIER:
+            copy->identifier = copyIdentifier(node->identifier);
+            break;
+        case EXPRESSION_CONSTANT:
+            copy->constant = copyConstant(node->constant);
+            break;
+        case EXPRESSION_ARRAY_ACCESS:
+            copy->identifierArray = copyIdentifier(node->identifierArray);
+            copy->indexExpression = copyExpression(node->indexExpression);
+            break;
+        case EXPRESSION_FUNCTION_CALL:
+            copy->identifierFunc = copyIdentifier(node->identifierFunc);
+            copy->arguments = copyListArguments(node->arguments);
+            break;
+    }
+    return copy;
+}
+
+Constant* copyConstant(const Constant* node) {
+    if (node == NULL) return NULL;
+    Constant* copy = calloc(1, sizeof(Constant));
+    copy->type = node->type;
+    if (node->type == TYPE_INT) {
+        copy->integer = malloc(sizeof(ConstantInteger));
+        *copy->integer = *node->integer;
+    }
+    else {
+        copy->character = malloc(sizeof(ConstantCharacter));
+        *copy->character = *node->character;
+    }
+    return copy;
+}
+
+Identifier* copyIdentifier(const Identifier* identifier) {
+    if (identifier == NULL) return NULL;
+    Identifier* copy = malloc(sizeof(Identifier));
+    *copy = strdup(*identifier);
+    return copy;
+}
@@ -17,7 +17,10 @@ typedef enum {
 
 typedef enum {
     DECLARATION_REGULAR,
-    DECLARATION_EXTERN
+    DECLARATION_EXTERN,
+    // A function created by the compiler (e.g., a specialized copy of
+    // another one), which is only visible inside of the program.
+    DECLARATION_INTERNAL
 } DeclarationType;
 
 typedef enum {
@@ -251,6 +254,7 @@ struct StatementReturn {
 
 struct Statement {
     StatementType type;
+    unsigned int line;
     union {
         struct {
             DataType dataType;
@@ -273,6 +277,7 @@ struct Statements {
 
 struct Block {
     Statements* statements;
+    unsigned int line;
 };
 
 struct Program {
@@ -305,5 +310,21 @@ void freeIdentifierSuffix(IdentifierSuffix* node);
 void freeListArguments(ListArguments* node);
 void freeExpression(Expression* node);
 void freeConstant(Constant* node);
+void freeIdentifier(Identifier* identifier);
+
+Block* copyBlock(const Block* node);
+Statements* copyStatements(const Statements* node);
+Statement* copyStatement(const Statement* node);
+StatementReturn* copyStatementReturn(const StatementReturn* node);
+StatementFor* copyStatementFor(const StatementFor* node);
+StatementWhile* copyStatementWhile(const StatementWhile* node);
+StatementIf* copyStatementIf(const StatementIf* node);
+StatementExpression* copyStatementExpression(const StatementExpression* node);
+Parameter* copyParameter(const Parameter* node);
+VariableSuffix* copyVariableSuffix(const VariableSuffix* node);
+ListArguments* copyListArguments(const ListArguments* node);
+Expression* copyExpression(const Expression* node);
+Constant* copyConstant(const Constant* node);
+Identifier* copyIdentifier(const Identifier* identifier);
 
 #endif
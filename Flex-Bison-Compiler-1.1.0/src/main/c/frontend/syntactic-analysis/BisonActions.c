@@ -20,13 +20,31 @@ extern unsigned int flexCurrentContext(void);
 
 /* PRIVATE FUNCTIONS */
 
+static boolean _consumeDeclaration(CompilerState* compilerState, Declaration* declaration);
 static void _logSyntacticAnalyzerAction(const char * functionName);
 
 /**
- * Logs a syntactic-analyzer action in DEBUGGING level.
+ * Hands a declaration to the consumer of the compiler state (if any), and
+ * releases it. Returns false if there is no consumer.
+ */
+static boolean _consumeDeclaration(CompilerState* compilerState, Declaration* declaration) {
+    if (compilerState == NULL || compilerState->declarationConsumer == NULL) {
+        return false;
+    }
+    compilerState->declarationConsumer(declaration);
+    freeDeclaration(declaration);
+    return true;
+}
+
+/**
+ * Logs a syntactic-analyzer action in DEBUGGING level, and counts the nodes
+ * that it builds (see "--stats").
  */
 static void _logSyntacticAnalyzerAction(const char * functionName) {
     logDebugging(_logger, "%s", functionName);
+    if (statisticsEnabled) {
+        countNamed(STATISTICS_NODES, functionName, 1);
+    }
 }
 
 /* PUBLIC FUNCTIONS */
@@ -35,7 +53,8 @@ static void _logSyntacticAnalyzerAction(const char * functionName) {
 Program* DeclarationListProgramSemanticAction(CompilerState* compilerState, DeclarationList* declarationList) {
     _logSyntacticAnalyzerAction(__FUNCTION__);
     Program* program = calloc(1, sizeof(Program));
-    program->declarationList = declarationList;
+    program->declarationList = declarationList->next;
+    declarationList->next = NULL;
     program->type = PROGRAM_DECLARATIONS;
     compilerState->abstractSyntaxtTree = program;
     if (0 < flexCurrentContext()) {
@@ -64,28 +83,25 @@ Program* EmptyProgramSemanticAction(CompilerState* compilerState) {
 }
 
 // Declaration actions
-DeclarationList* SingleDeclarationListSemanticAction(Declaration* declaration) {
+DeclarationList* SingleDeclarationListSemanticAction(CompilerState* compilerState, Declaration* declaration) {
     _logSyntacticAnalyzerAction(__FUNCTION__);
     DeclarationList* list = calloc(1, sizeof(DeclarationList));
-    list->declaration = declaration;
-    list->next = NULL;
+    list->declaration = _consumeDeclaration(compilerState, declaration) ? NULL : declaration;
+    list->next = list;
     return list;
 }
 
-DeclarationList* AppendDeclarationListSemanticAction(DeclarationList* list, Declaration* declaration) {
+DeclarationList* AppendDeclarationListSemanticAction(CompilerState* compilerState, DeclarationList* list, Declaration* declaration) {
     _logSyntacticAnalyzerAction(__FUNCTION__);
+    // While streaming, the list keeps a single (empty) node.
+    if (_consumeDeclaration(compilerState, declaration)) {
+        return list;
+    }
     DeclarationList* newList = calloc(1, sizeof(DeclarationList));
     newList->declaration = declaration;
-    newList->next = NULL;
-    
-    DeclarationList* current = list;
-    while (current->next != NULL) {
-        current = current->next;
-    }
-    
-    current->next = newList;
-    
-    return list;
+    newList->next = list->next;
+    list->next = newList;
+    return newList;
 }
 
 Declaration* RegularDeclarationSemanticAction(DataType type, Identifier * identifier, DeclarationSuffix* declarationSuffix) {
@@ -112,7 +128,7 @@ DeclarationSuffix* VariableDeclarationSuffixSemanticAction(VariableSuffix* varia
     _logSyntacticAnalyzerAction(__FUNCTION__);
     DeclarationSuffix* suffix = calloc(1, sizeof(DeclarationSuffix));
     suffix->variableSuffix = variableSuffix;
-    suffix->type = VARIABLE_SUFFIX_ARRAY;
+    suffix->type = DECLARATION_SUFFIX_VARIABLE;
     return suffix;
 }
 
@@ -176,7 +192,8 @@ Parameters* VoidParametersSemanticAction() {
 Parameters* ListParametersSemanticAction(ParameterList* list) {
     _logSyntacticAnalyzerAction(__FUNCTION__);
     Parameters* parameters = calloc(1, sizeof(Parameters));
-    parameters->list = list;
+    parameters->list = list->next;
+    list->next = NULL;
     parameters->type = PARAMS_LIST;
     return parameters;
 }
@@ -192,15 +209,16 @@ ParameterList* SingleParameterListSemanticAction(Parameter* parameter) {
     _logSyntacticAnalyzerAction(__FUNCTION__);
     ParameterList* list = calloc(1, sizeof(ParameterList));
     list->parameter = parameter;
-    list->next = NULL;
+    list->next = list;
     return list;
 }
 
-ParameterList* AppendParameterListSemanticAction(Parameter* parameter, ParameterList* list) {
+ParameterList* AppendParameterListSemanticAction(ParameterList* list, Parameter* parameter) {
     _logSyntacticAnalyzerAction(__FUNCTION__);
     ParameterList* newList = calloc(1, sizeof(ParameterList));
     newList->parameter = parameter;
-    newList->next = list;
+    newList->next = list->next;
+    list->next = newList;
     return newList;
 }
 
@@ -229,18 +247,28 @@ ParameterArray * EmptyParameterArraySemanticAction() {
 }
 
 // Block and statement actions
-Block* BlockSemanticAction(Statements* statements) {
+Block* BlockSemanticAction(Statements* statements, unsigned int line) {
     _logSyntacticAnalyzerAction(__FUNCTION__);
     Block* block = calloc(1, sizeof(Block));
-    block->statements = statements;
+    block->line = line;
+    if (statements != NULL) {
+        block->statements = statements->next;
+        statements->next = NULL;
+    }
     return block;
 }
 
-Statements* AppendStatementsSemanticAction(Statement* statement, Statements* statements) {
+Statements* AppendStatementsSemanticAction(Statements* statements, Statement* statement) {
     _logSyntacticAnalyzerAction(__FUNCTION__);
     Statements* newStatements = calloc(1, sizeof(Statements));
     newStatements->statement = statement;
-    newStatements->next = statements;
+    if (statements == NULL) {
+        newStatements->next = newStatements;
+    }
+    else {
+        newStatements->next = statements->next;
+        statements->next = newStatements;
+    }
     return newStatements;
 }
 
@@ -250,9 +278,10 @@ Statements* EmptyStatementsSemanticAction() {
 }
 
 
-Statement* DeclarationStatementSemanticAction(DataType type, Identifier* identifier, VariableSuffix* variableSuffix) {
+Statement* DeclarationStatementSemanticAction(DataType type, Identifier* identifier, VariableSuffix* variableSuffix, unsigned int line) {
     _logSyntacticAnalyzerAction(__FUNCTION__);
     Statement* statement = calloc(1, sizeof(Statement));
+    statement->line = line;
     statement->dataType = type;
     statement->identifier = identifier;
     statement->variableSuffix = variableSuffix;
@@ -260,57 +289,64 @@ Statement* DeclarationStatementSemanticAction(DataType type, Identifier* identif
     return statement;
 }
 
-Statement* IfStatementSemanticAction(StatementIf* statementIf) {
+Statement* IfStatementSemanticAction(StatementIf* statementIf, unsigned int line) {
     _logSyntacticAnalyzerAction(__FUNCTION__);
     Statement* statement = calloc(1, sizeof(Statement));
+    statement->line = line;
     statement->statementIf = statementIf;
     statement->type = STATEMENT_IF;
     return statement;
 }
 
-Statement* WhileStatementSemanticAction(StatementWhile* statementWhile) {
+Statement* WhileStatementSemanticAction(StatementWhile* statementWhile, unsigned int line) {
     _logSyntacticAnalyzerAction(__FUNCTION__);
     Statement* statement = calloc(1, sizeof(Statement));
+    statement->line = line;
     statement->statementWhile = statementWhile;
     statement->type = STATEMENT_WHILE;
     return statement;
 }
 
-Statement* ForStatementSemanticAction(StatementFor* statementFor) {
+Statement* ForStatementSemanticAction(StatementFor* statementFor, unsigned int line) {
     _logSyntacticAnalyzerAction(__FUNCTION__);
     Statement* statement = calloc(1, sizeof(Statement));
+    statement->line = line;
     statement->statementFor = statementFor;
     statement->type = STATEMENT_FOR;
     return statement;
 }
 
-Statement* ReturnStatementSemanticAction(StatementReturn* statementReturn) {
+Statement* ReturnStatementSemanticAction(StatementReturn* statementReturn, unsigned int line) {
     _logSyntacticAnalyzerAction(__FUNCTION__);
     Statement* statement = calloc(1, sizeof(Statement));
+    statement->line = line;
     statement->statementReturn = statementReturn;
     statement->type = STATEMENT_RETURN;
     return statement;
 }
 
-Statement* ExpressionStatementSemanticAction(StatementExpression* statementExpression) {
+Statement* ExpressionStatementSemanticAction(StatementExpression* statementExpression, unsigned int line) {
     _logSyntacticAnalyzerAction(__FUNCTION__);
     Statement* statement = calloc(1, sizeof(Statement));
+    statement->line = line;
     statement->statementExpression = statementExpression;
     statement->type = STATEMENT_EXPRESSION;
     return statement;
 }
 
-Statement* BlockStatementSemanticAction(Block* block) {
+Statement* BlockStatementSemanticAction(Block* block, unsigned int line) {
     _logSyntacticAnalyzerAction(__FUNCTION__);
     Statement* statement = calloc(1, sizeof(Statement));
+    statement->line = line;
     statement->block = block;
     statement->type = STATEMENT_BLOCK;
     return statement;
 }
 
-Statement* EmptyStatementSemanticAction() {
+Statement* EmptyStatementSemanticAction(unsigned int line) {
     _logSyntacticAnalyzerAction(__FUNCTION__);
     Statement* statement = calloc(1, sizeof(Statement));
+    statement->line = line;
     statement->type = STATEMENT_EMPTY;
     return statement;
 }
@@ -521,7 +557,7 @@ Expression* IdentifierExpressionSemanticAction(Identifier* identifier, Identifie
         result->indexExpression = suffix->indexExpression;
         result->type = EXPRESSION_ARRAY_ACCESS;
     }
-    
+    free(suffix);
     return result;
 }
 
@@ -561,7 +597,10 @@ Expression* ArrayExpressionLvalueSemanticAction(Identifier* identifier, Expressi
 IdentifierSuffix* FunctionCallIdentifierSuffixSemanticAction(ListArguments* arguments) {
     _logSyntacticAnalyzerAction(__FUNCTION__);
     IdentifierSuffix* suffix = calloc(1, sizeof(IdentifierSuffix));
-    suffix->arguments = arguments;
+    if (arguments != NULL) {
+        suffix->arguments = arguments->next;
+        arguments->next = NULL;
+    }
     suffix->type = IDENTIFIER_SUFFIX_FUNCTION_CALL;
     return suffix;
 }
@@ -585,24 +624,17 @@ ListArguments* SingleListArgumentsSemanticAction(Expression* expression) {
     _logSyntacticAnalyzerAction(__FUNCTION__);
     ListArguments* list = calloc(1, sizeof(ListArguments));
     list->expression = expression;
-    list->next = NULL;
+    list->next = list;
     return list;
 }
 
 ListArguments* AppendListArgumentsSemanticAction(ListArguments* list, Expression* expression) {
     _logSyntacticAnalyzerAction(__FUNCTION__);
-    ListArguments* current = list;
-    while (current->next != NULL) {
-        current = current->next;
-    }
-    
     ListArguments* newArg = calloc(1, sizeof(ListArguments));
     newArg->expression = expression;
-    newArg->next = NULL;
-    
-    current->next = newArg;
-    
-    return list;
+    newArg->next = list->next;
+    list->next = newArg;
+    return newArg;
 }
 
 Constant* IntegerConstantSemanticAction(ConstantInteger* constant) {
@@ -639,6 +671,6 @@ ConstantCharacter* ConstantCharacterSemanticAction(char value) {
 Identifier* IdentifierSemanticAction(char* name) {
     _logSyntacticAnalyzerAction(__FUNCTION__);
     Identifier* identifier = calloc(1, sizeof(Identifier));
-    *identifier = strdup(name);
+    *identifier = name;
     return identifier;
 }
\ No newline at end of file
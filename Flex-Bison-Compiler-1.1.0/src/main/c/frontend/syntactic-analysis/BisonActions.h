@@ -3,6 +3,7 @@
 
 #include "../../shared/CompilerState.h"
 #include "../../shared/Logger.h"
+#include "../../shared/Statistics.h"
 #include "../../shared/Type.h"
 #include "AbstractSyntaxTree.h"
 #include "SyntacticAnalyzer.h"
@@ -17,6 +18,11 @@ void shutdownBisonActionsModule();
 
 /**
  * Bison semantic actions.
+ *
+ * While a list is parsed, its value is its last node, in a circular list (the
+ * next node of the last one is the first), so appending a node takes constant
+ * time. The action that consumes the list opens the circle, and returns its
+ * first node.
  */
 
 // Program actions
@@ -27,8 +33,8 @@ Program* EmptyProgramSemanticAction(CompilerState* compilerState);
 
 Declaration* RegularDeclarationSemanticAction(DataType type, Identifier * identifier, DeclarationSuffix* declarationSuffix);
 Declaration* ExternDeclarationSemanticAction(DataType type, Identifier * identifier, DeclarationSuffix* declarationSuffix);
-DeclarationList* SingleDeclarationListSemanticAction(Declaration* declaration);
-DeclarationList* AppendDeclarationListSemanticAction(DeclarationList* list, Declaration* declaration);
+DeclarationList* SingleDeclarationListSemanticAction(CompilerState* compilerState, Declaration* declaration);
+DeclarationList* AppendDeclarationListSemanticAction(CompilerState* compilerState, DeclarationList* list, Declaration* declaration);
 DeclarationSuffix* VariableDeclarationSuffixSemanticAction(VariableSuffix* variableSuffix);
 DeclarationSuffix* FunctionDeclarationSuffixSemanticAction(Parameters* parameters, FunctionSuffix* functionSuffix);
 FunctionSuffix* EmptyFunctionSuffixSemanticAction();
@@ -43,22 +49,22 @@ Parameters* VoidParametersSemanticAction();
 Parameters* ListParametersSemanticAction(ParameterList* list);
 Parameters* EmptyParametersSemanticAction();
 ParameterList* SingleParameterListSemanticAction(Parameter* parameter);
-ParameterList* AppendParameterListSemanticAction(Parameter* parameter, ParameterList* list);
+ParameterList* AppendParameterListSemanticAction(ParameterList* list, Parameter* parameter);
 ParameterArray* ArrayParameterArraySemanticAction();
 ParameterArray* EmptyParameterArraySemanticAction();
 
 // Block and statement actions
-Block* BlockSemanticAction(Statements* statements);
-Statements* AppendStatementsSemanticAction(Statement* statement, Statements* statements);
+Block* BlockSemanticAction(Statements* statements, unsigned int line);
+Statements* AppendStatementsSemanticAction(Statements* statements, Statement* statement);
 Statements* EmptyStatementsSemanticAction();
-Statement* DeclarationStatementSemanticAction(DataType type, Identifier* identifier, VariableSuffix* variableSuffix);
-Statement* IfStatementSemanticAction(StatementIf* statementIf);
-Statement* WhileStatementSemanticAction(StatementWhile* statementWhile);
-Statement* ForStatementSemanticAction(StatementFor* statementFor);
-Statement* ReturnStatementSemanticAction(StatementReturn* statementReturn);
-Statement* ExpressionStatementSemanticAction(StatementExpression* statementExpression);
-Statement* BlockStatementSemanticAction(Block* block);
-Statement* EmptyStatementSemanticAction();
+Statement* DeclarationStatementSemanticAction(DataType type, Identifier* identifier, VariableSuffix* variableSuffix, unsigned int line);
+Statement* IfStatementSemanticAction(StatementIf* statementIf, unsigned int line);
+Statement* WhileStatementSemanticAction(StatementWhile* statementWhile, unsigned int line);
+Statement* ForStatementSemanticAction(StatementFor* statementFor, unsigned int line);
+Statement* ReturnStatementSemanticAction(StatementReturn* statementReturn, unsigned int line);
+Statement* ExpressionStatementSemanticAction(StatementExpression* statementExpression, unsigned int line);
+Statement* BlockStatementSemanticAction(Block* block, unsigned int line);
+Statement* EmptyStatementSemanticAction(unsigned int line);
 StatementExpression* StatementExpressionSemanticAction(Expression* expression);
 StatementIf* SimpleStatementIfSemanticAction(Expression* condition, Block* thenBlock);
 StatementIf* WithElseStatementIfSemanticAction(Expression* condition, Block* thenBlock, Block* elseBlock);
@@ -103,7 +109,7 @@ Constant* CharacterConstantSemanticAction(ConstantCharacter* constant);
 ConstantInteger* ConstantIntegerSemanticAction(int value);
 ConstantCharacter* ConstantCharacterSemanticAction(char value);
 
-// Identifier action
+// Identifier action (takes the ownership of the name)
 Identifier* IdentifierSemanticAction(char* name);
 
 #endif
\ No newline at end of file
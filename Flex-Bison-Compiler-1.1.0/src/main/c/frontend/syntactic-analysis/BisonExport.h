@@ -0,0 +1,13 @@
+#ifndef BISON_EXPORT_HEADER
+#define BISON_EXPORT_HEADER
+
+/**
+ * Hook that allows to export a static function or variable from the inside of
+ * Bison infrastructure, in this case, the name of a token (as declared in the
+ * grammar).
+ */
+const char * bisonTokenName(const Token token) {
+	return yytname[YYTRANSLATE(token)];
+}
+
+#endif
@@ -3,11 +3,55 @@
 
 #include "BisonActions.h"
 
+/**
+ * Bison computes the location of every reduction with this macro, which is
+ * expanded inside "yyparse", so it can also observe the depth of the parser
+ * stack (a reduction always follows its deepest push). A location is just the
+ * line of the first token of the rule (or of the previous one, if the rule
+ * is empty), which the statements and blocks keep for the coverage.
+ *
+ * The stack starts with room for "YYINITDEPTH" states, and Bison only checks
+ * "YYMAXDEPTH" when it grows, so the limit is enforced here too, as if the
+ * parser ran out of memory ("YYNOMEM"), for any limit below that room.
+ *
+ * @see https://www.gnu.org/software/bison/manual/html_node/Location-Default-Action.html
+ * @see https://www.gnu.org/software/bison/manual/html_node/Memory-Management.html
+ */
+#define YYLLOC_DEFAULT(Current, Rhs, N)									\
+	do {																\
+		const unsigned int depth = (unsigned int) (yyssp - yyss) + 1;	\
+		if ((unsigned int) parserStackLimit() < depth) {				\
+			YYNOMEM;													\
+		}																\
+		(Current) = (N) ? YYRHSLOC(Rhs, 1) : YYRHSLOC(Rhs, 0);			\
+		if (statisticsEnabled) {										\
+			recordParserDepth(depth);									\
+		}																\
+	} while (0)
+
+/**
+ * The maximum depth of the parser stack (see "PARSER_STACK_LIMIT"). Every
+ * list of the grammar is left-recursive, so the depth only grows with the
+ * nesting of the program, and never with the length of a list.
+ */
+#define YYMAXDEPTH parserStackLimit()
+
 %}
 
 // You touch this, and you die.
 %define api.value.union.name SemanticValue
 
+// The parser is reentrant (without global variables), so many instances can
+// parse at the same time (see "parseTokensInParallel").
+%define api.pure full
+
+// The locations are lines, and they observe the parser stack (see "YYLLOC_DEFAULT").
+%define api.location.type {unsigned int}
+%locations
+
+// Exports the names of the tokens (see "BisonExport.h").
+%token-table
+
 %union {
 	/** Terminals. */
 	int integer;
@@ -132,8 +176,8 @@ Programa: DeclarationList                                             { $$ = Dec
 	| %empty                                                           { $$ = EmptyProgramSemanticAction(currentCompilerState()); }
 	;
 
-DeclarationList: Declaration                                          { $$ = SingleDeclarationListSemanticAction($1); }
-	| DeclarationList Declaration                                     { $$ = AppendDeclarationListSemanticAction($1, $2); }
+DeclarationList: Declaration                                          { $$ = SingleDeclarationListSemanticAction(currentCompilerState(), $1); }
+	| DeclarationList Declaration                                     { $$ = AppendDeclarationListSemanticAction(currentCompilerState(), $1, $2); }
 	;
 
 Declaration: Type Identifier DeclarationSuffix                      { $$ = RegularDeclarationSemanticAction($1, $2, $3); }
@@ -159,7 +203,7 @@ Parameters: VOID                                                       { $$ = Vo
 	;
 
 ParameterList: Parameter                                              { $$ = SingleParameterListSemanticAction($1); }
-	| Parameter COMMA ParameterList                                   { $$ = AppendParameterListSemanticAction($1, $3); }
+	| ParameterList COMMA Parameter                                   { $$ = AppendParameterListSemanticAction($1, $3); }
 	;
 
 Parameter: Type Identifier ParameterArray                           { $$ = ParameterSemanticAction($1, $2, $3); }
@@ -173,21 +217,21 @@ Type: INT                                                              { $$ = TY
 	| CHAR                                                             { $$ = TYPE_CHAR; }
 	;
 
-Block: OPEN_BRACE Statements CLOSE_BRACE                              { $$ = BlockSemanticAction($2); }
+Block: OPEN_BRACE Statements CLOSE_BRACE                              { $$ = BlockSemanticAction($2, @1); }
 	;
 
-Statements: Statement Statements                                       { $$ = AppendStatementsSemanticAction($1, $2); }
+Statements: Statements Statement                                       { $$ = AppendStatementsSemanticAction($1, $2); }
 	| %empty                                                           { $$ = EmptyStatementsSemanticAction(); }
 	;
 
-Statement: Type Identifier VariableSuffix SEMICOLON                 { $$ = DeclarationStatementSemanticAction($1, $2, $3); }
-	| StatementIf                                                      { $$ = IfStatementSemanticAction($1); }
-	| StatementWhile                                                   { $$ = WhileStatementSemanticAction($1); }
-	| StatementFor                                                     { $$ = ForStatementSemanticAction($1); }
-	| StatementReturn                                                  { $$ = ReturnStatementSemanticAction($1); }
-	| StatementExpression                                               { $$ = ExpressionStatementSemanticAction($1); }
-	| Block                                                           { $$ = BlockStatementSemanticAction($1); }
-	| SEMICOLON                                                        { $$ = EmptyStatementSemanticAction(); }
+Statement: Type Identifier VariableSuffix SEMICOLON                 { $$ = DeclarationStatementSemanticAction($1, $2, $3, @$); }
+	| StatementIf                                                      { $$ = IfStatementSemanticAction($1, @$); }
+	| StatementWhile                                                   { $$ = WhileStatementSemanticAction($1, @$); }
+	| StatementFor                                                     { $$ = ForStatementSemanticAction($1, @$); }
+	| StatementReturn                                                  { $$ = ReturnStatementSemanticAction($1, @$); }
+	| StatementExpression                                               { $$ = ExpressionStatementSemanticAction($1, @$); }
+	| Block                                                           { $$ = BlockStatementSemanticAction($1, @$); }
+	| SEMICOLON                                                        { $$ = EmptyStatementSemanticAction(@$); }
 	;
 
 StatementExpression: Expression SEMICOLON                                { $$ = StatementExpressionSemanticAction($1); }
@@ -291,4 +335,6 @@ ConstantCharacter: CHARACTER                                           { $$ = Co
 Identifier: IDENTIFIER                                                  { $$ = IdentifierSemanticAction($1); }
 	;
 
-%%
\ No newline at end of file
+%%
+
+#include "BisonExport.h"
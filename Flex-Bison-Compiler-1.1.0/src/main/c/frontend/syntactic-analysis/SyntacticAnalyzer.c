@@ -1,13 +1,74 @@
 #include "SyntacticAnalyzer.h"
 #include "../lexical-analysis/LexicalAnalyzerContext.h"
+#include "AbstractSyntaxTree.h"
+#include "BisonParser.h"
+#include <pthread.h>
+#include <unistd.h>
 
 /* MODULE INTERNAL STATE */
 
-static CompilerState * _currentCompilerState = NULL;
 static Logger * _logger = NULL;
 
+/**
+ * The state of the parser running in each thread: the compiler state, and
+ * the token array that it consumes (see "parseTokens"), with the position of
+ * its next token and the end of the consumed range; or NULL if the parser
+ * consumes the scanner. A speculative parser doesn't report its errors.
+ */
+static __thread CompilerState * _currentCompilerState = NULL;
+static __thread const TokenArray * _tokens = NULL;
+static __thread unsigned int _position = 0;
+static __thread unsigned int _end = 0;
+static __thread boolean _speculative = false;
+
+/**
+ * The default limit of the parser stack (the default of Bison).
+ */
+static const int _defaultParserStackLimit = 10000;
+static int _parserStackLimit = 10000;
+
+/**
+ * The message of Bison when the parser stack reaches its limit.
+ */
+static const char * _stackExhaustedMessage = "memory exhausted";
+
+/**
+ * The amount of parsers in parallel (see "PARSER_THREADS"), and the minimum
+ * amount of tokens of each chunk, below which the threads cost more than
+ * they save.
+ */
+static unsigned int _parserThreads = 1;
+static const unsigned int _minimumChunkTokens = 16384;
+
+/**
+ * A range of top-level declarations of a token array, parsed on its own.
+ */
+typedef struct {
+	const TokenArray * tokens;
+	unsigned int begin;
+	unsigned int end;
+	CompilerState compilerState;
+	SyntacticAnalysisStatus status;
+} ParserChunk;
+
+/**
+ * The semantic value of the current lexeme, written by the actions of the
+ * scanner (the pure parser has its own, for each instance).
+ */
+union SemanticValue yylval;
+
 void initializeSyntacticAnalyzerModule() {
 	_logger = createLogger("SyntacticAnalyzer");
+	const char * limit = getStringOrDefault("PARSER_STACK_LIMIT", NULL);
+	_parserStackLimit = limit == NULL ? _defaultParserStackLimit : atoi(limit);
+	if (_parserStackLimit <= 0) {
+		logError(_logger, "The parser stack limit is invalid (%s), so the default is used: %d", limit, _defaultParserStackLimit);
+		_parserStackLimit = _defaultParserStackLimit;
+	}
+	const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+	const char * threads = getStringOrDefault("PARSER_THREADS", NULL);
+	const int parserThreads = threads == NULL ? (int) processors : atoi(threads);
+	_parserThreads = parserThreads <= 0 ? 1 : (unsigned int) parserThreads;
 }
 
 void shutdownSyntacticAnalyzerModule() {
@@ -18,13 +79,26 @@ void shutdownSyntacticAnalyzerModule() {
 
 /** IMPORTED FUNCTIONS */
 
-extern LexicalAnalyzerContext * createLexicalAnalyzerContext();
+// The current context of the scanner, that is, its start condition (provided by Flex).
+extern unsigned int flexCurrentContext(void);
 
-/**
- * Bison exported functions.
- *
- * @see https://www.gnu.org/software/bison/manual/html_node/Error-Reporting-Function.html
- */
+// The wrapper of "yyrestart" function (provided by Flex).
+extern void flexRestart(FILE * input);
+
+// The scanner (provided by Flex, see "YY_DECL").
+extern Token flexNextToken(void);
+
+// The offset of the current lexeme in the input (provided by Flex).
+extern unsigned int flexLexemeOffset(void);
+
+// The lexeme length in characters (provided by Flex).
+extern int yyleng;
+
+// The line number (provided by Flex).
+extern int yylineno;
+
+// The name of a token (provided by Bison).
+extern const char * bisonTokenName(const Token token);
 
 /**
  * Bison main entry-point.
@@ -33,10 +107,127 @@ extern LexicalAnalyzerContext * createLexicalAnalyzerContext();
  */
 extern int yyparse(void);
 
-// Bison error-reporting function.
-void yyerror(const char * string) {
-	LexicalAnalyzerContext * lexicalAnalyzerContext = createLexicalAnalyzerContext();
-	logError(_logger, "Syntax error (on line %d).", lexicalAnalyzerContext->line);
+/* PRIVATE FUNCTIONS */
+
+static Token _nextArrayToken(union SemanticValue * semanticValue);
+static void * _parseChunk(void * argument);
+static unsigned int _splitChunks(const TokenArray * tokens, ParserChunk * chunks, const unsigned int maximumChunks);
+
+/**
+ * Consumes the next token of the array, and sets its semantic value like
+ * the actions of the scanner. The name of an identifier is a copy of the
+ * interned one, since the semantic action takes its ownership.
+ */
+static Token _nextArrayToken(union SemanticValue * semanticValue) {
+	if (_end <= _position) {
+		return 0;
+	}
+	const unsigned int position = _position++;
+	const Token token = tokenAt(_tokens, position);
+	const int32_t value = _tokens->values[position];
+	switch (token) {
+		case IDENTIFIER:
+			semanticValue->string = strdup(_tokens->names[value]);
+			break;
+		case INTEGER:
+			semanticValue->integer = value;
+			break;
+		case CHARACTER:
+			semanticValue->character = (char) value;
+			break;
+		default:
+			semanticValue->token = token;
+	}
+	return token;
+}
+
+/**
+ * Parses a chunk speculatively, in the current thread.
+ */
+static void * _parseChunk(void * argument) {
+	ParserChunk * chunk = argument;
+	_tokens = chunk->tokens;
+	_position = chunk->begin;
+	_end = chunk->end;
+	_speculative = true;
+	chunk->status = parse(&chunk->compilerState);
+	_speculative = false;
+	_tokens = NULL;
+	return NULL;
+}
+
+/**
+ * Splits the tokens in chunks of about the same size, only after the end of
+ * a top-level declaration: a semicolon, or a closing brace, outside of any
+ * block. Returns the amount of chunks, or zero if the braces are unbalanced.
+ */
+static unsigned int _splitChunks(const TokenArray * tokens, ParserChunk * chunks, const unsigned int maximumChunks) {
+	const uint8_t openBrace = tokenKind(OPEN_BRACE);
+	const uint8_t closeBrace = tokenKind(CLOSE_BRACE);
+	const uint8_t semicolon = tokenKind(SEMICOLON);
+	const unsigned int size = (tokens->count + maximumChunks - 1) / maximumChunks;
+	unsigned int count = 0;
+	unsigned int begin = 0;
+	int depth = 0;
+	for (unsigned int position = 0; position < tokens->count; ++position) {
+		const uint8_t kind = tokens->kinds[position];
+		if (kind == openBrace) {
+			++depth;
+		}
+		else if (kind == closeBrace && --depth < 0) {
+			return 0;
+		}
+		if (depth == 0 && (kind == semicolon || kind == closeBrace) && size <= position + 1 - begin && count + 1 < maximumChunks) {
+			chunks[count++] = (ParserChunk) { .tokens = tokens, .begin = begin, .end = position + 1 };
+			begin = position + 1;
+		}
+	}
+	if (depth != 0) {
+		return 0;
+	}
+	if (begin < tokens->count) {
+		chunks[count++] = (ParserChunk) { .tokens = tokens, .begin = begin, .end = tokens->count };
+	}
+	return count;
+}
+
+/**
+ * Bison lexer, that is, the scanner of Flex, which is timed and counted
+ * while the statistics are enabled; or the next token of an array. The
+ * location of a token is its line.
+ */
+int yylex(union SemanticValue * semanticValue, unsigned int * location) {
+	if (_tokens != NULL) {
+		*location = _position < _end ? _tokens->lines[_position] : (0 < _position ? _tokens->lines[_position - 1] : 1);
+		return _nextArrayToken(semanticValue);
+	}
+	Token token;
+	if (!statisticsEnabled) {
+		token = flexNextToken();
+	}
+	else {
+		const uint64_t start = monotonicTime();
+		token = flexNextToken();
+		addPhaseTime(STATISTICS_LEXING, monotonicTime() - start);
+		if (0 < token) {
+			countNamed(STATISTICS_TOKENS, bisonTokenName(token), 1);
+		}
+	}
+	*semanticValue = yylval;
+	*location = (unsigned int) yylineno;
+	return token;
+}
+
+/**
+ * Bison error-reporting function, with the location of the unexpected token.
+ * When the parser runs out of stack, Bison reports it with this message too,
+ * but it's not a syntax error: "parse" reports the limit instead.
+ */
+void yyerror(unsigned int * location, const char * string) {
+	if (_speculative || strcmp(string, _stackExhaustedMessage) == 0) {
+		return;
+	}
+	logError(_logger, "Syntax error (on line %u).", *location);
 }
 
 /* PUBLIC FUNCTIONS */
@@ -45,6 +236,107 @@ CompilerState * currentCompilerState() {
 	return _currentCompilerState;
 }
 
+int parserStackLimit() {
+	return _parserStackLimit;
+}
+
+void restartSyntacticAnalyzer(FILE * input) {
+	flexRestart(input);
+}
+
+TokenArray * lexTokens() {
+	TokenArray * tokens = createTokenArray();
+	for (Token token = flexNextToken(); 0 < token; token = flexNextToken()) {
+		int32_t value = 0;
+		switch (token) {
+			case IDENTIFIER:
+				value = internName(tokens, yylval.string);
+				free(yylval.string);
+				break;
+			case INTEGER:
+				value = yylval.integer;
+				break;
+			case CHARACTER:
+				value = yylval.character;
+				break;
+		}
+		appendToken(tokens, token, flexLexemeOffset(), (uint32_t) yyleng, (uint32_t) yylineno, value);
+		if (statisticsEnabled) {
+			countNamed(STATISTICS_TOKENS, bisonTokenName(token), 1);
+		}
+	}
+	return tokens;
+}
+
+SyntacticAnalysisStatus parseTokens(CompilerState * compilerState, const TokenArray * tokens) {
+	_tokens = tokens;
+	_position = 0;
+	_end = tokens->count;
+	const SyntacticAnalysisStatus syntacticAnalysisStatus = parse(compilerState);
+	_tokens = NULL;
+	return syntacticAnalysisStatus;
+}
+
+SyntacticAnalysisStatus parseTokensInParallel(CompilerState * compilerState, const TokenArray * tokens) {
+	unsigned int maximumChunks = tokens->count / _minimumChunkTokens;
+	if (_parserThreads < maximumChunks) {
+		maximumChunks = _parserThreads;
+	}
+	// An unterminated comment is reported by the sequential parse.
+	if (maximumChunks < 2 || 0 < flexCurrentContext()) {
+		return parseTokens(compilerState, tokens);
+	}
+	ParserChunk * chunks = calloc(maximumChunks, sizeof(ParserChunk));
+	pthread_t * threads = calloc(maximumChunks, sizeof(pthread_t));
+	boolean * started = calloc(maximumChunks, sizeof(boolean));
+	const unsigned int count = _splitChunks(tokens, chunks, maximumChunks);
+	logDebugging(_logger, "Parsing %u tokens in %u chunks...", tokens->count, count);
+	for (unsigned int k = 1; k < count; ++k) {
+		started[k] = pthread_create(&threads[k], NULL, _parseChunk, &chunks[k]) == 0;
+	}
+	for (unsigned int k = 0; k < count; ++k) {
+		if (k == 0 || !started[k]) {
+			_parseChunk(&chunks[k]);
+		}
+		else {
+			pthread_join(threads[k], NULL);
+		}
+	}
+	boolean accepted = 0 < count;
+	for (unsigned int k = 0; k < count; ++k) {
+		accepted = accepted && chunks[k].status == ACCEPT;
+	}
+
+	// Merges the declarations of the chunks in order, and releases the rest.
+	SyntacticAnalysisStatus syntacticAnalysisStatus;
+	if (accepted) {
+		Program * program = chunks[0].compilerState.abstractSyntaxtTree;
+		DeclarationList * last = program->declarationList;
+		for (unsigned int k = 1; k < count; ++k) {
+			Program * chunkProgram = chunks[k].compilerState.abstractSyntaxtTree;
+			while (last->next != NULL) {
+				last = last->next;
+			}
+			last->next = chunkProgram->declarationList;
+			free(chunkProgram);
+		}
+		compilerState->abstractSyntaxtTree = program;
+		compilerState->succeed = true;
+		syntacticAnalysisStatus = ACCEPT;
+	}
+	else {
+		for (unsigned int k = 0; k < count; ++k) {
+			freeProgram(chunks[k].compilerState.abstractSyntaxtTree);
+		}
+		logDebugging(_logger, "A chunk was rejected, so the tokens are parsed sequentially.");
+		syntacticAnalysisStatus = parseTokens(compilerState, tokens);
+	}
+	free(started);
+	free(threads);
+	free(chunks);
+	return syntacticAnalysisStatus;
+}
+
 SyntacticAnalysisStatus parse(CompilerState * compilerState) {
 	logDebugging(_logger, "Parsing...");
 	_currentCompilerState = compilerState;
@@ -64,7 +356,9 @@ SyntacticAnalysisStatus parse(CompilerState * compilerState) {
 			syntacticAnalysisStatus = REJECT;
 			break;
 		case 2:
-			logError(_logger, "Bison ran out of memory.");
+			if (!_speculative) {
+				logError(_logger, "Bison ran out of memory (the program is nested deeper than the parser stack limit: %d).", _parserStackLimit);
+			}
 			syntacticAnalysisStatus = OUT_OF_MEMORY;
 			break;
 		default:
@@ -2,12 +2,17 @@
 #define SYNTACTIC_ANALYZER_HEADER
 
 #include "../../shared/CompilerState.h"
+#include "../../shared/Environment.h"
 #include "../../shared/Logger.h"
+#include "../../shared/Statistics.h"
+#include "../lexical-analysis/TokenArray.h"
+#include <stdio.h>
 
-/** Bison imported functions. */
+/** Bison imported functions (of a pure parser, with locations). */
 
-int yylex(void);
-void yyerror(const char * string);
+union SemanticValue;
+int yylex(union SemanticValue * semanticValue, unsigned int * location);
+void yyerror(unsigned int * location, const char * string);
 
 /** Initialize module's internal state. */
 void initializeSyntacticAnalyzerModule();
@@ -29,6 +34,40 @@ typedef enum {
  */
 CompilerState * currentCompilerState();
 
+/**
+ * The maximum depth of the parser stack, from the "PARSER_STACK_LIMIT"
+ * environment variable. A program nested deeper than the limit is rejected.
+ */
+int parserStackLimit();
+
+/**
+ * Makes the next parse read from the specified input (instead of the
+ * standard input), from its first line.
+ */
+void restartSyntacticAnalyzer(FILE * input);
+
+/**
+ * Lexes the whole input of the scanner at once, into a token array (instead
+ * of on demand of the parser). The tokens are counted in the statistics, if
+ * they're enabled.
+ */
+TokenArray * lexTokens();
+
+/**
+ * Executes the parsing phase of the compiler over the tokens of an array,
+ * which is not modified, so it can be parsed again.
+ */
+SyntacticAnalysisStatus parseTokens(CompilerState * compilerState, const TokenArray * tokens);
+
+/**
+ * Executes the parsing phase of the compiler over the tokens of an array,
+ * splitting them in chunks of top-level declarations, which are parsed in
+ * parallel (see "PARSER_THREADS") and then merged in a single program. If a
+ * chunk is rejected, the whole array is parsed again sequentially, to report
+ * the errors as usual.
+ */
+SyntacticAnalysisStatus parseTokensInParallel(CompilerState * compilerState, const TokenArray * tokens);
+
 /**
  * Executes the parsing phase of the compiler.
  */
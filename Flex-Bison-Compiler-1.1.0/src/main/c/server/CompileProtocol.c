@@ -0,0 +1,157 @@
+#define _GNU_SOURCE
+#include "CompileProtocol.h"
+
+/* PUBLIC FUNCTIONS */
+
+boolean compileSocketAddress(struct sockaddr_un * address, const char * path) {
+	memset(address, 0, sizeof(struct sockaddr_un));
+	address->sun_family = AF_UNIX;
+	if (sizeof(address->sun_path) <= strlen(path)) {
+		return false;
+	}
+	strcpy(address->sun_path, path);
+	return true;
+}
+
+const char * compileSocketPath(char * buffer, const size_t size) {
+	const char * path = getStringOrDefault("COMPILER_SOCKET", NULL);
+	if (path != NULL) {
+		return path;
+	}
+	const char * runtime = getStringOrDefault("XDG_RUNTIME_DIR", "");
+	int length = 0;
+	if (runtime[0] != '\0') {
+		length = snprintf(buffer, size, "%s/" COMPILE_PROTOCOL_SOCKET_NAME, runtime);
+		return (length < 0 || size <= (size_t) length) ? NULL : buffer;
+	}
+	length = snprintf(buffer, size, "/tmp/Compiler-%u", (unsigned int) geteuid());
+	if (length < 0 || size <= (size_t) length) {
+		return NULL;
+	}
+	// The directory of another user (or a link to it) is never trusted.
+	struct stat status;
+	if ((mkdir(buffer, S_IRWXU) != 0 && errno != EEXIST) || lstat(buffer, &status) != 0 || !S_ISDIR(status.st_mode)
+			|| status.st_uid != geteuid() || (status.st_mode & (S_IRWXG | S_IRWXO)) != 0) {
+		return NULL;
+	}
+	const int name = snprintf(buffer + length, size - (size_t) length, "/" COMPILE_PROTOCOL_SOCKET_NAME);
+	return (name < 0 || size - (size_t) length <= (size_t) name) ? NULL : buffer;
+}
+
+boolean samePeerUser(const int connection) {
+	struct ucred credentials;
+	socklen_t length = sizeof(credentials);
+	return getsockopt(connection, SOL_SOCKET, SO_PEERCRED, &credentials, &length) == 0 && credentials.uid == geteuid();
+}
+
+boolean readFully(const int descriptor, void * buffer, const size_t size) {
+	size_t done = 0;
+	while (done < size) {
+		const ssize_t count = read(descriptor, (char *) buffer + done, size - done);
+		if (count == 0 || (count < 0 && errno != EINTR)) {
+			return false;
+		}
+		if (0 < count) {
+			done += (size_t) count;
+		}
+	}
+	return true;
+}
+
+boolean writeFully(const int descriptor, const void * buffer, const size_t size) {
+	size_t done = 0;
+	while (done < size) {
+		const ssize_t count = write(descriptor, (const char *) buffer + done, size - done);
+		if (count < 0 && errno != EINTR) {
+			return false;
+		}
+		if (0 < count) {
+			done += (size_t) count;
+		}
+	}
+	return true;
+}
+
+boolean writeProtocolString(const int descriptor, const char * string) {
+	const uint32_t length = (uint32_t) strlen(string);
+	return writeFully(descriptor, &length, sizeof(length)) && writeFully(descriptor, string, length);
+}
+
+char * readProtocolString(const int descriptor) {
+	uint32_t length = 0;
+	if (!readFully(descriptor, &length, sizeof(length)) || COMPILE_PROTOCOL_MAXIMUM_STRING_LENGTH < length) {
+		return NULL;
+	}
+	char * string = calloc(1 + length, sizeof(char));
+	if (!readFully(descriptor, string, length)) {
+		free(string);
+		return NULL;
+	}
+	return string;
+}
+
+boolean sendCompileRequest(const int descriptor, const CompileRequest * request, const int descriptors[COMPILE_PROTOCOL_DESCRIPTORS]) {
+	union {
+		char buffer[CMSG_SPACE(COMPILE_PROTOCOL_DESCRIPTORS * sizeof(int))];
+		struct cmsghdr alignment;
+	} control;
+	memset(&control, 0, sizeof(control));
+	struct iovec vector = { .iov_base = (void *) request, .iov_len = sizeof(CompileRequest) };
+	struct msghdr message = {
+		.msg_iov = &vector,
+		.msg_iovlen = 1,
+		.msg_control = control.buffer,
+		.msg_controllen = sizeof(control.buffer)
+	};
+	struct cmsghdr * header = CMSG_FIRSTHDR(&message);
+	header->cmsg_level = SOL_SOCKET;
+	header->cmsg_type = SCM_RIGHTS;
+	header->cmsg_len = CMSG_LEN(COMPILE_PROTOCOL_DESCRIPTORS * sizeof(int));
+	memcpy(CMSG_DATA(header), descriptors, COMPILE_PROTOCOL_DESCRIPTORS * sizeof(int));
+	ssize_t count;
+	do {
+		count = sendmsg(descriptor, &message, 0);
+	} while (count < 0 && errno == EINTR);
+	// The descriptors travel with the first byte, so the rest is plain data.
+	return 0 < count && writeFully(descriptor, (const char *) request + count, sizeof(CompileRequest) - (size_t) count);
+}
+
+boolean receiveCompileRequest(const int descriptor, CompileRequest * request, int descriptors[COMPILE_PROTOCOL_DESCRIPTORS]) {
+	union {
+		char buffer[CMSG_SPACE(COMPILE_PROTOCOL_DESCRIPTORS * sizeof(int))];
+		struct cmsghdr alignment;
+	} control;
+	memset(&control, 0, sizeof(control));
+	struct iovec vector = { .iov_base = request, .iov_len = sizeof(CompileRequest) };
+	struct msghdr message = {
+		.msg_iov = &vector,
+		.msg_iovlen = 1,
+		.msg_control = control.buffer,
+		.msg_controllen = sizeof(control.buffer)
+	};
+	ssize_t count;
+	do {
+		count = recvmsg(descriptor, &message, 0);
+	} while (count < 0 && errno == EINTR);
+	for (int k = 0; k < COMPILE_PROTOCOL_DESCRIPTORS; ++k) {
+		descriptors[k] = -1;
+	}
+	struct cmsghdr * header = CMSG_FIRSTHDR(&message);
+	if (0 < count && header != NULL && header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS
+			&& header->cmsg_len == CMSG_LEN(COMPILE_PROTOCOL_DESCRIPTORS * sizeof(int))) {
+		memcpy(descriptors, CMSG_DATA(header), COMPILE_PROTOCOL_DESCRIPTORS * sizeof(int));
+	}
+	else if (header != NULL && header->cmsg_type == SCM_RIGHTS) {
+		// Unexpected descriptors are closed, so they don't leak.
+		const size_t received = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+		for (size_t k = 0; k < received; ++k) {
+			close(((int *) CMSG_DATA(header))[k]);
+		}
+		return false;
+	}
+	if (count <= 0 || descriptors[0] < 0) {
+		return false;
+	}
+	return readFully(descriptor, (char *) request + count, sizeof(CompileRequest) - (size_t) count)
+		&& request->magic == COMPILE_PROTOCOL_MAGIC && request->version == COMPILE_PROTOCOL_VERSION;
+}
@@ -0,0 +1,101 @@
+#ifndef COMPILE_PROTOCOL_HEADER
+#define COMPILE_PROTOCOL_HEADER
+
+#include "../shared/Environment.h"
+#include "../shared/Type.h"
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/**
+ * The messages between the compile server and its clients, over a Unix
+ * domain socket. The client sends a request header, together with its
+ * standard input, output and error descriptors (as ancillary data), so the
+ * server reads the source and writes the output and the diagnostics
+ * directly:
+ *
+ *	CompileRequest	then "strings" strings: the working directory, the
+ *			arguments and the environment (as "NAME=VALUE").
+ *
+ * The server answers with a CompileResponse once the compilation ends.
+ */
+
+#define COMPILE_PROTOCOL_MAGIC 0x4D474343u
+#define COMPILE_PROTOCOL_VERSION 1u
+
+// The upper bounds of a request, to reject malformed ones.
+#define COMPILE_PROTOCOL_MAXIMUM_STRINGS 65536u
+#define COMPILE_PROTOCOL_MAXIMUM_STRING_LENGTH (1u << 20)
+
+// The descriptors sent with a request: input, output and error.
+#define COMPILE_PROTOCOL_DESCRIPTORS 3
+
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t argumentCount;
+	uint32_t environmentCount;
+} CompileRequest;
+
+typedef struct {
+	uint32_t magic;
+	int32_t status;
+} CompileResponse;
+
+/**
+ * The name of the socket in its default directory.
+ */
+#define COMPILE_PROTOCOL_SOCKET_NAME "Compiler.socket"
+
+/**
+ * Fills the address of a socket path, and returns false if it's too long.
+ */
+boolean compileSocketAddress(struct sockaddr_un * address, const char * path);
+
+/**
+ * The path of the socket: "COMPILER_SOCKET", if it's defined, or else the
+ * socket in the runtime directory of the user ("XDG_RUNTIME_DIR"), or in
+ * "/tmp/Compiler-<uid>", which is created with mode 0700. The path is
+ * written in the buffer, unless it's the variable. Returns NULL if it
+ * doesn't fit, or if that directory is not private to the user (e.g.,
+ * because another one created it first).
+ */
+const char * compileSocketPath(char * buffer, const size_t size);
+
+/**
+ * Checks that the process at the other end of a connection runs as the same
+ * user as this one (with "SO_PEERCRED"), since the requests carry the
+ * environment and the standard descriptors of the client.
+ */
+boolean samePeerUser(const int connection);
+
+/**
+ * Reads or writes exactly "size" bytes, retrying on interruptions and short
+ * transfers. Return false on failure (or on a premature end of the input).
+ */
+boolean readFully(const int descriptor, void * buffer, const size_t size);
+boolean writeFully(const int descriptor, const void * buffer, const size_t size);
+
+/**
+ * Sends a string prefixed by its 32-bit length, or receives it (in
+ * heap-memory, or NULL on failure).
+ */
+boolean writeProtocolString(const int descriptor, const char * string);
+char * readProtocolString(const int descriptor);
+
+/**
+ * Sends the request header together with the descriptors, or receives them
+ * (the received descriptors must be closed by the caller).
+ */
+boolean sendCompileRequest(const int descriptor, const CompileRequest * request, const int descriptors[COMPILE_PROTOCOL_DESCRIPTORS]);
+boolean receiveCompileRequest(const int descriptor, CompileRequest * request, int descriptors[COMPILE_PROTOCOL_DESCRIPTORS]);
+
+#endif
@@ -0,0 +1,288 @@
+#include "CompileServer.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+/**
+ * The amount of requests a worker serves before it's replaced by a new one,
+ * which bounds the memory that a long-lived worker can leak.
+ */
+static const unsigned int _maximumRequestsPerWorker = 1000;
+
+// Set by the signal handler of the server, to stop it.
+static volatile sig_atomic_t _stopping = 0;
+
+/**
+ * The environment of a worker, owned by it (the variables point to these
+ * strings once applied).
+ */
+typedef struct {
+	char ** variables;
+	unsigned int count;
+} Environment;
+
+void initializeCompileServerModule() {
+	_logger = createLogger("CompileServer");
+}
+
+void shutdownCompileServerModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static void _applyEnvironment(Environment * current, char ** variables, const unsigned int count);
+static boolean _bindSocket(const char * path, int * listener);
+static void _handleRequest(const int connection, const CompilerHooks * hooks, Environment * environment, const int savedDescriptors[COMPILE_PROTOCOL_DESCRIPTORS]);
+static void _onSignal(int signal);
+static boolean _sameEnvironment(const Environment * current, char ** variables, const unsigned int count);
+static void _serveWorker(const int listener, const CompilerHooks * hooks);
+static pid_t _spawnWorker(const int listener, const CompilerHooks * hooks);
+
+/**
+ * Replaces the whole environment of the process. The strings of the
+ * previous one are released (the process stops referencing them first).
+ */
+static void _applyEnvironment(Environment * current, char ** variables, const unsigned int count) {
+	clearenv();
+	for (unsigned int k = 0; k < current->count; ++k) {
+		free(current->variables[k]);
+	}
+	free(current->variables);
+	current->variables = variables;
+	current->count = count;
+	for (unsigned int k = 0; k < count; ++k) {
+		putenv(variables[k]);
+	}
+}
+
+/**
+ * Creates the listening socket, which only its user can connect to. A stale
+ * socket file is replaced, but not the socket of a running server.
+ */
+static boolean _bindSocket(const char * path, int * listener) {
+	struct sockaddr_un address;
+	if (path == NULL) {
+		logError(_logger, "There is no private directory for the socket (see \"XDG_RUNTIME_DIR\" and \"COMPILER_SOCKET\").");
+		return false;
+	}
+	if (!compileSocketAddress(&address, path)) {
+		logError(_logger, "The socket path is too long: \"%s\"", path);
+		return false;
+	}
+	*listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (*listener < 0) {
+		logError(_logger, "Cannot create a socket: %s", strerror(errno));
+		return false;
+	}
+	if (connect(*listener, (struct sockaddr *) &address, sizeof(address)) == 0) {
+		logError(_logger, "Another server is already listening on \"%s\".", path);
+		close(*listener);
+		return false;
+	}
+	close(*listener);
+	unlink(path);
+	*listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (*listener < 0
+			|| bind(*listener, (struct sockaddr *) &address, sizeof(address)) != 0
+			|| chmod(path, S_IRUSR | S_IWUSR) != 0
+			|| listen(*listener, SOMAXCONN) != 0) {
+		logError(_logger, "Cannot listen on \"%s\": %s", path, strerror(errno));
+		if (0 <= *listener) {
+			close(*listener);
+		}
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Serves a single request: it reads the options, switches to the directory,
+ * environment and descriptors of the client, compiles, restores its own
+ * descriptors, and answers with the status.
+ */
+static void _handleRequest(const int connection, const CompilerHooks * hooks, Environment * environment, const int savedDescriptors[COMPILE_PROTOCOL_DESCRIPTORS]) {
+	CompileRequest request;
+	int descriptors[COMPILE_PROTOCOL_DESCRIPTORS];
+	const boolean received = receiveCompileRequest(connection, &request, descriptors);
+	const unsigned int stringCount = received ? 1 + request.argumentCount + request.environmentCount : 0;
+	char ** strings = NULL;
+	boolean valid = received && stringCount <= COMPILE_PROTOCOL_MAXIMUM_STRINGS;
+	if (valid) {
+		strings = calloc(stringCount, sizeof(char *));
+		for (unsigned int k = 0; valid && k < stringCount; ++k) {
+			strings[k] = readProtocolString(connection);
+			valid = strings[k] != NULL;
+		}
+	}
+	CompileResponse response = { .magic = COMPILE_PROTOCOL_MAGIC, .status = FAILED };
+	if (valid && chdir(strings[0]) != 0) {
+		logError(_logger, "Cannot change to the directory of the client \"%s\": %s", strings[0], strerror(errno));
+		valid = false;
+	}
+	if (valid) {
+		const unsigned int argumentCount = request.argumentCount;
+		char ** variables = strings + 1 + argumentCount;
+		if (!_sameEnvironment(environment, variables, request.environmentCount)) {
+			char ** owned = calloc(request.environmentCount == 0 ? 1 : request.environmentCount, sizeof(char *));
+			memcpy(owned, variables, request.environmentCount * sizeof(char *));
+			memset(variables, 0, request.environmentCount * sizeof(char *));
+			hooks->shutdown();
+			_applyEnvironment(environment, owned, request.environmentCount);
+			hooks->initialize();
+		}
+		FILE * input = fdopen(descriptors[0], "r");
+		descriptors[0] = -1;
+		fflush(stdout);
+		fflush(stderr);
+		dup2(descriptors[1], STDOUT_FILENO);
+		dup2(descriptors[2], STDERR_FILENO);
+		restartSyntacticAnalyzer(input);
+		response.status = hooks->compile((int) argumentCount, (const char **) (strings + 1));
+		fflush(stdout);
+		fflush(stderr);
+		dup2(savedDescriptors[1], STDOUT_FILENO);
+		dup2(savedDescriptors[2], STDERR_FILENO);
+		fclose(input);
+	}
+	if (received) {
+		writeFully(connection, &response, sizeof(response));
+	}
+	for (int k = 0; k < COMPILE_PROTOCOL_DESCRIPTORS; ++k) {
+		if (0 <= descriptors[k]) {
+			close(descriptors[k]);
+		}
+	}
+	for (unsigned int k = 0; strings != NULL && k < stringCount; ++k) {
+		free(strings[k]);
+	}
+	free(strings);
+}
+
+static void _onSignal(int signal) {
+	(void) signal;
+	_stopping = 1;
+}
+
+static boolean _sameEnvironment(const Environment * current, char ** variables, const unsigned int count) {
+	if (current->variables == NULL || current->count != count) {
+		return false;
+	}
+	for (unsigned int k = 0; k < count; ++k) {
+		if (strcmp(current->variables[k], variables[k]) != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * The loop of a worker, which never returns.
+ */
+static void _serveWorker(const int listener, const CompilerHooks * hooks) {
+	signal(SIGINT, SIG_DFL);
+	signal(SIGTERM, SIG_DFL);
+	// A client that goes away must not kill the worker.
+	signal(SIGPIPE, SIG_IGN);
+	const int savedDescriptors[COMPILE_PROTOCOL_DESCRIPTORS] = { dup(STDIN_FILENO), dup(STDOUT_FILENO), dup(STDERR_FILENO) };
+	Environment environment = { .variables = NULL, .count = 0 };
+	for (unsigned int served = 0; served < _maximumRequestsPerWorker; ) {
+		const int connection = accept(listener, NULL, NULL);
+		if (connection < 0) {
+			if (errno == EINTR || errno == ECONNABORTED) {
+				continue;
+			}
+			logError(_logger, "Cannot accept a connection: %s", strerror(errno));
+			break;
+		}
+		if (!samePeerUser(connection)) {
+			logError(_logger, "A connection from another user is refused.");
+			close(connection);
+			continue;
+		}
+		_handleRequest(connection, hooks, &environment, savedDescriptors);
+		close(connection);
+		++served;
+	}
+	_exit(0);
+}
+
+static pid_t _spawnWorker(const int listener, const CompilerHooks * hooks) {
+	const pid_t pid = fork();
+	if (pid == 0) {
+		_serveWorker(listener, hooks);
+	}
+	else if (pid < 0) {
+		logError(_logger, "Cannot start a worker: %s", strerror(errno));
+	}
+	return pid;
+}
+
+/* PUBLIC FUNCTIONS */
+
+CompilationStatus serveCompileRequests(const char * path, const unsigned int workers, const CompilerHooks * hooks) {
+	int listener = -1;
+	if (!_bindSocket(path, &listener)) {
+		return FAILED;
+	}
+	const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+	const unsigned int workerCount = 0 < workers ? workers : (0 < processors ? (unsigned int) processors : 1);
+	// The handler doesn't restart "waitpid", so the loop sees the flag.
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = _onSignal;
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+	fflush(stdout);
+	fflush(stderr);
+	pid_t * pids = calloc(workerCount, sizeof(pid_t));
+	for (unsigned int k = 0; k < workerCount; ++k) {
+		pids[k] = _spawnWorker(listener, hooks);
+	}
+	logInformation(_logger, "Serving on \"%s\" with %u workers.", path, workerCount);
+	fflush(stdout);
+	while (!_stopping) {
+		int status = 0;
+		const pid_t pid = waitpid(-1, &status, 0);
+		if (pid < 0 && errno == ECHILD) {
+			// Every worker failed to start, so it retries a bit later.
+			sleep(1);
+			for (unsigned int k = 0; k < workerCount; ++k) {
+				if (pids[k] <= 0) {
+					pids[k] = _spawnWorker(listener, hooks);
+				}
+			}
+		}
+		if (pid <= 0 || _stopping) {
+			continue;
+		}
+		if (WIFSIGNALED(status)) {
+			logError(_logger, "A worker was terminated by signal %d.", WTERMSIG(status));
+		}
+		fflush(stdout);
+		fflush(stderr);
+		for (unsigned int k = 0; k < workerCount; ++k) {
+			if (pids[k] == pid) {
+				pids[k] = _spawnWorker(listener, hooks);
+			}
+		}
+	}
+	for (unsigned int k = 0; k < workerCount; ++k) {
+		if (0 < pids[k]) {
+			kill(pids[k], SIGTERM);
+		}
+	}
+	for (unsigned int k = 0; k < workerCount; ++k) {
+		if (0 < pids[k]) {
+			waitpid(pids[k], NULL, 0);
+		}
+	}
+	free(pids);
+	close(listener);
+	unlink(path);
+	logInformation(_logger, "The server is stopped.");
+	return SUCCEED;
+}
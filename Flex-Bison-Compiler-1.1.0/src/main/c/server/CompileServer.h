@@ -0,0 +1,52 @@
+#ifndef COMPILE_SERVER_HEADER
+#define COMPILE_SERVER_HEADER
+
+#include "../shared/CompilerState.h"
+#include "../shared/Logger.h"
+#include "../shared/Type.h"
+#include "../frontend/syntactic-analysis/SyntacticAnalyzer.h"
+#include "CompileProtocol.h"
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * The hooks of the compiler that the server runs for each request. The
+ * modules are initialized once per worker, and only initialized again when
+ * a request comes with a different environment (since the modules read
+ * their configuration from it).
+ */
+typedef struct {
+	void (* initialize)(void);
+	void (* shutdown)(void);
+	CompilationStatus (* compile)(const int count, const char ** arguments);
+} CompilerHooks;
+
+/** Initialize module's internal state. */
+void initializeCompileServerModule();
+
+/** Shutdown module's internal state. */
+void shutdownCompileServerModule();
+
+/**
+ * Serves compile requests on a Unix domain socket until the process
+ * receives SIGINT or SIGTERM. The requests are handled by a pool of
+ * pre-forked workers (one per online processor if "workers" is zero), which
+ * accept connections from the same socket and compile one request at a
+ * time, with the standard descriptors of the client. Only the clients of the
+ * same user are served. The compiler modules must be initialized, so every
+ * worker inherits them already warm.
+ *
+ * Returns FAILED if the socket cannot be created (or if there's no path, see
+ * "compileSocketPath").
+ */
+CompilationStatus serveCompileRequests(const char * path, const unsigned int workers, const CompilerHooks * hooks);
+
+#endif
@@ -0,0 +1,124 @@
+#include "../shared/CompilerState.h"
+#include "../shared/Environment.h"
+#include "../shared/Logger.h"
+#include "CompileProtocol.h"
+#include <limits.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* MODULE INTERNAL STATE */
+
+extern char ** environ;
+
+static Logger * _logger = NULL;
+
+/* PRIVATE FUNCTIONS */
+
+static int _connect(const char * path);
+static CompilationStatus _fallBack(const char ** arguments);
+static CompilationStatus _request(const int connection, const int count, const char ** arguments);
+
+/**
+ * Connects to the server, or returns -1 if it's not running. A server of
+ * another user is never trusted with the descriptors of the client.
+ */
+static int _connect(const char * path) {
+	struct sockaddr_un address;
+	if (path == NULL || !compileSocketAddress(&address, path)) {
+		return -1;
+	}
+	const int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (0 <= connection && connect(connection, (struct sockaddr *) &address, sizeof(address)) != 0) {
+		close(connection);
+		return -1;
+	}
+	if (0 <= connection && !samePeerUser(connection)) {
+		logError(_logger, "The compile server on \"%s\" runs as another user, so it's not used.", path);
+		close(connection);
+		return -1;
+	}
+	return connection;
+}
+
+/**
+ * Without a server, the client becomes the compiler that lives next to it,
+ * so it's always a drop-in replacement.
+ */
+static CompilationStatus _fallBack(const char ** arguments) {
+	char path[PATH_MAX];
+	const ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+	if (0 < length) {
+		path[length] = '\0';
+		char * separator = strrchr(path, '/');
+		if (separator != NULL && (size_t) (separator - path) + sizeof("/Compiler") <= sizeof(path)) {
+			strcpy(separator, "/Compiler");
+			logDebugging(_logger, "The compile server is not running, so \"%s\" is executed instead.", path);
+			execv(path, (char * const *) arguments);
+		}
+	}
+	logError(_logger, "The compile server is not running, and the compiler cannot be executed.");
+	return FAILED;
+}
+
+/**
+ * Sends the request with the standard descriptors of this process, and
+ * waits for the status of the compilation.
+ */
+static CompilationStatus _request(const int connection, const int count, const char ** arguments) {
+	char directory[PATH_MAX];
+	if (getcwd(directory, sizeof(directory)) == NULL) {
+		logError(_logger, "Cannot get the working directory: %s", strerror(errno));
+		return FAILED;
+	}
+	unsigned int environmentCount = 0;
+	while (environ[environmentCount] != NULL) {
+		++environmentCount;
+	}
+	const CompileRequest request = {
+		.magic = COMPILE_PROTOCOL_MAGIC,
+		.version = COMPILE_PROTOCOL_VERSION,
+		.argumentCount = (uint32_t) count,
+		.environmentCount = environmentCount
+	};
+	const int descriptors[COMPILE_PROTOCOL_DESCRIPTORS] = { STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO };
+	boolean sent = sendCompileRequest(connection, &request, descriptors) && writeProtocolString(connection, directory);
+	for (int k = 0; sent && k < count; ++k) {
+		sent = writeProtocolString(connection, arguments[k]);
+	}
+	for (unsigned int k = 0; sent && k < environmentCount; ++k) {
+		sent = writeProtocolString(connection, environ[k]);
+	}
+	CompileResponse response;
+	if (!sent || !readFully(connection, &response, sizeof(response)) || response.magic != COMPILE_PROTOCOL_MAGIC) {
+		logError(_logger, "The compile server closed the connection before answering.");
+		return FAILED;
+	}
+	return response.status == SUCCEED ? SUCCEED : FAILED;
+}
+
+/* PUBLIC FUNCTIONS */
+
+/**
+ * A thin client of the compile server, with the same interface as the
+ * compiler: it compiles the standard input into the standard output, with
+ * the current arguments and environment.
+ */
+int main(const int count, const char ** arguments) {
+	_logger = createLogger("CompilerClient");
+	signal(SIGPIPE, SIG_IGN);
+	char path[PATH_MAX];
+	const int connection = _connect(compileSocketPath(path, sizeof(path)));
+	CompilationStatus compilationStatus;
+	if (connection < 0) {
+		compilationStatus = _fallBack(arguments);
+	}
+	else {
+		compilationStatus = _request(connection, count, arguments);
+		close(connection);
+	}
+	destroyLogger(_logger);
+	return compilationStatus;
+}
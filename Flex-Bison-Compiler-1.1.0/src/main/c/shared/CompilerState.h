@@ -22,6 +22,11 @@ typedef struct {
 	// A flag that indicates the current state of the compilation so far.
 	boolean succeed;
 
+	// When defined, the parser hands each top-level declaration to this
+	// consumer as soon as it's reduced, and then releases it, instead of
+	// appending it to the AST (see "--streaming").
+	void (*declarationConsumer)(void * declaration);
+
 	// TODO: Add an stack to handle nested scopes.
 	// TODO: Add a symbol table.
 	// TODO: Add configuration.
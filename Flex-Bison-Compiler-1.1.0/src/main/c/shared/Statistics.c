@@ -0,0 +1,231 @@
+#include "Statistics.h"
+
+/* MODULE INTERNAL STATE */
+
+boolean statisticsEnabled = false;
+
+/**
+ * The capacity of each group of named counters (an open-addressing table,
+ * indexed by the address of the name).
+ */
+#define STATISTICS_GROUP_CAPACITY 256
+
+typedef struct {
+	const char * name;
+	unsigned long amount;
+} NamedCounter;
+
+static const char * _phaseNames[STATISTICS_PHASE_COUNT] = { "lexing", "parsing", "generation", "release" };
+static const char * _groupNames[STATISTICS_GROUP_COUNT] = { "tokens", "astNodes", "peepholeRules", "boundsChecks", "functionCache", "deadDeclarations", "partialEvaluation", "specialization", "instructionSelection" };
+
+/**
+ * The suffix removed from the names of a group, if any (the nodes are
+ * counted by the semantic action that builds them).
+ */
+static const char * _groupSuffixes[STATISTICS_GROUP_COUNT] = { NULL, "SemanticAction", NULL, NULL, NULL, NULL, NULL, NULL, NULL };
+
+static uint64_t _phases[STATISTICS_PHASE_COUNT];
+static NamedCounter _groups[STATISTICS_GROUP_COUNT][STATISTICS_GROUP_CAPACITY];
+static unsigned long _symbolLookups = 0;
+static unsigned long _symbolProbes = 0;
+static unsigned long _symbolDeclarations = 0;
+static unsigned int _parserDepth = 0;
+
+static unsigned long _allocations = 0;
+static unsigned long _reallocations = 0;
+static unsigned long _releases = 0;
+static unsigned long _allocatedBytes = 0;
+
+void initializeStatisticsModule() {
+	statisticsEnabled = false;
+}
+
+void shutdownStatisticsModule() {
+	statisticsEnabled = false;
+}
+
+/* PRIVATE FUNCTIONS */
+
+static int _compareCounters(const void * left, const void * right);
+static void _writeGroup(FILE * stream, const StatisticsGroup group);
+
+static int _compareCounters(const void * left, const void * right) {
+	const NamedCounter * a = left;
+	const NamedCounter * b = right;
+	if (a->name == NULL || b->name == NULL) {
+		return (a->name == NULL) - (b->name == NULL);
+	}
+	return strcmp(a->name, b->name);
+}
+
+/**
+ * Writes a group of named counters (sorted by name), with their total.
+ */
+static void _writeGroup(FILE * stream, const StatisticsGroup group) {
+	NamedCounter counters[STATISTICS_GROUP_CAPACITY];
+	memcpy(counters, _groups[group], sizeof(counters));
+	qsort(counters, STATISTICS_GROUP_CAPACITY, sizeof(NamedCounter), _compareCounters);
+	const char * suffix = _groupSuffixes[group];
+	unsigned long total = 0;
+	fprintf(stream, "\t\"%s\": {\n\t\t\"counts\": {", _groupNames[group]);
+	for (int k = 0; k < STATISTICS_GROUP_CAPACITY && counters[k].name != NULL; ++k) {
+		const char * name = counters[k].name;
+		int length = (int) strlen(name);
+		if (suffix != NULL && strlen(suffix) < (size_t) length && strcmp(name + length - strlen(suffix), suffix) == 0) {
+			length -= (int) strlen(suffix);
+		}
+		fprintf(stream, "%s\n\t\t\t\"%.*s\": %lu", k == 0 ? "" : ",", length, name, counters[k].amount);
+		total += counters[k].amount;
+	}
+	fprintf(stream, "\n\t\t},\n\t\t\"total\": %lu\n\t},\n", total);
+}
+
+/* PUBLIC FUNCTIONS */
+
+void startStatistics() {
+	memset(_phases, 0, sizeof(_phases));
+	memset(_groups, 0, sizeof(_groups));
+	_symbolLookups = 0;
+	_symbolProbes = 0;
+	_symbolDeclarations = 0;
+	_parserDepth = 0;
+	_allocations = 0;
+	_reallocations = 0;
+	_releases = 0;
+	_allocatedBytes = 0;
+	statisticsEnabled = true;
+}
+
+void stopStatistics() {
+	statisticsEnabled = false;
+}
+
+uint64_t monotonicTime() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+}
+
+void addPhaseTime(const StatisticsPhase phase, const uint64_t nanoseconds) {
+	_phases[phase] += nanoseconds;
+}
+
+void countNamed(const StatisticsGroup group, const char * name, const unsigned long amount) {
+	NamedCounter * counters = _groups[group];
+	unsigned int index = (unsigned int) (((uintptr_t) name >> 3) * 2654435761u) % STATISTICS_GROUP_CAPACITY;
+	for (int k = 0; k < STATISTICS_GROUP_CAPACITY; ++k) {
+		NamedCounter * counter = &counters[index];
+		const char * expected = __atomic_load_n(&counter->name, __ATOMIC_RELAXED);
+		if (expected == NULL && __atomic_compare_exchange_n(&counter->name, &expected, name, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+			expected = name;
+		}
+		if (expected == name) {
+			__atomic_fetch_add(&counter->amount, amount, __ATOMIC_RELAXED);
+			return;
+		}
+		index = (index + 1) % STATISTICS_GROUP_CAPACITY;
+	}
+}
+
+void countSymbolLookup(const unsigned int probes) {
+	__atomic_fetch_add(&_symbolLookups, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&_symbolProbes, probes, __ATOMIC_RELAXED);
+}
+
+void countSymbolDeclaration() {
+	__atomic_fetch_add(&_symbolDeclarations, 1, __ATOMIC_RELAXED);
+}
+
+void recordParserDepth(const unsigned int depth) {
+	unsigned int current = __atomic_load_n(&_parserDepth, __ATOMIC_RELAXED);
+	while (current < depth && !__atomic_compare_exchange_n(&_parserDepth, &current, depth, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+	}
+}
+
+void writeStatistics(FILE * stream) {
+	const uint64_t parsing = _phases[STATISTICS_PARSING] - _phases[STATISTICS_LEXING];
+	uint64_t total = parsing;
+	fprintf(stream, "{\n\t\"phasesNanoseconds\": {\n");
+	for (int phase = 0; phase < STATISTICS_PHASE_COUNT; ++phase) {
+		const uint64_t time = phase == STATISTICS_PARSING ? parsing : _phases[phase];
+		if (phase != STATISTICS_PARSING) {
+			total += time;
+		}
+		fprintf(stream, "\t\t\"%s\": %llu,\n", _phaseNames[phase], (unsigned long long) time);
+	}
+	fprintf(stream, "\t\t\"total\": %llu\n\t},\n", (unsigned long long) total);
+	for (int group = 0; group < STATISTICS_GROUP_COUNT; ++group) {
+		_writeGroup(stream, group);
+	}
+#ifdef ALLOCATION_STATISTICS
+	fprintf(stream, "\t\"allocations\": { \"allocations\": %lu, \"reallocations\": %lu, \"releases\": %lu, \"bytes\": %lu },\n",
+		_allocations, _reallocations, _releases, _allocatedBytes);
+#else
+	fprintf(stream, "\t\"allocations\": null,\n");
+#endif
+	fprintf(stream, "\t\"symbolTable\": { \"lookups\": %lu, \"probes\": %lu, \"declarations\": %lu },\n",
+		_symbolLookups, _symbolProbes, _symbolDeclarations);
+	fprintf(stream, "\t\"parserStack\": { \"highWaterMark\": %u }\n}\n", _parserDepth);
+}
+
+/**
+ * The allocation counters. The linker redirects the calls of the compiler
+ * to these wrappers (with "--wrap"), which then call the real functions.
+ */
+#ifdef ALLOCATION_STATISTICS
+
+void * __real_calloc(size_t count, size_t size);
+void __real_free(void * pointer);
+void * __real_malloc(size_t size);
+int __real_posix_memalign(void ** pointer, size_t alignment, size_t size);
+void * __real_realloc(void * pointer, size_t size);
+char * __real_strdup(const char * string);
+
+void * __wrap_calloc(size_t count, size_t size) {
+	if (statisticsEnabled) {
+		__atomic_fetch_add(&_allocations, 1, __ATOMIC_RELAXED);
+		__atomic_fetch_add(&_allocatedBytes, count * size, __ATOMIC_RELAXED);
+	}
+	return __real_calloc(count, size);
+}
+
+void __wrap_free(void * pointer) {
+	if (statisticsEnabled && pointer != NULL) {
+		__atomic_fetch_add(&_releases, 1, __ATOMIC_RELAXED);
+	}
+	__real_free(pointer);
+}
+
+void * __wrap_malloc(size_t size) {
+	if (statisticsEnabled) {
+		__atomic_fetch_add(&_allocations, 1, __ATOMIC_RELAXED);
+		__atomic_fetch_add(&_allocatedBytes, size, __ATOMIC_RELAXED);
+	}
+	return __real_malloc(size);
+}
+
+int __wrap_posix_memalign(void ** pointer, size_t alignment, size_t size) {
+	if (statisticsEnabled) {
+		__atomic_fetch_add(&_allocations, 1, __ATOMIC_RELAXED);
+		__atomic_fetch_add(&_allocatedBytes, size, __ATOMIC_RELAXED);
+	}
+	return __real_posix_memalign(pointer, alignment, size);
+}
+
+void * __wrap_realloc(void * pointer, size_t size) {
+	if (statisticsEnabled) {
+		__atomic_fetch_add(&_reallocations, 1, __ATOMIC_RELAXED);
+		__atomic_fetch_add(&_allocatedBytes, size, __ATOMIC_RELAXED);
+	}
+	return __real_realloc(pointer, size);
+}
+
+char * __wrap_strdup(const char * string) {
+	if (statisticsEnabled) {
+		__atomic_fetch_add(&_allocations, 1, __ATOMIC_RELAXED);
+		__atomic_fetch_add(&_allocatedBytes, strlen(string) + 1, __ATOMIC_RELAXED);
+	}
+	return __real_strdup(string);
+}
+
+#endif
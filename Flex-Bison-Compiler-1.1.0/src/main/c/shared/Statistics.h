@@ -0,0 +1,106 @@
+#ifndef STATISTICS_HEADER
+#define STATISTICS_HEADER
+
+#include "Type.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * The counters and timers of a compilation (see "--stats"). Every probe in
+ * the compiler is guarded by "statisticsEnabled", so the only cost of the
+ * instrumentation while it's disabled is that branch. The counters are
+ * updated atomically, since many parsers (see "parseTokensInParallel") and
+ * many generators (see "GENERATOR_THREADS") can run at the same time.
+ */
+
+/**
+ * The timed phases of a compilation.
+ */
+typedef enum {
+	STATISTICS_LEXING,
+	STATISTICS_PARSING,
+	STATISTICS_GENERATION,
+	STATISTICS_RELEASE,
+	STATISTICS_PHASE_COUNT
+} StatisticsPhase;
+
+/**
+ * The groups of counters indexed by name.
+ */
+typedef enum {
+	STATISTICS_TOKENS,
+	STATISTICS_NODES,
+	STATISTICS_PEEPHOLE_RULES,
+	STATISTICS_BOUNDS_CHECKS,
+	STATISTICS_FUNCTION_CACHE,
+	STATISTICS_DEAD_DECLARATIONS,
+	STATISTICS_PARTIAL_EVALUATION,
+	STATISTICS_SPECIALIZATION,
+	STATISTICS_INSTRUCTION_SELECTION,
+	STATISTICS_GROUP_COUNT
+} StatisticsGroup;
+
+/**
+ * True while the statistics are collected. Only read it: it's changed with
+ * "startStatistics" and "stopStatistics".
+ */
+extern boolean statisticsEnabled;
+
+/** Initialize module's internal state. */
+void initializeStatisticsModule();
+
+/** Shutdown module's internal state. */
+void shutdownStatisticsModule();
+
+/**
+ * Resets every counter and timer, and starts collecting statistics.
+ */
+void startStatistics();
+
+/**
+ * Stops collecting statistics (they can still be written).
+ */
+void stopStatistics();
+
+/**
+ * The current time of a monotonic clock, in nanoseconds.
+ */
+uint64_t monotonicTime();
+
+/**
+ * Accumulates time in a phase. The parsing time includes the lexing, since
+ * the scanner runs on demand of the parser, so it's subtracted in the report.
+ */
+void addPhaseTime(const StatisticsPhase phase, const uint64_t nanoseconds);
+
+/**
+ * Adds an amount to the counter of a group with the specified name. The
+ * name must be a static string, since the counters are indexed by address.
+ */
+void countNamed(const StatisticsGroup group, const char * name, const unsigned long amount);
+
+/**
+ * Counts a lookup in a symbol table, that compared the specified amount of
+ * symbols (zero for an empty bucket).
+ */
+void countSymbolLookup(const unsigned int probes);
+
+/**
+ * Counts a declaration in a symbol table.
+ */
+void countSymbolDeclaration();
+
+/**
+ * Records the depth of the parser stack, to keep its high-water mark.
+ */
+void recordParserDepth(const unsigned int depth);
+
+/**
+ * Writes the statistics as a JSON object.
+ */
+void writeStatistics(FILE * stream);
+
+#endif
@@ -0,0 +1,805 @@
+#include "../backend/code-generation/Emitter.h"
+#include "../backend/code-generation/Generator.h"
+#include "../backend/domain-specific/Calculator.h"
+#include "../backend/optimization/Peephole.h"
+#include "../frontend/lexical-analysis/FlexActions.h"
+#include "../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../frontend/syntactic-analysis/BisonActions.h"
+#include "../frontend/syntactic-analysis/SyntacticAnalyzer.h"
+#include "../shared/CompilerState.h"
+#include "../shared/Logger.h"
+#include "../shared/Statistics.h"
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+static const char * _green = "\033[0;32m";
+static const char * _red = "\033[0;31m";
+static const char * _yellow = "\033[0;33m";
+static const char * _off = "\033[0m";
+
+/**
+ * A regression must also be slower than its baseline by this amount, since
+ * the time of the smallest cases is mostly noise.
+ */
+static const uint64_t _minimumRegression = 1000000;
+
+/**
+ * The directives of a case (see "script/ubuntu/test.sh") that decide whether
+ * it compiles: the variables ("NAME=value") and the arguments of every
+ * compilation, and the names of the cases of "accept" whose summaries it
+ * loads. The other ones check the output, or run the program (such as
+ * "profile"), so only the script applies them.
+ */
+typedef struct {
+	char ** variables;
+	unsigned int variableCount;
+	char ** arguments;
+	unsigned int argumentCount;
+	char ** interfaces;
+	unsigned int interfaceCount;
+} Directives;
+
+/**
+ * A case of the corpus, whose expected outcome is given by its directory.
+ */
+typedef struct {
+	char * path;
+	boolean accept;
+	Directives directives;
+} TestCase;
+
+/**
+ * The result of a case, written by the worker that compiles it. A worker
+ * that dies while compiling a case leaves the signal that killed it.
+ */
+typedef struct {
+	boolean finished;
+	CompilationStatus status;
+	int signal;
+	uint64_t nanoseconds;
+} TestResult;
+
+/**
+ * The state shared by the runner and its workers (in anonymous shared
+ * memory): the next case to take, the case of each worker, and the results.
+ */
+typedef struct {
+	unsigned int next;
+	unsigned int caseCount;
+	unsigned int workerCount;
+	int * running;
+	TestResult * results;
+} SharedState;
+
+/**
+ * The variables that a worker applied for its current case, with the values
+ * that they had before (or NULL), to restore them.
+ */
+typedef struct {
+	char ** variables;
+	char ** previous;
+	unsigned int count;
+} AppliedEnvironment;
+
+/**
+ * A recorded compilation time.
+ */
+typedef struct {
+	char * path;
+	uint64_t nanoseconds;
+} BaselineEntry;
+
+/**
+ * The configuration of a run.
+ */
+typedef struct {
+	const char * corpus;
+	const char * directory;
+	const char * baseline;
+	const char * record;
+	unsigned int workers;
+	unsigned int repetitions;
+	unsigned int timeout;
+	unsigned int tolerance;
+} RunnerOptions;
+
+/* PRIVATE FUNCTIONS */
+
+static boolean _addCases(const char * corpus, const char * directory, const boolean accept, TestCase ** cases, unsigned int * count, unsigned int * capacity);
+static void _addWord(char *** words, unsigned int * count, const char * word, const size_t length);
+static int _compareBaselineEntries(const void * left, const void * right);
+static int _compareNames(const void * left, const void * right);
+static CompilationStatus _compileCase(FILE * input, const Directives * directives, uint64_t * nanoseconds);
+static const BaselineEntry * _findBaseline(const BaselineEntry * entries, const unsigned int count, const char * path);
+static const TestCase * _findCase(const TestCase * cases, const unsigned int count, const char * path);
+static void _freeWords(char ** words, const unsigned int count);
+static boolean _hasArgument(const Directives * directives, const char * argument);
+static void _initializeModules(void);
+static BaselineEntry * _loadBaseline(const char * path, unsigned int * count);
+static FILE * _openCase(const int home, const char * path);
+static boolean _parseOptions(const int count, const char ** arguments, RunnerOptions * options);
+static void _readDirectives(const char * path, Directives * directives);
+static boolean _recordBaseline(const char * path, const TestCase * cases, const SharedState * state);
+static void _removeDirectory(const char * path);
+static unsigned int _report(const RunnerOptions * options, const TestCase * cases, const SharedState * state, const uint64_t nanoseconds);
+static CompilationStatus _runCase(const RunnerOptions * options, const TestCase * cases, const unsigned int caseCount, const unsigned int index, AppliedEnvironment * environment, uint64_t * nanoseconds);
+static void _runWorker(const TestCase * cases, SharedState * state, const unsigned int worker, const RunnerOptions * options);
+static boolean _runCases(const TestCase * cases, SharedState * state, const RunnerOptions * options);
+static void _shutdownModules(void);
+static pid_t _spawnWorker(const TestCase * cases, SharedState * state, const unsigned int worker, const RunnerOptions * options);
+static void _useEnvironment(AppliedEnvironment * environment, char ** variables, const unsigned int count);
+static void _writeInterface(const RunnerOptions * options, const TestCase * cases, const unsigned int caseCount, const int home, const char * name, AppliedEnvironment * environment);
+
+/**
+ * Adds every file of a directory of the corpus, sorted by name.
+ */
+static boolean _addCases(const char * corpus, const char * directory, const boolean accept, TestCase ** cases, unsigned int * count, unsigned int * capacity) {
+	char path[PATH_MAX];
+	snprintf(path, sizeof(path), "%s/%s", corpus, directory);
+	DIR * stream = opendir(path);
+	if (stream == NULL) {
+		logError(_logger, "Cannot open the directory \"%s\": %s", path, strerror(errno));
+		return false;
+	}
+	const unsigned int first = *count;
+	for (struct dirent * entry = readdir(stream); entry != NULL; entry = readdir(stream)) {
+		if (entry->d_name[0] == '.') {
+			continue;
+		}
+		if (*count == *capacity) {
+			*capacity = *capacity == 0 ? 64 : 2 * *capacity;
+			*cases = realloc(*cases, *capacity * sizeof(TestCase));
+		}
+		TestCase * testCase = &(*cases)[(*count)++];
+		testCase->path = malloc(strlen(path) + strlen(entry->d_name) + 2);
+		sprintf(testCase->path, "%s/%s", path, entry->d_name);
+		testCase->accept = accept;
+		_readDirectives(testCase->path, &testCase->directives);
+	}
+	closedir(stream);
+	qsort(*cases + first, *count - first, sizeof(TestCase), _compareNames);
+	return true;
+}
+
+static void _addWord(char *** words, unsigned int * count, const char * word, const size_t length) {
+	*words = realloc(*words, (*count + 1) * sizeof(char *));
+	(*words)[(*count)++] = strndup(word, length);
+}
+
+static int _compareBaselineEntries(const void * left, const void * right) {
+	return strcmp(((const BaselineEntry *) left)->path, ((const BaselineEntry *) right)->path);
+}
+
+static int _compareNames(const void * left, const void * right) {
+	return strcmp(((const TestCase *) left)->path, ((const TestCase *) right)->path);
+}
+
+/**
+ * Compiles a case in-process (with the output discarded), like the
+ * compiler does with its standard input, and with the arguments of its
+ * directives that choose how it's parsed and generated.
+ */
+static CompilationStatus _compileCase(FILE * input, const Directives * directives, uint64_t * nanoseconds) {
+	const boolean streaming = _hasArgument(directives, "--streaming");
+	const boolean parallelParse = !streaming && _hasArgument(directives, "--parallel-parse");
+	rewind(input);
+	const uint64_t start = monotonicTime();
+	restartSyntacticAnalyzer(input);
+	CompilerState compilerState = {
+		.abstractSyntaxtTree = NULL,
+		.succeed = false,
+		.value = 0
+	};
+	CompilerState generationState = {
+		.abstractSyntaxtTree = NULL,
+		.succeed = true,
+		.value = 0
+	};
+	if (streaming && beginGeneration(&generationState)) {
+		compilerState.declarationConsumer = generateDeclaration;
+	}
+	SyntacticAnalysisStatus syntacticAnalysisStatus;
+	if (parallelParse || _hasArgument(directives, "--token-array")) {
+		TokenArray * tokens = lexTokens();
+		syntacticAnalysisStatus = parallelParse
+			? parseTokensInParallel(&compilerState, tokens)
+			: parseTokens(&compilerState, tokens);
+		destroyTokenArray(tokens);
+	}
+	else {
+		syntacticAnalysisStatus = parse(&compilerState);
+	}
+	if (compilerState.declarationConsumer != NULL) {
+		endGeneration();
+	}
+	CompilationStatus compilationStatus = FAILED;
+	if (syntacticAnalysisStatus == ACCEPT) {
+		Program * program = compilerState.abstractSyntaxtTree;
+		compilerState.succeed = true;
+		if (streaming) {
+			compilerState.succeed = generationState.succeed;
+		}
+		else {
+			generate(&compilerState);
+		}
+		if (compilerState.succeed) {
+			compilationStatus = SUCCEED;
+		}
+		freeProgram(program);
+	}
+	*nanoseconds = monotonicTime() - start;
+	return compilationStatus;
+}
+
+static const BaselineEntry * _findBaseline(const BaselineEntry * entries, const unsigned int count, const char * path) {
+	const BaselineEntry key = { .path = (char *) path, .nanoseconds = 0 };
+	return count == 0 ? NULL : bsearch(&key, entries, count, sizeof(BaselineEntry), _compareBaselineEntries);
+}
+
+static const TestCase * _findCase(const TestCase * cases, const unsigned int count, const char * path) {
+	for (unsigned int k = 0; k < count; ++k) {
+		if (strcmp(cases[k].path, path) == 0) {
+			return &cases[k];
+		}
+	}
+	return NULL;
+}
+
+static void _freeWords(char ** words, const unsigned int count) {
+	for (unsigned int k = 0; k < count; ++k) {
+		free(words[k]);
+	}
+	free(words);
+}
+
+static boolean _hasArgument(const Directives * directives, const char * argument) {
+	for (unsigned int k = 0; k < directives->argumentCount; ++k) {
+		if (strcmp(directives->arguments[k], argument) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static void _initializeModules(void) {
+	initializeStatisticsModule();
+	initializeLineCounterModule();
+	initializeFlexActionsModule();
+	initializeBisonActionsModule();
+	initializeSyntacticAnalyzerModule();
+	initializeAbstractSyntaxTreeModule();
+	initializeInterfaceResolverModule();
+	initializeTypeCheckerModule();
+	initializeCalculatorModule();
+	initializePeepholeModule();
+	initializeEmitterModule();
+	initializeGeneratorModule();
+}
+
+/**
+ * Loads a baseline: a line with the time (in nanoseconds) and the path of
+ * each case, as written by "--record".
+ */
+static BaselineEntry * _loadBaseline(const char * path, unsigned int * count) {
+	FILE * stream = fopen(path, "r");
+	if (stream == NULL) {
+		logError(_logger, "Cannot open the baseline \"%s\": %s", path, strerror(errno));
+		return NULL;
+	}
+	BaselineEntry * entries = NULL;
+	unsigned int capacity = 0;
+	unsigned long long nanoseconds;
+	char name[PATH_MAX];
+	*count = 0;
+	while (fscanf(stream, "%llu %4095[^\n]", &nanoseconds, name) == 2) {
+		if (*count == capacity) {
+			capacity = capacity == 0 ? 64 : 2 * capacity;
+			entries = realloc(entries, capacity * sizeof(BaselineEntry));
+		}
+		entries[*count].path = strdup(name);
+		entries[*count].nanoseconds = nanoseconds;
+		++*count;
+	}
+	fclose(stream);
+	qsort(entries, *count, sizeof(BaselineEntry), _compareBaselineEntries);
+	return entries;
+}
+
+/**
+ * Opens a case by its path relative to the original directory of the
+ * worker, from the directory of any case.
+ */
+static FILE * _openCase(const int home, const char * path) {
+	const int descriptor = openat(home, path, O_RDONLY);
+	return descriptor < 0 ? NULL : fdopen(descriptor, "r");
+}
+
+/**
+ * Parses the "--name value" options.
+ */
+static boolean _parseOptions(const int count, const char ** arguments, RunnerOptions * options) {
+	for (int k = 1; k < count; ++k) {
+		const char * name = arguments[k];
+		if (count <= k + 1) {
+			logError(_logger, "The option \"%s\" is unknown, or has no value.", name);
+			return false;
+		}
+		const char * value = arguments[++k];
+		if (strcmp(name, "--corpus") == 0) options->corpus = value;
+		else if (strcmp(name, "--baseline") == 0) options->baseline = value;
+		else if (strcmp(name, "--record") == 0) options->record = value;
+		else if (strcmp(name, "--workers") == 0) options->workers = (unsigned int) strtoul(value, NULL, 10);
+		else if (strcmp(name, "--repetitions") == 0) options->repetitions = (unsigned int) strtoul(value, NULL, 10);
+		else if (strcmp(name, "--timeout") == 0) options->timeout = (unsigned int) strtoul(value, NULL, 10);
+		else if (strcmp(name, "--tolerance") == 0) options->tolerance = (unsigned int) strtoul(value, NULL, 10);
+		else {
+			logError(_logger, "The option \"%s\" is unknown.", name);
+			return false;
+		}
+	}
+	if (options->repetitions == 0) {
+		options->repetitions = 1;
+	}
+	return true;
+}
+
+/**
+ * Reads the directives of a case as the script does: the "name: value"
+ * lines of the comment that starts the case, if any. The words of the
+ * "environment" and "arguments" directives with a "=" are variables, and the
+ * other ones are arguments.
+ */
+static void _readDirectives(const char * path, Directives * directives) {
+	*directives = (Directives) { 0 };
+	FILE * stream = fopen(path, "r");
+	if (stream == NULL) {
+		return;
+	}
+	char line[4096];
+	for (boolean first = true; fgets(line, sizeof(line), stream) != NULL; first = false) {
+		if (first && strncmp(line, "/*", 2) != 0) {
+			break;
+		}
+		char * text = first ? line + strspn(line, "/*") : line;
+		char * closing = strstr(text, "*/");
+		if (closing != NULL) {
+			*closing = '\0';
+		}
+		text += strspn(text, " \t");
+		text += *text == '*';
+		text += strspn(text, " \t");
+		const boolean interface = strncmp(text, "interface: ", 11) == 0;
+		char * value = interface ? text + 11
+			: strncmp(text, "environment: ", 13) == 0 ? text + 13
+			: strncmp(text, "arguments: ", 11) == 0 ? text + 11
+			: NULL;
+		while (value != NULL && *(value += strspn(value, " \t\r\n")) != '\0') {
+			const size_t length = strcspn(value, " \t\r\n");
+			if (interface) {
+				_addWord(&directives->interfaces, &directives->interfaceCount, value, length);
+			}
+			else if (memchr(value, '=', length) != NULL) {
+				_addWord(&directives->variables, &directives->variableCount, value, length);
+			}
+			else {
+				_addWord(&directives->arguments, &directives->argumentCount, value, length);
+			}
+			value += length;
+		}
+		if (closing != NULL) {
+			break;
+		}
+	}
+	fclose(stream);
+}
+
+static boolean _recordBaseline(const char * path, const TestCase * cases, const SharedState * state) {
+	FILE * stream = fopen(path, "w");
+	if (stream == NULL) {
+		logError(_logger, "Cannot write the baseline \"%s\": %s", path, strerror(errno));
+		return false;
+	}
+	for (unsigned int k = 0; k < state->caseCount; ++k) {
+		if (state->results[k].signal == 0) {
+			fprintf(stream, "%llu %s\n", (unsigned long long) state->results[k].nanoseconds, cases[k].path);
+		}
+	}
+	return fclose(stream) == 0;
+}
+
+static void _removeDirectory(const char * path) {
+	DIR * stream = opendir(path);
+	for (struct dirent * entry = stream == NULL ? NULL : readdir(stream); entry != NULL; entry = readdir(stream)) {
+		if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+			continue;
+		}
+		char child[PATH_MAX];
+		struct stat status;
+		snprintf(child, sizeof(child), "%s/%s", path, entry->d_name);
+		if (lstat(child, &status) == 0 && S_ISDIR(status.st_mode)) {
+			_removeDirectory(child);
+		}
+		else {
+			unlink(child);
+		}
+	}
+	if (stream != NULL) {
+		closedir(stream);
+	}
+	rmdir(path);
+}
+
+/**
+ * Writes the failed and the regressed cases, and a summary. Returns the
+ * amount of cases that failed or regressed.
+ */
+static unsigned int _report(const RunnerOptions * options, const TestCase * cases, const SharedState * state, const uint64_t nanoseconds) {
+	unsigned int baselineCount = 0;
+	BaselineEntry * baseline = options->baseline == NULL ? NULL : _loadBaseline(options->baseline, &baselineCount);
+	unsigned int failed = 0;
+	unsigned int regressed = 0;
+	for (unsigned int k = 0; k < state->caseCount; ++k) {
+		const TestCase * testCase = &cases[k];
+		const TestResult * result = &state->results[k];
+		const double milliseconds = result->nanoseconds / 1e6;
+		if (result->signal != 0) {
+			++failed;
+			printf("    %s, %sbut it %s%s (signal %d: %s)\n", testCase->path, _red,
+				result->signal == SIGALRM ? "timed out" : "crashed", _off, result->signal, strsignal(result->signal));
+		}
+		else if ((result->status == SUCCEED) != testCase->accept) {
+			++failed;
+			printf("    %s, %sbut it %s%s (%.3f ms)\n", testCase->path, _red,
+				testCase->accept ? "rejects" : "accepts", _off, milliseconds);
+		}
+		const BaselineEntry * entry = _findBaseline(baseline, baselineCount, testCase->path);
+		if (result->signal == 0 && entry != NULL
+				&& entry->nanoseconds * (100 + options->tolerance) < 100 * result->nanoseconds
+				&& entry->nanoseconds + _minimumRegression < result->nanoseconds) {
+			++regressed;
+			printf("    %s, %sregressed%s from %.3f ms to %.3f ms\n", testCase->path, _yellow, _off,
+				entry->nanoseconds / 1e6, milliseconds);
+		}
+	}
+	const unsigned int passed = state->caseCount - failed;
+	printf("%u cases: %s%u passed%s, %s%u failed%s, %s%u regressed%s (%.3f s, with %u workers).\n",
+		state->caseCount,
+		_green, passed, _off,
+		failed == 0 ? "" : _red, failed, failed == 0 ? "" : _off,
+		regressed == 0 ? "" : _yellow, regressed, regressed == 0 ? "" : _off,
+		nanoseconds / 1e9, state->workerCount);
+	for (unsigned int k = 0; k < baselineCount; ++k) {
+		free(baseline[k].path);
+	}
+	free(baseline);
+	return failed + regressed;
+}
+
+/**
+ * Runs a case in a directory of its own, where the relative paths of its
+ * variables are resolved, and with the environment of its directives (after
+ * the cases of its "interface" directives, which write their summaries
+ * there). The case is compiled many times, and its time is the fastest one.
+ */
+static CompilationStatus _runCase(const RunnerOptions * options, const TestCase * cases, const unsigned int caseCount, const unsigned int index, AppliedEnvironment * environment, uint64_t * nanoseconds) {
+	const TestCase * testCase = &cases[index];
+	const Directives * directives = &testCase->directives;
+	char directory[PATH_MAX];
+	snprintf(directory, sizeof(directory), "%s/%u", options->directory, index);
+	const int home = open(".", O_RDONLY | O_DIRECTORY);
+	FILE * input = home < 0 ? NULL : _openCase(home, testCase->path);
+	if (input == NULL || mkdir(directory, S_IRWXU) != 0 || chdir(directory) != 0) {
+		logError(_logger, "Cannot prepare the case \"%s\": %s", testCase->path, strerror(errno));
+		if (input != NULL) {
+			fclose(input);
+		}
+		if (0 <= home) {
+			close(home);
+		}
+		return FAILED;
+	}
+	char interfaces[PATH_MAX] = "INTERFACE_FILES=";
+	for (unsigned int k = 0; k < directives->interfaceCount; ++k) {
+		_writeInterface(options, cases, caseCount, home, directives->interfaces[k], environment);
+		const size_t length = strlen(interfaces);
+		snprintf(interfaces + length, sizeof(interfaces) - length, "%sinterface-%s.bin", k == 0 ? "" : ":", directives->interfaces[k]);
+	}
+	char ** variables = NULL;
+	unsigned int variableCount = 0;
+	for (unsigned int k = 0; k < directives->variableCount; ++k) {
+		_addWord(&variables, &variableCount, directives->variables[k], strlen(directives->variables[k]));
+	}
+	if (0 < directives->interfaceCount) {
+		_addWord(&variables, &variableCount, interfaces, strlen(interfaces));
+	}
+	_useEnvironment(environment, variables, variableCount);
+	CompilationStatus compilationStatus = FAILED;
+	for (unsigned int k = 0; k < options->repetitions; ++k) {
+		uint64_t repetition = 0;
+		compilationStatus = _compileCase(input, directives, &repetition);
+		if (k == 0 || repetition < *nanoseconds) {
+			*nanoseconds = repetition;
+		}
+	}
+	fclose(input);
+	if (fchdir(home) != 0) {
+		logError(_logger, "Cannot leave the directory of the case \"%s\": %s", testCase->path, strerror(errno));
+	}
+	close(home);
+	_removeDirectory(directory);
+	return compilationStatus;
+}
+
+/**
+ * Runs the cases of the shared queue until it's empty.
+ */
+static void _runWorker(const TestCase * cases, SharedState * state, const unsigned int worker, const RunnerOptions * options) {
+	const int discard = open("/dev/null", O_WRONLY);
+	if (0 <= discard) {
+		dup2(discard, STDOUT_FILENO);
+		dup2(discard, STDERR_FILENO);
+		close(discard);
+	}
+	AppliedEnvironment environment = {
+		.variables = NULL,
+		.previous = NULL,
+		.count = 0
+	};
+	for (;;) {
+		const unsigned int index = __atomic_fetch_add(&state->next, 1, __ATOMIC_RELAXED);
+		if (state->caseCount <= index) {
+			break;
+		}
+		__atomic_store_n(&state->running[worker], (int) index, __ATOMIC_RELEASE);
+		TestResult * result = &state->results[index];
+		alarm(options->timeout);
+		result->status = _runCase(options, cases, state->caseCount, index, &environment, &result->nanoseconds);
+		alarm(0);
+		__atomic_store_n(&result->finished, true, __ATOMIC_RELEASE);
+		__atomic_store_n(&state->running[worker], -1, __ATOMIC_RELEASE);
+	}
+	fflush(stdout);
+	_exit(0);
+}
+
+/**
+ * Runs every case in a pool of workers. A worker that dies (because the
+ * compiler crashed, or timed out) marks its case, and it's replaced while
+ * there are cases left.
+ */
+static boolean _runCases(const TestCase * cases, SharedState * state, const RunnerOptions * options) {
+	pid_t * pids = calloc(state->workerCount, sizeof(pid_t));
+	unsigned int alive = 0;
+	for (unsigned int k = 0; k < state->workerCount; ++k) {
+		state->running[k] = -1;
+		if (0 < (pids[k] = _spawnWorker(cases, state, k, options))) {
+			++alive;
+		}
+	}
+	while (0 < alive) {
+		int status;
+		const pid_t pid = waitpid(-1, &status, 0);
+		if (pid < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+		unsigned int worker = 0;
+		while (worker < state->workerCount && pids[worker] != pid) {
+			++worker;
+		}
+		if (worker == state->workerCount) {
+			continue;
+		}
+		--alive;
+		pids[worker] = 0;
+		const int index = __atomic_load_n(&state->running[worker], __ATOMIC_ACQUIRE);
+		if (0 <= index) {
+			TestResult * result = &state->results[index];
+			result->signal = WIFSIGNALED(status) ? WTERMSIG(status) : SIGABRT;
+			result->finished = true;
+			state->running[worker] = -1;
+			if (__atomic_load_n(&state->next, __ATOMIC_ACQUIRE) < state->caseCount
+					&& 0 < (pids[worker] = _spawnWorker(cases, state, worker, options))) {
+				++alive;
+			}
+		}
+	}
+	free(pids);
+	for (unsigned int k = 0; k < state->caseCount; ++k) {
+		if (!state->results[k].finished) {
+			logError(_logger, "The case \"%s\" was never run.", cases[k].path);
+			return false;
+		}
+	}
+	return true;
+}
+
+static void _shutdownModules(void) {
+	shutdownGeneratorModule();
+	shutdownEmitterModule();
+	shutdownPeepholeModule();
+	shutdownCalculatorModule();
+	shutdownTypeCheckerModule();
+	shutdownInterfaceResolverModule();
+	shutdownAbstractSyntaxTreeModule();
+	shutdownSyntacticAnalyzerModule();
+	shutdownBisonActionsModule();
+	shutdownFlexActionsModule();
+	shutdownLineCounterModule();
+	shutdownStatisticsModule();
+}
+
+static pid_t _spawnWorker(const TestCase * cases, SharedState * state, const unsigned int worker, const RunnerOptions * options) {
+	fflush(stdout);
+	fflush(stderr);
+	const pid_t pid = fork();
+	if (pid == 0) {
+		_runWorker(cases, state, worker, options);
+	}
+	else if (pid < 0) {
+		logError(_logger, "Cannot create a worker: %s", strerror(errno));
+	}
+	return pid;
+}
+
+/**
+ * Applies the variables (and takes their ownership), restoring the ones of
+ * the previous case first. The modules read their configuration from the
+ * environment, so they're initialized again, but only if the variables
+ * changed (as the compile server does).
+ */
+static void _useEnvironment(AppliedEnvironment * environment, char ** variables, const unsigned int count) {
+	boolean same = count == environment->count;
+	for (unsigned int k = 0; same && k < count; ++k) {
+		same = strcmp(variables[k], environment->variables[k]) == 0;
+	}
+	if (same) {
+		_freeWords(variables, count);
+		return;
+	}
+	_shutdownModules();
+	for (unsigned int k = environment->count; 0 < k; --k) {
+		char * name = environment->variables[k - 1];
+		name[strcspn(name, "=")] = '\0';
+		if (environment->previous[k - 1] == NULL) {
+			unsetenv(name);
+		}
+		else {
+			setenv(name, environment->previous[k - 1], 1);
+		}
+	}
+	_freeWords(environment->variables, environment->count);
+	_freeWords(environment->previous, environment->count);
+	environment->variables = variables;
+	environment->previous = calloc(count == 0 ? 1 : count, sizeof(char *));
+	environment->count = count;
+	for (unsigned int k = 0; k < count; ++k) {
+		const size_t length = strcspn(variables[k], "=");
+		char * name = strndup(variables[k], length);
+		const char * previous = getenv(name);
+		environment->previous[k] = previous == NULL ? NULL : strdup(previous);
+		setenv(name, variables[k] + length + 1, 1);
+		free(name);
+	}
+	_initializeModules();
+}
+
+/**
+ * Compiles a case of "accept" (with its own directives) to write its
+ * summary in the current directory, as "interface-<name>.bin".
+ */
+static void _writeInterface(const RunnerOptions * options, const TestCase * cases, const unsigned int caseCount, const int home, const char * name, AppliedEnvironment * environment) {
+	char path[PATH_MAX];
+	snprintf(path, sizeof(path), "%s/accept/%s", options->corpus, name);
+	const TestCase * library = _findCase(cases, caseCount, path);
+	FILE * input = library == NULL ? NULL : _openCase(home, library->path);
+	if (input == NULL) {
+		logError(_logger, "Cannot open the interface \"%s\".", path);
+		return;
+	}
+	char ** variables = NULL;
+	unsigned int variableCount = 0;
+	for (unsigned int k = 0; k < library->directives.variableCount; ++k) {
+		_addWord(&variables, &variableCount, library->directives.variables[k], strlen(library->directives.variables[k]));
+	}
+	snprintf(path, sizeof(path), "INTERFACE_OUTPUT_FILE=interface-%s.bin", name);
+	_addWord(&variables, &variableCount, path, strlen(path));
+	_useEnvironment(environment, variables, variableCount);
+	uint64_t nanoseconds = 0;
+	_compileCase(input, &library->directives, &nanoseconds);
+	fclose(input);
+}
+
+/* PUBLIC FUNCTIONS */
+
+/**
+ * Runs the corpus of the compiler ("accept" and "reject" directories) in
+ * a pool of processes, each one compiling many cases in-process, and reports
+ * the cases that fail, or whose time regressed from a baseline. The workers
+ * are processes (and not threads), so a case that crashes or hangs only
+ * loses its worker, and the environment of a case (which the modules read
+ * when they're initialized) only affects the worker that compiles it.
+ */
+int main(const int count, const char ** arguments) {
+	_logger = createLogger("TestRunner");
+	_initializeModules();
+
+	char directory[PATH_MAX];
+	const char * temporary = getenv("TMPDIR");
+	snprintf(directory, sizeof(directory), "%s/CompilerTestRunner.XXXXXX", temporary == NULL ? "/tmp" : temporary);
+	RunnerOptions options = {
+		.corpus = "src/test/c",
+		.directory = directory,
+		.baseline = NULL,
+		.record = NULL,
+		.workers = 0,
+		.repetitions = 3,
+		.timeout = 10,
+		.tolerance = 50
+	};
+	TestCase * cases = NULL;
+	unsigned int caseCount = 0;
+	unsigned int capacity = 0;
+	CompilationStatus compilationStatus = FAILED;
+	if (mkdtemp(directory) == NULL) {
+		logError(_logger, "Cannot create the directory of the cases \"%s\": %s", directory, strerror(errno));
+	}
+	else if (_parseOptions(count, arguments, &options)
+			&& _addCases(options.corpus, "accept", true, &cases, &caseCount, &capacity)
+			&& _addCases(options.corpus, "reject", false, &cases, &caseCount, &capacity)) {
+		const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+		unsigned int workers = options.workers == 0 ? (0 < processors ? (unsigned int) processors : 1) : options.workers;
+		if (caseCount < workers) {
+			workers = caseCount == 0 ? 1 : caseCount;
+		}
+		const size_t size = sizeof(SharedState) + workers * sizeof(int) + caseCount * sizeof(TestResult);
+		void * memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+		if (memory == MAP_FAILED) {
+			logError(_logger, "Cannot map the shared state: %s", strerror(errno));
+		}
+		else {
+			SharedState * state = memory;
+			state->next = 0;
+			state->caseCount = caseCount;
+			state->workerCount = workers;
+			state->results = (TestResult *) (state + 1);
+			state->running = (int *) (state->results + caseCount);
+			const uint64_t start = monotonicTime();
+			if (_runCases(cases, state, &options)) {
+				const unsigned int problems = _report(&options, cases, state, monotonicTime() - start);
+				const boolean recorded = options.record == NULL || _recordBaseline(options.record, cases, state);
+				compilationStatus = problems == 0 && recorded ? SUCCEED : FAILED;
+			}
+			munmap(memory, size);
+		}
+	}
+	for (unsigned int k = 0; k < caseCount; ++k) {
+		free(cases[k].path);
+		_freeWords(cases[k].directives.variables, cases[k].directives.variableCount);
+		_freeWords(cases[k].directives.arguments, cases[k].directives.argumentCount);
+		_freeWords(cases[k].directives.interfaces, cases[k].directives.interfaceCount);
+	}
+	free(cases);
+	_removeDirectory(directory);
+
+	_shutdownModules();
+	destroyLogger(_logger);
+	return compilationStatus;
+}